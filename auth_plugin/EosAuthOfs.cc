@@ -31,6 +31,7 @@
 #include "ProtoUtils.hh"
 #include "EosAuthOfsDirectory.hh"
 #include "EosAuthOfsFile.hh"
+#include "MgmChannel.hh"
 #include "common/SymKeys.hh"
 #include <XrdOuc/XrdOucTrace.hh>
 #include <XrdOuc/XrdOucString.hh>
@@ -41,7 +42,6 @@
 #include <XrdNet/XrdNetAddr.hh>
 #include <XProtocol/XProtocol.hh>
 #include <XrdVersion.hh>
-#include <google/protobuf/io/zero_copy_stream_impl.h>
 
 // The global OFS handle
 eos::auth::EosAuthOfs* eos::auth::gOFS = nullptr;
@@ -130,12 +130,11 @@ EOSAUTHNAMESPACE_BEGIN
 // Constructor
 //------------------------------------------------------------------------------
 EosAuthOfs::EosAuthOfs():
-  XrdOfs(), eos::common::LogId(),  proxy_tid(0), mFrontend(0),
-  mSizePoolSocket(5), mPort(0), mCollapsePort(0), mLogLevel(LOG_INFO)
+  XrdOfs(), eos::common::LogId(), mPort(0), mCollapsePort(0),
+  mLogLevel(LOG_INFO)
 {
   // Initialise the ZMQ client
   mZmqContext = new zmq::context_t(1);
-  mBackend = std::make_pair(std::string(""), (zmq::socket_t*)0);
 
   // Set Logging parameters
   XrdOucString unit = "auth@localhost";
@@ -152,21 +151,8 @@ EosAuthOfs::EosAuthOfs():
 //------------------------------------------------------------------------------
 EosAuthOfs::~EosAuthOfs()
 {
-  zmq::socket_t* socket;
-
-  // Kill the auth proxy thread
-  if (proxy_tid) {
-    XrdSysThread::Cancel(proxy_tid);
-    XrdSysThread::Join(proxy_tid, 0);
-  }
-
-  // Release memory
-  while (mPoolSocket.try_pop(socket)) {
-    delete socket;
-  }
-
-  delete mFrontend;
-  delete mBackend.second;
+  // Stop the I/O thread of the channel before the context goes away
+  mChannel.reset();
   delete mZmqContext;
 }
 
@@ -261,7 +247,7 @@ EosAuthOfs::Configure(XrdSysError& error, XrdOucEnv* envP)
             mgm_instance = val;
 
             if (mgm_instance.find(":") != std::string::npos) {
-              mBackend = std::make_pair(mgm_instance, (zmq::socket_t*)0);
+              mMgmEndpoint = mgm_instance;
             }
           } else {
             // This parameter is critical
@@ -281,15 +267,12 @@ EosAuthOfs::Configure(XrdSysError& error, XrdOucEnv* envP)
           }
         }
 
-        // Get number of sockets in the pool by default 10
+        // Obsolete, requests are multiplexed over one connection
         option_tag = "numsockets";
 
         if (!strncmp(var, option_tag.c_str(), option_tag.length())) {
-          if (!(val = Config.GetWord())) {
-            error.Emsg("Configure ", "No number of sockets specified");
-          } else {
-            mSizePoolSocket = atoi(val);
-          }
+          (void) Config.GetWord();
+          error.Say("=====> eosauth.numsockets is obsolete and ignored");
         }
 
         // Get log level by default LOG_INFO
@@ -321,37 +304,14 @@ EosAuthOfs::Configure(XrdSysError& error, XrdOucEnv* envP)
     }
 
     // Check and connect at least to an MGM master
-    if (!mBackend.first.empty()) {
-      if ((XrdSysThread::Run(&proxy_tid, EosAuthOfs::StartAuthProxyThread,
-                             static_cast<void*>(this), 0, "Auth Proxy Thread"))) {
-        eos_err("cannot start the authentication proxy thread");
-        NoGo = 1;
-      }
+    if (!mMgmEndpoint.empty()) {
+      mChannel.reset(new MgmChannel(*mZmqContext, "tcp://" + mMgmEndpoint));
 
-      // Create a pool of sockets connected to the master proxy service
-      for (int i = 0; i < mSizePoolSocket; i++) {
-        // Set socket receive timeout to 5 seconds
-        zmq::socket_t* socket = new zmq::socket_t(*mZmqContext, ZMQ_REQ);
-        int timeout_mili = 5000;
-        socket->set(zmq::sockopt::rcvtimeo, timeout_mili);
-        int socket_linger = 0;
-        socket->set(zmq::sockopt::linger, socket_linger);
-        std::string endpoint = "inproc://proxyfrontend";
-
-        // Try in a loop to connect to the proxyfrontend as it can take a while for
-        // the proxy thread to do the binding, therefore connect can fail
-        while (1) {
-          try {
-            socket->connect(endpoint.c_str());
-          } catch (zmq::error_t& err) {
-            eos_warning("dealing with connect exception, retrying ...");
-            continue;
-          }
-
-          break;
-        }
-
-        mPoolSocket.push(socket);
+      if (!mChannel->Start()) {
+        eos_err("cannot connect to the MGM %s", mMgmEndpoint.c_str());
+        NoGo = 1;
+      } else {
+        OfsEroute.Say("=====> connected to MGM: ", mMgmEndpoint.c_str());
       }
     } else {
       eos_err("No master MGM specified e.g. eos.master.cern.ch:15555");
@@ -410,144 +370,6 @@ EosAuthOfs::Configure(XrdSysError& error, XrdOucEnv* envP)
 }
 
 
-//------------------------------------------------------------------------------
-// Authentication proxy thread startup function
-//------------------------------------------------------------------------------
-void*
-EosAuthOfs::StartAuthProxyThread(void* pp)
-{
-  EosAuthOfs* ofs = static_cast<EosAuthOfs*>(pp);
-  ofs->AuthProxyThread();
-  return 0;
-}
-
-
-//------------------------------------------------------------------------------
-// Authentication proxt thread which forwards requests form the clients
-// to the proper MGM intance.
-//------------------------------------------------------------------------------
-void
-EosAuthOfs::AuthProxyThread()
-{
-  // Bind the client facing socket
-  mFrontend = new zmq::socket_t(*mZmqContext, ZMQ_ROUTER);
-  mFrontend->bind("inproc://proxyfrontend");
-  // Connect sockets facing the MGM nodes - master and slave
-  std::ostringstream sstr;
-  mBackend = std::make_pair(mBackend.first,
-			    new zmq::socket_t(*mZmqContext, ZMQ_DEALER));
-  sstr << "tcp://" << mBackend.first;
-  mBackend.second->connect(sstr.str().c_str());
-  OfsEroute.Say("=====> connected to MGM: ", mBackend.first.c_str());
-
-  // Set the master to point to the master MGM - no need for lock
-  auto master = mBackend.second;
-  int rc = -1;
-  zmq::message_t msg;
-  // Start the proxy using the first entry
-  int more;
-  int poll_size = 2;
-  zmq::pollitem_t items[3] = {
-    { (void*)* mFrontend, 0, ZMQ_POLLIN, 0},
-    { (void*)* mBackend.second, 0, ZMQ_POLLIN, 0}
-  };
-
-  // Main loop in which the proxy thread accepts request from the clients and
-  // then he forwards them to the current master MGM. The master MGM can change
-  // at any point.
-  while (true) {
-    // Wait while there are either requests or replies to process
-    try {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-      rc = zmq::poll(&items[0], poll_size, -1);
-#pragma GCC diagnostic pop
-    } catch (zmq::error_t& e) {
-      eos_err("Exception thrown: %s", e.what());
-    }
-
-    if (rc < 0) {
-      eos_err("error in poll");
-      return;
-    }
-
-    // Process a request
-    if (items[0].revents & ZMQ_POLLIN) {
-      eos_debug("got frontend event");
-      zmq::recv_flags rf = zmq::recv_flags::none;
-
-      while (true) {
-        if (!mFrontend->recv(msg, rf).has_value()) {
-          eos_err("error while recv on frontend");
-          return;
-        }
-
-        try {
-          more = mFrontend->get(zmq::sockopt::rcvmore);
-        } catch (zmq::error_t& err) {
-          eos_err("exception in getsockopt");
-          return;
-        }
-
-        // Send request to the MGM
-        {
-          XrdSysMutexHelper scop_lock(mMutexMaster);
-          zmq::send_flags sf = zmq::send_flags::none;
-
-          if (more) {
-            sf = zmq::send_flags::sndmore;
-          }
-
-          if (!master->send(msg, sf)) {
-            eos_err("error while sending to master");
-            return;
-          }
-        }
-
-        if (more == 0) {
-          break;
-        }
-      }
-    }
-
-    // Process a reply from the first MGM
-    if (items[1].revents & ZMQ_POLLIN) {
-      eos_debug("got mBackend event");
-      zmq::recv_flags rf = zmq::recv_flags::none;
-
-      while (true) {
-        if (!mBackend.second->recv(msg, rf).has_value()) {
-          eos_err("error while recv on mBackend");
-          return;
-        }
-
-        try {
-          more = mBackend.second->get(zmq::sockopt::rcvmore);
-        } catch (zmq::error_t& err) {
-          eos_err("exception in getsockopt");
-          return;
-        }
-
-        zmq::send_flags sf = zmq::send_flags::none;
-
-        if (more) {
-          sf = zmq::send_flags::sndmore;
-        }
-
-        if (!mFrontend->send(msg, sf)) {
-          eos_err("error while send to frontend(1)");
-          return;
-        }
-
-        if (more == 0) {
-          break;
-        }
-      }
-    }
-  }
-}
-
-
 //------------------------------------------------------------------------------
 // Get directory object
 //------------------------------------------------------------------------------
@@ -611,12 +433,11 @@ EosAuthOfs::stat(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_stat = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_stat = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_stat) {
       retc = resp_stat->response();
@@ -634,8 +455,7 @@ EosAuthOfs::stat(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -664,12 +484,11 @@ EosAuthOfs::stat(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_stat = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_stat = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_stat) {
       retc = resp_stat->response();
@@ -685,8 +504,7 @@ EosAuthOfs::stat(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -729,12 +547,11 @@ EosAuthOfs::fsctl(const int cmd,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_fsctl1 = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_fsctl1 = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_fsctl1) {
       retc = resp_fsctl1->response();
@@ -746,8 +563,7 @@ EosAuthOfs::fsctl(const int cmd,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -773,12 +589,11 @@ EosAuthOfs::FSctl(const int cmd,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_fsctl2 = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_fsctl2 = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_fsctl2) {
       retc = resp_fsctl2->response();
@@ -790,8 +605,7 @@ EosAuthOfs::FSctl(const int cmd,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -819,12 +633,11 @@ EosAuthOfs::chmod(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_chmod = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_chmod = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_chmod) {
       retc = resp_chmod->response();
@@ -835,8 +648,7 @@ EosAuthOfs::chmod(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -865,12 +677,11 @@ EosAuthOfs::chksum(csFunc func,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_chksum = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_chksum = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_chksum) {
       retc = resp_chksum->response();
@@ -882,8 +693,7 @@ EosAuthOfs::chksum(csFunc func,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -910,12 +720,11 @@ EosAuthOfs::exists(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_exists = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_exists = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_exists) {
       retc = resp_exists->response();
@@ -931,8 +740,7 @@ EosAuthOfs::exists(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -964,12 +772,11 @@ EosAuthOfs::mkdir(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_mkdir = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_mkdir = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_mkdir) {
       retc = resp_mkdir->response();
@@ -981,8 +788,7 @@ EosAuthOfs::mkdir(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -1008,12 +814,11 @@ EosAuthOfs::remdir(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_remdir = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_remdir = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_remdir) {
       retc = resp_remdir->response();
@@ -1025,8 +830,7 @@ EosAuthOfs::remdir(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -1052,12 +856,11 @@ EosAuthOfs::rem(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_rem = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_rem = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_rem) {
       retc = resp_rem->response();
@@ -1069,8 +872,7 @@ EosAuthOfs::rem(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -1099,12 +901,11 @@ EosAuthOfs::rename(const char* oldName,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_rename = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_rename = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_rename) {
       retc = resp_rename->response();
@@ -1116,8 +917,7 @@ EosAuthOfs::rename(const char* oldName,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -1142,12 +942,11 @@ EosAuthOfs::prepare(XrdSfsPrep& pargs,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_prepare = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_prepare = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_prepare) {
       retc = resp_prepare->response();
@@ -1159,8 +958,7 @@ EosAuthOfs::prepare(XrdSfsPrep& pargs,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -1188,12 +986,11 @@ EosAuthOfs::truncate(const char* path,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (SendProtoBufRequest(socket, req_proto)) {
-    ResponseProto* resp_truncate = static_cast<ResponseProto*>(GetResponse(socket));
+  if (SendProtoBufRequest(req_id, req_proto)) {
+    ResponseProto* resp_truncate = static_cast<ResponseProto*>(GetResponse(req_id));
 
     if (resp_truncate) {
       retc = resp_truncate->response();
@@ -1205,8 +1002,7 @@ EosAuthOfs::truncate(const char* path,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -1229,36 +1025,22 @@ EosAuthOfs::getStats(char* buff, int blen)
 // Send ProtocolBuffer object using ZMQ
 //------------------------------------------------------------------------------
 bool
-EosAuthOfs::SendProtoBufRequest(zmq::socket_t* socket,
+EosAuthOfs::SendProtoBufRequest(uint64_t& id,
                                 google::protobuf::Message* message)
 {
-  // Send the request
-  bool sent = false;
-#if GOOGLE_PROTOBUF_VERSION < 3004000
-  int msg_size = message->ByteSize();
-#else
-  int msg_size = message->ByteSizeLong();
-#endif
-  zmq::message_t request(msg_size);
-  google::protobuf::io::ArrayOutputStream aos(request.data(), msg_size);
-
-  if (!message->SerializeToZeroCopyStream(&aos)) {
-    eos_err("failed to serialize message");
-    return sent;
-  }
-
-  zmq::send_flags sf = zmq::send_flags::dontwait;
-  auto r = socket->send(request, sf);
+  std::string request;
 
-  if (r.has_value()) {
-    sent = true;
+  if (!message->SerializeToString(&request)) {
+    eos_err("failed to serialize message");
+    return false;
   }
 
-  if (!sent) {
+  if (!mChannel || !mChannel->Send(std::move(request), id)) {
     eos_err("unable to send request using zmq");
+    return false;
   }
 
-  return sent;
+  return true;
 }
 
 
@@ -1266,65 +1048,15 @@ EosAuthOfs::SendProtoBufRequest(zmq::socket_t* socket,
 // Get ProtocolBuffer response object using ZMQ
 //------------------------------------------------------------------------------
 google::protobuf::Message*
-EosAuthOfs::GetResponse(zmq::socket_t*& socket)
+EosAuthOfs::GetResponse(uint64_t id)
 {
   // It makes no sense to wait more than 1 min since the XRootD client will
   // timeout by default after 60 seconds.
-  int num_retries = 12; // 1 min = 12 * 5 sec
-  bool done = false;
-  bool reset_socket = false;
-  zmq::message_t reply;
+  std::string resp_str;
   ResponseProto* resp = static_cast<ResponseProto*>(0);
-
-  try {
-    zmq::recv_flags rf = zmq::recv_flags::none;
-    zmq::recv_result_t rr;
-
-    do {
-      rr = socket->recv(reply, rf);
-      --num_retries;
-
-      if (!rr.has_value()) {
-        eos_err("ptr_socket=%p, num_retries=%i failed receive", socket,
-                num_retries);
-      } else {
-        done = true;
-      }
-    } while (!rr.has_value() && (num_retries > 0));
-  } catch (zmq::error_t& e) {
-    eos_err("socket error: %s", e.what());
-    reset_socket = true;
-  }
-
-  // We time out while waiting for a response or a fatal error occurent -
-  // then we throw away the socket and create a new one
-  if ((num_retries <= 0) || reset_socket) {
-    eos_err("discard current socket and create a new one");
-    delete socket;
-    socket = new zmq::socket_t(*mZmqContext, ZMQ_REQ);
-    int timeout_mili = 5000;
-    socket->set(zmq::sockopt::rcvtimeo, timeout_mili);
-    int socket_linger = 0;
-    socket->set(zmq::sockopt::linger, socket_linger);
-    std::string endpoint = "inproc://proxyfrontend";
-
-    // Try in a loop to connect to the proxyfrontend as it can take a while for
-    // the proxy thread to do the binding, therefore connect can fail
-    while (1) {
-      try {
-        socket->connect(endpoint.c_str());
-      } catch (zmq::error_t& err) {
-        eos_warning("dealing with connect exception, retrying ...");
-        continue;
-      }
-
-      break;
-    }
-  }
+  bool done = mChannel->GetResponse(id, resp_str, std::chrono::seconds(60));
 
   if (done) {
-    std::string resp_str = std::string(static_cast<char*>(reply.data()),
-                                       reply.size());
     resp = new ResponseProto();
     resp->ParseFromString(resp_str);
 
@@ -26,8 +26,9 @@
 
 #include <XrdOfs/XrdOfs.hh>
 #include "Namespace.hh"
-#include "common/ConcurrentQueue.hh"
+#include "common/Logging.hh"
 #include <zmq.hpp>
+#include <memory>
 #include <string>
 
 //! Forward declaration
@@ -52,6 +53,8 @@ class Message;
 
 EOSAUTHNAMESPACE_BEGIN
 
+class MgmChannel;
+
 //------------------------------------------------------------------------------
 //! Class EosAuthOfs built on top of XrdOfs
 /*! Decription: The libEosAuthOfs.so is inteded to be used as an OFS library
@@ -72,11 +75,9 @@ EOSAUTHNAMESPACE_BEGIN
     - eosauth.mgm - contain the hostname and the
         port to which ZMQ will connect so that it can forward
         requests and receive responses. 
-    - eosauth.numsockets - once a clients wants to send a request the thread
-        allocated to him in XRootD will require a socket to send the request
-        to the MGM node. Therefore, we set up a pool of sockets from the
-        begining which can be used to send/receiver requests/responses.
-        The default size is 10 sockets.
+    - eosauth.numsockets - obsolete, the requests of all the client threads
+        are multiplexed over a single connection to the MGM and matched to
+        their responses by request id, see MgmChannel.
 
     MGM - configuration
     ===================
@@ -260,53 +261,36 @@ public:
 
 private:
 
-  pthread_t proxy_tid; ///< id of the proxy thread
   zmq::context_t* mZmqContext; ///< ZMQ context
-  zmq::socket_t* mFrontend; ///< proxy socket facing the clients
-  XrdSysMutex mMutexMaster;
-  int mSizePoolSocket; ///< maximum size of the client socket pool
-  eos::common::ConcurrentQueue<zmq::socket_t*>
-  mPoolSocket; ///< ZMQ client socket pool
-  ///! MGM endpoints to which requests can be dispatched and the corresponding sockets
-  std::pair<std::string, zmq::socket_t*> mBackend;
+  std::string mMgmEndpoint; ///< MGM endpoint to which requests are dispatched
+  std::unique_ptr<MgmChannel> mChannel; ///< Multiplexed channel to the MGM
   std::string mManagerIp; ///< auth ip address
   int mPort;   ///< port on which the current auth server runs
   int mCollapsePort; ///< port to which a redirect gets collapsed on
   int mLogLevel; ///< log level value 0 -7 (LOG_EMERG - LOG_DEBUG)
 
-  //--------------------------------------------------------------------------
-  //! Authentication proxy thread which forwards requests form the clients
-  //! to the proper MGM intance.
-  //--------------------------------------------------------------------------
-  void AuthProxyThread();
-
-  //--------------------------------------------------------------------------
-  //! Authentication proxy thread startup function
-  //--------------------------------------------------------------------------
-  static void* StartAuthProxyThread(void* pp);
-
   //--------------------------------------------------------------------------
   //! Send ProtocolBuffer object using ZMQ
   //!
-  //! @param socket ZMQ socket object
+  //! @param id identifier of the request, to be passed to GetResponse
   //! @param object to be sent over the wire
   //!
   //! @return true if object sent successfully, otherwise false
   //!
   //--------------------------------------------------------------------------
-  bool SendProtoBufRequest(zmq::socket_t* socket,
+  bool SendProtoBufRequest(uint64_t& id,
                            google::protobuf::Message* message);
 
   //--------------------------------------------------------------------------
   //! Get ProtocolBuffer reply object using ZMQ
   //!
-  //! @param socket ZMQ socket object
+  //! @param id identifier of the request
   //!
   //! @return pointer to received object, the user has the responsibility to
   //!         delete the obtained object
   //!
   //--------------------------------------------------------------------------
-  google::protobuf::Message* GetResponse(zmq::socket_t*& socket);
+  google::protobuf::Message* GetResponse(uint64_t id);
 
   //--------------------------------------------------------------------------
 };
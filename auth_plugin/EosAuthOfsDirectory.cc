@@ -78,13 +78,12 @@ EosAuthOfsDirectory::open(const char* name,
     return retc;
   }
   
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto))
+  if (gOFS->SendProtoBufRequest(req_id, req_proto))
   {
-    ResponseProto* resp_open = static_cast<ResponseProto*>(gOFS->GetResponse(socket));
+    ResponseProto* resp_open = static_cast<ResponseProto*>(gOFS->GetResponse(req_id));
 
     if (resp_open)
     {
@@ -94,8 +93,7 @@ EosAuthOfsDirectory::open(const char* name,
     }
   }
   
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -121,13 +119,12 @@ EosAuthOfsDirectory::nextEntry()
     return static_cast<const char*>(0) ;
   }
   
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto))
+  if (gOFS->SendProtoBufRequest(req_id, req_proto))
   {
-    ResponseProto* resp_read = static_cast<ResponseProto*>(gOFS->GetResponse(socket));
+    ResponseProto* resp_read = static_cast<ResponseProto*>(gOFS->GetResponse(req_id));
 
     if (resp_read)
     {
@@ -148,8 +145,7 @@ EosAuthOfsDirectory::nextEntry()
     }
   }
   
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return (retc ? static_cast<const char*>(0) : mNextEntry.c_str());
 }
@@ -175,13 +171,12 @@ EosAuthOfsDirectory::close()
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto))
+  if (gOFS->SendProtoBufRequest(req_id, req_proto))
   {
-    ResponseProto* resp_close = static_cast<ResponseProto*>(gOFS->GetResponse(socket));
+    ResponseProto* resp_close = static_cast<ResponseProto*>(gOFS->GetResponse(req_id));
 
     if (resp_close)
     {
@@ -191,8 +186,7 @@ EosAuthOfsDirectory::close()
     }
   }
   
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -218,13 +212,12 @@ EosAuthOfsDirectory::FName()
     return static_cast<const char*>(0) ;
   }
   
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto))
+  if (gOFS->SendProtoBufRequest(req_id, req_proto))
   {
-    ResponseProto* resp_fname = static_cast<ResponseProto*>(gOFS->GetResponse(socket));
+    ResponseProto* resp_fname = static_cast<ResponseProto*>(gOFS->GetResponse(req_id));
 
     if (resp_fname)
     {
@@ -245,8 +238,7 @@ EosAuthOfsDirectory::FName()
     }
   }
   
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return (retc ? static_cast<const char*>(0) : mName.c_str());
 }
@@ -81,13 +81,12 @@ EosAuthOfsFile::open(const char* fileName,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto)) {
+  if (gOFS->SendProtoBufRequest(req_id, req_proto)) {
     ResponseProto* resp_open = static_cast<ResponseProto*>(gOFS->GetResponse(
-                                 socket));
+                                 req_id));
 
     if (resp_open) {
       retc = resp_open->response();
@@ -102,8 +101,7 @@ EosAuthOfsFile::open(const char* fileName,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -131,13 +129,12 @@ EosAuthOfsFile::read(XrdSfsFileOffset offset,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto)) {
+  if (gOFS->SendProtoBufRequest(req_id, req_proto)) {
     ResponseProto* resp_fread = static_cast<ResponseProto*>(gOFS->GetResponse(
-                                  socket));
+                                 req_id));
 
     if (resp_fread) {
       retc = resp_fread->response();
@@ -152,8 +149,7 @@ EosAuthOfsFile::read(XrdSfsFileOffset offset,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -182,13 +178,12 @@ EosAuthOfsFile::write(XrdSfsFileOffset offset,
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto)) {
+  if (gOFS->SendProtoBufRequest(req_id, req_proto)) {
     ResponseProto* resp_fwrite = static_cast<ResponseProto*>(gOFS->GetResponse(
-                                   socket));
+                                 req_id));
 
     if (resp_fwrite) {
       retc = resp_fwrite->response();
@@ -197,8 +192,7 @@ EosAuthOfsFile::write(XrdSfsFileOffset offset,
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -224,13 +218,12 @@ EosAuthOfsFile::FName()
     return "";
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto)) {
+  if (gOFS->SendProtoBufRequest(req_id, req_proto)) {
     ResponseProto* resp_fname = static_cast<ResponseProto*>(gOFS->GetResponse(
-                                  socket));
+                                 req_id));
 
     if (resp_fname) {
       retc = resp_fname->response();
@@ -247,8 +240,7 @@ EosAuthOfsFile::FName()
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return (retc ? static_cast<const char*>(0) :
           (mName.empty() ? "" : mName.c_str()));
@@ -275,13 +267,12 @@ EosAuthOfsFile::stat(struct stat* buf)
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto)) {
+  if (gOFS->SendProtoBufRequest(req_id, req_proto)) {
     ResponseProto* resp_fstat = static_cast<ResponseProto*>(gOFS->GetResponse(
-                                  socket));
+                                 req_id));
 
     if (resp_fstat) {
       retc = resp_fstat->response();
@@ -296,8 +287,7 @@ EosAuthOfsFile::stat(struct stat* buf)
     memset(buf, 0, sizeof(struct stat));
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -323,13 +313,12 @@ EosAuthOfsFile::close()
     return retc;
   }
 
-  // Get a socket object from the pool
-  zmq::socket_t* socket;
-  gOFS->mPoolSocket.wait_pop(socket);
+  // Queue the request on the MGM channel
+  uint64_t req_id;
 
-  if (gOFS->SendProtoBufRequest(socket, req_proto)) {
+  if (gOFS->SendProtoBufRequest(req_id, req_proto)) {
     ResponseProto* resp_close = static_cast<ResponseProto*>(gOFS->GetResponse(
-                                  socket));
+                                 req_id));
 
     if (resp_close) {
       retc = resp_close->response();
@@ -338,8 +327,7 @@ EosAuthOfsFile::close()
     }
   }
 
-  // Release socket and free memory
-  gOFS->mPoolSocket.push(socket);
+  // Free memory
   delete req_proto;
   return retc;
 }
@@ -0,0 +1,288 @@
+//------------------------------------------------------------------------------
+// File: MgmChannel.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "MgmChannel.hh"
+#include "common/Logging.hh"
+#include <sys/eventfd.h>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+EOSAUTHNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+MgmChannel::MgmChannel(zmq::context_t& ctx, const std::string& endpoint):
+  mZmqContext(ctx), mEndpoint(endpoint),
+  mEventFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), mStop(false), mLastId(0)
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+MgmChannel::~MgmChannel()
+{
+  mStop = true;
+
+  if (mThread.joinable()) {
+    uint64_t one = 1;
+    (void) !::write(mEventFd, &one, sizeof(one));
+    mThread.join();
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mCalls.empty()) {
+      Complete(mCalls.begin()->first, nullptr);
+    }
+  }
+
+  if (mEventFd >= 0) {
+    close(mEventFd);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Connect to the MGM and start the I/O thread
+//------------------------------------------------------------------------------
+bool
+MgmChannel::Start()
+{
+  if (mEventFd < 0) {
+    eos_static_err("msg=\"failed to create eventfd\" errno=%i", errno);
+    return false;
+  }
+
+  zmq::socket_t* socket = nullptr;
+
+  try {
+    socket = new zmq::socket_t(mZmqContext, ZMQ_DEALER);
+    int socket_linger = 0;
+    socket->set(zmq::sockopt::linger, socket_linger);
+    socket->connect(mEndpoint.c_str());
+  } catch (zmq::error_t& err) {
+    eos_static_err("msg=\"failed to connect to MGM\" endpoint=%s err=\"%s\"",
+                   mEndpoint.c_str(), err.what());
+    delete socket;
+    return false;
+  }
+
+  mThread = std::thread(&MgmChannel::Loop, this, socket);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Queue a request to be sent to the MGM
+//------------------------------------------------------------------------------
+bool
+MgmChannel::Send(std::string request, uint64_t& id)
+{
+  if (mStop) {
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    id = ++mLastId;
+    mCalls.emplace(id, std::make_shared<Call>());
+    mQueue.emplace_back(id, std::move(request));
+
+    // The I/O thread is only woken up for the first queued request
+    if (mQueue.size() > 1) {
+      return true;
+    }
+  }
+
+  uint64_t one = 1;
+  (void) !::write(mEventFd, &one, sizeof(one));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Wait for the response of a request
+//------------------------------------------------------------------------------
+bool
+MgmChannel::GetResponse(uint64_t id, std::string& response,
+                        std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  auto it = mCalls.find(id);
+
+  if (it == mCalls.end()) {
+    return false;
+  }
+
+  std::shared_ptr<Call> call = it->second;
+
+  if (!call->mCond.wait_for(lock, timeout, [&call] { return call->mDone; })) {
+    // A late response is dropped by the I/O thread
+    eos_static_err("msg=\"timeout waiting for MGM response\" id=%lu", id);
+    mCalls.erase(id);
+    return false;
+  }
+
+  mCalls.erase(id);
+
+  if (call->mFailed) {
+    return false;
+  }
+
+  response.swap(call->mResponse);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Complete a request
+//------------------------------------------------------------------------------
+void
+MgmChannel::Complete(uint64_t id, std::string* response)
+{
+  auto it = mCalls.find(id);
+
+  if (it == mCalls.end()) {
+    eos_static_debug("msg=\"drop response of unknown request\" id=%lu", id);
+    return;
+  }
+
+  std::shared_ptr<Call> call = it->second;
+
+  if (response) {
+    call->mResponse.swap(*response);
+  } else {
+    call->mFailed = true;
+    // nobody might be waiting anymore
+    mCalls.erase(it);
+  }
+
+  call->mDone = true;
+  call->mCond.notify_one();
+}
+
+//------------------------------------------------------------------------------
+// I/O loop sending the queued requests and dispatching the responses
+//------------------------------------------------------------------------------
+void
+MgmChannel::Loop(zmq::socket_t* socket)
+{
+  std::deque<std::pair<uint64_t, std::string>> to_send;
+  zmq::pollitem_t items[2] = {
+    { (void*)* socket, 0, ZMQ_POLLIN, 0},
+    { nullptr, mEventFd, ZMQ_POLLIN, 0}
+  };
+
+  while (!mStop) {
+    int rc = -1;
+
+    try {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+      rc = zmq::poll(&items[0], 2, -1);
+#pragma GCC diagnostic pop
+    } catch (zmq::error_t& e) {
+      eos_static_err("msg=\"exception in poll\" err=\"%s\"", e.what());
+
+      if (e.num() == ETERM) {
+        break;
+      }
+
+      continue;
+    }
+
+    if (rc < 0) {
+      continue;
+    }
+
+    // Send all the queued requests
+    if (items[1].revents & ZMQ_POLLIN) {
+      uint64_t val;
+      (void) !::read(mEventFd, &val, sizeof(val));
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        to_send.swap(mQueue);
+      }
+
+      for (auto& req : to_send) {
+        zmq::message_t id_msg(&req.first, sizeof(req.first));
+        zmq::message_t delim_msg;
+        zmq::message_t data_msg(req.second.data(), req.second.size());
+        bool sent = false;
+
+        try {
+          sent = socket->send(id_msg, zmq::send_flags::sndmore |
+                              zmq::send_flags::dontwait).has_value() &&
+                 socket->send(delim_msg, zmq::send_flags::sndmore).has_value() &&
+                 socket->send(data_msg, zmq::send_flags::none).has_value();
+        } catch (zmq::error_t& e) {
+          eos_static_err("msg=\"exception in send\" err=\"%s\"", e.what());
+        }
+
+        if (!sent) {
+          eos_static_err("msg=\"unable to send request using zmq\" id=%lu",
+                         req.first);
+          std::unique_lock<std::mutex> lock(mMutex);
+          Complete(req.first, nullptr);
+        }
+      }
+
+      to_send.clear();
+    }
+
+    // Dispatch all the received responses
+    if (items[0].revents & ZMQ_POLLIN) {
+      while (true) {
+        zmq::message_t id_msg;
+        zmq::message_t msg;
+
+        try {
+          if (!socket->recv(id_msg, zmq::recv_flags::dontwait).has_value()) {
+            break;
+          }
+
+          // Read the remaining frames: delimiter then payload
+          while (socket->get(zmq::sockopt::rcvmore)) {
+            (void) socket->recv(msg, zmq::recv_flags::none);
+          }
+        } catch (zmq::error_t& e) {
+          eos_static_err("msg=\"exception in recv\" err=\"%s\"", e.what());
+          break;
+        }
+
+        if (id_msg.size() != sizeof(uint64_t)) {
+          eos_static_err("msg=\"discard response with malformed envelope\"");
+          continue;
+        }
+
+        uint64_t id;
+        memcpy(&id, id_msg.data(), sizeof(id));
+        std::string response(static_cast<char*>(msg.data()), msg.size());
+        std::unique_lock<std::mutex> lock(mMutex);
+        Complete(id, &response);
+      }
+    }
+  }
+
+  delete socket;
+}
+
+EOSAUTHNAMESPACE_END
@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// File: MgmChannel.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "Namespace.hh"
+#include <zmq.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+EOSAUTHNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class MgmChannel
+//!
+//! @description Multiplexes the requests of all the client threads over one
+//!   DEALER socket connected to the authentication ROUTER of the MGM. Every
+//!   request is sent as [request id][empty delimiter][payload], the MGM REP
+//!   workers echo the envelope back so responses are matched to their request
+//!   in any order. The socket is only used by the I/O thread of the channel,
+//!   client threads queue their requests and wake it up through an eventfd.
+//------------------------------------------------------------------------------
+class MgmChannel
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param ctx ZMQ context
+  //! @param endpoint MGM endpoint e.g. tcp://eosmgm:15555
+  //----------------------------------------------------------------------------
+  MgmChannel(zmq::context_t& ctx, const std::string& endpoint);
+
+  //----------------------------------------------------------------------------
+  //! Destructor - fails all the requests still waiting for a response
+  //----------------------------------------------------------------------------
+  ~MgmChannel();
+
+  //----------------------------------------------------------------------------
+  //! Connect to the MGM and start the I/O thread
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool Start();
+
+  //----------------------------------------------------------------------------
+  //! Queue a request to be sent to the MGM
+  //!
+  //! @param request serialized request
+  //! @param id identifier of the request to be used for GetResponse
+  //!
+  //! @return true if the request is queued, otherwise false
+  //----------------------------------------------------------------------------
+  bool Send(std::string request, uint64_t& id);
+
+  //----------------------------------------------------------------------------
+  //! Wait for the response of a request, must be called once for every
+  //! successfully queued request
+  //!
+  //! @param id identifier of the request
+  //! @param response serialized response
+  //! @param timeout max time to wait for the response
+  //!
+  //! @return true if the response is received, false on timeout or error
+  //----------------------------------------------------------------------------
+  bool GetResponse(uint64_t id, std::string& response,
+                   std::chrono::milliseconds timeout);
+
+private:
+  //! Request waiting for its response
+  struct Call {
+    std::condition_variable mCond;
+    std::string mResponse;
+    bool mDone = false;
+    bool mFailed = false;
+  };
+
+  //----------------------------------------------------------------------------
+  //! I/O loop sending the queued requests and dispatching the responses
+  //----------------------------------------------------------------------------
+  void Loop(zmq::socket_t* socket);
+
+  //----------------------------------------------------------------------------
+  //! Complete a request, mMutex must be held
+  //----------------------------------------------------------------------------
+  void Complete(uint64_t id, std::string* response);
+
+  zmq::context_t& mZmqContext; ///< ZMQ context
+  std::string mEndpoint; ///< MGM endpoint
+  int mEventFd; ///< Wakes up the I/O thread
+  std::atomic<bool> mStop; ///< Signal the I/O thread to exit
+  std::thread mThread; ///< I/O thread
+  std::mutex mMutex; ///< Protects the queue and the calls
+  std::deque<std::pair<uint64_t, std::string>> mQueue; ///< Requests to send
+  std::unordered_map<uint64_t, std::shared_ptr<Call>> mCalls; ///< In flight
+  uint64_t mLastId; ///< Last request id
+};
+
+EOSAUTHNAMESPACE_END
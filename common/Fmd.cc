@@ -20,6 +20,8 @@
 #include "common/StringConversion.hh"
 #include "common/LayoutId.hh"
 #include "common/StringTokenizer.hh"
+#include "common/StringUtils.hh"
+#include <sstream>
 
 EOSCOMMONNAMESPACE_BEGIN
 
@@ -33,6 +35,80 @@ std::set<std::string> GetKnownFsckErrs()
           FSCK_ORPHANS_N, FSCK_STRIPE_ERR};
 }
 
+//------------------------------------------------------------------------------
+// Serialize fsck delta
+//------------------------------------------------------------------------------
+std::string
+FsckDelta::Serialize() const
+{
+  std::ostringstream oss;
+  oss << mSeq << ':' << (mAppeared ? '+' : '-') << ':' << mErrType << ':'
+      << mFid << ':' << mFsid;
+  return oss.str();
+}
+
+//------------------------------------------------------------------------------
+// Deserialize fsck delta
+//------------------------------------------------------------------------------
+bool
+FsckDelta::Deserialize(const std::string& data)
+{
+  auto tokens = StringTokenizer::split<std::vector<std::string>>(data, ':');
+
+  if ((tokens.size() != 5) || tokens[2].empty() ||
+      ((tokens[1] != "+") && (tokens[1] != "-"))) {
+    return false;
+  }
+
+  if (!StringToNumeric(tokens[0], mSeq) ||
+      !StringToNumeric(tokens[3], mFid) ||
+      !StringToNumeric(tokens[4], mFsid)) {
+    return false;
+  }
+
+  mAppeared = (tokens[1] == "+");
+  mErrType = tokens[2];
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Compute the difference between two fsck error maps
+//------------------------------------------------------------------------------
+void
+ComputeFsckDeltas(const FsckErrsPerFsMap& old_map,
+                  const FsckErrsPerFsMap& new_map,
+                  FsckErrsPerFsMap& appeared,
+                  FsckErrsPerFsMap& resolved)
+{
+  // Collect entries from lhs which are not present in rhs
+  auto diff = [](const FsckErrsPerFsMap & lhs, const FsckErrsPerFsMap & rhs,
+  FsckErrsPerFsMap & out) {
+    for (const auto& err_elem : lhs) {
+      auto it_err = rhs.find(err_elem.first);
+
+      for (const auto& fs_elem : err_elem.second) {
+        const std::set<eos::common::FileId::fileid_t>* rhs_fids = nullptr;
+
+        if (it_err != rhs.end()) {
+          auto it_fs = it_err->second.find(fs_elem.first);
+
+          if (it_fs != it_err->second.end()) {
+            rhs_fids = &it_fs->second;
+          }
+        }
+
+        for (const auto& fid : fs_elem.second) {
+          if ((rhs_fids == nullptr) || (rhs_fids->count(fid) == 0)) {
+            out[err_elem.first][fs_elem.first].insert(fid);
+          }
+        }
+      }
+    }
+  };
+  diff(new_map, old_map, appeared);
+  diff(old_map, new_map, resolved);
+}
+
 //------------------------------------------------------------------------------
 // Convert string to FsckErr type
 //------------------------------------------------------------------------------
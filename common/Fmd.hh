@@ -131,6 +131,52 @@ static constexpr auto FSCK_BLOCKXS_ERR   = "blockxs_err";
 static constexpr auto FSCK_ORPHANS_N     = "orphans_n";
 static constexpr auto FSCK_STRIPE_ERR    = "stripe_err";
 
+//! QuarkDB deque holding the fsck error deltas published by the FSTs
+static constexpr auto FSCK_DELTA_KEY     = "fsck:delta";
+//! QuarkDB counter used to assign sequence numbers to the fsck deltas
+static constexpr auto FSCK_DELTA_SEQ_KEY = "fsck:delta-seq";
+//! Max number of fsck deltas kept in QuarkDB if nobody consumes them
+static constexpr uint64_t FSCK_DELTA_MAX_LEN = 10000000;
+
+//------------------------------------------------------------------------------
+//! Fsck error delta i.e. an error that appeared or was resolved for a given
+//! file and file system since the previous publication
+//------------------------------------------------------------------------------
+struct FsckDelta {
+  uint64_t mSeq {0ull}; ///< Sequence number assigned by the publisher
+  bool mAppeared {true}; ///< True if error appeared, false if resolved
+  std::string mErrType; ///< Fsck error type e.g. d_cx_diff
+  eos::common::FileId::fileid_t mFid {0ull}; ///< File identifier
+  eos::common::FileSystem::fsid_t mFsid {0ul}; ///< File system identifier
+
+  //----------------------------------------------------------------------------
+  //! Serialize delta in the form: <seq>:<+|->:<err_type>:<fid>:<fsid>
+  //----------------------------------------------------------------------------
+  std::string Serialize() const;
+
+  //----------------------------------------------------------------------------
+  //! Deserialize delta from string representation
+  //!
+  //! @param data string representation
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool Deserialize(const std::string& data);
+};
+
+//------------------------------------------------------------------------------
+//! Compute the difference between two fsck error maps
+//!
+//! @param old_map previously published errors
+//! @param new_map currently detected errors
+//! @param appeared errors present only in the new map
+//! @param resolved errors present only in the old map
+//------------------------------------------------------------------------------
+void ComputeFsckDeltas(const FsckErrsPerFsMap& old_map,
+                       const FsckErrsPerFsMap& new_map,
+                       FsckErrsPerFsMap& appeared,
+                       FsckErrsPerFsMap& resolved);
+
 //------------------------------------------------------------------------------
 //! FsckErr types
 //------------------------------------------------------------------------------
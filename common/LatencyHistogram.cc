@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+// File: LatencyHistogram.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/LatencyHistogram.hh"
+#include <algorithm>
+#include <cmath>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Add the contents of another snapshot to the current one
+//------------------------------------------------------------------------------
+void
+LatencySnapshot::Merge(const LatencySnapshot& other)
+{
+  if (mCounts.size() < other.mCounts.size()) {
+    mCounts.resize(other.mCounts.size(), 0ull);
+  }
+
+  for (size_t i = 0; i < other.mCounts.size(); ++i) {
+    mCounts[i] += other.mCounts[i];
+  }
+
+  mCount += other.mCount;
+  mSumUs += other.mSumUs;
+  mMaxUs = std::max(mMaxUs, other.mMaxUs);
+}
+
+//------------------------------------------------------------------------------
+// Get value at the given quantile
+//------------------------------------------------------------------------------
+uint64_t
+LatencySnapshot::Quantile(double q) const
+{
+  if (mCount == 0) {
+    return 0ull;
+  }
+
+  q = std::min(std::max(q, 0.0), 1.0);
+  uint64_t rank = (uint64_t)std::ceil(q * mCount);
+
+  if (rank == 0) {
+    rank = 1;
+  }
+
+  uint64_t seen = 0ull;
+
+  for (size_t i = 0; i < mCounts.size(); ++i) {
+    seen += mCounts[i];
+
+    if (seen >= rank) {
+      return std::min(LatencyHistogram::BucketUpperBound(i), mMaxUs);
+    }
+  }
+
+  return mMaxUs;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram()
+{
+  Reset();
+}
+
+//------------------------------------------------------------------------------
+// Get shard index for the current thread
+//------------------------------------------------------------------------------
+uint32_t
+LatencyHistogram::GetShardIndex()
+{
+  static std::atomic<uint32_t> sNextShard {0};
+  static thread_local uint32_t tlShard = sNextShard++ % kNumShards;
+  return tlShard;
+}
+
+//------------------------------------------------------------------------------
+// Record a new sample
+//------------------------------------------------------------------------------
+void
+LatencyHistogram::Record(uint64_t value_us)
+{
+  Shard& shard = mShards[GetShardIndex()];
+  shard.mCounts[BucketIndex(value_us)].fetch_add(1, std::memory_order_relaxed);
+  shard.mSumUs.fetch_add(value_us, std::memory_order_relaxed);
+  uint64_t old_max = shard.mMaxUs.load(std::memory_order_relaxed);
+
+  while ((value_us > old_max) &&
+         !shard.mMaxUs.compare_exchange_weak(old_max, value_us,
+             std::memory_order_relaxed)) {}
+}
+
+//------------------------------------------------------------------------------
+// Get snapshot of the histogram merging all the shards
+//------------------------------------------------------------------------------
+LatencySnapshot
+LatencyHistogram::GetSnapshot() const
+{
+  LatencySnapshot snap;
+  snap.mCounts.resize(kNumBuckets, 0ull);
+
+  for (const auto& shard : mShards) {
+    for (uint32_t i = 0; i < kNumBuckets; ++i) {
+      snap.mCounts[i] += shard.mCounts[i].load(std::memory_order_relaxed);
+    }
+
+    snap.mSumUs += shard.mSumUs.load(std::memory_order_relaxed);
+    snap.mMaxUs = std::max(snap.mMaxUs,
+                           shard.mMaxUs.load(std::memory_order_relaxed));
+  }
+
+  // Compute the count from the buckets so that it's always consistent with
+  // them even if samples are recorded concurrently
+  for (const auto& count : snap.mCounts) {
+    snap.mCount += count;
+  }
+
+  return snap;
+}
+
+//------------------------------------------------------------------------------
+// Reset all counters
+//------------------------------------------------------------------------------
+void
+LatencyHistogram::Reset()
+{
+  for (auto& shard : mShards) {
+    for (auto& count : shard.mCounts) {
+      count.store(0ull, std::memory_order_relaxed);
+    }
+
+    shard.mSumUs.store(0ull, std::memory_order_relaxed);
+    shard.mMaxUs.store(0ull, std::memory_order_relaxed);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Close the current interval and store its delta in the ring
+//------------------------------------------------------------------------------
+void
+WindowedLatencyHistogram::Rotate()
+{
+  LatencySnapshot current = mHisto.GetSnapshot();
+  std::unique_lock<std::mutex> lock(mMutex);
+  Interval interval;
+
+  if (mLastCumulative.mCounts.empty()) {
+    mLastCumulative.mCounts.resize(LatencyHistogram::kNumBuckets, 0ull);
+  }
+
+  for (uint32_t i = 0; i < LatencyHistogram::kNumBuckets; ++i) {
+    // Counters are monotonic unless a reset happened in between
+    uint64_t delta = (current.mCounts[i] >= mLastCumulative.mCounts[i]) ?
+                     current.mCounts[i] - mLastCumulative.mCounts[i] :
+                     current.mCounts[i];
+
+    if (delta) {
+      interval.mBuckets.emplace_back((uint16_t)i, delta);
+      interval.mCount += delta;
+    }
+  }
+
+  interval.mSumUs = (current.mSumUs >= mLastCumulative.mSumUs) ?
+                    current.mSumUs - mLastCumulative.mSumUs : current.mSumUs;
+  mLastCumulative = std::move(current);
+  mIntervals.push_back(std::move(interval));
+
+  while (mIntervals.size() > mMaxIntervals) {
+    mIntervals.pop_front();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get snapshot over the last completed intervals
+//------------------------------------------------------------------------------
+LatencySnapshot
+WindowedLatencyHistogram::GetWindow(size_t num_intervals) const
+{
+  LatencySnapshot snap;
+  snap.mCounts.resize(LatencyHistogram::kNumBuckets, 0ull);
+  std::unique_lock<std::mutex> lock(mMutex);
+  size_t count = 0;
+
+  for (auto it = mIntervals.rbegin();
+       (it != mIntervals.rend()) && (count < num_intervals); ++it, ++count) {
+    for (const auto& elem : it->mBuckets) {
+      snap.mCounts[elem.first] += elem.second;
+      snap.mMaxUs = std::max(snap.mMaxUs,
+                             LatencyHistogram::BucketUpperBound(elem.first));
+    }
+
+    snap.mCount += it->mCount;
+    snap.mSumUs += it->mSumUs;
+  }
+
+  return snap;
+}
+
+//------------------------------------------------------------------------------
+// Reset all counters and intervals
+//------------------------------------------------------------------------------
+void
+WindowedLatencyHistogram::Reset()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mHisto.Reset();
+  mLastCumulative = LatencySnapshot();
+  mIntervals.clear();
+}
+
+EOSCOMMONNAMESPACE_END
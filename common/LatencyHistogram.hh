@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+// File: LatencyHistogram.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "common/Namespace.hh"
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Snapshot of a latency histogram i.e. plain (non-atomic) bucket counters
+//! that can be merged and queried for quantiles.
+//------------------------------------------------------------------------------
+struct LatencySnapshot {
+  std::vector<uint64_t> mCounts; ///< Per bucket counters
+  uint64_t mCount {0ull}; ///< Total number of samples
+  uint64_t mSumUs {0ull}; ///< Sum of all samples in microseconds
+  uint64_t mMaxUs {0ull}; ///< Max sample value in microseconds
+
+  //----------------------------------------------------------------------------
+  //! Add the contents of another snapshot to the current one
+  //----------------------------------------------------------------------------
+  void Merge(const LatencySnapshot& other);
+
+  //----------------------------------------------------------------------------
+  //! Get value in microseconds at the given quantile
+  //!
+  //! @param q quantile in the range [0, 1]
+  //!
+  //! @return upper bound of the bucket holding the given quantile, capped
+  //!         at the max recorded value
+  //----------------------------------------------------------------------------
+  uint64_t Quantile(double q) const;
+
+  //----------------------------------------------------------------------------
+  //! Get mean value in microseconds
+  //----------------------------------------------------------------------------
+  double Mean() const
+  {
+    return (mCount ? (double)mSumUs / mCount : 0.0);
+  }
+};
+
+//------------------------------------------------------------------------------
+//! Log-linear (HDR-style) latency histogram with microsecond resolution.
+//! Each power of two interval is split into kSubBuckets linear buckets which
+//! bounds the relative error of any reported quantile to 1/kSubBuckets.
+//! Recording is lock-free and spread over a few cache-line aligned shards
+//! selected per thread, the shards are merged when taking a snapshot.
+//------------------------------------------------------------------------------
+class LatencyHistogram
+{
+public:
+  static constexpr uint32_t kSubBucketBits = 4;
+  static constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;
+  //! Values above 2^kMaxExponent us (~12 days) end up in the last bucket
+  static constexpr uint32_t kMaxExponent = 40;
+  static constexpr uint32_t kNumBuckets =
+    (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+  static constexpr uint32_t kNumShards = 4;
+
+  //----------------------------------------------------------------------------
+  //! Get bucket index for the given value
+  //----------------------------------------------------------------------------
+  static inline uint32_t BucketIndex(uint64_t value)
+  {
+    if (value < kSubBuckets) {
+      return (uint32_t)value;
+    }
+
+    uint32_t exp = 63 - __builtin_clzll(value);
+
+    if (exp >= kMaxExponent) {
+      return kNumBuckets - 1;
+    }
+
+    return (exp - kSubBucketBits + 1) * kSubBuckets +
+           (uint32_t)((value >> (exp - kSubBucketBits)) & (kSubBuckets - 1));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the lowest value mapped to the given bucket
+  //----------------------------------------------------------------------------
+  static inline uint64_t BucketLowerBound(uint32_t index)
+  {
+    if (index < kSubBuckets) {
+      return index;
+    }
+
+    uint32_t group = index / kSubBuckets;
+    uint64_t sub = index % kSubBuckets;
+    return (kSubBuckets + sub) << (group - 1);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the highest value mapped to the given bucket
+  //----------------------------------------------------------------------------
+  static inline uint64_t BucketUpperBound(uint32_t index)
+  {
+    if (index < kSubBuckets) {
+      return index;
+    }
+
+    return BucketLowerBound(index) + (1ull << (index / kSubBuckets - 1)) - 1;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  LatencyHistogram();
+
+  //----------------------------------------------------------------------------
+  //! Record a new sample
+  //!
+  //! @param value_us sample value in microseconds
+  //----------------------------------------------------------------------------
+  void Record(uint64_t value_us);
+
+  //----------------------------------------------------------------------------
+  //! Get snapshot of the histogram merging all the shards
+  //----------------------------------------------------------------------------
+  LatencySnapshot GetSnapshot() const;
+
+  //----------------------------------------------------------------------------
+  //! Reset all counters
+  //----------------------------------------------------------------------------
+  void Reset();
+
+private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kNumBuckets> mCounts;
+    std::atomic<uint64_t> mSumUs;
+    std::atomic<uint64_t> mMaxUs;
+  };
+
+  std::array<Shard, kNumShards> mShards;
+
+  //----------------------------------------------------------------------------
+  //! Get shard index for the current thread
+  //----------------------------------------------------------------------------
+  static uint32_t GetShardIndex();
+};
+
+//------------------------------------------------------------------------------
+//! Latency histogram keeping the cumulative distribution since start and a
+//! ring of per-interval deltas used to answer queries over sliding windows.
+//! The deltas are stored in a sparse form since typically only a small
+//! number of buckets are populated.
+//------------------------------------------------------------------------------
+class WindowedLatencyHistogram
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param max_intervals maximum number of intervals kept in memory
+  //----------------------------------------------------------------------------
+  explicit WindowedLatencyHistogram(size_t max_intervals = 60):
+    mMaxIntervals(max_intervals)
+  {}
+
+  //----------------------------------------------------------------------------
+  //! Record a new sample
+  //!
+  //! @param value_us sample value in microseconds
+  //----------------------------------------------------------------------------
+  inline void Record(uint64_t value_us)
+  {
+    mHisto.Record(value_us);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Close the current interval and store its delta in the ring. Should be
+  //! called periodically at a fixed rate by a single thread.
+  //----------------------------------------------------------------------------
+  void Rotate();
+
+  //----------------------------------------------------------------------------
+  //! Get snapshot of the cumulative distribution
+  //----------------------------------------------------------------------------
+  LatencySnapshot GetCumulative() const
+  {
+    return mHisto.GetSnapshot();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get snapshot over the last completed intervals
+  //!
+  //! @param num_intervals number of intervals to merge, if there are fewer
+  //!        completed intervals then all of them are used
+  //----------------------------------------------------------------------------
+  LatencySnapshot GetWindow(size_t num_intervals) const;
+
+  //----------------------------------------------------------------------------
+  //! Reset all counters and intervals
+  //----------------------------------------------------------------------------
+  void Reset();
+
+private:
+  //! Sparse representation of the delta for one interval
+  struct Interval {
+    std::vector<std::pair<uint16_t, uint64_t>> mBuckets;
+    uint64_t mCount {0ull};
+    uint64_t mSumUs {0ull};
+  };
+
+  LatencyHistogram mHisto; ///< Cumulative histogram
+  const size_t mMaxIntervals; ///< Max number of intervals in the ring
+  mutable std::mutex mMutex; ///< Mutex protecting the members below
+  LatencySnapshot mLastCumulative; ///< Cumulative state at last rotation
+  std::deque<Interval> mIntervals; ///< Ring of interval deltas, newest last
+};
+
+EOSCOMMONNAMESPACE_END
@@ -38,6 +38,7 @@
 #include <grp.h>
 #include <sys/stat.h>
 #include <jwt-cpp/jwt.h>
+#include <openssl/evp.h>
 
 EOSCOMMONNAMESPACE_BEGIN
 
@@ -67,6 +68,11 @@ ShardedCache<std::string, Mapping::gid_set> Mapping::gShardedPhysicalGidCache(
 ShardedCache<uid_t, std::string> Mapping::gShardedNegativeUserNameCache(8);
 ShardedCache<gid_t, std::string> Mapping::gShardedNegativeGroupNameCache(8);
 ShardedCache<std::string, bool> Mapping::gShardedNegativePhysicalUidCache(8);
+ShardedCache<std::string, Mapping::token_entry> Mapping::gShardedTokenCache(8);
+std::atomic<uint64_t> Mapping::gMapGeneration {0};
+ShardedCache<std::string, Mapping::identity_entry>
+Mapping::gShardedIdentityCache(8);
+std::atomic<bool> Mapping::gIdentityCache = true;
 ShardedCache<std::string, time_t> Mapping::ActiveTidentsSharded(16);
 ShardedCache<uid_t, size_t> Mapping::ActiveUidsSharded(16);
 
@@ -105,6 +111,34 @@ static std::string g_ztn_gid_key = "ztn:" + g_pwd_gid_key;
 // flag to indicate whether the mapping is initialized
 std::once_flag g_cache_map_init;
 
+// lifetime in seconds of the entries of the identity cache, bounding the time
+// changes of the physical ids or of the DNS take to be visible
+static constexpr time_t kIdentityCacheLifetime = 60;
+
+//------------------------------------------------------------------------------
+// SHA-256 digest of a list of fields, e.g. of a token and of the key used to
+// verify it, identifying entries of the token and identity caches
+//------------------------------------------------------------------------------
+static std::string
+Sha256Digest(std::initializer_list<std::string_view> fields)
+{
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int md_len = 0;
+  EVP_MD_CTX* md_ctx = EVP_MD_CTX_new();
+  EVP_DigestInit_ex(md_ctx, EVP_sha256(), NULL);
+
+  for (const auto& field : fields) {
+    // prefix each field with its length to keep the fields apart
+    uint64_t len = field.size();
+    EVP_DigestUpdate(md_ctx, &len, sizeof(len));
+    EVP_DigestUpdate(md_ctx, field.data(), field.size());
+  }
+
+  EVP_DigestFinal_ex(md_ctx, md, &md_len);
+  EVP_MD_CTX_free(md_ctx);
+  return std::string((const char*) md, md_len);
+}
+
 //------------------------------------------------------------------------------
 // Initialize static maps
 //------------------------------------------------------------------------------
@@ -117,6 +151,12 @@ Mapping::Init()
     gRootSquash = false;
   }
 
+  // disable caching of the computed identities via env variable
+  if (getenv("EOS_IDMAP_NO_CACHE") &&
+      !strcmp("1", getenv("EOS_IDMAP_NO_CACHE"))) {
+    gIdentityCache = false;
+  }
+
   if (getenv("EOS_SECONDARY_GROUPS") &&
       !strcmp("1", getenv("EOS_SECONDARY_GROUPS"))) {
     gSecondaryGroups = true;
@@ -146,6 +186,8 @@ Mapping::Init()
           "NegGroupNameGC");
       gShardedNegativePhysicalUidCache.reset_cleanup_thread(3600 * 1000,
           "NegUidGC");
+      gShardedTokenCache.reset_cleanup_thread(300 * 1000, "TokenCacheGC");
+      gShardedIdentityCache.reset_cleanup_thread(60 * 1000, "IdentityCacheGC");
       ActiveUidsSharded.reset_cleanup_thread(300 * 1000,
                                              "ActiveUidsSharded");
       ActiveTidentsSharded.reset_cleanup_thread(300 * 1000,
@@ -176,6 +218,8 @@ Mapping::Reset()
   }
   ActiveTidentsSharded.clear();
   ActiveUidsSharded.clear();
+  gShardedTokenCache.clear();
+  gShardedIdentityCache.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -198,6 +242,63 @@ Mapping::IdMap(const XrdSecEntity* client, const char* env, const char* tident,
   vid = VirtualIdentity::Nobody();
   XrdOucEnv Env(env);
   std::string authz = (Env.Get("authz") ? Env.Get("authz") : "");
+
+  // Bookkeeping of the active clients, done for every request
+  auto track_client = [&](const std::string & active_tident) {
+    if (!ActiveTidentsSharded.contains(active_tident)) {
+      ActiveUidsSharded.fetch_add(vid.uid, 1);
+    }
+
+    ActiveTidentsSharded.store(active_tident,
+                               std::make_unique<time_t>(time(NULL)));
+
+    if (log) {
+      eos_static_info("%s sec.tident=\"%s\" vid.uid=%d vid.gid=%d sudo=%d gateway=%d",
+                      eos::common::SecEntity::ToString(client, Env.Get("eos.app")).c_str(),
+                      tident, vid.uid, vid.gid, vid.sudoer, vid.gateway);
+    }
+  };
+  // Identities not depending on a token or on the authz plugin are taken
+  // from the identity cache while the mapping rules stay the same
+  const bool cacheable = gIdentityCache && authz.empty() &&
+                         !(authz_obj && client->creds &&
+                           (strcmp(client->prot, "ztn") == 0));
+  std::string cache_key;
+
+  if (cacheable) {
+    std::string user_value;
+    static const std::string user_key = "request.name";
+
+    if (client->eaAPI) {
+      client->eaAPI->Get(user_key, user_value);
+    }
+
+    // the key starts with the null-ness of the fields, as the mapping treats
+    // missing and empty fields differently
+    auto field = [&cache_key](const char* value) {
+      cache_key += (value ? '1' : '0');
+      return std::string_view(value ? value : "");
+    };
+    const std::string digest = Sha256Digest({
+      field(client->prot), field(client->name), field(client->host),
+      field(client->tident), field(client->role), field(client->grps),
+      field(client->vorg), field(client->endorsements), field(client->creds),
+      field(tident), field(Env.Get("eos.ruid")), field(Env.Get("eos.rgid")),
+      field(Env.Get("eos.app")), user_value});
+    cache_key += digest;
+
+    if (auto entry = gShardedIdentityCache.retrieve(cache_key)) {
+      if ((entry->generation == gMapGeneration) &&
+          (entry->expires >= time(NULL))) {
+        vid = entry->vid;
+        track_client(entry->active_tident);
+        return;
+      }
+
+      gShardedIdentityCache.invalidate(cache_key);
+    }
+  }
+
   vid.name = (client->name ? client->name : "");
   vid.tident = tident;
   vid.sudoer = false;
@@ -213,6 +314,8 @@ Mapping::IdMap(const XrdSecEntity* client, const char* env, const char* tident,
   useralias += "uid";
   groupalias += "gid";
   RWMutexReadLock lock(gMapMutex);
+  // generation of the rules used for this mapping
+  const uint64_t generation = gMapGeneration;
   vid.prot = client->prot;
 
   // @todo (esindril) this is just a workaround for the fact that XrdHttp
@@ -834,11 +937,9 @@ Mapping::IdMap(const XrdSecEntity* client, const char* env, const char* tident,
       }
 
       int rc = 0;
-      vid.token = std::make_shared<EosTok>();
+      vid.token = ReadEosToken(authz, key, rc);
 
-      if ((rc = vid.token->Read(authz, key, eos::common::EosTok::sTokenGeneration,
-                                false))) {
-        vid.token->Reset();
+      if (rc) {
         eos_static_err("failed to decode token tident='%s' token='%s' errno=%d", tident,
                        authz.c_str(), -rc);
       } else {
@@ -993,7 +1094,8 @@ Mapping::IdMap(const XrdSecEntity* client, const char* env, const char* tident,
         eos_static_debug("invalidating token - origin mismatch %s:%s:%s",
                          vid.host.c_str(), vid.uid_string.c_str(),
                          vid.prot.c_str());
-        vid.token->Reset();
+        // the token may be shared through the token cache, replace it
+        vid.token = std::make_shared<EosTok>();
         // reset the vid to nobody if the origin does not match
         vid.toNobody();
       }
@@ -1043,20 +1145,17 @@ Mapping::IdMap(const XrdSecEntity* client, const char* env, const char* tident,
   snprintf(actident, sizeof(actident) - 1, "%d^%s^%s^%s^%s", vid.uid,
            mytident.c_str(), vid.prot.c_str(), vid.host.c_str(), vid.app.c_str());
   std::string intident = actident;
-
-  if (!ActiveTidentsSharded.contains(intident)) {
-    ActiveUidsSharded.fetch_add(vid.uid, 1);
-  }
-
-  ActiveTidentsSharded.store(intident, std::make_unique<time_t>(time(NULL)));
   eos_static_debug("selected %d %d [%s %s]", vid.uid, vid.gid, ruid.c_str(),
                    rgid.c_str());
 
-  if (log) {
-    eos_static_info("%s sec.tident=\"%s\" vid.uid=%d vid.gid=%d sudo=%d gateway=%d",
-                    eos::common::SecEntity::ToString(client, Env.Get("eos.app")).c_str(),
-                    tident, vid.uid, vid.gid, vid.sudoer, vid.gateway);
+  // Tokens and OAuth2 identities have their own lifetime, don't cache them
+  if (cacheable && !vid.token && (vid.prot != "oauth2")) {
+    gShardedIdentityCache.store(cache_key, std::make_unique<identity_entry>
+                                (identity_entry{vid, intident, generation,
+                                                time(NULL) + kIdentityCacheLifetime}));
   }
+
+  track_client(intident);
 }
 
 //------------------------------------------------------------------------------
@@ -1170,6 +1269,37 @@ Mapping::HandleKEYS(const XrdSecEntity* client, VirtualIdentity& vid)
   }
 }
 
+//------------------------------------------------------------------------------
+// Decode and verify an EOS token, using the cache of verified tokens
+//------------------------------------------------------------------------------
+std::shared_ptr<Token>
+Mapping::ReadEosToken(const std::string& authz, const std::string& key,
+                      int& rc)
+{
+  rc = 0;
+  const uint64_t generation = EosTok::sTokenGeneration;
+  const std::string digest = Sha256Digest({key, authz});
+
+  if (auto entry = gShardedTokenCache.retrieve(digest)) {
+    if ((entry->generation == generation) && (entry->expires >= time(NULL))) {
+      return entry->token;
+    }
+
+    gShardedTokenCache.invalidate(digest);
+  }
+
+  std::shared_ptr<EosTok> token = std::make_shared<EosTok>();
+
+  if ((rc = token->Read(authz, key, generation, false))) {
+    token->Reset();
+    return token;
+  }
+
+  gShardedTokenCache.store(digest, std::make_unique<token_entry>
+                           (token_entry{token, generation, token->Expires()}));
+  return token;
+}
+
 //------------------------------------------------------------------------------
 // Print the current mappings
 //------------------------------------------------------------------------------
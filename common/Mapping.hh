@@ -214,6 +214,40 @@ public:
   static std::map<std::string, gid_t> gPhysicalGroupIdCache;
   static ShardedCache<gid_t, std::string> gShardedNegativeGroupNameCache;
 
+  // ---------------------------------------------------------------------------
+  //! A cache of verified EOS tokens, keyed by the HMAC of the token computed
+  //! with the verification key. Entries are only used while the token has not
+  //! expired and its generation is still the current one.
+  // ---------------------------------------------------------------------------
+  struct token_entry {
+    std::shared_ptr<Token> token;
+    uint64_t generation;
+    time_t expires;
+  };
+  static ShardedCache<std::string, token_entry> gShardedTokenCache;
+
+  // ---------------------------------------------------------------------------
+  //! Generation of the mapping rules, to be incremented with the gMapMutex
+  //! write-locked by anyone modifying the global maps
+  // ---------------------------------------------------------------------------
+  static std::atomic<uint64_t> gMapGeneration;
+
+  // ---------------------------------------------------------------------------
+  //! A cache of the identities computed by IdMap, keyed by the digest of the
+  //! client credentials, tident and identity related opaque keys. Entries are
+  //! only used while the mapping rules are still of the same generation.
+  //! Requests carrying a token or authorized through an authz plugin are
+  //! never cached. Can be disabled with EOS_IDMAP_NO_CACHE=1.
+  // ---------------------------------------------------------------------------
+  struct identity_entry {
+    VirtualIdentity vid;
+    std::string active_tident;
+    uint64_t generation;
+    time_t expires;
+  };
+  static ShardedCache<std::string, identity_entry> gShardedIdentityCache;
+  static std::atomic<bool> gIdentityCache;
+
   // ---------------------------------------------------------------------------
   //! RWMutex protecting all global hash maps
   // ---------------------------------------------------------------------------
@@ -424,6 +458,20 @@ public:
   //! @note needs to be called with the gMapMutex locked
   //----------------------------------------------------------------------------
   static void HandleKEYS(const XrdSecEntity* client, VirtualIdentity& vid);
+
+  //----------------------------------------------------------------------------
+  //! Decode and verify an EOS token, tokens already verified are taken from
+  //! gShardedTokenCache
+  //!
+  //! @param authz token
+  //! @param key verification key
+  //! @param rc 0 if the token is valid, otherwise the error of EosTok::Read
+  //!
+  //! @return token, shared with other requests when coming from the cache so
+  //!         it must not be modified
+  //----------------------------------------------------------------------------
+  static std::shared_ptr<Token> ReadEosToken(const std::string& authz,
+      const std::string& key, int& rc);
 };
 
 EOSCOMMONNAMESPACE_END
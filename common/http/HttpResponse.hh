@@ -32,6 +32,7 @@
 #define __EOSCOMMON_HTTP_RESPONSE__HH__
 
 #include "common/Namespace.hh"
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
@@ -90,9 +91,16 @@ public:
 public:
   typedef std::map<std::string, std::string> HeaderMap;
 
+  /**
+   * Producer of a streamed body, appends the next part of the body to the
+   * given buffer and returns false once the body is complete
+   */
+  typedef std::function<bool(std::string&)> BodyProducer;
+
 protected:
   HeaderMap    mResponseHeaders;       //!< the response headers to be filled
   std::string  mResponseBody;          //!< the response body to be created
+  BodyProducer mBodyProducer;          //!< producer of a streamed body
   int          mResponseCode;          //!< the response code to be determined
 
 public:
@@ -187,6 +195,42 @@ public:
     return mResponseBody.length();
   }
 
+  /**
+   * Stream the body instead of holding it in memory. The body is produced
+   * part by part while being sent, using chunked transfer encoding, so the
+   * response must not set a Content-Length.
+   *
+   * @param producer  the producer of the body parts
+   */
+  inline void
+  SetBodyProducer(BodyProducer producer)
+  {
+    mBodyProducer = std::move(producer);
+  }
+
+  /**
+   * @return true if the body is streamed by a producer
+   */
+  inline bool
+  IsStreamed() const
+  {
+    return (bool) mBodyProducer;
+  }
+
+  /**
+   * Produce the next part of a streamed body
+   *
+   * @param chunk  buffer receiving the next part, it may be empty
+   *
+   * @return false once the body is complete, chunk holds then its last part
+   */
+  inline bool
+  NextBodyChunk(std::string& chunk)
+  {
+    chunk.clear();
+    return mBodyProducer && mBodyProducer(chunk);
+  }
+
   /**
    * @return the server response code
    */
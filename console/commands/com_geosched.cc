@@ -42,7 +42,8 @@ com_geosched(char* arg1)
                                           "plctDlScorePenalty", "plctUlScorePenalty",
                                           "accessDlScorePenalty", "accessUlScorePenalty",
                                           "fillRatioLimit", "fillRatioCompTol", "saturationThres",
-                                          "timeFrameDurationMs", "penaltyUpdateRate", "proxyCloseToFs"
+                                          "timeFrameDurationMs", "penaltyUpdateRate", "proxyCloseToFs",
+                                          "fixedPlacementKernels"
                                          };
   XrdOucString in = "";
 
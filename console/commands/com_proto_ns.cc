@@ -655,8 +655,10 @@ void com_ns_help()
       << "    print or configure basic namespace parameters" << std::endl
       << "  ns stat [-a] [-m] [-n] [--reset]" << std::endl
       << "    print namespace statistics" << std::endl
-      << "    -a      : break down by uid/gid" << std::endl
-      << "    -m      : display in monitoring format <key>=<value>" << std::endl
+      << "    -a      : break down by uid/gid and show latency percentiles"
+      << std::endl
+      << "    -m      : display in monitoring format <key>=<value> including"
+      << " latency percentiles per client type over 1m/5m/1h" << std::endl
       << "    -n      : display numerical uid/gid(s)" << std::endl
       << "    --reset : reset namespace counters" << std::endl
       << std::endl
@@ -547,6 +547,10 @@ void com_space_help()
       << "space config <space-name> space.fsck_refresh_interval=<sec>           : time interval after which fsck inconsistencies are refreshed\n"
       << "space config <space-name> space.drainperiod=<sec>                     : configure the default drain  period if not defined on a filesystem (see fs for details)\n"
       << "space config <space-name> space.graceperiod=<sec>                     : configure the default grace  period if not defined on a filesystem (see fs for details)\n"
+      << "space config <space-name> space.transfer.fs.ntx=<#>                   : configure the max number of background transfers per fs scheduled by the transfer scheduler, 0 means no limit [ default=0 ]\n"
+      << "space config <space-name> space.transfer.node.ntx=<#>                 : configure the max number of background transfers per node, 0 means no limit [ default=0 ]\n"
+      << "space config <space-name> space.transfer.fs.rate=<MB/s>               : configure the background transfer bandwidth per fs, 0 means no limit [ default=0 ]\n"
+      << "space config <space-name> space.transfer.fs.maxload=<0-1>             : configure the disk load above which only one background transfer per fs is allowed [ default=0.9 ]\n"
       << "space config <space-name> space.filearchivedgc=on|off                 : enable/disable the 'file archived' garbage collector [ default=off ]\n"
       << "space config <space-name> space.tracker=on|off                        : enable/disable the space layout creation tracker [ default=off ]\n"
       << "space config <space-name> space.inspector=on|off                      : enable/disable the file inspector [ default=off ]\n"
@@ -288,7 +288,7 @@ ScanDir::AccountMissing()
   }
 
   // Push collected errors to QDB
-  if (!gOFS.Storage->PushToQdb(mFsId, errs_map)) {
+  if (!gOFS.Storage->PushToQdb(mFsId, errs_map, "ns")) {
     eos_err("msg=\"failed to push fsck errors to QDB\" fsid=%lu", mFsId);
   }
 }
@@ -538,6 +538,7 @@ ScanDir::ScanSubtree(ThreadAssistant& assistant) noexcept
 
   std::string fpath;
   eos::common::FsckErrsPerFsMap errs_map;
+  std::set<eos::common::FileId::fileid_t> checked_fids;
 
   while ((fpath = io->ftsRead(handle.get())) != "") {
     if (!mBgThread) {
@@ -556,6 +557,7 @@ ScanDir::ScanSubtree(ThreadAssistant& assistant) noexcept
       }
 
       auto fmd = gOFS.mFmdHandler->LocalGetFmd(fid, mFsId, true, false);
+      checked_fids.insert(fid);
 
       if (fmd) {
         CollectInconsistencies(*fmd.get(), mFsId, errs_map);
@@ -576,7 +578,7 @@ ScanDir::ScanSubtree(ThreadAssistant& assistant) noexcept
 #ifndef _NOOFS
 
   // Push collected errors to QDB
-  if (!gOFS.Storage->PushToQdb(mFsId, errs_map)) {
+  if (!gOFS.Storage->PushToQdb(mFsId, errs_map, "disk", &checked_fids)) {
     eos_err("msg=\"failed to push fsck errors to QDB\" fsid=%lu", mFsId);
   }
 
@@ -110,6 +110,7 @@ Storage::UnregisterFileSystem(const std::string& queuepath)
   }
 
   mFsMutex.UnLockWrite();
+  ClearFsckPublished(fs->GetLocalId());
   eos_static_info("msg=\"deleting file system\" qpath=%s",
                   fs->GetQueuePath().c_str());
   delete fs;
@@ -196,6 +197,8 @@ Storage::ProcessFstConfigChange(const std::string& key,
   if (key == "stat.refresh_fs") {
     if (last_refresh_ts != value) {
       last_refresh_ts = value;
+      // Make sure the MGM gets all the values of the new file systems
+      mPublishFilter.Reset();
       SignalRegisterThread();
     }
 
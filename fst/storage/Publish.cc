@@ -700,6 +700,11 @@ bool Storage::PublishFsStatistics(eos::common::FileSystem::fsid_t fsid)
   common::FileSystemUpdateBatch batch;
   FileSystem* fs = it->second;
   std::map<std::string, std::string> fsStats = GetFsStatistics(fs);
+  mPublishFilter.Filter(fs->GetQueuePath(), fsStats);
+
+  if (fsStats.empty()) {
+    return true;
+  }
 
   for (auto it = fsStats.begin(); it != fsStats.end(); it++) {
     batch.setStringTransient(it->first, it->second);
@@ -725,6 +730,16 @@ Storage::Publish(ThreadAssistant& assistant) noexcept
   // The following line acts as a barrier that prevents progress
   // until the config queue becomes known
   gConfig.getFstNodeConfigQueue("Publish");
+  // Don't publish noisy metrics unless they changed noticeably
+  mPublishFilter.SetThreshold("stat.disk.readratemb", 1.0, 0.05);
+  mPublishFilter.SetThreshold("stat.disk.writeratemb", 1.0, 0.05);
+  mPublishFilter.SetThreshold("stat.disk.load", 0.01, 0.05);
+  mPublishFilter.SetThreshold("stat.net.inratemib", 1.0, 0.05);
+  mPublishFilter.SetThreshold("stat.net.outratemib", 1.0, 0.05);
+  mPublishFilter.SetThreshold("stat.sys.vsize", 0.0, 0.01);
+  mPublishFilter.SetThreshold("stat.sys.rss", 0.0, 0.01);
+  mPublishFilter.SetThreshold("stat.sys.threads", 0.0, 0.05);
+  mPublishFilter.SetThreshold("stat.sys.sockets", 0.0, 0.05);
 
   while (!assistant.terminationRequested()) {
     std::chrono::milliseconds randomizedReportInterval =
@@ -773,6 +788,7 @@ Storage::Publish(ThreadAssistant& assistant) noexcept
         common::SharedHashLocator locator = gConfig.getNodeHashLocator("Publish");
 
         if (!locator.empty()) {
+          mPublishFilter.Filter(locator.getConfigQueue(), fst_stats);
           mq::SharedHashWrapper::Batch batch;
 
           for (auto it = fst_stats.begin(); it != fst_stats.end(); ++it) {
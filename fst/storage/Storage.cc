@@ -42,6 +42,7 @@
 #include "qclient/structures/QSet.hh"
 #include <google/dense_hash_map>
 #include <math.h>
+#include <array>
 // @note (esindril)use this when Clang (>= 6.0.0) supports it
 //#include <filesystem>
 
@@ -1398,7 +1399,9 @@ Storage::GetFSCount() const
 //------------------------------------------------------------------------------
 bool
 Storage::PushToQdb(eos::common::FileSystem::fsid_t fsid,
-                   const eos::common::FsckErrsPerFsMap& errs_map)
+                   const eos::common::FsckErrsPerFsMap& errs_map,
+                   const std::string& source,
+                   const std::set<eos::common::FileId::fileid_t>* checked_fids)
 {
 #ifndef _NOOFS
   static const uint32_t s_max_batch_size = 10000;
@@ -1408,32 +1411,203 @@ Storage::PushToQdb(eos::common::FileSystem::fsid_t fsid,
     return false;
   }
 
+  // By default everything is pushed and all the entries are new
+  eos::common::FsckErrsPerFsMap to_add;
+  eos::common::FsckErrsPerFsMap appeared;
+  eos::common::FsckErrsPerFsMap resolved;
+  // New state of the source, recorded only once the sets are updated in QDB
+  eos::common::FsckErrsPerFsMap current = errs_map;
+  const auto now = std::chrono::steady_clock::now();
+  const auto key = std::make_pair(fsid, source);
+  bool full_push = true;
+
+  if (!source.empty()) {
+    eos::common::FsckErrsPerFsMap previous;
+    std::list<eos::common::FsckErrsPerFsMap> others;
+    bool first_push = true;
+    {
+      std::unique_lock<std::mutex> lock(mFsckPublishedMutex);
+      auto it = mFsckPublished.find(key);
+
+      if (it != mFsckPublished.end()) {
+        first_push = false;
+        previous = it->second.first;
+        full_push = (now - it->second.second >= sFsckFullPushInterval);
+      }
+
+      for (const auto& other : mFsckPublished) {
+        if ((other.first.first == fsid) && (other.first.second != source)) {
+          others.push_back(other.second.first);
+        }
+      }
+    }
+
+    if (first_push) {
+      // First push from this source - QDB might contain stale info from a
+      // previous run so push everything
+      appeared = errs_map;
+    } else {
+      // Errors of files not checked in this round are still valid as long as
+      // the files are still on disk and tracked locally
+      if (checked_fids) {
+        for (const auto& elem : previous) {
+          for (const auto& errfsid : elem.second) {
+            for (const auto& fid : errfsid.second) {
+              if ((checked_fids->count(fid) == 0) &&
+                  IsFsckEntryValid(errfsid.first, fid)) {
+                current[elem.first][errfsid.first].insert(fid);
+              }
+            }
+          }
+        }
+      }
+
+      eos::common::ComputeFsckDeltas(previous, current, appeared, resolved);
+
+      // Entries still reported by a different source for the same file
+      // system are not resolved
+      for (const auto& other : others) {
+        eos::common::FsckErrsPerFsMap not_reported, ignored;
+        eos::common::ComputeFsckDeltas(other, resolved, not_reported, ignored);
+        resolved.swap(not_reported);
+      }
+    }
+
+    // Periodically push everything to recover from any lost updates or
+    // entries dropped in the meantime by the MGM
+    to_add = (full_push ? current : appeared);
+  } else {
+    appeared = errs_map;
+    to_add = errs_map;
+  }
+
   qclient::AsyncHandler ah;
   qclient::QSet fsck_set(*gOFS.mFsckQcl, "");
+  // Helper function to apply the updates to the fsck sets in batches
+  auto update_sets = [&](const eos::common::FsckErrsPerFsMap & emap,
+  bool add) {
+    for (const auto& elem : emap) {
+      std::list<std::string> values; // contains fid:fsid entries
+      fsck_set.setKey(SSTR("fsck:" << elem.first).c_str());
 
-  for (const auto& elem : errs_map) {
-    std::list<std::string> values; // contains fid:fsid entries
-
-    for (auto& errfsid : elem.second) {
-      for (auto& fid : errfsid.second) {
-        if (values.size() <= s_max_batch_size) {
+      for (auto& errfsid : elem.second) {
+        for (auto& fid : errfsid.second) {
           values.push_back(SSTR(fid << ":" << errfsid.first));
-        } else {
-          fsck_set.setKey(SSTR("fsck:" << elem.first).c_str());
+
+          if (values.size() >= s_max_batch_size) {
+            if (add) {
+              fsck_set.sadd_async(values, &ah);
+            } else {
+              fsck_set.srem_async(values, &ah);
+            }
+
+            values.clear();
+          }
+        }
+      }
+
+      if (!values.empty()) {
+        if (add) {
           fsck_set.sadd_async(values, &ah);
-          values.clear();
+        } else {
+          fsck_set.srem_async(values, &ah);
         }
       }
     }
+  };
+  update_sets(to_add, true);
+  update_sets(resolved, false);
 
-    if (!values.empty()) {
-      fsck_set.setKey(SSTR("fsck:" << elem.first).c_str());
-      fsck_set.sadd_async(values, &ah);
+  if (!ah.Wait()) {
+    eos_err("msg=\"some qset async requests failed\" fsid=%lu", fsid);
+    return false;
+  }
+
+  if (!source.empty()) {
+    std::unique_lock<std::mutex> lock(mFsckPublishedMutex);
+    auto& published = mFsckPublished[key];
+    published.first = std::move(current);
+
+    if (full_push) {
+      published.second = now;
     }
   }
 
-  if (!ah.Wait()) {
-    eos_err("msg=\"some qset async requests failed\" fsid=%lu", fsid);
+  // Record the deltas so that the MGM can update its view incrementally
+  const std::array<const eos::common::FsckErrsPerFsMap*, 2> deltas {
+    &appeared, &resolved};
+  uint64_t num_deltas = 0ull;
+
+  for (const auto* emap : deltas) {
+    for (const auto& elem : *emap) {
+      for (const auto& errfsid : elem.second) {
+        num_deltas += errfsid.second.size();
+      }
+    }
+  }
+
+  if (num_deltas == 0ull) {
+    return true;
+  }
+
+  // Reserve a range of sequence numbers for the current deltas
+  auto reply = gOFS.mFsckQcl->exec("HINCRBY", eos::common::FSCK_DELTA_SEQ_KEY,
+                                   "last", std::to_string(num_deltas)).get();
+
+  if (!reply || (reply->type != REDIS_REPLY_INTEGER)) {
+    eos_err("msg=\"failed to reserve fsck delta sequence numbers\" fsid=%lu",
+            fsid);
+    return false;
+  }
+
+  eos::common::FsckDelta delta;
+  delta.mSeq = (uint64_t)reply->integer - num_deltas;
+  std::vector<std::string> request {"deque-push-back",
+                                    eos::common::FSCK_DELTA_KEY};
+  std::list<std::future<qclient::redisReplyPtr>> responses;
+
+  for (const auto* emap : deltas) {
+    delta.mAppeared = (emap == &appeared);
+
+    for (const auto& elem : *emap) {
+      delta.mErrType = elem.first;
+
+      for (const auto& errfsid : elem.second) {
+        delta.mFsid = errfsid.first;
+
+        for (const auto& fid : errfsid.second) {
+          ++delta.mSeq;
+          delta.mFid = fid;
+          request.push_back(delta.Serialize());
+
+          if (request.size() >= s_max_batch_size) {
+            responses.push_back(gOFS.mFsckQcl->execute(request));
+            request.resize(2);
+          }
+        }
+      }
+    }
+  }
+
+  if (request.size() > 2) {
+    responses.push_back(gOFS.mFsckQcl->execute(request));
+  }
+
+  responses.push_back(gOFS.mFsckQcl->exec("deque-trim-front",
+                      eos::common::FSCK_DELTA_KEY,
+                      std::to_string(eos::common::FSCK_DELTA_MAX_LEN)));
+  bool ok = true;
+
+  for (auto& resp : responses) {
+    auto resp_reply = resp.get();
+
+    if (!resp_reply || (resp_reply->type == REDIS_REPLY_ERROR)) {
+      ok = false;
+    }
+  }
+
+  if (!ok) {
+    eos_err("msg=\"failed to push fsck deltas\" fsid=%lu", fsid);
     return false;
   }
 
@@ -1441,6 +1615,57 @@ Storage::PushToQdb(eos::common::FileSystem::fsid_t fsid,
   return true;
 }
 
+//------------------------------------------------------------------------------
+// Check if a previously published fsck entry still refers to a file present
+// on disk and in the local file metadata
+//------------------------------------------------------------------------------
+bool
+Storage::IsFsckEntryValid(eos::common::FileSystem::fsid_t fsid,
+                          eos::common::FileId::fileid_t fid)
+{
+#ifndef _NOOFS
+  std::string fs_path;
+  {
+    eos::common::RWMutexReadLock rd_lock(mFsMutex);
+    auto it = mFsMap.find(fsid);
+
+    if (it == mFsMap.end()) {
+      return false;
+    }
+
+    fs_path = it->second->GetPath();
+  }
+  struct stat info;
+  const std::string fpath = eos::common::FileId::FidPrefix2FullPath
+                            (eos::common::FileId::Fid2Hex(fid).c_str(), fs_path.c_str());
+
+  if (stat(fpath.c_str(), &info)) {
+    return false;
+  }
+
+  return (gOFS.mFmdHandler->LocalGetFmd(fid, fsid, true, false) != nullptr);
+#else
+  return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Forget the fsck errors published for a file system
+//------------------------------------------------------------------------------
+void
+Storage::ClearFsckPublished(eos::common::FileSystem::fsid_t fsid)
+{
+  std::unique_lock<std::mutex> lock(mFsckPublishedMutex);
+
+  for (auto it = mFsckPublished.begin(); it != mFsckPublished.end();) {
+    if (it->first.first == fsid) {
+      it = mFsckPublished.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 // Publish a paricular fsck error to QDB
 //------------------------------------------------------------------------------
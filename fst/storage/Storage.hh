@@ -25,6 +25,7 @@
 #include "fst/Namespace.hh"
 #include "fst/Load.hh"
 #include "fst/Health.hh"
+#include "fst/utils/PublishFilter.hh"
 #include "common/Logging.hh"
 #include "common/FileSystem.hh"
 #include "common/RWMutex.hh"
@@ -37,6 +38,8 @@
 #include <list>
 #include <queue>
 #include <map>
+#include <chrono>
+#include <mutex>
 
 namespace eos
 {
@@ -239,12 +242,22 @@ public:
   //!
   //! @param fsid file system identifier
   //! @param errs_map map of error types to set of fids which are affected
+  //! @param source if not empty then errs_map holds the complete list of
+  //!        errors detected by the given source (e.g. "ns" or "disk" scan) and
+  //!        only the difference with respect to the previous push from the
+  //!        same source is sent to QDB. Otherwise all errors are pushed.
+  //! @param checked_fids if not null then only the given files were checked
+  //!        by the source and the previous errors of the other files are
+  //!        still valid as long as the files are on disk and in the local
+  //!        file metadata
   //!
   //! @return true if push was successful, othewise false
   //----------------------------------------------------------------------------
   bool
   PushToQdb(eos::common::FileSystem::fsid_t fsid,
-            const eos::common::FsckErrsPerFsMap& errs_map);
+            const eos::common::FsckErrsPerFsMap& errs_map,
+            const std::string& source = "",
+            const std::set<eos::common::FileId::fileid_t>* checked_fids = nullptr);
 
   //----------------------------------------------------------------------------
   //! Process file system configuration change
@@ -297,6 +310,8 @@ private:
   AssistedThread mQdbCommunicatorThread;
   std::set<std::string> mLastRoundFilesystems;
   AssistedThread mPublisherThread; ///< Thread publishing FST/FS info
+  //! Filter of the FST/FS info keeping only what changed since last published
+  PublishFilter mPublishFilter;
   AssistedThread mErrorReportThread; ///< Thread sending error reports
   AssistedThread mRegisterFsThread; ///< Thread updating list of FS registered
   //! CV and mutex used for notifying the register thread
@@ -304,6 +319,35 @@ private:
   std::mutex mMutexRegisterFs;
   bool mTriggerRegisterFs {false};
   AssistedThread mFsConfigThread; ///< Thread applying FS config updates
+  //! Interval after which the full list of fsck errors is pushed again to
+  //! QDB even if only deltas would be needed
+  static constexpr std::chrono::seconds sFsckFullPushInterval {24 * 3600};
+  //! Mutex protecting the last published fsck errors
+  std::mutex mFsckPublishedMutex;
+  //! Last published fsck errors and timestamp of the last full push per file
+  //! system and error source
+  std::map<std::pair<eos::common::FileSystem::fsid_t, std::string>,
+      std::pair<eos::common::FsckErrsPerFsMap,
+      std::chrono::steady_clock::time_point>> mFsckPublished;
+  //----------------------------------------------------------------------------
+  //! Check if a previously published fsck entry still refers to a file
+  //! present on disk and in the local file metadata
+  //!
+  //! @param fsid file system identifier
+  //! @param fid file identifier
+  //!
+  //! @return true if entry is still valid, otherwise false
+  //----------------------------------------------------------------------------
+  bool IsFsckEntryValid(eos::common::FileSystem::fsid_t fsid,
+                        eos::common::FileId::fileid_t fid);
+
+  //----------------------------------------------------------------------------
+  //! Forget the fsck errors published for a file system
+  //!
+  //! @param fsid file system identifier
+  //----------------------------------------------------------------------------
+  void ClearFsckPublished(eos::common::FileSystem::fsid_t fsid);
+
   //----------------------------------------------------------------------------
   //! Struct modelling a file system configuration update
   //----------------------------------------------------------------------------
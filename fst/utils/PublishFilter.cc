@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+// File: PublishFilter.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/utils/PublishFilter.hh"
+#include <cmath>
+#include <cstdlib>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Set the threshold of a numeric key
+//------------------------------------------------------------------------------
+void
+PublishFilter::SetThreshold(const std::string& key, double abs_delta,
+                            double rel_delta)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mThresholds[key] = Threshold {abs_delta, rel_delta};
+}
+
+//------------------------------------------------------------------------------
+// Keep only the values which need to be published
+//------------------------------------------------------------------------------
+void
+PublishFilter::Filter(const std::string& hash,
+                      std::map<std::string, std::string>& values)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  HashState& state = mHashes[hash];
+
+  if ((state.mCycle == 0) || (state.mCycle >= mRefreshCycles)) {
+    // Publish everything
+    state.mCycle = 1;
+    state.mPublished = values;
+    return;
+  }
+
+  ++state.mCycle;
+
+  for (auto it = values.begin(); it != values.end();) {
+    auto it_pub = state.mPublished.find(it->first);
+
+    if ((it_pub != state.mPublished.end()) &&
+        !IsChanged(it->first, it_pub->second, it->second)) {
+      it = values.erase(it);
+    } else {
+      state.mPublished[it->first] = it->second;
+      ++it;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Publish all the keys of every hash at the next cycle
+//------------------------------------------------------------------------------
+void
+PublishFilter::Reset()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mHashes.clear();
+}
+
+//------------------------------------------------------------------------------
+// Check if the new value of a key differs enough from the published one
+//------------------------------------------------------------------------------
+bool
+PublishFilter::IsChanged(const std::string& key, const std::string& published,
+                         const std::string& value) const
+{
+  if (published == value) {
+    return false;
+  }
+
+  auto it = mThresholds.find(key);
+
+  if (it == mThresholds.end()) {
+    return true;
+  }
+
+  char* end_old = nullptr;
+  char* end_new = nullptr;
+  double old_val = strtod(published.c_str(), &end_old);
+  double new_val = strtod(value.c_str(), &end_new);
+
+  // Not numeric, any change matters
+  if ((end_old == published.c_str()) || *end_old ||
+      (end_new == value.c_str()) || *end_new) {
+    return true;
+  }
+
+  double delta = std::fabs(new_val - old_val);
+  return ((delta > it->second.mAbsDelta) &&
+          (delta > it->second.mRelDelta * std::fabs(old_val)));
+}
+
+EOSFSTNAMESPACE_END
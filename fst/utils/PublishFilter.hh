@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+// File: PublishFilter.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "fst/Namespace.hh"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class PublishFilter
+//!
+//! @description Keeps track of the values last published for every shared
+//!   hash so that only the keys which changed are published again. Noisy
+//!   numeric values can be given a threshold below which a change is not
+//!   worth publishing. All the keys of a hash are published again every
+//!   few cycles, so that observers which missed transient updates converge.
+//!   Thread-safe.
+//------------------------------------------------------------------------------
+class PublishFilter
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param refresh_cycles number of cycles after which all the keys of a
+  //!        hash are published again, 0 to publish them every cycle
+  //----------------------------------------------------------------------------
+  PublishFilter(uint32_t refresh_cycles = 10):
+    mRefreshCycles(refresh_cycles)
+  {}
+
+  //----------------------------------------------------------------------------
+  //! Set the threshold of a numeric key, a new value is published only if it
+  //! differs from the last published one by more than abs_delta and by more
+  //! than rel_delta times the last published value
+  //!
+  //! @param key hash key
+  //! @param abs_delta absolute threshold
+  //! @param rel_delta relative threshold
+  //----------------------------------------------------------------------------
+  void SetThreshold(const std::string& key, double abs_delta,
+                    double rel_delta = 0.0);
+
+  //----------------------------------------------------------------------------
+  //! Keep only the values which need to be published and record them as
+  //! published
+  //!
+  //! @param hash identifier of the shared hash
+  //! @param values current values of the hash, on return the ones to publish
+  //----------------------------------------------------------------------------
+  void Filter(const std::string& hash, std::map<std::string, std::string>& values);
+
+  //----------------------------------------------------------------------------
+  //! Publish all the keys of every hash at the next cycle
+  //----------------------------------------------------------------------------
+  void Reset();
+
+private:
+  struct Threshold {
+    double mAbsDelta;
+    double mRelDelta;
+  };
+
+  struct HashState {
+    uint32_t mCycle {0}; ///< Cycles since all the keys were published
+    std::map<std::string, std::string> mPublished; ///< Last published values
+  };
+
+  //----------------------------------------------------------------------------
+  //! Check if the new value of a key differs enough from the published one
+  //----------------------------------------------------------------------------
+  bool IsChanged(const std::string& key, const std::string& published,
+                 const std::string& value) const;
+
+  const uint32_t mRefreshCycles;
+  std::mutex mMutex; ///< Protects the members below
+  std::map<std::string, Threshold> mThresholds;
+  std::map<std::string, HashState> mHashes;
+};
+
+EOSFSTNAMESPACE_END
@@ -2627,9 +2627,23 @@ FsView::HeartBeatCheck(ThreadAssistant& assistant) noexcept
               is_group_active) {
             ssize_t max_ropen = fs->GetLongLong("max.ropen");
             ssize_t max_wopen = fs->GetLongLong("max.wopen");
-            bool overloaded = ((max_ropen &&
-                                (max_ropen <= fs->GetLongLong("stat.ropen"))) ||
-                               (max_wopen && (max_wopen <= fs->GetLongLong("stat.wopen"))));
+            ssize_t ropen = fs->GetLongLong("stat.ropen");
+            ssize_t wopen = fs->GetLongLong("stat.wopen");
+            bool overloaded = ((max_ropen && (max_ropen <= ropen)) ||
+                               (max_wopen && (max_wopen <= wopen)));
+            // Refresh the live load used by the load aware placement
+            double eth_rate = fs->GetDouble("stat.net.ethratemib");
+            double net_util = 0.0;
+
+            if (eth_rate > 0) {
+              net_util = std::max(fs->GetDouble("stat.net.inratemib"),
+                                  fs->GetDouble("stat.net.outratemib")) / eth_rate;
+            }
+
+            gOFS->mFsScheduler->setDiskLoad(fs->GetSpace(), fs->GetId(),
+                                            fs->GetDouble("stat.disk.load"),
+                                            net_util,
+                                            std::max<ssize_t>(ropen + wopen, 0));
 
             if (!overloaded) {
               if (fs->GetActiveStatus() != eos::common::ActiveStatus::kOnline) {
@@ -38,6 +38,7 @@
 #include <sys/stat.h>
 #include <tuple>
 #include <algorithm>
+#include <new>
 
 using namespace std;
 using namespace eos::common;
@@ -47,8 +48,15 @@ EOSMGMNAMESPACE_BEGIN
 
 // We assume that all the trees have the same max size, we should take the max
 // of all the sizes otherwise
-const size_t GeoTreeEngine::gGeoBufferSize = sizeof(FastPlacementTree) +
-    FastPlacementTree::sGetMaxDataMemSize();
+const size_t GeoTreeEngine::gGeoBufferSize =
+  FastPlacementTree::sGetHeaderSize() +
+  FastPlacementTree::sGetMaxDataMemSize();
+// The working copy of a tree is made in a cache line aligned buffer and the
+// nodes start after the padded tree header, none of them straddles two cache
+// lines as long as their size divides the cache line size
+static_assert(FastPlacementTree::sGetHeaderSize() % 64 == 0 &&
+              64 % sizeof(FastPlacementTree::FastTreeNode) == 0,
+              "fast tree nodes are not cache line aligned in the geobuffer");
 thread_local void* GeoTreeEngine::tlGeoBuffer = NULL;
 pthread_key_t GeoTreeEngine::gPthreadKey;
 
@@ -133,7 +141,8 @@ unsigned int GetMaxPlacementAttempts()
 //------------------------------------------------------------------------------
 GeoTreeEngine::GeoTreeEngine(mq::MessagingRealm* realm) :
   pSkipSaturatedAccess(true), pSkipSaturatedDrnAccess(true),
-  pSkipSaturatedBlcAccess(true), pProxyCloseToFs(true),
+  pSkipSaturatedBlcAccess(true), pFixedPlacementKernels(false),
+  pProxyCloseToFs(true),
   pPenaltyUpdateRate(1),
   pFillRatioLimit(80), pFillRatioCompTol(100), pSaturationThres(10),
   pTimeFrameDurationMs(1000), pPublishToPenaltyDelayMs(1000),
@@ -597,6 +606,7 @@ void GeoTreeEngine::printInfo(std::string& info, bool dispTree, bool dispSnaps,
     ostr << "skipSaturatedDrnAccess = " << pSkipSaturatedDrnAccess << std::endl;
     ostr << "skipSaturatedBlcAccess = " << pSkipSaturatedBlcAccess << std::endl;
     ostr << "proxyCloseToFs = " << pProxyCloseToFs << std::endl;
+    ostr << "fixedPlacementKernels = " << pFixedPlacementKernels << std::endl;
     ostr << "penaltyUpdateRate = " << pPenaltyUpdateRate << std::endl;
     ostr << "plctDlScorePenalty = " << pPenaltySched.pPlctDlScorePenaltyF[0] <<
          "(default)" << " | "
@@ -2729,22 +2739,17 @@ bool GeoTreeEngine::updateTreeInfo(SchedTME* entry,
 bool GeoTreeEngine::updateTreeInfo(const std::map<std::string, int>& updatesFs,
                                    const std::map<std::string, int>& updatesDp)
 {
-  // copy the foreground FastStructures to the BackGround FastStructures
-  // so that the penalties applied after the placement/access are kept by defaut
-  // (and overwritten if a new state is received from the fs)
+  // The foreground FastStructures are copied to the BackGround FastStructures
+  // only for the groups being updated, so that the penalties applied after the
+  // placement/access are kept by defaut (and overwritten if a new state is
+  // received from the fs). The nodes having penalties are then refreshed along
+  // with the updated ones.
   // => SCHEDULING
   pTreeMapMutex.LockRead();
 
   for (auto it = pGroup2SchedTME.begin(); it != pGroup2SchedTME.end(); it++) {
     SchedTME* entry = it->second;
     RWMutexReadLock lock(entry->slowTreeMutex);
-
-    if (!entry->foregroundFastStruct->DeepCopyTo(entry->backgroundFastStruct)) {
-      eos_crit("error deep copying in double buffering");
-      pTreeMapMutex.UnLockRead();
-      return false;
-    }
-
     // Copy the penalties of the last frame from each group and reset the
     // penalties counter in the fast trees.
     auto& pVec = pPenaltySched.pCircFrCnt2FsPenalties[pFrameCount % pCircSize];
@@ -2753,6 +2758,11 @@ bool GeoTreeEngine::updateTreeInfo(const std::map<std::string, int>& updatesFs,
          it2 != entry->foregroundFastStruct->fs2TreeIdx->end(); it2++) {
       auto cur = *it2;
       pVec[cur.first] = (*entry->foregroundFastStruct->penalties)[cur.second];
+
+      if (pVec[cur.first].dlScorePenalty || pVec[cur.first].ulScorePenalty) {
+        entry->modifiedFastTreeNodes.insert(cur.second);
+      }
+
       AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty,
                 (*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty, (char)0);
       AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].ulScorePenalty,
@@ -2767,13 +2777,6 @@ bool GeoTreeEngine::updateTreeInfo(const std::map<std::string, int>& updatesFs,
   for (auto it = pPxyGrp2DpTME.begin(); it != pPxyGrp2DpTME.end(); it++) {
     DataProxyTME* entry = it->second;
     RWMutexReadLock lock(entry->slowTreeMutex);
-
-    if (!entry->foregroundFastStruct->DeepCopyTo(entry->backgroundFastStruct)) {
-      eos_crit("error deep copying in double buffering");
-      pPxyTreeMapMutex.UnLockRead();
-      return false;
-    }
-
     // Copy the penalties of the last frame from each group and reset the
     // penalties counter in the fast trees.
     auto& pMap = pPenaltySched.pCircFrCnt2HostPenalties[pFrameCount % pCircSize];
@@ -2782,6 +2785,11 @@ bool GeoTreeEngine::updateTreeInfo(const std::map<std::string, int>& updatesFs,
          it2 != entry->foregroundFastStruct->host2TreeIdx->end(); it2++) {
       auto cur = *it2;
       pMap[cur.first] = (*entry->foregroundFastStruct->penalties)[cur.second];
+
+      if (pMap[cur.first].dlScorePenalty || pMap[cur.first].ulScorePenalty) {
+        entry->modifiedFastTreeNodes.insert(cur.second);
+      }
+
       AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty,
                 (*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty, (char)0);
       AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].ulScorePenalty,
@@ -2831,6 +2839,15 @@ bool GeoTreeEngine::updateTreeInfo(const std::map<std::string, int>& updatesFs,
     // the fast structures.
     entry->slowTreeMutex.LockWrite();
     entry->doubleBufferMutex.LockRead();
+
+    if (!entry->syncBackGroundFastStructures()) {
+      eos_crit("error deep copying in double buffering");
+      entry->doubleBufferMutex.UnLockRead();
+      entry->slowTreeMutex.UnLockWrite();
+      AtomicDec(entry->fastStructLockWaitersCount);
+      return false;
+    }
+
     const SchedTreeBase::tFastTreeIdx* idx = NULL;
     SlowTreeNode* node = NULL;
 
@@ -2857,6 +2874,7 @@ bool GeoTreeEngine::updateTreeInfo(const std::map<std::string, int>& updatesFs,
 
     if (idx) {
       entry->fastStructModified = true;
+      entry->modifiedFastTreeNodes.insert(*idx);
     }
 
     if (node) {
@@ -2871,11 +2889,10 @@ bool GeoTreeEngine::updateTreeInfo(const std::map<std::string, int>& updatesFs,
 
   // Update the atomic penalties
   updateAtomicPenalties();
-  // Update the trees that need to be updated (could maybe optimized by
-  // updating only the branch needing, might be worth it if only 1 or 2
-  // branches are updated). Self update for the fast structure if update
-  // from slow tree is not needed. If convert from slowtree is needed,
-  // update the slowtree from the fast for the info and for the state
+  // Update the trees that need to be updated. Self update for the fast
+  // structure of the modified branches only if update from slow tree is not
+  // needed. If convert from slowtree is needed, update the slowtree from the
+  // fast for the info and for the state
   // => SCHED
   pTreeMapMutex.LockRead();
 
@@ -3214,6 +3231,12 @@ bool GeoTreeEngine::setProxyCloseToFs(bool value, bool setconfig)
                           setconfig ? "proxyclosetofs" : "");
 }
 
+bool GeoTreeEngine::setFixedPlacementKernels(bool value, bool setconfig)
+{
+  return setInternalParam(pFixedPlacementKernels, (int)value, false,
+                          setconfig ? "fixedplacementkernels" : "");
+}
+
 bool GeoTreeEngine::setScorePenalty(std::vector<float>& fvector,
                                     std::vector<char>& cvector,
                                     const std::vector<char>& vvalue,
@@ -3431,6 +3454,8 @@ bool GeoTreeEngine::setParameter(std::string param, const std::string& value,
     ok = this->setSkipSaturatedDrnAccess((bool)ival, setconfig);
   } else if (param == "skipsaturatedaccess") {
     ok = this->setSkipSaturatedAccess((bool)ival, setconfig);
+  } else if (param == "fixedplacementkernels") {
+    ok = this->setFixedPlacementKernels((bool)ival, setconfig);
   } else if (param == "penaltyupdaterate") {
     ok = this->setPenaltyUpdateRate((float)dval, setconfig);
   } else if (param == "disabledbranches") {
@@ -3989,13 +4014,13 @@ void GeoTreeEngine::tlFree(void* arg)
 {
   eos_static_debug("destroying thread specific geobuffer");
   // delete the buffer
-  delete[](char*)arg;
+  operator delete[](arg, std::align_val_t(64));
 }
 
 char* GeoTreeEngine::tlAlloc(size_t size)
 {
   eos_static_debug("allocating thread specific geobuffer");
-  char* buf = new char[size];
+  char* buf = new (std::align_val_t(64)) char[size];
 
   if (pthread_setspecific(gPthreadKey, buf)) {
     eos_static_crit("error registering thread-local buffer located at %p for "
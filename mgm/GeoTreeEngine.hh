@@ -420,6 +420,19 @@ class GeoTreeEngine : public eos::common::LogId
       drnPlacementTree->updateTree();
     }
 
+    // update only the given nodes and their ancestors, all the trees share
+    // the same layout
+    void UpdateTrees(const std::set<SchedTreeBase::tFastTreeIdx>& nodes)
+    {
+      std::vector<SchedTreeBase::tFastTreeIdx> branches(nodes.begin(), nodes.end());
+      placementTree->addAncestors(branches);
+      rOAccessTree->updateBranches(branches);
+      rWAccessTree->updateBranches(branches);
+      drnAccessTree->updateBranches(branches);
+      placementTree->updateBranches(branches);
+      drnPlacementTree->updateBranches(branches);
+    }
+
     inline void applyDlScorePenalty(SchedTreeBase::tFastTreeIdx idx,
                                     const char& penalty, bool background)
     /**< Apply download score penalty */
@@ -464,11 +477,16 @@ class GeoTreeEngine : public eos::common::LogId
       penalties->resize(newsize);
     }
 
-    inline void setConfigParam(
+    inline bool setConfigParam(
       const char& fillRatioLimit,
       const char& fillRatioCompTol,
       const char& saturationThres)
     {
+      // all the trees get the same parameters
+      const bool changed =
+        (placementTree->getSaturationThreshold() != saturationThres) ||
+        (placementTree->getSpreadingFillRatioCap() != fillRatioLimit) ||
+        (placementTree->getFillRatioCompTol() != fillRatioCompTol);
       rOAccessTree->setSaturationThreshold(saturationThres);
       rWAccessTree->setSaturationThreshold(saturationThres);
       drnAccessTree->setSaturationThreshold(saturationThres);
@@ -478,6 +496,7 @@ class GeoTreeEngine : public eos::common::LogId
       drnPlacementTree->setSaturationThreshold(saturationThres);
       drnPlacementTree->setSpreadingFillRatioCap(fillRatioLimit);
       drnPlacementTree->setFillRatioCompTol(fillRatioCompTol);
+      return changed;
     }
 
   };
@@ -568,6 +587,13 @@ class GeoTreeEngine : public eos::common::LogId
       proxyAccessTree->updateTree();
     }
 
+    void UpdateTrees(const std::set<SchedTreeBase::tFastTreeIdx>& nodes)
+    {
+      std::vector<SchedTreeBase::tFastTreeIdx> branches(nodes.begin(), nodes.end());
+      proxyAccessTree->addAncestors(branches);
+      proxyAccessTree->updateBranches(branches);
+    }
+
     inline void applyDlScorePenalty(SchedTreeBase::tFastTreeIdx idx,
                                     const char& penalty, bool background)
     {
@@ -601,12 +627,15 @@ class GeoTreeEngine : public eos::common::LogId
       penalties->resize(newsize);
     }
 
-    inline void setConfigParam(
+    inline bool setConfigParam(
       const char& fillRatioLimit,
       const char& fillRatioCompTol,
       const char& saturationThres)
     {
+      const bool changed =
+        (proxyAccessTree->getSaturationThreshold() != saturationThres);
       proxyAccessTree->setSaturationThreshold(saturationThres);
+      return changed;
     }
 
   };
@@ -639,13 +668,20 @@ class GeoTreeEngine : public eos::common::LogId
     eos::common::RWMutex doubleBufferMutex;
     size_t fastStructLockWaitersCount;
     bool fastStructModified;
+    // the background is only made a copy of the foreground when it is about
+    // to be updated, groups without any change are not copied at every frame
+    bool backgroundFastStructSynced;
+    // fast tree nodes modified since the last swap. If no rebuild from the
+    // slowtree is needed, only them and their ancestors are updated.
+    std::set<SchedTreeBase::tFastTreeIdx> modifiedFastTreeNodes;
 
     TreeMapEntry(const std::string& groupName = "") :
       slowTreeModified(false),
       foregroundFastStruct(fastStructures),
       backgroundFastStruct(fastStructures + 1),
       fastStructLockWaitersCount(0),
-      fastStructModified(false)
+      fastStructModified(false),
+      backgroundFastStructSynced(false)
     {
       slowTree = new SlowTree(groupName);
       slowTreeMutex.SetBlocking(true);
@@ -663,16 +699,33 @@ class GeoTreeEngine : public eos::common::LogId
     {
       eos::common::RWMutexWriteLock lock(doubleBufferMutex);
       std::swap(foregroundFastStruct, backgroundFastStruct);
+      backgroundFastStructSynced = false;
+      modifiedFastTreeNodes.clear();
+    }
+
+    bool syncBackGroundFastStructures()
+    {
+      if (backgroundFastStructSynced) {
+        return true;
+      }
+
+      if (!foregroundFastStruct->DeepCopyTo(backgroundFastStruct)) {
+        return false;
+      }
+
+      backgroundFastStructSynced = true;
+      return true;
     }
 
-    void updateBGFastStructuresConfigParam(
+    // return true if the parameters changed, the fast trees then need to be
+    // refreshed entirely
+    bool updateBGFastStructuresConfigParam(
       const char& fillRatioLimit,
       const char& fillRatioCompTol,
       const char& saturationThres)
     {
-      backgroundFastStruct->setConfigParam(fillRatioLimit, fillRatioCompTol,
-                                           saturationThres);
-      refreshBackGroundFastStructures();
+      return backgroundFastStruct->setConfigParam(fillRatioLimit, fillRatioCompTol,
+             saturationThres);
     }
 
     void refreshBackGroundFastStructures()
@@ -680,6 +733,12 @@ class GeoTreeEngine : public eos::common::LogId
       backgroundFastStruct->UpdateTrees();
     }
 
+    void refreshBackGroundFastStructures(
+      const std::set<SchedTreeBase::tFastTreeIdx>& nodes)
+    {
+      backgroundFastStruct->UpdateTrees(nodes);
+    }
+
     bool updateFastStructures()
     {
       FastStruct* ft = backgroundFastStruct;
@@ -804,6 +863,16 @@ class GeoTreeEngine : public eos::common::LogId
       return true;
     }
 
+    // the update starts from the current state of the foreground
+    if (!entry->syncBackGroundFastStructures()) {
+      eos_crit("error deep copying in double buffering");
+      return false;
+    }
+
+    // update the BackGroundFastStructures configuration parameters accordingly to the one present in the GeoTree
+    const bool configChanged = entry->updateBGFastStructuresConfigParam(
+                                 pFillRatioLimit, pFillRatioCompTol, pSaturationThres);
+
     if (entry->slowTreeModified) {
       entry->updateSlowTreeInfoFromBgFastStruct();
 
@@ -813,6 +882,7 @@ class GeoTreeEngine : public eos::common::LogId
       }
 
       applyBranchDisablings(*entry);
+      entry->refreshBackGroundFastStructures();
 
       if (g_logging.gLogMask & LOG_MASK(LOG_DEBUG)) {
         std::stringstream ss;
@@ -826,7 +896,12 @@ class GeoTreeEngine : public eos::common::LogId
       }
     } else {
       // the rebuild of the fast structures is not necessary
-      entry->refreshBackGroundFastStructures();
+      if (configChanged) {
+        entry->refreshBackGroundFastStructures();
+      } else {
+        // only the modified nodes and their ancestors are updated
+        entry->refreshBackGroundFastStructures(entry->modifiedFastTreeNodes);
+      }
 
       if (g_logging.gLogMask & LOG_MASK(LOG_DEBUG)) {
         std::stringstream ss;
@@ -839,9 +914,6 @@ class GeoTreeEngine : public eos::common::LogId
     // mark the entry as updated
     entry->slowTreeModified = false;
     entry->fastStructModified = false;
-    // update the BackGroundFastStructures configuration parameters accordingly to the one present in the GeoTree (and update the fast trees)
-    entry->updateBGFastStructuresConfigParam(pFillRatioLimit, pFillRatioCompTol,
-        pSaturationThres);
     // clear the penalties
     std::fill(entry->backgroundFastStruct->penalties->begin(),
               entry->backgroundFastStruct->penalties->end(), Penalties());
@@ -859,6 +931,16 @@ class GeoTreeEngine : public eos::common::LogId
       return true;
     }
 
+    // the update starts from the current state of the foreground
+    if (!entry->syncBackGroundFastStructures()) {
+      eos_crit("error deep copying in double buffering");
+      return false;
+    }
+
+    // update the BackGroundFastStructures configuration parameters accordingly to the one present in the GeoTree
+    const bool configChanged = entry->updateBGFastStructuresConfigParam(
+                                 pFillRatioLimit, pFillRatioCompTol, pSaturationThres);
+
     if (entry->slowTreeModified) {
       entry->updateSlowTreeInfoFromBgFastStruct();
 
@@ -867,6 +949,8 @@ class GeoTreeEngine : public eos::common::LogId
         return false;
       }
 
+      entry->refreshBackGroundFastStructures();
+
       if (g_logging.gLogMask & LOG_MASK(LOG_DEBUG)) {
         std::stringstream ss;
         ss << (*entry->backgroundFastStruct->proxyAccessTree);
@@ -879,7 +963,12 @@ class GeoTreeEngine : public eos::common::LogId
       }
     } else {
       // the rebuild of the fast structures is not necessary
-      entry->refreshBackGroundFastStructures();
+      if (configChanged) {
+        entry->refreshBackGroundFastStructures();
+      } else {
+        // only the modified nodes and their ancestors are updated
+        entry->refreshBackGroundFastStructures(entry->modifiedFastTreeNodes);
+      }
 
       if (g_logging.gLogMask & LOG_MASK(LOG_DEBUG)) {
         std::stringstream ss;
@@ -892,9 +981,6 @@ class GeoTreeEngine : public eos::common::LogId
     // mark the entry as updated
     entry->slowTreeModified = false;
     entry->fastStructModified = false;
-    // update the BackGroundFastStructures configuration parameters accordingly to the one present in the GeoTree (and update the fast trees)
-    entry->updateBGFastStructuresConfigParam(pFillRatioLimit, pFillRatioCompTol,
-        pSaturationThres);
     // clear the penalties
     std::fill(entry->backgroundFastStruct->penalties->begin(),
               entry->backgroundFastStruct->penalties->end(), Penalties());
@@ -960,6 +1046,9 @@ protected:
   /// these settings indicate if saturated FS should try to be avoided
   /// this might lead to unoptimal access/placement location-wise
   bool pSkipSaturatedAccess, pSkipSaturatedDrnAccess, pSkipSaturatedBlcAccess;
+  /// this setting indicates if the 2 and 12 replicas placements should use the
+  /// fixed size kernels of the fast trees
+  bool pFixedPlacementKernels;
   /// these setting indicates if sthe proxy should be selected closest to the fs or closest to the client
   bool pProxyCloseToFs;
 
@@ -1289,6 +1378,11 @@ protected:
     // a read lock is supposed to be acquired on the fast structures
     eos::common::Logging& g_logging = eos::common::Logging::GetInstance();
     bool updateNeeded = false;
+    // the most common layouts are placed with the fixed size kernels, only the
+    // branches modified in the working copy are refreshed in that case
+    const bool fixedKernel = pFixedPlacementKernels && !nFinalCollocatedReplicas
+                             && (nNewReplicas == 2 || nNewReplicas == 12);
+    std::vector<SchedTreeBase::tFastTreeIdx> modifiedNodes;
 
     if (g_logging.gLogMask & LOG_MASK(LOG_DEBUG)) {
       std::stringstream ss;
@@ -1322,6 +1416,10 @@ protected:
         tree->pNodes[*it].fileData.freeSlotsCount = 0;
         tree->pNodes[*it].fileData.takenSlotsCount = 1;
 
+        if (fixedKernel) {
+          modifiedNodes.push_back(*it);
+        }
+
         // check if this replica is to be considered as a collocated one
         if (startFromNode) {
           // we have an accesser geotag
@@ -1355,6 +1453,10 @@ protected:
       for (auto it = excludedNodes->begin(); it != excludedNodes->end(); ++it) {
         tree->pNodes[*it].fsData.mStatus = tree->pNodes[*it].fsData.mStatus &
                                            ~SchedTreeBase::Available;
+
+        if (fixedKernel) {
+          modifiedNodes.push_back(*it);
+        }
       }
 
       if (!excludedNodes->empty()) {
@@ -1375,9 +1477,15 @@ protected:
         } else { // if there is not enough space, make the node unavailable
           tree->pNodes[idx].fsData.mStatus = tree->pNodes[idx].fsData.mStatus &
                                              ~SchedTreeBase::Available;
+
+          if (fixedKernel) {
+            modifiedNodes.push_back(idx);
+          }
         }
       }
 
+      // the prebooked space does not change the order of the branches, only
+      // the nodes made unavailable matter for the fixed size kernels
       updateNeeded = true;
     } else {
       // Test at lest that we have some free space
@@ -1389,6 +1497,10 @@ protected:
           tree->pNodes[idx].fsData.mStatus = tree->pNodes[idx].fsData.mStatus &
                                              ~SchedTreeBase::Available;
           updateNeeded = true;
+
+          if (fixedKernel) {
+            modifiedNodes.push_back(idx);
+          }
         }
       }
     }
@@ -1400,6 +1512,27 @@ protected:
       eos_debug("fast tree used for placement is: \n %s", ss.str().c_str());
     }
 
+    if (fixedKernel) {
+      if (!modifiedNodes.empty()) {
+        tree->addAncestors(modifiedNodes);
+        tree->updateBranches(modifiedNodes);
+      }
+
+      SchedTreeBase::tFastTreeIdx idxs[12];
+      bool found = (nNewReplicas == 2) ?
+                   tree->template findFreeSlotsFixed<2>(idxs) :
+                   tree->template findFreeSlotsFixed<12>(idxs);
+
+      if (!found) {
+        eos_debug("%s", "msg=\"could not find the new replica slots in the "
+                  "fast tree\"");
+        return false;
+      }
+
+      newReplicas->insert(newReplicas->end(), idxs, idxs + nNewReplicas);
+      return true;
+    }
+
     if (updateNeeded) {
       tree->updateTree();
     }
@@ -1662,6 +1795,7 @@ protected:
   bool setSkipSaturatedDrnAccess(bool value, bool setconfig = false);
   bool setSkipSaturatedBlcAccess(bool value, bool setconfig = false);
   bool setProxyCloseToFs(bool value, bool setconfig = false);
+  bool setFixedPlacementKernels(bool value, bool setconfig = false);
   bool setScorePenalty(std::vector<float>& fvector, std::vector<char>& cvector,
                        const std::vector<char>& value, const std::string& configentry);
   bool setScorePenalty(std::vector<float>& fvector, std::vector<char>& cvector,
@@ -23,6 +23,7 @@
 
 #pragma once
 #include "mgm/Namespace.hh"
+#include "mgm/Stat.hh"
 #include "common/Logging.hh"
 #include "common/VirtualIdentity.hh"
 #include "common/table_formatter/TableFormatterBase.hh"
@@ -247,9 +248,11 @@ public:
   //----------------------------------------------------------------------------
   InFlightRegistration(InFlightTracker& tracker,
                        const eos::common::VirtualIdentity& vid) :
-    mInFlightTracker(tracker)
+    mInFlightTracker(tracker), mPrevClient(Stat::GetThreadClient())
   {
     mSucceeded = mInFlightTracker.Up(vid);
+    // Attribute the execution times recorded by this thread to the client type
+    Stat::SetThreadClient(Stat::GetClientType(vid));
   }
 
   //----------------------------------------------------------------------------
@@ -258,6 +261,8 @@ public:
   //------------------------------------------------------------------------------
   ~InFlightRegistration()
   {
+    Stat::SetThreadClient(mPrevClient);
+
     if (mSucceeded) {
       mInFlightTracker.Down();
     }
@@ -282,6 +287,7 @@ public:
 private:
   InFlightTracker& mInFlightTracker;
   bool mSucceeded;
+  StatClient mPrevClient; ///< Client type of the thread before registration
 };
 
 EOSMGMNAMESPACE_END
@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------------
+// File: NegativeLookupCache.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/NegativeLookupCache.hh"
+#include <algorithm>
+#include <functional>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Get current version of the given container
+//------------------------------------------------------------------------------
+NegativeLookupCache::Version
+NegativeLookupCache::GetVersion(eos::IContainerMD& cont)
+{
+  Version version;
+  eos::IContainerMD::mtime_t mtime;
+  cont.getMTime(mtime);
+  version.mtime_sec = mtime.tv_sec;
+  version.mtime_nsec = mtime.tv_nsec;
+  version.num_files = cont.getNumFiles();
+  version.num_containers = cont.getNumContainers();
+  return version;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+NegativeLookupCache::NegativeLookupCache(size_t max_size):
+  mEnabled(max_size != 0), mMaxSize(max_size)
+{
+  size_t shard_size = GetShardSize(max_size);
+
+  for (size_t i = 0; i < kNumShards; ++i) {
+    mShards.emplace_back(new Shard(shard_size, shard_size / 10));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Check if name is known not to exist in the given container
+//------------------------------------------------------------------------------
+bool
+NegativeLookupCache::IsMissing(eos::IContainerMD::id_t parent_id,
+                               const Version& version, const std::string& name)
+{
+  if (!mEnabled) {
+    return false;
+  }
+
+  ++mRequests;
+  const std::string key = GetKey(parent_id, name);
+  Shard& shard = GetShard(key);
+  Version cached;
+
+  if (!shard.tryGet(key, cached)) {
+    return false;
+  }
+
+  if (!(cached == version)) {
+    // The parent changed since, the entry might have been created
+    shard.remove(key);
+    return false;
+  }
+
+  ++mHits;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Record that name was not found in the given container
+//------------------------------------------------------------------------------
+void
+NegativeLookupCache::AddMissing(eos::IContainerMD::id_t parent_id,
+                                const Version& version,
+                                const std::string& name)
+{
+  if (!mEnabled) {
+    return;
+  }
+
+  const std::string key = GetKey(parent_id, name);
+  GetShard(key).insert(key, version);
+}
+
+//------------------------------------------------------------------------------
+// Change max number of entries
+//------------------------------------------------------------------------------
+void
+NegativeLookupCache::SetMaxSize(size_t max_size)
+{
+  mEnabled = (max_size != 0);
+  mMaxSize = max_size;
+  size_t shard_size = GetShardSize(max_size);
+
+  for (auto& shard : mShards) {
+    shard->setMaxSize(shard_size);
+
+    if (!mEnabled) {
+      shard->clear();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Drop all entries
+//------------------------------------------------------------------------------
+void
+NegativeLookupCache::Clear()
+{
+  for (auto& shard : mShards) {
+    shard->clear();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get cache statistics
+//------------------------------------------------------------------------------
+NegativeLookupCache::Stats
+NegativeLookupCache::GetStats() const
+{
+  Stats stats;
+  stats.max_size = (mEnabled ? mMaxSize.load() : 0);
+
+  for (const auto& shard : mShards) {
+    stats.occupancy += shard->size();
+  }
+
+  stats.requests = mRequests;
+  stats.hits = mHits;
+  return stats;
+}
+
+//------------------------------------------------------------------------------
+// Build key of an entry
+//------------------------------------------------------------------------------
+std::string
+NegativeLookupCache::GetKey(eos::IContainerMD::id_t parent_id,
+                            const std::string& name)
+{
+  std::string key = std::to_string(parent_id);
+  key += ':';
+  key += name;
+  return key;
+}
+
+//------------------------------------------------------------------------------
+// Get shard holding the given key
+//------------------------------------------------------------------------------
+NegativeLookupCache::Shard&
+NegativeLookupCache::GetShard(const std::string& key) const
+{
+  return *mShards[std::hash<std::string>()(key) % kNumShards];
+}
+
+//------------------------------------------------------------------------------
+// Get max number of entries of a shard
+//------------------------------------------------------------------------------
+size_t
+NegativeLookupCache::GetShardSize(size_t max_size)
+{
+  return std::max<size_t>(max_size / kNumShards, 1);
+}
+
+EOSMGMNAMESPACE_END
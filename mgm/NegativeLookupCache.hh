@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------
+// File: NegativeLookupCache.hh
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "mgm/Namespace.hh"
+#include "common/LRU.hh"
+#include "namespace/interface/IContainerMD.hh"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! @brief Bounded cache of names known not to exist in a given container.
+//!
+//! Workloads like python imports, $PATH searches or compilers probe many
+//! missing paths, and each probe used to resolve the full path several times
+//! and build an exception for every attempt. Entries are keyed by parent
+//! container id and name, and remember the version of the parent at the time
+//! of the failed lookup. The version is made of the parent mtime, which the
+//! MGM updates on every creation like for the listing cache, and of the
+//! number of children, which also catches additions not touching the mtime.
+//! An entry whose version differs from the current one of the parent is
+//! stale and ignored. The entries are spread over kNumShards LRU caches by
+//! key hash so that concurrent lookups rarely contend on the same mutex.
+//------------------------------------------------------------------------------
+class NegativeLookupCache
+{
+public:
+  static constexpr size_t kNumShards = 16;
+
+  //----------------------------------------------------------------------------
+  //! State of the children of a container
+  //----------------------------------------------------------------------------
+  struct Version {
+    uint64_t mtime_sec {0};
+    uint64_t mtime_nsec {0};
+    uint64_t num_files {0};
+    uint64_t num_containers {0};
+
+    bool operator==(const Version& other) const
+    {
+      return (mtime_sec == other.mtime_sec) &&
+             (mtime_nsec == other.mtime_nsec) &&
+             (num_files == other.num_files) &&
+             (num_containers == other.num_containers);
+    }
+  };
+
+  //----------------------------------------------------------------------------
+  //! Cache statistics
+  //----------------------------------------------------------------------------
+  struct Stats {
+    uint64_t max_size {0};
+    uint64_t occupancy {0};
+    uint64_t requests {0};
+    uint64_t hits {0};
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get current version of the given container, must be taken before the
+  //! lookup which is going to be cached
+  //----------------------------------------------------------------------------
+  static Version GetVersion(eos::IContainerMD& cont);
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param max_size max number of entries, 0 disables the cache
+  //----------------------------------------------------------------------------
+  explicit NegativeLookupCache(size_t max_size = 100000);
+
+  //----------------------------------------------------------------------------
+  //! Check if name is known not to exist in the given container
+  //!
+  //! @param parent_id parent container id
+  //! @param version current version of the parent
+  //! @param name entry name
+  //!
+  //! @return true if name is missing, false if unknown
+  //----------------------------------------------------------------------------
+  bool IsMissing(eos::IContainerMD::id_t parent_id, const Version& version,
+                 const std::string& name);
+
+  //----------------------------------------------------------------------------
+  //! Record that name was not found in the given container
+  //!
+  //! @param parent_id parent container id
+  //! @param version version of the parent taken before the lookup
+  //! @param name entry name
+  //----------------------------------------------------------------------------
+  void AddMissing(eos::IContainerMD::id_t parent_id, const Version& version,
+                  const std::string& name);
+
+  //----------------------------------------------------------------------------
+  //! Change max number of entries, 0 disables the cache. Not thread-safe, to
+  //! be called during configuration only.
+  //----------------------------------------------------------------------------
+  void SetMaxSize(size_t max_size);
+
+  //----------------------------------------------------------------------------
+  //! Is the cache enabled?
+  //----------------------------------------------------------------------------
+  inline bool IsEnabled() const
+  {
+    return mEnabled;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Drop all entries
+  //----------------------------------------------------------------------------
+  void Clear();
+
+  //----------------------------------------------------------------------------
+  //! Get cache statistics
+  //----------------------------------------------------------------------------
+  Stats GetStats() const;
+
+private:
+  using Shard = eos::common::LRU::Cache<std::string, Version, std::mutex>;
+
+  std::atomic<bool> mEnabled;
+  std::atomic<size_t> mMaxSize;
+  std::vector<std::unique_ptr<Shard>> mShards;
+  std::atomic<uint64_t> mRequests {0};
+  std::atomic<uint64_t> mHits {0};
+
+  //----------------------------------------------------------------------------
+  //! Build key of an entry
+  //----------------------------------------------------------------------------
+  static std::string GetKey(eos::IContainerMD::id_t parent_id,
+                            const std::string& name);
+
+  //----------------------------------------------------------------------------
+  //! Get shard holding the given key
+  //----------------------------------------------------------------------------
+  Shard& GetShard(const std::string& key) const;
+
+  //----------------------------------------------------------------------------
+  //! Get max number of entries of a shard, the total stays below max_size
+  //----------------------------------------------------------------------------
+  static size_t GetShardSize(size_t max_size);
+};
+
+EOSMGMNAMESPACE_END
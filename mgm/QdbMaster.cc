@@ -123,6 +123,11 @@ QdbMaster::BootNamespace()
     namespaceConfig["qclient_rocksdb_options"] = gOFS->mQClientRocksDBOptions;
   }
 
+  if (!gOFS->mQClientFlusherCoalesceMs.empty()) {
+    namespaceConfig["qclient_flusher_coalesce_ms"] =
+      gOFS->mQClientFlusherCoalesceMs;
+  }
+
   FillNsCacheConfig(gOFS->ConfEngine, namespaceConfig);
 
   if (!gOFS->namespaceGroup->initialize(&gOFS->eosViewRWMutex, namespaceConfig,
@@ -24,15 +24,27 @@
 #include "common/Mapping.hh"
 #include "common/table_formatter/TableFormatterBase.hh"
 #include "common/Statistics.hh"
+#include "common/VirtualIdentity.hh"
 #include "mgm/Stat.hh"
 #include "mgm/FsView.hh"
 #include "mgm/XrdMgmOfs.hh"
 #include "mq/XrdMqSharedObject.hh"
 #include "mgm/Quota.hh"
 #include <XrdOuc/XrdOucString.hh>
+#include <sstream>
 
 EOSMGMNAMESPACE_BEGIN
 
+thread_local StatClient Stat::tlClient = StatClient::kXrootd;
+
+namespace
+{
+//! Windows reported for the latency histograms as (label, minutes)
+const std::vector<std::pair<std::string, size_t>> sLatencyWindows {
+  {"60s", 1}, {"300s", 5}, {"3600s", 60}
+};
+}
+
 /*----------------------------------------------------------------------------*/
 void
 Stat::Add(const char* tag, uid_t uid, gid_t gid, unsigned long val)
@@ -58,13 +70,103 @@ Stat::AddExt(const char* tag, uid_t uid, gid_t gid, unsigned long nsample,
 void
 Stat::AddExec(const char* tag, float exectime)
 {
-  XrdSysMutexHelper lock(mMutex);
-  StatExec[tag].push_back(exectime);
-  CumulativeTimeExec[tag] += exectime;
+  {
+    XrdSysMutexHelper lock(mMutex);
+    StatExec[tag].push_back(exectime);
+    CumulativeTimeExec[tag] += exectime;
+
+    // we average over 100 entries
+    if (StatExec[tag].size() > 100) {
+      StatExec[tag].pop_front();
+    }
+  }
+  AddExecLatency(tag, exectime);
+}
+
+//------------------------------------------------------------------------------
+// Record execution time in the latency histogram of the current client type
+//------------------------------------------------------------------------------
+void
+Stat::AddExecLatency(const char* tag, float exectime)
+{
+  uint64_t value_us = (exectime > 0) ? (uint64_t) llround(exectime * 1000.0) : 0;
+  size_t client = (size_t) tlClient;
+  {
+    std::shared_lock<std::shared_mutex> lock(mExecHistosMutex);
+    auto it = mExecHistos.find(tag);
+
+    if ((it != mExecHistos.end()) && it->second[client]) {
+      it->second[client]->Record(value_us);
+      return;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mExecHistosMutex);
+  auto& histo = mExecHistos[tag][client];
+
+  if (!histo) {
+    histo = std::make_unique<eos::common::WindowedLatencyHistogram>(60);
+  }
+
+  histo->Record(value_us);
+}
+
+//------------------------------------------------------------------------------
+// Close the current interval of all the latency histograms
+//------------------------------------------------------------------------------
+void
+Stat::RotateExecLatency()
+{
+  std::shared_lock<std::shared_mutex> lock(mExecHistosMutex);
+
+  for (auto& elem : mExecHistos) {
+    for (auto& histo : elem.second) {
+      if (histo) {
+        histo->Rotate();
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Classify the client type based on the given virtual identity
+//------------------------------------------------------------------------------
+StatClient
+Stat::GetClientType(const eos::common::VirtualIdentity& vid)
+{
+  if ((vid.prot == "grpc") || (vid.app == "grpc")) {
+    return StatClient::kGrpc;
+  }
+
+  if ((vid.prot == "https") || (vid.prot == "http") || (vid.app == "http")) {
+    return StatClient::kHttp;
+  }
+
+  if ((vid.app == "fuse") || (vid.app == "xrootdfs") ||
+      (vid.app.find("fuse::") == 0)) {
+    return StatClient::kFuse;
+  }
+
+  return StatClient::kXrootd;
+}
 
-  // we average over 100 entries
-  if (StatExec[tag].size() > 100) {
-    StatExec[tag].pop_front();
+//------------------------------------------------------------------------------
+// Convert client type to string
+//------------------------------------------------------------------------------
+const char*
+Stat::ClientTypeToString(StatClient client)
+{
+  switch (client) {
+  case StatClient::kFuse:
+    return "fuse";
+
+  case StatClient::kHttp:
+    return "http";
+
+  case StatClient::kGrpc:
+    return "grpc";
+
+  default:
+    return "xrootd";
   }
 }
 
@@ -656,6 +758,153 @@ Stat::Clear()
     StatExec[ittag->first].resize(1000);
     CumulativeTimeExec[ittag->first] = 0.0;
   }
+
+  std::shared_lock<std::shared_mutex> histo_lock(mExecHistosMutex);
+
+  for (auto& elem : mExecHistos) {
+    for (auto& histo : elem.second) {
+      if (histo) {
+        histo->Reset();
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Print latency quantiles per command and client type
+//------------------------------------------------------------------------------
+void
+Stat::PrintOutLatency(std::string& out, bool monitoring) const
+{
+  std::string format_s = !monitoring ? "s" : "os";
+  std::string format_ss = !monitoring ? "-s" : "os";
+  std::string format_l = !monitoring ? "+l" : "ol";
+  std::string format_f = !monitoring ? "f" : "of";
+  TableFormatterBase table_lat;
+
+  if (!monitoring) {
+    table_lat.SetHeader({
+      std::make_tuple("command", 24, format_ss),
+      std::make_tuple("client", 6, format_ss),
+      std::make_tuple("window", 6, format_s),
+      std::make_tuple("count", 8, format_l),
+      std::make_tuple("avg(ms)", 8, format_f),
+      std::make_tuple("50p(ms)", 8, format_f),
+      std::make_tuple("90p(ms)", 8, format_f),
+      std::make_tuple("99p(ms)", 8, format_f),
+      std::make_tuple("99.9p(ms)", 8, format_f),
+      std::make_tuple("max(ms)", 8, format_f)
+    });
+  } else {
+    table_lat.SetHeader({
+      std::make_tuple("uid", 0, format_ss),
+      std::make_tuple("gid", 0, format_s),
+      std::make_tuple("cmd", 0, format_s),
+      std::make_tuple("client", 0, format_s),
+      std::make_tuple("window", 0, format_s),
+      std::make_tuple("count", 0, format_l),
+      std::make_tuple("lat.avg", 0, format_f),
+      std::make_tuple("lat.p50", 0, format_f),
+      std::make_tuple("lat.p90", 0, format_f),
+      std::make_tuple("lat.p99", 0, format_f),
+      std::make_tuple("lat.p999", 0, format_f),
+      std::make_tuple("lat.max", 0, format_f)
+    });
+  }
+
+  std::shared_lock<std::shared_mutex> lock(mExecHistosMutex);
+
+  for (const auto& elem : mExecHistos) {
+    for (size_t client = 0; client < kStatClientCount; ++client) {
+      const auto& histo = elem.second[client];
+
+      if (!histo) {
+        continue;
+      }
+
+      for (const auto& window : sLatencyWindows) {
+        auto snap = histo->GetWindow(window.second);
+
+        // Skip empty windows in the human readable output
+        if (!monitoring && (snap.mCount == 0)) {
+          continue;
+        }
+
+        TableData table_data;
+        table_data.emplace_back();
+
+        if (monitoring) {
+          table_data.back().push_back(TableCell("all", format_ss));
+          table_data.back().push_back(TableCell("all", format_s));
+        }
+
+        table_data.back().push_back(TableCell(elem.first, format_ss));
+        table_data.back().push_back(TableCell(ClientTypeToString(
+                                                (StatClient)client), format_ss));
+        table_data.back().push_back(TableCell(window.first, format_s));
+        table_data.back().push_back(TableCell((unsigned long long) snap.mCount,
+                                              format_l));
+        table_data.back().push_back(TableCell(snap.Mean() / 1000.0, format_f));
+        table_data.back().push_back(TableCell(snap.Quantile(0.5) / 1000.0,
+                                              format_f));
+        table_data.back().push_back(TableCell(snap.Quantile(0.9) / 1000.0,
+                                              format_f));
+        table_data.back().push_back(TableCell(snap.Quantile(0.99) / 1000.0,
+                                              format_f));
+        table_data.back().push_back(TableCell(snap.Quantile(0.999) / 1000.0,
+                                              format_f));
+        table_data.back().push_back(TableCell(snap.mMaxUs / 1000.0, format_f));
+        table_lat.AddRows(table_data);
+      }
+    }
+  }
+
+  out += table_lat.GenerateTable(HEADER);
+}
+
+//------------------------------------------------------------------------------
+// Print latency quantiles in the Prometheus text exposition format
+//------------------------------------------------------------------------------
+void
+Stat::PrintOutPrometheus(std::string& out) const
+{
+  static const std::vector<std::string> quantiles {"0.5", "0.9", "0.99", "0.999"};
+  std::ostringstream oss;
+  oss << "# HELP eos_mgm_op_latency_seconds Execution time of MGM operations"
+      << std::endl
+      << "# TYPE eos_mgm_op_latency_seconds summary" << std::endl;
+  std::shared_lock<std::shared_mutex> lock(mExecHistosMutex);
+
+  for (const auto& elem : mExecHistos) {
+    for (size_t client = 0; client < kStatClientCount; ++client) {
+      const auto& histo = elem.second[client];
+
+      if (!histo) {
+        continue;
+      }
+
+      std::string labels = "op=\"" + elem.first + "\",client=\"" +
+                           ClientTypeToString((StatClient)client) + "\"";
+
+      for (const auto& window : sLatencyWindows) {
+        auto snap = histo->GetWindow(window.second);
+
+        for (const auto& quantile : quantiles) {
+          oss << "eos_mgm_op_latency_seconds{" << labels
+              << ",window=\"" << window.first << "\",quantile=\"" << quantile
+              << "\"} " << snap.Quantile(std::stod(quantile)) / 1e6 << std::endl;
+        }
+      }
+
+      auto cumul = histo->GetCumulative();
+      oss << "eos_mgm_op_latency_seconds_sum{" << labels << "} "
+          << cumul.mSumUs / 1e6 << std::endl
+          << "eos_mgm_op_latency_seconds_count{" << labels << "} "
+          << cumul.mCount << std::endl;
+    }
+  }
+
+  out += oss.str();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -877,6 +1126,12 @@ Stat::PrintOutTotal(XrdOucString& out, bool details, bool monitoring,
 
   out += table_all.GenerateTable(HEADER).c_str();
 
+  if (details || monitoring) {
+    std::string lat_out;
+    PrintOutLatency(lat_out, monitoring);
+    out += lat_out.c_str();
+  }
+
   if (details) {
     // Collect uids and gids inside the lock and the do the translation outside
     // the lock
@@ -1216,6 +1471,7 @@ Stat::Circulate(ThreadAssistant& assistant) noexcept
 #endif
   auto chrononow = std::chrono::system_clock::now();
   auto chronolast = chrononow;
+  time_t last_rotation_min = time(NULL) / 60;
 
   // Empty the circular buffer and extract some Mq statistic values
   while (!assistant.terminationRequested()) {
@@ -1284,9 +1540,16 @@ Stat::Circulate(ThreadAssistant& assistant) noexcept
     l1 = l1tmp;
     l2 = l2tmp;
     l3 = l3tmp;
-    XrdSysMutexHelper lock(mMutex);
     time_t now = time(NULL);
 
+    // Close the one minute interval of the latency histograms
+    if (now / 60 != last_rotation_min) {
+      last_rotation_min = now / 60;
+      RotateExecLatency();
+    }
+
+    XrdSysMutexHelper lock(mMutex);
+
     // loop over tags
     for (auto tit = StatAvgUid.begin(); tit != StatAvgUid.end(); ++tit) {
       // loop over vids
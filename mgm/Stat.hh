@@ -24,9 +24,13 @@
 #pragma once
 #include "mgm/Namespace.hh"
 #include "common/AssistedThread.hh"
+#include "common/LatencyHistogram.hh"
 #include <XrdOuc/XrdOucString.hh>
 #include <XrdSys/XrdSysPthread.hh>
 #include <google/sparse_hash_map>
+#include <array>
+#include <memory>
+#include <shared_mutex>
 #include <vector>
 #include <map>
 #include <string>
@@ -34,8 +38,25 @@
 #include <math.h>
 #include <sys/time.h>
 
+namespace eos::common
+{
+struct VirtualIdentity;
+}
+
 EOSMGMNAMESPACE_BEGIN
 
+//------------------------------------------------------------------------------
+//! Type of client issuing a request, used to split the latency histograms
+//------------------------------------------------------------------------------
+enum class StatClient : uint8_t {
+  kXrootd = 0,
+  kFuse   = 1,
+  kHttp   = 2,
+  kGrpc   = 3
+};
+
+static constexpr size_t kStatClientCount = 4;
+
 class StatAvg
 {
 public:
@@ -511,6 +532,14 @@ public:
   google::sparse_hash_map<std::string, std::deque<float> > StatExec;
   google::sparse_hash_map<std::string, double> CumulativeTimeExec;
 
+  //! Latency histograms per command tag and client type, the per minute
+  //! intervals are used to provide the 1m, 5m and 1h windows
+  using ExecHistos =
+    std::array<std::unique_ptr<eos::common::WindowedLatencyHistogram>,
+    kStatClientCount>;
+  std::map<std::string, ExecHistos, std::less<>> mExecHistos;
+  mutable std::shared_mutex mExecHistosMutex;
+
   void Add(const char* tag, uid_t uid, gid_t gid, unsigned long val);
 
   void AddExt(const char* tag, uid_t uid, gid_t gid, unsigned long nsample,
@@ -518,6 +547,45 @@ public:
 
   void AddExec(const char* tag, float exectime);
 
+  //----------------------------------------------------------------------------
+  //! Record the execution time for the given tag in the latency histogram of
+  //! the client type associated with the current thread
+  //!
+  //! @param tag command tag
+  //! @param exectime execution time in milliseconds
+  //----------------------------------------------------------------------------
+  void AddExecLatency(const char* tag, float exectime);
+
+  //----------------------------------------------------------------------------
+  //! Close the current interval of all the latency histograms, called once
+  //! per minute by the circulate thread
+  //----------------------------------------------------------------------------
+  void RotateExecLatency();
+
+  //----------------------------------------------------------------------------
+  //! Classify the client type based on the given virtual identity
+  //----------------------------------------------------------------------------
+  static StatClient GetClientType(const eos::common::VirtualIdentity& vid);
+
+  //----------------------------------------------------------------------------
+  //! Convert client type to string
+  //----------------------------------------------------------------------------
+  static const char* ClientTypeToString(StatClient client);
+
+  //----------------------------------------------------------------------------
+  //! Set/get the client type associated with the requests handled by the
+  //! current thread
+  //----------------------------------------------------------------------------
+  static void SetThreadClient(StatClient client)
+  {
+    tlClient = client;
+  }
+
+  static StatClient GetThreadClient()
+  {
+    return tlClient;
+  }
+
   // warning: you have to lock the mutex if directly used
   unsigned long long GetTotal(const char* tag);
   double GetCumulativeExecTime(const char* tag);
@@ -573,9 +641,28 @@ public:
   void PrintOutTotal(XrdOucString& out, bool details = false,
                      bool monitoring = false, bool numerical = false);
 
+  //----------------------------------------------------------------------------
+  //! Print latency quantiles per command and client type over the 1m, 5m
+  //! and 1h windows
+  //!
+  //! @param out output string
+  //! @param monitoring if true use the monitoring key=value format
+  //----------------------------------------------------------------------------
+  void PrintOutLatency(std::string& out, bool monitoring) const;
+
+  //----------------------------------------------------------------------------
+  //! Print latency quantiles in the Prometheus text exposition format
+  //!
+  //! @param out output string
+  //----------------------------------------------------------------------------
+  void PrintOutPrometheus(std::string& out) const;
+
   void Circulate(ThreadAssistant& assistant) noexcept;
 
   ~Stat() = default;
+
+private:
+  static thread_local StatClient tlClient; ///< Client type of current thread
 };
 
 EOSMGMNAMESPACE_END
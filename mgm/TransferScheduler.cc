@@ -0,0 +1,541 @@
+//------------------------------------------------------------------------------
+// File: TransferScheduler.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/TransferScheduler.hh"
+#include "mgm/FsView.hh"
+#include "common/StringUtils.hh"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Get the priority class for the given application tag
+//------------------------------------------------------------------------------
+TransferScheduler::Priority
+TransferScheduler::GetPriority(const std::string& app_tag)
+{
+  std::string tag = app_tag;
+  std::transform(tag.begin(), tag.end(), tag.begin(), ::tolower);
+
+  if (tag.find("fsck") != std::string::npos) {
+    return Priority::Fsck;
+  } else if (tag.find("balanc") != std::string::npos) {
+    return Priority::Balance;
+  } else if ((tag.find("drain") != std::string::npos) ||
+             (tag.find("stripe") != std::string::npos)) {
+    return Priority::Drain;
+  }
+
+  return Priority::Conversion;
+}
+
+//------------------------------------------------------------------------------
+// Get string representation of the priority class
+//------------------------------------------------------------------------------
+std::string
+TransferScheduler::PriorityToString(Priority prio)
+{
+  switch (prio) {
+  case Priority::Fsck:
+    return "fsck";
+
+  case Priority::Drain:
+    return "drain";
+
+  case Priority::Conversion:
+    return "conversion";
+
+  case Priority::Balance:
+    return "balance";
+  }
+
+  return "unknown";
+}
+
+//------------------------------------------------------------------------------
+// Start thread refreshing the file system information
+//------------------------------------------------------------------------------
+void
+TransferScheduler::Start()
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStopped = false;
+  }
+  mRefreshThread.reset(&TransferScheduler::RefreshFsInfo, this);
+}
+
+//------------------------------------------------------------------------------
+// Stop the refresh thread and wake up all the pending requests
+//------------------------------------------------------------------------------
+void
+TransferScheduler::Stop()
+{
+  mRefreshThread.join();
+  std::unique_lock<std::mutex> lock(mMutex);
+  mStopped = true;
+
+  for (auto& spaces : mQueues) {
+    for (auto& elem : spaces) {
+      for (auto* waiter : elem.second) {
+        waiter->mCv.notify_one();
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Acquire a transfer slot
+//------------------------------------------------------------------------------
+std::unique_ptr<TransferScheduler::Slot>
+TransferScheduler::Acquire(const Request& req,
+                           const std::function<bool()>& cancel)
+{
+  Waiter waiter;
+  waiter.mRequest = req;
+  auto& fsids = waiter.mRequest.mFsids;
+  fsids.erase(std::remove(fsids.begin(), fsids.end(), 0u), fsids.end());
+  std::sort(fsids.begin(), fsids.end());
+  fsids.erase(std::unique(fsids.begin(), fsids.end()), fsids.end());
+  const size_t prio = static_cast<size_t>(req.mPriority);
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (mStopped) {
+    return nullptr;
+  }
+
+  if (waiter.mRequest.mSpace.empty()) {
+    waiter.mRequest.mSpace = "default";
+
+    if (!fsids.empty()) {
+      auto it = mFsInfo.find(fsids.front());
+
+      if ((it != mFsInfo.end()) && !it->second.mSpace.empty()) {
+        waiter.mRequest.mSpace = it->second.mSpace;
+      }
+    }
+  }
+
+  mQueues[prio][waiter.mRequest.mSpace].push_back(&waiter);
+  ++mNumQueued[prio];
+  Dispatch();
+
+  // Waiters are woken up when granted, when the scheduler stops or when they
+  // need to dispatch the requests blocked on bandwidth
+  while (!waiter.mGranted) {
+    if (mStopped || (cancel && cancel())) {
+      auto it_space = mQueues[prio].find(waiter.mRequest.mSpace);
+
+      if (it_space != mQueues[prio].end()) {
+        auto& queue = it_space->second;
+        queue.erase(std::remove(queue.begin(), queue.end(), &waiter), queue.end());
+
+        if (queue.empty()) {
+          mQueues[prio].erase(it_space);
+        }
+      }
+
+      --mNumQueued[prio];
+      return nullptr;
+    }
+
+    auto deadline = mNextRefill;
+
+    if (cancel) {
+      deadline = std::min(deadline, std::chrono::steady_clock::now() +
+                          kCancelCheckInterval);
+    }
+
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+      waiter.mCv.wait(lock);
+    } else {
+      waiter.mCv.wait_until(lock, deadline);
+    }
+
+    if (!waiter.mGranted && (std::chrono::steady_clock::now() >= mNextRefill)) {
+      Dispatch();
+    }
+  }
+
+  return std::make_unique<Slot>(this, waiter.mRequest);
+}
+
+//------------------------------------------------------------------------------
+// Release the resources held by a granted request
+//------------------------------------------------------------------------------
+void
+TransferScheduler::Release(const Request& req)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (const auto fsid : req.mFsids) {
+    auto it_state = mFsState.find(fsid);
+
+    if ((it_state != mFsState.end()) && it_state->second.mRunning) {
+      --it_state->second.mRunning;
+    }
+
+    auto it_info = mFsInfo.find(fsid);
+
+    if ((it_info != mFsInfo.end()) && !it_info->second.mNode.empty()) {
+      auto it_node = mNodeRunning.find(it_info->second.mNode);
+
+      if (it_node != mNodeRunning.end()) {
+        if (--it_node->second == 0) {
+          mNodeRunning.erase(it_node);
+        }
+      }
+    }
+  }
+
+  --mNumRunning[static_cast<size_t>(req.mPriority)];
+  Dispatch();
+}
+
+//------------------------------------------------------------------------------
+// Grant as many queued requests as possible
+//------------------------------------------------------------------------------
+void
+TransferScheduler::Dispatch()
+{
+  const auto prev_refill = mNextRefill;
+  mNextRefill = std::chrono::steady_clock::time_point::max();
+  bool granted = true;
+
+  while (granted) {
+    granted = false;
+
+    for (size_t prio = 0; (prio < kNumPriorities) && !granted; ++prio) {
+      auto& spaces = mQueues[prio];
+
+      if (spaces.empty()) {
+        continue;
+      }
+
+      // Round-robin over the spaces starting after the last one served
+      auto it_space = spaces.upper_bound(mLastSpace[prio]);
+      const size_t num_spaces = spaces.size();
+
+      for (size_t n = 0; (n < num_spaces) && !granted; ++n) {
+        if (it_space == spaces.end()) {
+          it_space = spaces.begin();
+        }
+
+        auto& queue = it_space->second;
+        size_t look_ahead = 0;
+
+        for (auto it = queue.begin(); (it != queue.end()) &&
+             (look_ahead < kMaxLookAhead); ++it, ++look_ahead) {
+          if (!CanRun((*it)->mRequest)) {
+            continue;
+          }
+
+          Waiter* waiter = *it;
+          queue.erase(it);
+          const Request& req = waiter->mRequest;
+
+          for (const auto fsid : req.mFsids) {
+            auto& state = mFsState[fsid];
+            ++state.mRunning;
+            auto it_info = mFsInfo.find(fsid);
+
+            if (it_info != mFsInfo.end()) {
+              if (it_info->second.mRate) {
+                state.mTokens -= req.mSize;
+              }
+
+              if (!it_info->second.mNode.empty()) {
+                ++mNodeRunning[it_info->second.mNode];
+              }
+            }
+          }
+
+          --mNumQueued[prio];
+          ++mNumRunning[prio];
+          ++mNumGranted[prio];
+          mLastSpace[prio] = it_space->first;
+
+          if (queue.empty()) {
+            spaces.erase(it_space);
+          }
+
+          waiter->mGranted = true;
+          waiter->mCv.notify_one();
+          granted = true;
+          break;
+        }
+
+        if (!granted) {
+          ++it_space;
+        }
+      }
+    }
+  }
+
+  // Make sure one of the waiters dispatches again once the bandwidth tokens
+  // are refilled
+  if ((mNextRefill < prev_refill) ||
+      ((mNextRefill != std::chrono::steady_clock::time_point::max()) &&
+       (prev_refill <= std::chrono::steady_clock::now()))) {
+    for (const auto& spaces : mQueues) {
+      if (!spaces.empty()) {
+        spaces.begin()->second.front()->mCv.notify_one();
+        break;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Check if the given request can run now
+//------------------------------------------------------------------------------
+bool
+TransferScheduler::CanRun(const Request& req)
+{
+  static const FsInfo s_default_info;
+  const auto now = std::chrono::steady_clock::now();
+
+  for (const auto fsid : req.mFsids) {
+    auto it_info = mFsInfo.find(fsid);
+    const FsInfo& info = ((it_info != mFsInfo.end()) ? it_info->second :
+                          s_default_info);
+    auto& state = mFsState[fsid];
+
+    if (state.mRunning >= GetEffectiveMaxTx(info)) {
+      return false;
+    }
+
+    if (info.mRate) {
+      // Token bucket with a burst of one second worth of bandwidth
+      if (state.mLastRefill == std::chrono::steady_clock::time_point()) {
+        state.mTokens = info.mRate;
+      } else {
+        const double elapsed = std::chrono::duration<double>
+                               (now - state.mLastRefill).count();
+        state.mTokens = std::min((double)info.mRate,
+                                 state.mTokens + elapsed * info.mRate);
+      }
+
+      state.mLastRefill = now;
+
+      // Transfers are charged upfront so the budget can be in debt
+      if (state.mTokens <= 0) {
+        const auto refill = now + std::chrono::duration_cast
+                            <std::chrono::steady_clock::duration>
+                            (std::chrono::duration<double>
+                             ((1.0 - state.mTokens) / info.mRate));
+        mNextRefill = std::min(mNextRefill, refill);
+        return false;
+      }
+    }
+
+    if (info.mNodeMaxTx && !info.mNode.empty()) {
+      auto it_node = mNodeRunning.find(info.mNode);
+
+      if ((it_node != mNodeRunning.end()) &&
+          (it_node->second >= info.mNodeMaxTx)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get max number of concurrent transfers allowed on a file system
+//------------------------------------------------------------------------------
+uint32_t
+TransferScheduler::GetEffectiveMaxTx(const FsInfo& info)
+{
+  if (info.mMaxTx == 0) {
+    return UINT32_MAX;
+  }
+
+  if ((info.mMaxLoad <= 0) || (info.mLoad <= 0)) {
+    return info.mMaxTx;
+  }
+
+  if (info.mLoad >= info.mMaxLoad) {
+    return 1;
+  }
+
+  // Scale down linearly with the disk utilisation but always allow one
+  double max_tx = std::ceil(info.mMaxTx * (1.0 - info.mLoad / info.mMaxLoad));
+  return std::max(1u, (uint32_t)max_tx);
+}
+
+//------------------------------------------------------------------------------
+// Update the file system information used for scheduling
+//------------------------------------------------------------------------------
+void
+TransferScheduler::UpdateFsInfo(std::map<fsid_t, FsInfo>&& fs_info)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  // Keep the node counters consistent for the running transfers if a file
+  // system moved to a different node
+  std::map<std::string, uint32_t> node_running;
+
+  for (const auto& elem : mFsState) {
+    if (elem.second.mRunning == 0) {
+      continue;
+    }
+
+    auto it_info = fs_info.find(elem.first);
+
+    if ((it_info == fs_info.end()) || it_info->second.mNode.empty()) {
+      it_info = mFsInfo.find(elem.first);
+
+      if ((it_info == mFsInfo.end()) || it_info->second.mNode.empty()) {
+        continue;
+      }
+
+      fs_info[elem.first] = it_info->second;
+    }
+
+    node_running[it_info->second.mNode] += elem.second.mRunning;
+  }
+
+  mFsInfo = std::move(fs_info);
+  mNodeRunning = std::move(node_running);
+  Dispatch();
+}
+
+//------------------------------------------------------------------------------
+// Get number of queued requests for the given priority
+//------------------------------------------------------------------------------
+uint64_t
+TransferScheduler::GetNumQueued(Priority prio) const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mNumQueued[static_cast<size_t>(prio)];
+}
+
+//------------------------------------------------------------------------------
+// Get number of running transfers for the given priority
+//------------------------------------------------------------------------------
+uint64_t
+TransferScheduler::GetNumRunning(Priority prio) const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mNumRunning[static_cast<size_t>(prio)];
+}
+
+//------------------------------------------------------------------------------
+// Get number of running transfers on the given file system
+//------------------------------------------------------------------------------
+uint32_t
+TransferScheduler::GetNumRunningOnFs(fsid_t fsid) const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  auto it = mFsState.find(fsid);
+  return ((it != mFsState.end()) ? it->second.mRunning : 0);
+}
+
+//------------------------------------------------------------------------------
+// Print scheduler summary
+//------------------------------------------------------------------------------
+void
+TransferScheduler::PrintOut(std::string& out, bool monitoring) const
+{
+  std::ostringstream oss;
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  for (size_t prio = 0; prio < kNumPriorities; ++prio) {
+    const std::string sprio = PriorityToString(static_cast<Priority>(prio));
+
+    if (monitoring) {
+      oss << "uid=all gid=all transfer.prio=" << sprio
+          << " transfer.queued=" << mNumQueued[prio]
+          << " transfer.running=" << mNumRunning[prio]
+          << " transfer.granted=" << mNumGranted[prio] << std::endl;
+    } else {
+      oss << "ALL      transfer " << std::left << std::setw(23) << sprio
+          << "queued=" << mNumQueued[prio] << " running=" << mNumRunning[prio]
+          << " granted=" << mNumGranted[prio] << std::endl;
+    }
+  }
+
+  out += oss.str();
+}
+
+//------------------------------------------------------------------------------
+// Refresh the file system information from the FsView
+//------------------------------------------------------------------------------
+void
+TransferScheduler::RefreshFsInfo(ThreadAssistant& assistant) noexcept
+{
+  ThreadAssistant::setSelfThreadName("TransferSched");
+  eos_static_info("%s", "msg=\"started transfer scheduler refresh thread\"");
+  // Helper to read a numeric space config value
+  auto get_config = [](FsSpace * space, const std::string & key,
+  auto & value) {
+    const std::string svalue = space->GetConfigMember(key);
+
+    if (!svalue.empty()) {
+      (void) eos::common::StringToNumeric(svalue, value, value);
+    }
+  };
+
+  while (!assistant.terminationRequested()) {
+    std::map<fsid_t, FsInfo> fs_info;
+    {
+      eos::common::RWMutexReadLock fs_rd_lock(FsView::gFsView.ViewMutex);
+
+      for (const auto& space_elem : FsView::gFsView.mSpaceView) {
+        FsInfo space_info;
+        uint64_t rate_mb = 0ull;
+        get_config(space_elem.second, "transfer.fs.ntx", space_info.mMaxTx);
+        get_config(space_elem.second, "transfer.node.ntx",
+                   space_info.mNodeMaxTx);
+        get_config(space_elem.second, "transfer.fs.rate", rate_mb);
+        get_config(space_elem.second, "transfer.fs.maxload",
+                   space_info.mMaxLoad);
+        space_info.mRate = rate_mb * 1024 * 1024;
+        space_info.mSpace = space_elem.first;
+
+        for (auto it_grp = space_elem.second->begin();
+             it_grp != space_elem.second->end(); ++it_grp) {
+          FileSystem* fs = FsView::gFsView.mIdView.lookupByID(*it_grp);
+
+          if (fs == nullptr) {
+            continue;
+          }
+
+          FsInfo info = space_info;
+          info.mNode = fs->GetQueue();
+          info.mLoad = fs->GetDouble("stat.disk.load");
+          fs_info.emplace(fs->GetId(), std::move(info));
+        }
+      }
+    }
+    UpdateFsInfo(std::move(fs_info));
+    assistant.wait_for(std::chrono::seconds(10));
+  }
+
+  eos_static_info("%s", "msg=\"stopped transfer scheduler refresh thread\"");
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,261 @@
+//------------------------------------------------------------------------------
+// File: TransferScheduler.hh
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "mgm/Namespace.hh"
+#include "common/AssistedThread.hh"
+#include "common/FileSystem.hh"
+#include "common/Logging.hh"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+EOSMGMNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! @brief Central admission control for the background transfers done by the
+//! drain, balancer, converter and fsck subsystems.
+//!
+//! Every transfer acquires a slot before running the third-party copy. A slot
+//! consumes one concurrency token on each file system and node involved and
+//! the size of the transfer from the bandwidth budget of each file system.
+//! Pending requests are served by priority (fsck > drain > conversion >
+//! balance) and round-robin across spaces within the same priority. The
+//! scheduler is work conserving i.e. a lower priority request can run if all
+//! the higher priority ones are blocked on other resources. The number of
+//! concurrent transfers on a file system is reduced as its disk utilisation
+//! grows so that busy disks get less background traffic.
+//------------------------------------------------------------------------------
+class TransferScheduler: public eos::common::LogId
+{
+public:
+  using fsid_t = eos::common::FileSystem::fsid_t;
+
+  //! Transfer priority classes, lower value means higher priority
+  enum class Priority : uint8_t {Fsck = 0, Drain = 1, Conversion = 2,
+                                 Balance = 3
+                                };
+  static constexpr size_t kNumPriorities = 4;
+  //! Max number of queued requests inspected per space when looking for a
+  //! request that can run - avoids head-of-line blocking on busy disks
+  static constexpr size_t kMaxLookAhead = 64;
+  //! Interval at which a waiting request checks if it was cancelled
+  static constexpr std::chrono::milliseconds kCancelCheckInterval {1000};
+
+  //----------------------------------------------------------------------------
+  //! File system information used for scheduling
+  //----------------------------------------------------------------------------
+  struct FsInfo {
+    std::string mNode; ///< Node hosting the file system
+    std::string mSpace; ///< Space the file system belongs to
+    double mLoad {0.0}; ///< Disk utilisation in the range [0, 1]
+    uint32_t mMaxTx {0}; ///< Max concurrent transfers per fs, 0 no limit
+    uint32_t mNodeMaxTx {0}; ///< Max concurrent transfers per node, 0 no limit
+    uint64_t mRate {0ull}; ///< Bandwidth per file system in bytes/s, 0 no limit
+    double mMaxLoad {0.9}; ///< Utilisation above which only one tx is allowed
+  };
+
+  //----------------------------------------------------------------------------
+  //! Transfer request
+  //----------------------------------------------------------------------------
+  struct Request {
+    Priority mPriority {Priority::Balance};
+    std::string mSpace; ///< If empty, the space of the first file system
+    std::vector<fsid_t> mFsids; ///< Source and destination file systems
+    uint64_t mSize {0ull}; ///< Size of the transfer in bytes
+  };
+
+  //----------------------------------------------------------------------------
+  //! Slot granted to a transfer, the resources are released when the object
+  //! is destroyed
+  //----------------------------------------------------------------------------
+  class Slot
+  {
+  public:
+    Slot(TransferScheduler* scheduler, const Request& req):
+      mScheduler(scheduler), mRequest(req)
+    {}
+
+    ~Slot()
+    {
+      mScheduler->Release(mRequest);
+    }
+
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+  private:
+    TransferScheduler* mScheduler;
+    Request mRequest;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get the priority class for the given application tag
+  //!
+  //! @param app_tag application tag of the transfer e.g. drain, fsck
+  //----------------------------------------------------------------------------
+  static Priority GetPriority(const std::string& app_tag);
+
+  //----------------------------------------------------------------------------
+  //! Get string representation of the priority class
+  //----------------------------------------------------------------------------
+  static std::string PriorityToString(Priority prio);
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  TransferScheduler() = default;
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~TransferScheduler()
+  {
+    Stop();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Start thread refreshing the file system information from the FsView
+  //----------------------------------------------------------------------------
+  void Start();
+
+  //----------------------------------------------------------------------------
+  //! Stop the refresh thread and wake up all the pending requests which
+  //! will fail to acquire a slot
+  //----------------------------------------------------------------------------
+  void Stop();
+
+  //----------------------------------------------------------------------------
+  //! Acquire a transfer slot, blocking until the request can run
+  //!
+  //! @param req transfer request
+  //! @param cancel optional function checked regularly while waiting, if it
+  //!        returns true then the acquisition is abandoned
+  //!
+  //! @return slot object or nullptr if cancelled or scheduler stopped
+  //----------------------------------------------------------------------------
+  std::unique_ptr<Slot> Acquire(const Request& req,
+                                const std::function<bool()>& cancel = nullptr);
+
+  //----------------------------------------------------------------------------
+  //! Update the file system information used for scheduling
+  //!
+  //! @param fs_info map of file system id to info
+  //----------------------------------------------------------------------------
+  void UpdateFsInfo(std::map<fsid_t, FsInfo>&& fs_info);
+
+  //----------------------------------------------------------------------------
+  //! Get number of queued requests for the given priority
+  //----------------------------------------------------------------------------
+  uint64_t GetNumQueued(Priority prio) const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of running transfers for the given priority
+  //----------------------------------------------------------------------------
+  uint64_t GetNumRunning(Priority prio) const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of running transfers on the given file system
+  //----------------------------------------------------------------------------
+  uint32_t GetNumRunningOnFs(fsid_t fsid) const;
+
+  //----------------------------------------------------------------------------
+  //! Print scheduler summary
+  //!
+  //! @param out output string
+  //! @param monitoring if true then print in monitoring format
+  //----------------------------------------------------------------------------
+  void PrintOut(std::string& out, bool monitoring) const;
+
+private:
+  //! Request waiting for a slot
+  struct Waiter {
+    Request mRequest;
+    bool mGranted {false};
+    std::condition_variable mCv;
+  };
+
+  //! Run time state of a file system
+  struct FsState {
+    uint32_t mRunning {0};
+    double mTokens {0.0}; ///< Available bandwidth tokens in bytes
+    std::chrono::steady_clock::time_point mLastRefill;
+  };
+
+  mutable std::mutex mMutex; ///< Mutex protecting the members below
+  bool mStopped {false};
+  std::map<fsid_t, FsInfo> mFsInfo;
+  std::map<fsid_t, FsState> mFsState;
+  std::map<std::string, uint32_t> mNodeRunning;
+  //! Queues of waiters per priority and space
+  std::array<std::map<std::string, std::deque<Waiter*>>, kNumPriorities>
+  mQueues;
+  //! Last space served per priority used for the round-robin
+  std::array<std::string, kNumPriorities> mLastSpace;
+  std::array<uint64_t, kNumPriorities> mNumQueued {};
+  std::array<uint64_t, kNumPriorities> mNumRunning {};
+  std::array<uint64_t, kNumPriorities> mNumGranted {};
+  //! Earliest time at which a request blocked on bandwidth can run again
+  std::chrono::steady_clock::time_point mNextRefill {
+    std::chrono::steady_clock::time_point::max()};
+  AssistedThread mRefreshThread; ///< Thread refreshing the fs info
+
+  //----------------------------------------------------------------------------
+  //! Release the resources held by a granted request
+  //----------------------------------------------------------------------------
+  void Release(const Request& req);
+
+  //----------------------------------------------------------------------------
+  //! Grant as many queued requests as possible and wake them up. If some
+  //! requests are blocked on bandwidth then one waiter is woken up to
+  //! dispatch again once the tokens are refilled. mMutex must be held.
+  //----------------------------------------------------------------------------
+  void Dispatch();
+
+  //----------------------------------------------------------------------------
+  //! Check if the given request can run now, mMutex must be held
+  //----------------------------------------------------------------------------
+  bool CanRun(const Request& req);
+
+  //----------------------------------------------------------------------------
+  //! Get max number of concurrent transfers allowed on a file system given
+  //! its current utilisation
+  //----------------------------------------------------------------------------
+  static uint32_t GetEffectiveMaxTx(const FsInfo& info);
+
+  //----------------------------------------------------------------------------
+  //! Refresh the file system information from the FsView
+  //!
+  //! @param assistant thread doing the job
+  //----------------------------------------------------------------------------
+  void RefreshFsInfo(ThreadAssistant& assistant) noexcept;
+};
+
+EOSMGMNAMESPACE_END
@@ -37,6 +37,8 @@ bool
 Vid::Set(const char* value, bool storeConfig)
 {
   eos::common::RWMutexWriteLock lock(eos::common::Mapping::gMapMutex);
+  // invalidate the identities cached with the current rules
+  ++eos::common::Mapping::gMapGeneration;
   XrdOucEnv env(value);
   XrdOucString skey = env.Get("mgm.vid.key");
   XrdOucString svalue = value;
@@ -385,6 +387,7 @@ Vid::Rm(XrdOucEnv& env,
         bool storeConfig)
 {
   eos::common::RWMutexWriteLock lock(eos::common::Mapping::gMapMutex);
+  ++eos::common::Mapping::gMapGeneration;
   XrdOucString skey = env.Get("mgm.vid.key");
   XrdOucString vidcmd = env.Get("mgm.vid.cmd");
   int envlen = 0;
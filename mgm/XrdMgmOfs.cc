@@ -80,6 +80,7 @@
 #include "mgm/fsck/Fsck.hh"
 #include "mgm/IMaster.hh"
 #include "mgm/convert/ConverterDriver.hh"
+#include "mgm/TransferScheduler.hh"
 #include "mgm/FuseServer/FusexCastBatch.hh"
 #include "mgm/tgc/RealTapeGcMgm.hh"
 #include "mgm/tgc/MultiSpaceTapeGc.hh"
@@ -462,6 +463,11 @@ XrdMgmOfs::OrderlyShutdown()
     delete mZmqContext;
   }
 
+  if (mTransferScheduler) {
+    eos_warning("%s", "msg=\"stopping transfer scheduler\"");
+    mTransferScheduler->Stop();
+  }
+
   eos_warning("%s", "msg=\"stopping converter engine\"");
   mConverterDriver->Stop();
   eos_warning("%s", "msg=\"stopping central drainning\"");
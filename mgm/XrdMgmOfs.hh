@@ -123,6 +123,7 @@
 #include "namespace/locking/NSObjectLocker.hh"
 #include "namespace/locking/BulkNsObjectLocker.hh"
 #include "mgm/InFlightTracker.hh"
+#include "mgm/NegativeLookupCache.hh"
 #include "mgm/namespacestats/NamespaceStats.hh"
 #include <XrdAcc/XrdAccPrivs.hh>
 #include <google/sparse_hash_map>
@@ -180,6 +181,7 @@ class CommitHelper;
 class ReplicationTracker;
 class ConversionJob;
 class ConverterDriver;
+class TransferScheduler;
 }
 
 namespace eos::mgm::tgc
@@ -766,6 +768,36 @@ public:
   // ---------------------------------------------------------------------------
   void _stat_set_flags(struct stat* buf);
 
+  // ---------------------------------------------------------------------------
+  //! Check if the given path is known to be missing using the negative lookup
+  //! cache. Resolves the parent container, which the path walk of the
+  //! prefetch already brought into the cache, so that a known missing entry
+  //! is answered before any lookup of the path itself.
+  //!
+  //! @param cPath normalized path
+  //! @param parent set to the parent container if it exists and the cache is
+  //!        enabled
+  //! @param version set to the version of parent, to be used if the lookup
+  //!        which follows fails
+  //!
+  //! @return true if the path is known to be missing
+  // ---------------------------------------------------------------------------
+  bool _is_known_missing(eos::common::Path& cPath,
+                         std::shared_ptr<eos::IContainerMD>& parent,
+                         eos::mgm::NegativeLookupCache::Version& version);
+
+  // ---------------------------------------------------------------------------
+  //! Record the given path as missing in the negative lookup cache, if it is
+  //! indeed absent from its parent
+  //!
+  //! @param cPath normalized path
+  //! @param parent parent container as given by _is_known_missing
+  //! @param version version of parent as given by _is_known_missing
+  // ---------------------------------------------------------------------------
+  void _add_known_missing(eos::common::Path& cPath,
+                          const std::shared_ptr<eos::IContainerMD>& parent,
+                          const eos::mgm::NegativeLookupCache::Version& version);
+
   // ---------------------------------------------------------------------------
   // stat file to retrieve mode
   // ---------------------------------------------------------------------------
@@ -2053,6 +2085,8 @@ public:
   std::unique_ptr<eos::mq::MessagingRealm> mMessagingRealm;
   Drainer mDrainEngine; ///< Centralized draining
   std::unique_ptr<ConverterDriver> mConverterDriver; ///< Converter driver
+  //! Admission control for drain/balance/conversion/fsck transfers
+  std::unique_ptr<TransferScheduler> mTransferScheduler;
   std::unique_ptr<HttpServer> mHttpd; ///<  Http daemon if available
 
   std::unique_ptr<GrpcServer> GRPCd; ///< GRPC server
@@ -2088,6 +2122,7 @@ public:
   std::string mQClientDir; ///<QClient metadata directory
   std::string mQClientFlusherType; ///<QClient flusher type
   std::string mQClientRocksDBOptions; ///<QClient specific rocksdb options
+  std::string mQClientFlusherCoalesceMs; ///<QClient MD flusher coalescing window
   int mHttpdPort; ///< port of the http server, default 8000
   int mFusexPort; ///< port of the FUSEX broadcast MQZ, default 1100
   int mGRPCPort; ///< port of the GRPC server, default 50051
@@ -2096,6 +2131,8 @@ public:
   eos::common::XrdConnPool mXrdConnPool; ///< XRD connection pool
   //! Tracker for requests which are currently executing MGM code
   eos::mgm::InFlightTracker mTracker;
+  //! Names known not to exist, for stat and exists requests
+  eos::mgm::NegativeLookupCache mNegativeLookupCache;
   //! The tape-aware garbage collector's interface to the EOS MGM
   std::unique_ptr<tgc::RealTapeGcMgm> mTapeGcMgm;
   //! Multi-space tape-aware garbage collector
@@ -105,21 +105,32 @@ XrdMgmOfs::_exists(const char* path,
   EXEC_TIMING_BEGIN("Exists");
   gOFS->MgmStats.Add("Exists", vid.uid, vid.gid, 1);
   std::shared_ptr<eos::IContainerMD> cmd;
+  eos::common::Path lookupPath(path);
+  std::shared_ptr<eos::IContainerMD> lookup_parent;
+  eos::mgm::NegativeLookupCache::Version lookup_version;
+  bool known_missing = false;
   {
     // -------------------------------------------------------------------------
     eos::Prefetcher::prefetchContainerMDAndWait(gOFS->eosView, path, false);
+    // Repeated probes of a missing entry are answered from its parent only
+    known_missing = _is_known_missing(lookupPath, lookup_parent,
+                                      lookup_version);
 
-    try {
-      cmd = gOFS->eosView->getContainer(path, false);
-    } catch (eos::MDException& e) {
-      eos_debug("msg=\"exception\" ec=%d emsg=\"%s\"\n",
-                e.getErrno(), e.getMessage().str().c_str());
-    };
+    if (!known_missing) {
+      try {
+        cmd = gOFS->eosView->getContainer(path, false);
+      } catch (eos::MDException& e) {
+        eos_debug("msg=\"exception\" ec=%d emsg=\"%s\"\n",
+                  e.getErrno(), e.getMessage().str().c_str());
+      };
+    }
 
     // -------------------------------------------------------------------------
   }
 
-  if (!cmd) {
+  if (known_missing) {
+    file_exists = XrdSfsFileExistNo;
+  } else if (!cmd) {
     // -------------------------------------------------------------------------
     // try if that is a file
     // -------------------------------------------------------------------------
@@ -136,6 +147,7 @@ XrdMgmOfs::_exists(const char* path,
     // -------------------------------------------------------------------------
     if (!fmd) {
       file_exists = XrdSfsFileExistNo;
+      _add_known_missing(lookupPath, lookup_parent, lookup_version);
     } else {
       file_exists = XrdSfsFileExistIsFile;
     }
@@ -228,11 +240,23 @@ XrdMgmOfs::_exists(const char* path,
 {
   EXEC_TIMING_BEGIN("Exists");
   gOFS->MgmStats.Add("Exists", vid.uid, vid.gid, 1);
+  eos::common::Path lookupPath(path);
+  std::shared_ptr<eos::IContainerMD> lookup_parent;
+  eos::mgm::NegativeLookupCache::Version lookup_version;
   // try if that is directory
   {
     // -------------------------------------------------------------------------
     eos::Prefetcher::prefetchContainerMDAndWait(gOFS->eosView, path, false);
 
+    // Repeated probes of a missing entry are answered from its parent only
+    if (_is_known_missing(lookupPath, lookup_parent, lookup_version)) {
+      cmd.reset();
+      fmd.reset();
+      file_exists = XrdSfsFileExistNo;
+      EXEC_TIMING_END("Exists");
+      return SFS_OK;
+    }
+
     try {
       cmd = gOFS->eosView->getContainer(path, false);
     } catch (eos::MDException& e) {
@@ -260,6 +284,7 @@ XrdMgmOfs::_exists(const char* path,
 
     if (!fmd) {
       file_exists = XrdSfsFileExistNo;
+      _add_known_missing(lookupPath, lookup_parent, lookup_version);
     } else {
       file_exists = XrdSfsFileExistIsFile;
     }
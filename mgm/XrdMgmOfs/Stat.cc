@@ -199,6 +199,14 @@ XrdMgmOfs::_stat(const char* path,
   // Prefetch path
   eos::Prefetcher::prefetchItemAndWait(gOFS->eosView, cPath.GetPath(), follow);
   eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+  // Repeated probes of a missing entry are answered from its parent only
+  std::shared_ptr<eos::IContainerMD> lookup_parent;
+  eos::mgm::NegativeLookupCache::Version lookup_version;
+
+  if (_is_known_missing(cPath, lookup_parent, lookup_version)) {
+    errno = ENOENT;
+    return Emsg(epname, error, errno, "stat", cPath.GetPath());
+  }
 
   try {
     if (strncmp(cPath.GetPath(), "/.fxid:", 7) == 0) {
@@ -377,10 +385,74 @@ XrdMgmOfs::_stat(const char* path,
     errno = e.getErrno();
     eos_debug("msg=\"exception\" ec=%d emsg=\"%s\"", e.getErrno(),
               e.getMessage().str().c_str());
+
+    if (errno == ENOENT) {
+      _add_known_missing(cPath, lookup_parent, lookup_version);
+      errno = ENOENT;
+    }
+
     return Emsg(epname, error, errno, "stat", cPath.GetPath());
   }
 }
 
+//------------------------------------------------------------------------------
+// Check if the given path is known to be missing
+//------------------------------------------------------------------------------
+bool
+XrdMgmOfs::_is_known_missing(eos::common::Path& cPath,
+                             std::shared_ptr<eos::IContainerMD>& parent,
+                             eos::mgm::NegativeLookupCache::Version& version)
+{
+  parent.reset();
+
+  if (!mNegativeLookupCache.IsEnabled() || (*cPath.GetName() == '\0') ||
+      (strncmp(cPath.GetPath(), "/.fxid:", 7) == 0)) {
+    return false;
+  }
+
+  // Intermediate symlinks are always followed
+  folly::Future<eos::IContainerMDPtr> fut =
+    eosView->getContainerFut(cPath.GetParentPath(), true);
+  fut.wait();
+
+  if (fut.hasException()) {
+    return false;
+  }
+
+  parent = std::move(fut).get();
+  version = eos::mgm::NegativeLookupCache::GetVersion(*parent);
+  return mNegativeLookupCache.IsMissing(parent->getId(), version,
+                                        cPath.GetName());
+}
+
+//------------------------------------------------------------------------------
+// Record the given path as missing
+//------------------------------------------------------------------------------
+void
+XrdMgmOfs::_add_known_missing(eos::common::Path& cPath,
+                              const std::shared_ptr<eos::IContainerMD>& parent,
+                              const eos::mgm::NegativeLookupCache::Version& version)
+{
+  if (!parent) {
+    return;
+  }
+
+  // The lookup might have failed because of a dangling symlink, only cache
+  // names which are really absent. The version was taken before, so an
+  // entry created in the meantime makes this one stale.
+  try {
+    eos::FileOrContainerMD item = parent->findItem(cPath.GetName()).get();
+
+    if (item.file || item.container) {
+      return;
+    }
+  } catch (eos::MDException& e) {
+    return;
+  }
+
+  mNegativeLookupCache.AddMissing(parent->getId(), version, cPath.GetName());
+}
+
 // ---------------------------------------------------------------------------
 //  get the checksum info of a file
 // ---------------------------------------------------------------------------
@@ -52,6 +52,7 @@
 #include "mgm/QdbMaster.hh"
 #include "mgm/Messaging.hh"
 #include "mgm/convert/ConverterDriver.hh"
+#include "mgm/TransferScheduler.hh"
 #include "mgm/tgc/MultiSpaceTapeGc.hh"
 #include "mgm/tracker/ReplicationTracker.hh"
 #include "mgm/inspector/FileInspector.hh"
@@ -659,6 +660,17 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
           }
         }
 
+        if (!strcmp("qclient_flusher_coalesce_ms", var)) {
+          if (!(val = Config.GetWord())) {
+            Eroute.Emsg("Config", "argument for qclient_flusher_coalesce_ms is invalid");
+            NoGo = 1;
+          } else {
+            mQClientFlusherCoalesceMs = val;
+            Eroute.Say("=====> mgmofs.qclient_flusher_coalesce_ms : ",
+                       mQClientFlusherCoalesceMs.c_str());
+          }
+        }
+
         if (!strcmp("authlib", var)) {
           if ((!(val = Config.GetWord())) || (::access(val, R_OK))) {
             Eroute.Emsg("Config", "I cannot access the authorization library!");
@@ -1475,6 +1487,15 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
     Eroute.Say("=====> mgmofs.alias: ", MgmOfsAlias.c_str());
   }
 
+  // Size of the negative lookup cache, 0 disables it
+  if (getenv("EOS_MGM_NEGATIVE_LOOKUP_CACHE")) {
+    mNegativeLookupCache.SetMaxSize(strtoull(
+                                      getenv("EOS_MGM_NEGATIVE_LOOKUP_CACHE"),
+                                      nullptr, 10));
+    Eroute.Say("=====> mgmofs.negative-lookup-cache: ",
+               getenv("EOS_MGM_NEGATIVE_LOOKUP_CACHE"));
+  }
+
   // Build the adler & sha1 checksum of the default keytab file
   const std::string keytab_fn = "/etc/eos.keytab";
   std::string keytab_xs = "unaccessible";
@@ -2294,6 +2315,9 @@ XrdMgmOfs::Configure(XrdSysError& Eroute)
   // if there is no FST sending update
   mGeoTreeEngine->forceRefresh();
   mGeoTreeEngine->StartUpdater();
+  // Start the transfer scheduler shared by drain, balancer, converter and fsck
+  mTransferScheduler.reset(new eos::mgm::TransferScheduler());
+  mTransferScheduler->Start();
   // Start the drain engine
   mDrainEngine.Start();
   // Start the Converter driver
@@ -35,6 +35,8 @@
 #include "namespace/Prefetcher.hh"
 #include "namespace/interface/ContainerIterators.hh"
 #include <XrdOuc/XrdOucEnv.hh>
+#include <algorithm>
+#include <iterator>
 
 #ifdef __APPLE__
 #define ECOMM 70
@@ -169,8 +171,18 @@ XrdMgmOfsDirectory::_open(const char* dir_path,
   XrdOucEnv env(info);
   // Open the directory
   bool permok = false;
-  eos::Prefetcher::prefetchContainerMDWithChildrenAndWait(gOFS->eosView,
-      cPath.GetPath());
+
+  // Callers fetching the children metadata by themselves, e.g. batch by
+  // batch while streaming, skip the prefetching of all the children. The
+  // directory itself is still prefetched so that it is not loaded from the
+  // backend under the namespace lock.
+  if (!env.Get("ls.skip.prefetch")) {
+    eos::Prefetcher::prefetchContainerMDWithChildrenAndWait(gOFS->eosView,
+        cPath.GetPath());
+  } else {
+    eos::Prefetcher::prefetchContainerMDAndWait(gOFS->eosView, cPath.GetPath());
+  }
+
   //----------------------------------------------------------------------------
   std::shared_ptr<eos::IContainerMD> dh;
   eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
@@ -211,28 +223,50 @@ XrdMgmOfsDirectory::_open(const char* dir_path,
 
       // try to get the listing from the cache
       if (!use_cache || !dirCache.tryGet(cacheentry, dh_list)) {
-        dh_list = std::make_shared<listing_t>();
+        // The children maps are sorted by name, the file and subcontainer
+        // names only need to be merged
+        listing_t files;
+        listing_t dirs;
 
         if (!env.Get("ls.skip.files")) {
           // Collect all file names
+          files.reserve(dh->getNumFiles());
+
           for (auto it = eos::FileMapIterator(dh); it.valid(); it.next()) {
-            dh_list->insert(it.key());
+            files.push_back(it.key());
           }
         }
 
         if (!env.Get("ls.skip.directories")) {
           // Collect all subcontainers
+          dirs.reserve(dh->getNumContainers() + 2);
+
           for (auto it = eos::ContainerMapIterator(dh); it.valid(); it.next()) {
-            dh_list->insert(it.key());
+            dirs.push_back(it.key());
           }
 
-          dh_list->insert(".");
+          listing_t dots {"."};
 
           // The root dir has no .. entry
           if (strcmp(dir_path, "/")) {
-            dh_list->insert("..");
+            dots.push_back("..");
           }
+
+          listing_t tmp;
+          tmp.reserve(dirs.size() + dots.size());
+          std::set_union(std::make_move_iterator(dirs.begin()),
+                         std::make_move_iterator(dirs.end()),
+                         dots.begin(), dots.end(), std::back_inserter(tmp));
+          dirs.swap(tmp);
         }
+
+        dh_list = std::make_shared<listing_t>();
+        dh_list->reserve(files.size() + dirs.size());
+        std::set_union(std::make_move_iterator(files.begin()),
+                       std::make_move_iterator(files.end()),
+                       std::make_move_iterator(dirs.begin()),
+                       std::make_move_iterator(dirs.end()),
+                       std::back_inserter(*dh_list));
       }
 
       dh_it = dh_list->begin();
@@ -32,6 +32,7 @@
 #include <dirent.h>
 #include <string>
 #include <set>
+#include <vector>
 #include <mutex>
 
 //! Forward declaration
@@ -133,7 +134,8 @@ public:
   }
 
 
-  typedef std::set<std::string> listing_t;
+  //! Directory entries sorted by name
+  typedef std::vector<std::string> listing_t;
 
   static eos::common::LRU::Cache<std::string, std::shared_ptr<listing_t>>
       dirCache;
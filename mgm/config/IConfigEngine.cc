@@ -250,6 +250,7 @@ IConfigEngine::ApplyConfig(XrdOucString& err, bool apply_stall_redirect)
   (void) Quota::CleanUp();
   {
     eos::common::RWMutexWriteLock wr_lock(eos::common::Mapping::gMapMutex);
+    ++eos::common::Mapping::gMapGeneration;
     eos::common::Mapping::gUserRoleVector.clear();
     eos::common::Mapping::gGroupRoleVector.clear();
     eos::common::Mapping::gVirtualUidMap.clear();
@@ -438,6 +439,7 @@ IConfigEngine::ResetConfig(bool apply_stall_redirect)
   (void) Quota::CleanUp();
   {
     eos::common::RWMutexWriteLock wr_lock(eos::common::Mapping::gMapMutex);
+    ++eos::common::Mapping::gMapGeneration;
     eos::common::Mapping::gUserRoleVector.clear();
     eos::common::Mapping::gGroupRoleVector.clear();
     eos::common::Mapping::gVirtualUidMap.clear();
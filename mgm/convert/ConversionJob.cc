@@ -25,6 +25,7 @@
 #include "mgm/Stat.hh"
 #include "mgm/Quota.hh"
 #include "mgm/FsView.hh"
+#include "mgm/TransferScheduler.hh"
 #include "mgm/tgc/MultiSpaceTapeGc.hh"
 #include "common/Constants.hh"
 #include "common/Timing.hh"
@@ -214,7 +215,34 @@ void ConversionJob::DoIt() noexcept
   }
 
   dst_cgi << exclude_fsids;
-  // Prepare the TPC job
+  // Wait for a transfer slot on the source file systems, the destination is
+  // only selected when the TPC destination is opened
+  std::unique_ptr<TransferScheduler::Slot> tx_slot;
+
+  if (gOFS->mTransferScheduler) {
+    TransferScheduler::Request tx_req;
+    tx_req.mPriority = TransferScheduler::GetPriority(app_tag);
+    tx_req.mSpace = mConversionInfo.mLocation.getSpace();
+    tx_req.mSize = source_size;
+
+    for (const auto& fsid : src_locations) {
+      if (fsid != EOS_TAPE_FSID) {
+        tx_req.mFsids.push_back(fsid);
+      }
+    }
+
+    tx_slot = gOFS->mTransferScheduler->Acquire(tx_req, [this]() {
+      return mProgressHandler.ShouldCancel(0);
+    });
+
+    if (tx_slot == nullptr) {
+      HandleError("conversion job cancelled while waiting for a transfer slot");
+      return;
+    }
+  }
+
+  // Prepare the TPC job once the transfer can start so that the credentials
+  // don't expire while waiting for a slot
   XrdCl::URL url_src = NewUrl();
   std::ostringstream url_params;
   url_params << "eos.ruid=" << DAEMONUID
@@ -23,6 +23,7 @@
 
 #include "mgm/drain/DrainTransferJob.hh"
 #include "mgm/XrdMgmOfs.hh"
+#include "mgm/TransferScheduler.hh"
 #include "mgm/FsView.hh"
 #include "mgm/GeoTreeEngine.hh"
 #include "mgm/Stat.hh"
@@ -134,12 +135,41 @@ DrainTransferJob::DoIt() noexcept
       return;
     }
 
-    // Prepare the TPC copy job
+    // When no more sources are available mStatus is properly set already
+    // during the selection step
+    eos::common::FileSystem::fs_snapshot_t src_snapshot;
+    unsigned long src_lid = 0ul;
+
+    if (!SelectSrcFs(fdrain, src_snapshot, src_lid)) {
+      return;
+    }
+
+    // Wait for a transfer slot on the source and destination file systems
+    std::unique_ptr<TransferScheduler::Slot> tx_slot;
+
+    if (gOFS->mTransferScheduler) {
+      TransferScheduler::Request tx_req;
+      tx_req.mPriority = TransferScheduler::GetPriority(mAppTag);
+      tx_req.mFsids = {mTxFsIdSource.load(), mFsIdTarget.load()};
+      tx_req.mSize = fdrain.mProto.size();
+      tx_slot = gOFS->mTransferScheduler->Acquire(tx_req, [this]() {
+        return mProgressHandler.ShouldCancel(0);
+      });
+
+      if (tx_slot == nullptr) {
+        ReportError(SSTR("msg=\"job cancelled while waiting for a transfer "
+                         "slot\" fxid=" << eos::common::FileId::Fid2Hex(mFileId)));
+        return;
+      }
+    }
+
+    // Prepare the TPC copy job, the capabilities are only issued once the
+    // transfer can start so that they don't expire while waiting for a slot
     std::string log_id = LogId::GenerateLogId();
-    XrdCl::URL url_src = BuildTpcSrc(fdrain, log_id);
+    XrdCl::URL url_src = BuildTpcSrc(fdrain, src_snapshot, src_lid, log_id);
     XrdCl::URL url_dst = BuildTpcDst(fdrain, log_id);
 
-    // When no more sources are available the url_src/dst is empty and
+    // When the capabilities can not be built the url_src/dst is empty and
     // mStatus is properly set already during the build step
     if (!url_src.IsValid() || !url_dst.IsValid()) {
       eos_static_err("msg=\"url invalid\" src=\"%s\" dst=\"%s\"",
@@ -259,17 +289,16 @@ DrainTransferJob::GetFileInfo() const
 }
 
 //------------------------------------------------------------------------------
-// Build TPC source url
+// Select the TPC source file system
 //------------------------------------------------------------------------------
-XrdCl::URL
-DrainTransferJob::BuildTpcSrc(const FileDrainInfo& fdrain,
-                              const std::string& log_id)
+bool
+DrainTransferJob::SelectSrcFs(const FileDrainInfo& fdrain,
+                              eos::common::FileSystem::fs_snapshot_t& src_snapshot,
+                              unsigned long& target_lid)
 {
   using namespace eos::common;
-  XrdCl::URL url_src;
-  eos::common::FileSystem::fs_snapshot_t src_snapshot;
   unsigned long lid = fdrain.mProto.layout_id();
-  unsigned long target_lid = LayoutId::SetLayoutType(lid, LayoutId::kPlain);
+  target_lid = LayoutId::SetLayoutType(lid, LayoutId::kPlain);
 
   // Mask block checksums (set to kNone) for replica layouts
   if (LayoutId::GetLayoutType(lid) == LayoutId::kReplica) {
@@ -312,7 +341,7 @@ DrainTransferJob::BuildTpcSrc(const FileDrainInfo& fdrain,
 
       if (!fs) {
         ReportError(SSTR("msg=\"fsid=" << mFsIdSource << " no longer in the list"));
-        return url_src;
+        return false;
       }
 
       fs->SnapShotFileSystem(src_snapshot);
@@ -321,7 +350,7 @@ DrainTransferJob::BuildTpcSrc(const FileDrainInfo& fdrain,
     if (!found) {
       ReportError(SSTR("msg=\"no more replicas available\" " << "fxid="
                        << eos::common::FileId::Fid2Hex(fdrain.mProto.id())));
-      return url_src;
+      return false;
     }
   } else {
     // For RAIN layouts we trigger an attempt only once
@@ -329,7 +358,7 @@ DrainTransferJob::BuildTpcSrc(const FileDrainInfo& fdrain,
       ReportError(SSTR("msg=\"fxid=" << eos::common::FileId::Fid2Hex(
                          fdrain.mProto.id())
                        << " rain reconstruct already failed\""));
-      return url_src;
+      return false;
     } else {
       mRainAttempt = true;
     }
@@ -359,14 +388,28 @@ DrainTransferJob::BuildTpcSrc(const FileDrainInfo& fdrain,
         ReportError(SSTR("msg=\"source stripe not available\" " << "fxid="
                          << eos::common::FileId::Fid2Hex(fdrain.mProto.id())
                          << " fsid=" << mFsIdSource));
-        return url_src;
+        return false;
       }
     }
   }
 
+  mTxFsIdSource = src_snapshot.mId;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Build TPC source url
+//------------------------------------------------------------------------------
+XrdCl::URL
+DrainTransferJob::BuildTpcSrc(const FileDrainInfo& fdrain,
+                              const eos::common::FileSystem::fs_snapshot_t&
+                              src_snapshot, unsigned long target_lid,
+                              const std::string& log_id)
+{
+  using namespace eos::common;
+  XrdCl::URL url_src;
   // Construct the source URL
   std::ostringstream src_params;
-  mTxFsIdSource = src_snapshot.mId;
 
   if (mRainReconstruct) {
     src_params << "&mgm.path=" << StringConversion::SealXrdPath(fdrain.mFullPath)
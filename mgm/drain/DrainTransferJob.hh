@@ -250,15 +250,32 @@ private:
   //----------------------------------------------------------------------------
   FileDrainInfo GetFileInfo() const;
 
+  //----------------------------------------------------------------------------
+  //! Select the TPC source file system
+  //!
+  //! @param fdrain file to be drained info
+  //! @param src_snapshot snapshot of the selected source file system
+  //! @param target_lid layout id to be used for reading the source
+  //!
+  //! @return true if source selected, otherwise false and error reported
+  //----------------------------------------------------------------------------
+  bool SelectSrcFs(const FileDrainInfo& fdrain,
+                   eos::common::FileSystem::fs_snapshot_t& src_snapshot,
+                   unsigned long& target_lid);
+
   //----------------------------------------------------------------------------
   //! Build TPC source url
   //!
   //! @param fdrain file to be drained info
+  //! @param src_snapshot snapshot of the selected source file system
+  //! @param target_lid layout id to be used for reading the source
   //! @param log_id transfer log id
   //!
   //! @return XrdCl source URL
   //----------------------------------------------------------------------------
   XrdCl::URL BuildTpcSrc(const FileDrainInfo& fdrain,
+                         const eos::common::FileSystem::fs_snapshot_t&
+                         src_snapshot, unsigned long target_lid,
                          const std::string& log_id);
 
   //----------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 #include "namespace/interface/IView.hh"
 #include "namespace/interface/IFsView.hh"
 #include "namespace/Prefetcher.cc"
+#include "namespace/ns_quarkdb/persistency/RequestBuilder.hh"
 #include "qclient/structures/QSet.hh"
 #include "json/json.h"
 
@@ -323,11 +324,15 @@ Fsck::CollectErrs(ThreadAssistant& assistant) noexcept
   }
 
   gOFS->WaitUntilNamespaceIsBooted();
+  bool full_reload = true;
+  std::chrono::steady_clock::time_point last_collect;
 
   while (!assistant.terminationRequested()) {
     // Wait for the current MGM to become a master
     while (!gOFS->mMaster->IsMaster()) {
       eos_debug("%s", "msg=\"fsck collect disabled for slave\"");
+      // Deltas are not consumed while slave so reload everything afterwards
+      full_reload = true;
       assistant.wait_for(std::chrono::seconds(5));
 
       if (assistant.terminationRequested()) {
@@ -340,46 +345,66 @@ Fsck::CollectErrs(ThreadAssistant& assistant) noexcept
       break;
     }
 
-    Log("Start error collection");
-    Log("Filesystems to check: %lu", FsView::gFsView.GetNumFileSystems());
-    decltype(eFsMap) tmp_err_map;
-    QueryQdb(tmp_err_map);
-    {
-      // Swap in the new list of errors and clear the rest
-      eos::common::RWMutexWriteLock wr_lock(mErrMutex);
-      std::swap(tmp_err_map, eFsMap);
-      eFsUnavail.clear();
-      eFsDark.clear();
-      eTimeStamp = time(NULL);
-    }
+    const auto now = std::chrono::steady_clock::now();
+
+    if (full_reload || (now - last_collect >= mCollectInterval)) {
+      Log("Start error collection");
+      Log("Filesystems to check: %lu", FsView::gFsView.GetNumFileSystems());
+
+      if (full_reload) {
+        decltype(eFsMap) tmp_err_map;
+        QueryQdb(tmp_err_map);
+        {
+          // Swap in the new list of errors and clear the rest
+          eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+          std::swap(tmp_err_map, eFsMap);
+          mPendingRepair.clear();
+          eFsUnavail.clear();
+          eFsDark.clear();
+          eTimeStamp = time(NULL);
+        }
+        full_reload = false;
+      } else {
+        // The error map is kept up to date by the deltas, only check that
+        // nothing was missed
+        ReconcileErrs();
+      }
 
-    // @note accounting the offline replicas/files is a heavy ns op.
-    if (mShowOffline) {
-      AccountOfflineReplicas();
-      PrintOfflineReplicas();
-      AccountOfflineFiles();
-    }
+      // @note accounting the offline replicas/files is a heavy ns op.
+      if (mShowOffline) {
+        AccountOfflineReplicas();
+        PrintOfflineReplicas();
+        AccountOfflineFiles();
+      }
 
-    // @note no replicas can be a really long list (e.g. PPS)
-    if (mShowNoReplica) {
-      AccountNoReplicaFiles();
-    }
+      // @note no replicas can be a really long list (e.g. PPS)
+      if (mShowNoReplica) {
+        AccountNoReplicaFiles();
+      }
 
-    PrintErrorsSummary();
+      PrintErrorsSummary();
 
-    // @note the following operation is a heavy ns op.
-    if (mShowDarkFiles) {
-      AccountDarkFiles();
+      // @note the following operation is a heavy ns op.
+      if (mShowDarkFiles) {
+        AccountDarkFiles();
+      }
+
+      Log("Finished error collection");
+      Log("Next run in %d minutes",
+          std::chrono::duration_cast<std::chrono::minutes>(mCollectInterval).count());
+      // Notify the repair thread that it can run over all the errors
+      mFullRepair = true;
+      mStartProcessing = true;
+      PublishLogs();
+      last_collect = now;
+    }
+
+    // Apply the deltas published by the FSTs in the meantime
+    if (!ConsumeDeltas(assistant)) {
+      full_reload = true;
     }
 
-    Log("Finished error collection");
-    Log("Next run in %d minutes",
-        std::chrono::duration_cast<std::chrono::minutes>(mCollectInterval).count());
-    // Notify the repair thread that it can run now
-    mStartProcessing = true;
-    PublishLogs();
-    // Wait for next FSCK round ...
-    assistant.wait_for(mCollectInterval);
+    assistant.wait_for(mDeltaInterval);
   }
 
   ResetErrorMaps();
@@ -435,13 +460,21 @@ Fsck::RepairErrs(ThreadAssistant& assistant) noexcept
     }
 
     // Create local struct for errors so that we avoid the iterator invalidation
-    // and the long locks
-    std::map<std::string,
-        std::map<eos::common::FileId::fileid_t,
-        std::set <eos::common::FileSystem::fsid_t> > > local_emap;
+    // and the long locks. Between full passes only the newly appeared errors
+    // are handled.
+    ErrMapT local_emap;
     {
-      eos::common::RWMutexReadLock rd_lock(mErrMutex);
-      local_emap.insert(eFsMap.begin(), eFsMap.end());
+      eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+
+      if (mFullRepair) {
+        mFullRepair = false;
+        local_emap.insert(eFsMap.begin(), eFsMap.end());
+        mPendingRepair.clear();
+      } else {
+        local_emap.swap(mPendingRepair);
+      }
+
+      mStartProcessing = false;
     }
     uint64_t count = 0ull;
     uint64_t msg_delay = 0;
@@ -517,7 +550,6 @@ Fsck::RepairErrs(ThreadAssistant& assistant) noexcept
 
     // Force flush any collected notifications
     NotifyFixedErr(0ull, 0ul, "", true);
-    mStartProcessing = false;
     eos_info("%s", "msg=\"loop in fsck repair thread\"");
   }
 
@@ -583,7 +615,10 @@ Fsck::PrintOut(std::string& out, bool monitor_fmt) const
         << "repair_category=" <<
         ((mRepairCategory == FsckErr::None) ?
          "all" : eos::common::FsckErrToString(mRepairCategory)) << std::endl
-        << "best_effort=" << (mDoBestEffort ? "true" : "false") << std::endl;
+        << "best_effort=" << (mDoBestEffort ? "true" : "false") << std::endl
+        << "delta_last_seq=" << mLastDeltaSeq << std::endl
+        << "delta_applied=" << mNumDeltas << std::endl
+        << "reconciled_types=" << mNumReconciled << std::endl;
   } else {
     oss << "Info: collection thread status -> "
         << (mCollectEnabled ? "enabled" : "disabled") << std::endl
@@ -593,7 +628,10 @@ Fsck::PrintOut(std::string& out, bool monitor_fmt) const
         << ((mRepairCategory == FsckErr::None) ?
             "all" : eos::common::FsckErrToString(mRepairCategory)) << std::endl
         << "Info: best effort              -> "
-        << (mDoBestEffort ? "true" : "false") << std::endl;
+        << (mDoBestEffort ? "true" : "false") << std::endl
+        << "Info: last delta sequence      -> " << mLastDeltaSeq << std::endl
+        << "Info: applied deltas           -> " << mNumDeltas << std::endl
+        << "Info: reconciled error types   -> " << mNumReconciled << std::endl;
   }
 
   {
@@ -1161,31 +1199,89 @@ Fsck::PrintErrorsSummary() const
 void
 Fsck::AccountDarkFiles()
 {
-  eos::common::RWMutexWriteLock wr_lock(mErrMutex);
-  eos::common::RWMutexReadLock fs_rd_lock(FsView::gFsView.ViewMutex);
-  eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+  // Only the file systems unknown to the FsView are dark, so collect them
+  // first and count their files afterwards without holding the locks
+  std::vector<IFileMD::location_t> dark_fsids;
+  {
+    eos::common::RWMutexReadLock fs_rd_lock(FsView::gFsView.ViewMutex);
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
 
-  for (auto it = gOFS->eosFsView->getFileSystemIterator();
-       it->valid(); it->next()) {
-    IFileMD::location_t nfsid = it->getElement();
+    for (auto it = gOFS->eosFsView->getFileSystemIterator();
+         it->valid(); it->next()) {
+      IFileMD::location_t nfsid = it->getElement();
 
-    try {
-      // @todo(gbitzes): Urgent fix for QDB namespace needed.. This loop
-      // will need to load all filesystems in memory, just to get a couple
-      // of silly counters.
-      uint64_t num_files = gOFS->eosFsView->getNumFilesOnFs(nfsid);
-
-      if (num_files) {
-        // Check if this exists in the gFsView
-        if (!FsView::gFsView.mIdView.exists(nfsid)) {
-          eFsDark[nfsid] += num_files;
-          Log("shadow fsid=%lu shadow_entries=%llu ", nfsid, num_files);
-        }
+      if (!FsView::gFsView.mIdView.exists(nfsid)) {
+        dark_fsids.push_back(nfsid);
       }
-    } catch (const eos::MDException& e) {
-      // ignore
     }
   }
+  std::vector<uint64_t> num_files(dark_fsids.size(), 0ull);
+
+  if (mQcl && !gOFS->eosView->inMemory()) {
+    // Pipeline the cardinality queries instead of loading the file lists
+    std::vector<std::future<qclient::redisReplyPtr>> replies;
+    replies.reserve(dark_fsids.size());
+
+    for (const auto fsid : dark_fsids) {
+      replies.push_back(mQcl->exec("SCARD",
+                                   eos::RequestBuilder::keyFilesystemFiles(fsid)));
+    }
+
+    for (size_t i = 0; i < replies.size(); ++i) {
+      qclient::redisReplyPtr reply = replies[i].get();
+
+      if (reply && (reply->type == REDIS_REPLY_INTEGER) &&
+          (reply->integer > 0)) {
+        num_files[i] = reply->integer;
+      }
+    }
+  } else {
+    eos::common::RWMutexReadLock ns_rd_lock(gOFS->eosViewRWMutex);
+
+    for (size_t i = 0; i < dark_fsids.size(); ++i) {
+      try {
+        num_files[i] = gOFS->eosFsView->getNumFilesOnFs(dark_fsids[i]);
+      } catch (const eos::MDException& e) {
+        // ignore
+      }
+    }
+  }
+
+  eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+
+  for (size_t i = 0; i < dark_fsids.size(); ++i) {
+    if (num_files[i]) {
+      eFsDark[dark_fsids[i]] += num_files[i];
+      Log("shadow fsid=%lu shadow_entries=%llu ", dark_fsids[i], num_files[i]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Parse fsck entry stored in QDB in the form: fid:fsid
+//------------------------------------------------------------------------------
+static std::pair<eos::IFileMD::id_t, eos::common::FileSystem::fsid_t>
+ParseFsckEntry(const std::string& data)
+{
+  const size_t pos = data.find(':');
+
+  if ((pos == std::string::npos) || (pos == data.length())) {
+    eos_static_err("msg=\"failed to parse fsck element\" data=\"%s\"",
+                   data.c_str());
+    return {0ull, 0ul};
+  }
+
+  eos::IFileMD::id_t fid;
+  eos::common::FileSystem::fsid_t fsid;
+
+  if (!eos::common::StringToNumeric(data.substr(0, pos), fid) ||
+      !eos::common::StringToNumeric(data.substr(pos + 1), fsid)) {
+    eos_static_err("msg=\"failed to convert fsck info\" data=\"%s\"",
+                   data.c_str());
+    return {0ull, 0ul};
+  }
+
+  return {fid, fsid};
 }
 
 //------------------------------------------------------------------------------
@@ -1195,46 +1291,217 @@ void
 Fsck::QueryQdb(ErrMapT& err_map)
 {
   static std::set<std::string> known_errs = eos::common::GetKnownFsckErrs();
-  qclient::QSet set_errs(*mQcl.get(), "");
-  // Helper function to parse fsck info stored in QDB
-  auto parse_fsck =
-    [](const std::string & data) ->
-  std::pair<eos::IFileMD::id_t, eos::common::FileSystem::fsid_t> {
-    const size_t pos = data.find(':');
-
-    if ((pos == std::string::npos) || (pos == data.length()))
-    {
-      eos_static_err("msg=\"failed to parse fsck element\" data=\"%s\"",
-                     data.c_str());
-      return {0ull, 0ul};
+  eos_static_info("%s", "msg=\"check for fsck errors\"");
+
+  for (const auto& err_type : known_errs) {
+    QueryQdb(err_type, err_map);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Query QDB for the given fsck error type
+//------------------------------------------------------------------------------
+void
+Fsck::QueryQdb(const std::string& err_type, ErrMapT& err_map)
+{
+  qclient::QSet set_errs(*mQcl.get(), SSTR("fsck:" << err_type));
+
+  for (auto it = set_errs.getIterator(); it.valid(); it.next()) {
+    // Set elements are in the form: fid:fsid
+    auto pair_info = ParseFsckEntry(it.getElement());
+    err_map[err_type][pair_info.first].insert(pair_info.second);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Consume the fsck deltas published by the FSTs
+//------------------------------------------------------------------------------
+bool
+Fsck::ConsumeDeltas(ThreadAssistant& assistant)
+{
+  static const uint64_t s_max_batch_size = 1000;
+  static std::set<std::string> known_errs = eos::common::GetKnownFsckErrs();
+  auto reply = mQcl->exec("deque-len", eos::common::FSCK_DELTA_KEY).get();
+
+  if (!reply || (reply->type != REDIS_REPLY_INTEGER)) {
+    eos_err("%s", "msg=\"failed to get length of fsck delta log\"");
+    return true;
+  }
+
+  uint64_t len = (uint64_t)reply->integer;
+
+  if (len >= eos::common::FSCK_DELTA_MAX_LEN) {
+    // The log was trimmed so some deltas are lost - start from a clean log
+    // and reload everything since the FSTs update the sets before the log
+    eos_warning("msg=\"fsck delta log overflow, full reload\" len=%llu", len);
+    (void) mQcl->exec("deque-clear", eos::common::FSCK_DELTA_KEY).get();
+    return false;
+  }
+
+  // Helper function to remove an entry from an error map
+  auto erase_err = [](ErrMapT & err_map, const eos::common::FsckDelta & delta) {
+    auto it_err = err_map.find(delta.mErrType);
+
+    if (it_err == err_map.end()) {
+      return;
     }
 
-    eos::IFileMD::id_t fid;
-    eos::common::FileSystem::fsid_t fsid;
+    auto it_fid = it_err->second.find(delta.mFid);
 
-    if (!eos::common::StringToNumeric(data.substr(0, pos), fid) ||
-        !eos::common::StringToNumeric(data.substr(pos + 1), fsid))
-    {
-      eos_static_err("msg=\"failed to convert fsck info\" data=\"%s\"",
-                     data.c_str());
-      return {0ull, 0ul};
+    if (it_fid == it_err->second.end()) {
+      return;
     }
 
-    return {fid, fsid};
+    it_fid->second.erase(delta.mFsid);
+
+    if (it_fid->second.empty()) {
+      it_err->second.erase(it_fid);
+    }
   };
-  eos_static_info("%s", "msg=\"check for fsck errors\"");
+
+  while (len && !assistant.terminationRequested()) {
+    const uint64_t batch_size = std::min(len, s_max_batch_size);
+    len -= batch_size;
+    std::vector<std::future<qclient::redisReplyPtr>> replies;
+    replies.reserve(batch_size);
+
+    // Pipeline the pop requests
+    for (uint64_t i = 0ull; i < batch_size; ++i) {
+      replies.push_back(mQcl->exec("deque-pop-front",
+                                   eos::common::FSCK_DELTA_KEY));
+    }
+
+    std::vector<eos::common::FsckDelta> deltas;
+    deltas.reserve(batch_size);
+
+    for (auto& fut : replies) {
+      auto resp = fut.get();
+
+      if (!resp || (resp->type != REDIS_REPLY_STRING)) {
+        continue;
+      }
+
+      eos::common::FsckDelta delta;
+      const std::string data(resp->str, resp->len);
+
+      if (!delta.Deserialize(data) || !known_errs.count(delta.mErrType)) {
+        eos_err("msg=\"failed to parse fsck delta\" data=\"%s\"", data.c_str());
+        continue;
+      }
+
+      deltas.push_back(std::move(delta));
+    }
+
+    if (deltas.empty()) {
+      continue;
+    }
+
+    bool new_errs = false;
+    {
+      eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+
+      for (const auto& delta : deltas) {
+        if (delta.mAppeared) {
+          eFsMap[delta.mErrType][delta.mFid].insert(delta.mFsid);
+          mPendingRepair[delta.mErrType][delta.mFid].insert(delta.mFsid);
+          new_errs = true;
+        } else {
+          erase_err(eFsMap, delta);
+          erase_err(mPendingRepair, delta);
+        }
+
+        if (delta.mSeq > mLastDeltaSeq) {
+          mLastDeltaSeq = delta.mSeq;
+        }
+      }
+
+      eTimeStamp = time(NULL);
+    }
+    mNumDeltas += deltas.size();
+
+    // Notify the repair thread that there are new errors
+    if (new_errs) {
+      mStartProcessing = true;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Reconcile the in-memory error map with the contents of QDB
+//------------------------------------------------------------------------------
+void
+Fsck::ReconcileErrs()
+{
+  static std::set<std::string> known_errs = eos::common::GetKnownFsckErrs();
+  std::map<std::string, std::future<qclient::redisReplyPtr>> replies;
 
   for (const auto& err_type : known_errs) {
-    set_errs.setKey(SSTR("fsck:" << err_type));
+    replies.emplace(err_type, mQcl->exec("SCARD", SSTR("fsck:" << err_type)));
+  }
+
+  std::map<std::string, uint64_t> qdb_counts;
 
-    for (auto it = set_errs.getIterator(); it.valid(); it.next()) {
-      // Set elements are in the form: fid:fsid
-      auto pair_info = parse_fsck(it.getElement());
-      err_map[err_type][pair_info.first].insert(pair_info.second);
+  for (auto& elem : replies) {
+    auto reply = elem.second.get();
+
+    if (!reply || (reply->type != REDIS_REPLY_INTEGER)) {
+      eos_err("msg=\"failed to get fsck set size\" err_type=%s",
+              elem.first.c_str());
+      continue;
     }
+
+    qdb_counts[elem.first] = (uint64_t)reply->integer;
   }
 
-  return;
+  std::set<std::string> to_reload;
+  {
+    eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+
+    // Drop the entries accounted only by the MGM, they are recomputed
+    for (auto it = eFsMap.begin(); it != eFsMap.end();) {
+      if (known_errs.count(it->first) == 0) {
+        it = eFsMap.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    eFsUnavail.clear();
+    eFsDark.clear();
+
+    for (const auto& elem : qdb_counts) {
+      uint64_t count = 0ull;
+      auto it = eFsMap.find(elem.first);
+
+      if (it != eFsMap.end()) {
+        for (const auto& fid_elem : it->second) {
+          count += fid_elem.second.size();
+        }
+      }
+
+      if (count != elem.second) {
+        eos_info("msg=\"fsck error count mismatch\" err_type=%s mem=%llu "
+                 "qdb=%llu", elem.first.c_str(), count, elem.second);
+        to_reload.insert(elem.first);
+      }
+    }
+  }
+
+  for (const auto& err_type : to_reload) {
+    ErrMapT tmp_err_map;
+    QueryQdb(err_type, tmp_err_map);
+    eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+    eFsMap[err_type].swap(tmp_err_map[err_type]);
+  }
+
+  {
+    eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+    eTimeStamp = time(NULL);
+  }
+  mNumReconciled += to_reload.size();
+  Log("Reconciled error types: %lu", to_reload.size());
 }
 
 //------------------------------------------------------------------------------
@@ -1298,6 +1565,32 @@ Fsck::NotifyFixedErr(eos::IFileMD::id_t fid,
       }
     }
 
+    // Keep the in-memory error map consistent with the backend
+    if (!updates.empty()) {
+      eos::common::RWMutexWriteLock wr_lock(mErrMutex);
+
+      for (const auto& elem : updates) {
+        auto it_err = eFsMap.find(elem.first);
+
+        if (it_err == eFsMap.end()) {
+          continue;
+        }
+
+        for (const auto& value : elem.second) {
+          auto pair_info = ParseFsckEntry(value);
+          auto it_fid = it_err->second.find(pair_info.first);
+
+          if (it_fid != it_err->second.end()) {
+            it_fid->second.erase(pair_info.second);
+
+            if (it_fid->second.empty()) {
+              it_err->second.erase(it_fid);
+            }
+          }
+        }
+      }
+    }
+
     num_updates = 0ull;
     updates.clear();
   }
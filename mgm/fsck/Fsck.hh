@@ -247,6 +247,19 @@ private:
         std::map<eos::common::FileId::fileid_t ,
         std::set <eos::common::FileSystem::fsid_t>>>;
   ErrMapT eFsMap;
+  //! Errors that appeared since the last repair pass and were not yet
+  //! submitted for repair, protected by mErrMutex
+  ErrMapT mPendingRepair;
+  //! Mark if the next repair pass should cover all the collected errors
+  std::atomic<bool> mFullRepair {true};
+  //! Interval between consecutive polls of the fsck delta log
+  std::chrono::seconds mDeltaInterval {5};
+  //! Highest fsck delta sequence number applied
+  std::atomic<uint64_t> mLastDeltaSeq {0ull};
+  //! Number of fsck deltas applied since the collector started
+  std::atomic<uint64_t> mNumDeltas {0ull};
+  //! Number of error types reloaded during reconciliation
+  std::atomic<uint64_t> mNumReconciled {0ull};
   //! Unavailable filesystems map
   std::map<eos::common::FileSystem::fsid_t, unsigned long long > eFsUnavail;
   //! Dark filesystem map - filesystems referenced by a file but not configured
@@ -268,6 +281,32 @@ private:
   //----------------------------------------------------------------------------
   void QueryQdb(ErrMapT& err_map);
 
+  //----------------------------------------------------------------------------
+  //! Query QDB for the given fsck error type
+  //!
+  //! @param err_type fsck error type
+  //! @param err_map map of fsck errors collected
+  //----------------------------------------------------------------------------
+  void QueryQdb(const std::string& err_type, ErrMapT& err_map);
+
+  //----------------------------------------------------------------------------
+  //! Consume the fsck deltas published by the FSTs and apply them to the
+  //! in-memory error map. Newly appeared errors are queued for repair.
+  //!
+  //! @param assistant thread doing the job
+  //!
+  //! @return false if the delta log overflowed or could not be read and a
+  //!         full reload of the errors is needed, otherwise true
+  //----------------------------------------------------------------------------
+  bool ConsumeDeltas(ThreadAssistant& assistant);
+
+  //----------------------------------------------------------------------------
+  //! Reconcile the in-memory error map with the contents of QDB. The number
+  //! of entries of each error type is compared with the cardinality of the
+  //! corresponding QDB set and only the types that differ are reloaded.
+  //----------------------------------------------------------------------------
+  void ReconcileErrs();
+
   //----------------------------------------------------------------------------
   //! Create report in JSON format
   //!
@@ -35,6 +35,7 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <functional>
 #include <limits>
 #define __EOSMGM_FASTTREE__H__
 
@@ -1645,6 +1646,45 @@ public:
       updateTree(pBranches[b].sonIdx);
     }
 
+    updateNode(node);
+  }
+
+  // add the ancestors of the given nodes and sort them so that every node
+  // comes before its father. The nodes are laid out by depth in the tree so
+  // a decreasing index order is enough.
+  inline void
+  addAncestors(std::vector<tFastTreeIdx>& nodes) const
+  {
+    const size_t count = nodes.size();
+
+    for (size_t i = 0; i < count; i++) {
+      for (tFastTreeIdx node = nodes[i]; pNodes[node].treeData.fatherIdx != node;) {
+        node = pNodes[node].treeData.fatherIdx;
+        nodes.push_back(node);
+      }
+    }
+
+    std::sort(nodes.begin(), nodes.end(), std::greater<tFastTreeIdx>());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  }
+
+  // update the given nodes as updateTree would do. If only some leaves were
+  // modified since the last update, updating them and their ancestors as given
+  // by addAncestors gives the same result as updateTree().
+  inline void
+  updateBranches(const std::vector<tFastTreeIdx>& nodes)
+  {
+    for (auto node : nodes) {
+      updateNode(node);
+    }
+  }
+
+  // update the sorting and the aggregates of one node from its children
+  inline void
+  updateNode(const tFastTreeIdx& node)
+  {
+    const tFastTreeIdx& nbChildren = pNodes[node].treeData.childrenCount;
+
     if (nbChildren < 2) {
       pNodes[node].fileData.lastHighestPriorityOffset = 0;
     }
@@ -1674,6 +1714,14 @@ public:
     return (sizeof(FastTreeNode) + sizeof(Branch)) * sGetMaxNodeCount();
   }
 
+  // size of the tree header when copied to a buffer, it is padded to a whole
+  // number of cache lines so that the nodes following it in a cache line
+  // aligned buffer do not straddle two cache lines
+  inline static constexpr size_t sGetHeaderSize()
+  {
+    return (sizeof(tSelf) + 63) & ~((size_t) 63);
+  }
+
   inline tFastTreeIdx
   getNodeCount() const
   {
@@ -1896,6 +1944,18 @@ public:
   {
     pBranchComp.fillRatioCompTol = tol;
   }
+  char getSaturationThreshold() const
+  {
+    return pBranchComp.saturationThresh;
+  }
+  char getSpreadingFillRatioCap() const
+  {
+    return pBranchComp.spreadingFillRatioCap;
+  }
+  char getFillRatioCompTol() const
+  {
+    return pBranchComp.fillRatioCompTol;
+  }
   bool
   selfAllocate(tFastTreeIdx size)
   {
@@ -1930,8 +1990,8 @@ public:
   size_t
   copyToBuffer(char* buffer, size_t bufSize) const
   {
-    size_t memsize = (sizeof(FastTreeNode) + sizeof(Branch)) * pNodeCount + sizeof(
-                       FastTree);
+    size_t memsize = (sizeof(FastTreeNode) + sizeof(Branch)) * pNodeCount +
+                     sGetHeaderSize();
 
     if (bufSize < memsize) {
       return memsize;
@@ -1941,7 +2001,7 @@ public:
     tSelf* destFastTree = (tSelf*)(buffer);
     // adjust the value of some of them
     (*destFastTree) = *this;
-    destFastTree->pNodes = (FastTreeNode*)(buffer += sizeof(tSelf));
+    destFastTree->pNodes = (FastTreeNode*)(buffer += sGetHeaderSize());
     memcpy((void*)destFastTree->pNodes, pNodes,
            (sizeof(FastTreeNode)) * pNodeCount);
     destFastTree->pBranches = (Branch*)(buffer += sizeof(FastTreeNode) *
@@ -2150,6 +2210,86 @@ public:
     }
   }
 
+  // max number of highest priority branches scored by getRandomBranchFixed
+  static constexpr tFastTreeIdx sMaxFixedFanOut = 64;
+
+  // same as getRandomBranch, the weights of the highest priority branches are
+  // gathered in a cache line aligned array so that their sum is vectorised and
+  // the selection is done without branching
+  inline tFastTreeIdx
+  getRandomBranchFixed(const tFastTreeIdx& node) const
+  {
+    const tFastTreeIdx nBranches = pNodes[node].fileData.lastHighestPriorityOffset
+                                   + 1;
+
+    if (nBranches > sMaxFixedFanOut) {
+      return getRandomBranch(node);
+    }
+
+    const Branch* branches = pBranches + pNodes[node].treeData.firstBranchIdx;
+    alignas(64) uint16_t weights[sMaxFixedFanOut];
+    int weightSum = 0;
+
+    for (tFastTreeIdx i = 0; i < nBranches; i++) {
+      const FastTreeNode& son = pNodes[branches[i].sonIdx];
+      weights[i] = pRandVar(son.fsData, son.fileData);
+    }
+
+    for (tFastTreeIdx i = 0; i < nBranches; i++) {
+      weightSum += weights[i];
+    }
+
+    if (!weightSum) {
+      // in this case all weights are 0 -> uniform probability
+      return branches[eos::common::getRandom() % nBranches].sonIdx;
+    }
+
+    int r = eos::common::getRandom();
+    r = r % (weightSum);
+    tFastTreeIdx selected = 0;
+    int cumul = 0;
+
+    // the selected branch is the first one whose cumulated weight is above r
+    for (tFastTreeIdx i = 0; i < nBranches; i++) {
+      cumul += weights[i];
+      selected += (cumul <= r);
+    }
+
+    return branches[selected].sonIdx;
+  }
+
+  // placement of a number of replicas known at compile time, specialised for
+  // the most common layouts (replica 2, RAIN 10+2 ...). It gives the same
+  // result as calling findFreeSlotFirstHit(newReplicas[k], 0, true) N times
+  // but descends the tree iteratively and uses getRandomBranchFixed.
+  template<size_t N>
+  bool
+  findFreeSlotsFixed(tFastTreeIdx* newReplicas)
+  {
+    static_assert(N > 0 && N < std::numeric_limits<unsigned char>::max(),
+                  "invalid number of replicas");
+
+    for (size_t k = 0; k < N; k++) {
+      tFastTreeIdx node = 0;
+
+      while (pNodes[node].fileData.freeSlotsCount &&
+             pNodes[node].treeData.childrenCount) {
+        node = pNodes[node].fileData.lastHighestPriorityOffset ?
+               getRandomBranchFixed(node) :
+               pBranches[pNodes[node].treeData.firstBranchIdx].sonIdx;
+      }
+
+      if (!pNodes[node].fileData.freeSlotsCount || !isValidSlotNode(node)) {
+        return false;
+      }
+
+      newReplicas[k] = node;
+      decrementFreeSlot(node, true);
+    }
+
+    return true;
+  }
+
   bool
   findFreeSlotFirstHitBack(tFastTreeIdx& newReplica, tFastTreeIdx startFrom = 0)
   {
@@ -948,6 +948,55 @@ int mainFull()
          elapsed) / CLOCKS_PER_SEC)
        << " placements/sec " << endl;
   cout << "----------------------------" << endl << endl;
+
+  for (size_t nRep : {2, 12}) {
+    begin = clock();
+
+    for (size_t i = 0; i < schedGroups.size() * nbIter; i++) {
+      char buffer[bufferSize];
+      assert(fptrees[i % schedGroups.size()].copyToBuffer(buffer, bufferSize) == 0);
+      FastPlacementTree* ftree = (FastPlacementTree*) buffer;
+      SchedTreeBase::tFastTreeIdx repId;
+
+      for (size_t k = 0; k < nRep; k++) {
+        ftree->findFreeSlot(repId);
+      }
+    }
+
+    elapsed = clock() - begin;
+    cout << "REPLICA PLACEMENT SPEED TEST (" << nRep << " REPLICAS)" << endl;
+    cout << "elapsed time : " << float (elapsed) / CLOCKS_PER_SEC << " sec." <<
+         endl;
+    cout << "speed        : " << nRep * schedGroups.size() * nbIter / (float (
+           elapsed) / CLOCKS_PER_SEC)
+         << " placements/sec " << endl;
+    cout << "----------------------------" << endl << endl;
+    begin = clock();
+
+    for (size_t i = 0; i < schedGroups.size() * nbIter; i++) {
+      char buffer[bufferSize];
+      assert(fptrees[i % schedGroups.size()].copyToBuffer(buffer, bufferSize) == 0);
+      FastPlacementTree* ftree = (FastPlacementTree*) buffer;
+      SchedTreeBase::tFastTreeIdx repIdxs[12];
+
+      if (nRep == 2) {
+        ftree->findFreeSlotsFixed<2>(repIdxs);
+      } else {
+        ftree->findFreeSlotsFixed<12>(repIdxs);
+      }
+    }
+
+    elapsed = clock() - begin;
+    cout << "FIXED KERNEL REPLICA PLACEMENT SPEED TEST (" << nRep << " REPLICAS)"
+         << endl;
+    cout << "elapsed time : " << float (elapsed) / CLOCKS_PER_SEC << " sec." <<
+         endl;
+    cout << "speed        : " << nRep * schedGroups.size() * nbIter / (float (
+           elapsed) / CLOCKS_PER_SEC)
+         << " placements/sec " << endl;
+    cout << "----------------------------" << endl << endl;
+  }
+
   begin = clock();
 
   for (size_t i = 0; i < schedGroups.size() * nbIter; i++) {
@@ -1113,6 +1162,40 @@ int mainFull()
          elapsed) / CLOCKS_PER_SEC) << " updates/sec "
        << endl;
   cout << "----------------------" << endl << endl;
+
+  // update rate of a group when some of its fs publish a new state in a frame
+  for (size_t nUpdatedFs : {
+         1, 8, 32
+       }) {
+    std::vector<SchedTreeBase::tFastTreeIdx> nodes;
+    begin = clock();
+
+    for (size_t i = 0; i < schedGroups.size() * nbIter; i++) {
+      char buffer[bufferSize];
+      assert(fptrees[i % schedGroups.size()].copyToBuffer(buffer, bufferSize) == 0);
+      FastPlacementTree* ftree = (FastPlacementTree*) buffer;
+      nodes.clear();
+
+      for (size_t k = 0; k < nUpdatedFs; k++) {
+        nodes.push_back(fsIdxBegV[i % schedGroups.size()]
+                        + eos::common::getRandom() % (fsIdxEndV[i % schedGroups.size()] -
+                            fsIdxBegV[i % schedGroups.size()]));
+      }
+
+      ftree->addAncestors(nodes);
+      ftree->updateBranches(nodes);
+    }
+
+    elapsed = clock() - begin;
+    cout << "UPDATE FAST TREE TEST (" << nUpdatedFs << " MODIFIED FS) " << endl;
+    cout << "elapsed time : " << float (elapsed) / CLOCKS_PER_SEC << " sec." <<
+         endl;
+    cout << "speed        : " << schedGroups.size() * nbIter / (float (
+           elapsed) / CLOCKS_PER_SEC) << " updates/sec "
+         << endl;
+    cout << "----------------------" << endl << endl;
+  }
+
   begin = clock();
 
   for (size_t i = 0; i < schedGroups.size() * nbIter; i++) {
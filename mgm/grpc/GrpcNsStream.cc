@@ -0,0 +1,352 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifdef EOS_GRPC
+#include "GrpcNsStream.hh"
+#include "GrpcNsInterface.hh"
+#include "GrpcServer.hh"
+#include "common/Logging.hh"
+#include "mgm/Macros.hh"
+#include <map>
+
+EOSMGMNAMESPACE_BEGIN
+
+/**
+ * One Exec stream, from the request of the call to its release. All the
+ * state is protected by mMutex, the events come from the pollers of the
+ * completion queue and from the batches finishing in the thread pool.
+ */
+class GrpcNsStreamService::Call
+{
+public:
+  enum class Op { kRequest, kRead, kWrite, kFinish };
+
+  struct Tag {
+    Call* call;
+    Op op;
+  };
+
+  /* Constructor - waits for the next stream of the service */
+  Call(GrpcNsStreamService* svc):
+    mSvc(svc), mStream(&mCtx), mRequestTag{this, Op::kRequest},
+    mReadTag{this, Op::kRead}, mWriteTag{this, Op::kWrite},
+    mFinishTag{this, Op::kFinish}, mInflight(0), mRefs(1), mReading(false),
+    mWriting(false), mReadsDone(false), mFinishing(false), mDead(false)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mSvc->mMutex);
+      ++mSvc->mCalls;
+    }
+    mSvc->mService.RequestExec(&mCtx, &mStream, mSvc->mCq.get(),
+                               mSvc->mCq.get(), &mRequestTag);
+  }
+
+  /* Handle the completion of a tag, the call may be deleted on return */
+  void Proceed(Op op, bool ok)
+  {
+    GrpcNsStreamService* svc = mSvc;
+    bool release = false;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      --mRefs;
+
+      switch (op) {
+      case Op::kRequest:
+        if (ok) {
+          eos_static_info("grpc::exec::stream from client peer=%s ip=%s DN=%s",
+                          mCtx.peer().c_str(), GrpcServer::IP(&mCtx).c_str(),
+                          GrpcServer::DN(&mCtx).c_str());
+          // wait for the next stream right away, while this call is still
+          // accounted so that Stop can not shut the queue down in between
+          new Call(mSvc);
+        } else {
+          // server shutting down
+          mDead = true;
+        }
+
+        break;
+
+      case Op::kRead:
+        mReading = false;
+
+        if (ok) {
+          auto batch = std::make_shared<eos::rpc::NSBatchRequest>();
+          batch->Swap(&mRequest);
+
+          if ((size_t) batch->ops_size() > mSvc->mMaxInflight) {
+            // a single batch would bypass the back-pressure, refuse it and
+            // finish once the results of the previous batches are written
+            mStatus = grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                                   "batch of " + std::to_string(batch->ops_size()) +
+                                   " operations exceeds the limit of " +
+                                   std::to_string(mSvc->mMaxInflight));
+            mReadsDone = true;
+          } else if (batch->ops_size()) {
+            mInflight += batch->ops_size();
+            ++mRefs;
+            mSvc->mPool.PushTask<void>([this, batch] {
+              Execute(*batch);
+            });
+          }
+        } else {
+          // client done writing or stream broken, finish when all pending
+          // results are written
+          mReadsDone = true;
+        }
+
+        break;
+
+      case Op::kWrite:
+        mWriting = false;
+
+        if (ok) {
+          mInflight -= mResponse.results_size();
+          mResponse.Clear();
+        } else {
+          mDead = true;
+        }
+
+        break;
+
+      case Op::kFinish:
+        mDead = true;
+        break;
+      }
+
+      Schedule();
+      release = !mRefs && (mDead || mFinishing);
+    }
+
+    if (release) {
+      delete this;
+      svc->CallDone();
+    }
+  }
+
+private:
+  /* Start the next read, write or the finish of the stream if possible,
+   * with mMutex held
+   */
+  void Schedule()
+  {
+    if (mDead || mFinishing) {
+      return;
+    }
+
+    if (!mWriting && mPending.results_size()) {
+      mResponse.Swap(&mPending);
+      mWriting = true;
+      ++mRefs;
+      mStream.Write(mResponse, &mWriteTag);
+    }
+
+    // back-pressure, pending results count until they are written
+    if (!mReading && !mReadsDone && (mInflight < mSvc->mMaxInflight)) {
+      mReading = true;
+      ++mRefs;
+      mStream.Read(&mRequest, &mReadTag);
+    }
+
+    if (mReadsDone && !mInflight && !mWriting) {
+      mFinishing = true;
+      ++mRefs;
+      mStream.Finish(mStatus, &mFinishTag);
+    }
+  }
+
+  /* Execute the operations of a batch in order, in the thread pool */
+  void Execute(const eos::rpc::NSBatchRequest& batch)
+  {
+    WAIT_BOOT;
+
+    for (const auto& op : batch.ops()) {
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        if (mDead) {
+          break;
+        }
+      }
+
+      eos::rpc::NSResult result;
+      result.set_id(op.id());
+      grpc::Status status = GrpcNsInterface::Exec(GetVid(op.request().authkey()),
+                            result.mutable_response(), &op.request());
+
+      if (!status.ok()) {
+        result.set_grpc_code(status.error_code());
+        result.set_grpc_message(status.error_message());
+      }
+
+      std::unique_lock<std::mutex> lock(mMutex);
+      mPending.add_results()->Swap(&result);
+      Schedule();
+    }
+
+    bool release = false;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      --mRefs;
+      Schedule();
+      release = !mRefs && (mDead || mFinishing);
+    }
+
+    if (release) {
+      GrpcNsStreamService* svc = mSvc;
+      delete this;
+      svc->CallDone();
+    }
+  }
+
+  /* Identity of the stream for the given auth key, mapped once per key */
+  eos::common::VirtualIdentity& GetVid(const std::string& authkey)
+  {
+    std::unique_lock<std::mutex> lock(mVidMutex);
+    auto it = mVids.find(authkey);
+
+    if (it == mVids.end()) {
+      it = mVids.emplace(authkey, eos::common::VirtualIdentity()).first;
+      GrpcServer::Vid(&mCtx, it->second, authkey);
+    }
+
+    return it->second;
+  }
+
+  GrpcNsStreamService* mSvc;
+  grpc::ServerContext mCtx;
+  grpc::ServerAsyncReaderWriter<eos::rpc::NSBatchResponse,
+       eos::rpc::NSBatchRequest> mStream;
+  Tag mRequestTag;
+  Tag mReadTag;
+  Tag mWriteTag;
+  Tag mFinishTag;
+  std::mutex mMutex;
+  eos::rpc::NSBatchRequest mRequest; ///< Target of the read in progress
+  eos::rpc::NSBatchResponse mResponse; ///< Results being written
+  eos::rpc::NSBatchResponse mPending; ///< Results waiting for the next write
+  size_t mInflight; ///< Operations read whose result is not written yet
+  size_t mRefs; ///< Tags in the queue and batches in the pool
+  grpc::Status mStatus; ///< Status sent when finishing the stream
+  bool mReading;
+  bool mWriting;
+  bool mReadsDone;
+  bool mFinishing;
+  bool mDead; ///< Stream broken or finished, nothing is started anymore
+  std::mutex mVidMutex;
+  std::map<std::string, eos::common::VirtualIdentity> mVids;
+};
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+GrpcNsStreamService::GrpcNsStreamService(size_t max_inflight):
+  mPool(4, 64, 10, 6, 5, "grpc_stream"),
+  mMaxInflight(max_inflight ? max_inflight : 1), mCalls(0)
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+GrpcNsStreamService::~GrpcNsStreamService()
+{
+  Stop();
+}
+
+//------------------------------------------------------------------------------
+// Register the service and its completion queue
+//------------------------------------------------------------------------------
+void
+GrpcNsStreamService::Register(grpc::ServerBuilder& builder)
+{
+  builder.RegisterService(&mService);
+  mCq = builder.AddCompletionQueue();
+}
+
+//------------------------------------------------------------------------------
+// Start serving streams
+//------------------------------------------------------------------------------
+void
+GrpcNsStreamService::Start(size_t pollers)
+{
+  new Call(this);
+
+  for (size_t i = 0; i < pollers; ++i) {
+    mPollers.emplace_back(&GrpcNsStreamService::Poll, this);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Stop serving, all the calls are released once the server is shut down
+//------------------------------------------------------------------------------
+void
+GrpcNsStreamService::Stop()
+{
+  if (!mCq) {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCond.wait(lock, [this] { return mCalls == 0; });
+  }
+
+  // Nothing is queued anymore, drain the queue before its destruction
+  mCq->Shutdown();
+
+  for (auto& poller : mPollers) {
+    poller.join();
+  }
+
+  mPollers.clear();
+  void* tag;
+  bool ok;
+
+  // without pollers if never started
+  while (mCq->Next(&tag, &ok)) {}
+
+  mCq.reset();
+}
+
+//------------------------------------------------------------------------------
+// Process the events of the completion queue
+//------------------------------------------------------------------------------
+void
+GrpcNsStreamService::Poll()
+{
+  void* tag;
+  bool ok;
+
+  while (mCq->Next(&tag, &ok)) {
+    auto* call_tag = static_cast<Call::Tag*>(tag);
+    call_tag->call->Proceed(call_tag->op, ok);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Account for a released call
+//------------------------------------------------------------------------------
+void
+GrpcNsStreamService::CallDone()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  --mCalls;
+  mCond.notify_all();
+}
+
+EOSMGMNAMESPACE_END
+#endif
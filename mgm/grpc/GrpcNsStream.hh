@@ -0,0 +1,86 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+
+#ifdef EOS_GRPC
+#include "mgm/Namespace.hh"
+#include "common/ThreadPool.hh"
+#include "proto/NsStream.grpc.pb.h"
+#include <grpc++/grpc++.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+EOSMGMNAMESPACE_BEGIN
+
+/**
+ * @file   GrpcNsStream.hh
+ *
+ * @brief  Asynchronous server side of the EosStream service
+ *
+ * The streams are driven by a completion queue, so an open stream does not
+ * hold a server thread. The namespace operations are executed by a thread
+ * pool, one task per batch. A stream is not read any further while it has
+ * too many operations whose result is not yet written, which pushes back
+ * on the client through the gRPC flow control. A batch holding more
+ * operations than this limit is refused, the stream is then finished with
+ * RESOURCE_EXHAUSTED once the results of the previous batches are written.
+ */
+class GrpcNsStreamService
+{
+public:
+  /* Constructor
+   * @param max_inflight max number of pending operations per stream, also
+   *        the max number of operations of a batch
+   */
+  GrpcNsStreamService(size_t max_inflight = 1024);
+
+  ~GrpcNsStreamService();
+
+  /* Register the service and its completion queue, before the server start */
+  void Register(grpc::ServerBuilder& builder);
+
+  /* Start serving streams, once the server is started */
+  void Start(size_t pollers = 2);
+
+  /* Stop serving, once the server is shut down */
+  void Stop();
+
+private:
+  class Call;
+
+  /* Process the events of the completion queue */
+  void Poll();
+
+  /* Account for a call which is released */
+  void CallDone();
+
+  eos::rpc::EosStream::AsyncService mService;
+  std::unique_ptr<grpc::ServerCompletionQueue> mCq;
+  eos::common::ThreadPool mPool; ///< Executing the batches of operations
+  std::vector<std::thread> mPollers;
+  size_t mMaxInflight;
+  std::mutex mMutex;
+  std::condition_variable mCond;
+  size_t mCalls; ///< Number of calls alive, including the one waiting
+};
+
+EOSMGMNAMESPACE_END
+#endif
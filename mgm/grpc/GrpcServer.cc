@@ -23,6 +23,7 @@
 
 #include "GrpcServer.hh"
 #include "GrpcNsInterface.hh"
+#include "GrpcNsStream.hh"
 #include <google/protobuf/util/json_util.h>
 #include "common/Logging.hh"
 #include "common/StringConversion.hh"
@@ -292,6 +293,14 @@ GrpcServer::Run(ThreadAssistant& assistant) noexcept
   }
 
   RequestServiceImpl service;
+  // Bulk namespace operations are served asynchronously
+  size_t max_inflight = 1024;
+
+  if (getenv("EOS_MGM_GRPC_STREAM_MAX_INFLIGHT")) {
+    max_inflight = strtoul(getenv("EOS_MGM_GRPC_STREAM_MAX_INFLIGHT"), 0, 10);
+  }
+
+  GrpcNsStreamService stream_service(max_inflight);
   std::string bind_address = "0.0.0.0:";
   bind_address += std::to_string(mPort);
   grpc::ServerBuilder builder;
@@ -317,12 +326,16 @@ GrpcServer::Run(ThreadAssistant& assistant) noexcept
   }
 
   builder.RegisterService(&service);
+  stream_service.Register(builder);
   mServer = builder.BuildAndStart();
 
   if (mServer) {
+    stream_service.Start();
     mServer->Wait();
   }
 
+  stream_service.Stop();
+
 #else
   // Make the compiler happy
   (void) mPort;
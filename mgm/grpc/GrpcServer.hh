@@ -65,7 +65,10 @@ public:
 #ifdef EOS_GRPC
 
     if (mServer) {
-      mServer->Shutdown();
+      // Streams stay open as long as the clients want, cancel them after
+      // a grace period
+      mServer->Shutdown(std::chrono::system_clock::now() +
+                        std::chrono::seconds(5));
     }
 
 #endif
@@ -178,6 +178,21 @@ HttpHandler::Get(eos::common::HttpRequest* request, bool isHEAD)
   eos::common::OwnCloud::OwnCloudRemapping(spath, request);
   eos::common::OwnCloud::ReplaceRemotePhp(spath);
 
+  if (spath == "/proc/metrics") {
+    // Latency histograms in the Prometheus text format, admins only
+    if (mVirtualIdentity->uid && !mVirtualIdentity->sudoer) {
+      return HttpServer::HttpError("Metrics require admin privileges",
+                                   response->FORBIDDEN);
+    }
+
+    std::string body;
+    gOFS->MgmStats.PrintOutPrometheus(body);
+    response = new eos::common::PlainHttpResponse();
+    response->AddHeader("Content-Type", "text/plain; version=0.0.4");
+    response->SetBody(body);
+    return response;
+  }
+
   if (!spath.beginswith("/proc/")) {
     XrdOucErrInfo error(mVirtualIdentity->tident.c_str());
     {
@@ -40,6 +40,48 @@ EOSMGMNAMESPACE_BEGIN
                           </head><body>No such file or directory</body></html>"
 
 #ifdef EOS_MICRO_HTTPD
+/*----------------------------------------------------------------------------*/
+/**
+ * State of a streamed response body, keeping the protocol handler and its
+ * response alive until the body is sent
+ */
+struct BodyStream {
+  eos::common::ProtocolHandler* handler;
+  std::string chunk;
+  size_t offset;
+  bool more;
+};
+
+/*----------------------------------------------------------------------------*/
+ssize_t
+HttpServer::StreamBody(void* cls, uint64_t pos, char* buf, size_t max)
+{
+  BodyStream* stream = (BodyStream*) cls;
+
+  while (stream->offset == stream->chunk.length()) {
+    if (!stream->more) {
+      return MHD_CONTENT_READER_END_OF_STREAM;
+    }
+
+    stream->more = stream->handler->GetResponse()->NextBodyChunk(stream->chunk);
+    stream->offset = 0;
+  }
+
+  size_t len = std::min(max, stream->chunk.length() - stream->offset);
+  memcpy(buf, stream->chunk.data() + stream->offset, len);
+  stream->offset += len;
+  return len;
+}
+
+/*----------------------------------------------------------------------------*/
+void
+HttpServer::StreamBodyFree(void* cls)
+{
+  BodyStream* stream = (BodyStream*) cls;
+  delete stream->handler;
+  delete stream;
+}
+
 /*----------------------------------------------------------------------------*/
 int
 HttpServer::Handler(void* cls,
@@ -212,9 +254,19 @@ HttpServer::Handler(void* cls,
   eos_static_debug("\n\n%s", response->ToString().c_str());
   // Create the response
   struct MHD_Response* mhdResponse;
-  mhdResponse = MHD_create_response_from_buffer(response->GetBodySize(), (void*)
-                response->GetBody().c_str(),
-                MHD_RESPMEM_MUST_COPY);
+  BodyStream* stream = nullptr;
+
+  if (response->IsStreamed()) {
+    // the body stream takes over the protocol handler
+    stream = new BodyStream{protocolHandler, "", 0, true};
+    mhdResponse = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 64 * 1024,
+                  &HttpServer::StreamBody, stream,
+                  &HttpServer::StreamBodyFree);
+  } else {
+    mhdResponse = MHD_create_response_from_buffer(response->GetBodySize(), (void*)
+                  response->GetBody().c_str(),
+                  MHD_RESPMEM_MUST_COPY);
+  }
 
   if (mhdResponse) {
     // Add all the response header tags
@@ -229,11 +281,16 @@ HttpServer::Handler(void* cls,
                                  mhdResponse);
     eos_static_debug("msg=\"MHD_queue_response\" retc=%d", ret);
     MHD_destroy_response(mhdResponse);
-    delete protocolHandler;
+
+    if (!stream) {
+      delete protocolHandler;
+    }
+
     *ptr = 0;
     return ret;
   } else {
     eos_static_crit("msg=\"response creation failed\"");
+    delete stream;
     delete protocolHandler;
     *ptr = 0;
     return MHD_NO;
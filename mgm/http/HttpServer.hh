@@ -90,7 +90,26 @@ public:
                   void**                             con_cls,
                   enum MHD_RequestTerminationCode    toe);
 
+  /**
+   * MHD content reader sending a streamed response body
+   *
+   * @param cls     the body stream, owning the protocol handler
+   * @param pos     position in the body
+   * @param buf     buffer to be filled
+   * @param max     size of the buffer
+   *
+   * @return number of bytes written to buf or MHD_CONTENT_READER_END_OF_STREAM
+   */
+  static ssize_t
+  StreamBody(void* cls, uint64_t pos, char* buf, size_t max);
 
+  /**
+   * Release a body stream once the response is done
+   *
+   * @param cls     the body stream
+   */
+  static void
+  StreamBodyFree(void* cls);
 
 #endif
 
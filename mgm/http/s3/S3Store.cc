@@ -25,8 +25,8 @@
 #include "mgm/http/s3/S3Store.hh"
 #include "mgm/http/s3/S3Handler.hh"
 #include "mgm/XrdMgmOfs.hh"
-#include "mgm/XrdMgmOfsDirectory.hh"
 #include "namespace/interface/IView.hh"
+#include "namespace/interface/ContainerIterators.hh"
 #include "namespace/utils/Checksum.hh"
 #include "common/http/PlainHttpResponse.hh"
 #include "common/Logging.hh"
@@ -203,6 +203,389 @@ S3Store::ListBuckets(const std::string& id)
   return response;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+ * Escape the XML special characters of an object key
+ */
+static std::string
+XmlEscape(const std::string& in)
+{
+  std::string out;
+  out.reserve(in.length());
+
+  for (char c : in) {
+    switch (c) {
+    case '&':
+      out += "&amp;";
+      break;
+
+    case '<':
+      out += "&lt;";
+      break;
+
+    case '>':
+      out += "&gt;";
+      break;
+
+    case '"':
+      out += "&quot;";
+      break;
+
+    case '\'':
+      out += "&apos;";
+      break;
+
+    default:
+      out += c;
+    }
+  }
+
+  return out;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+ * Build a ListObjectsV2 continuation token, i.e. a cursor made of the id of
+ * the listed container and of the last listed key without the prefix, hex
+ * encoded to be used as is in a query string
+ */
+static std::string
+EncodeContinuationToken(uint64_t cid, const std::string& name)
+{
+  return eos::common::StringConversion::string_to_hex(std::to_string(cid) +
+         "/" + name);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+ * Decode a continuation token built by EncodeContinuationToken
+ *
+ * @return false if the token is malformed
+ */
+static bool
+DecodeContinuationToken(const std::string& token, uint64_t& cid,
+                        std::string& name)
+{
+  if (token.empty() || (token.length() % 2)) {
+    return false;
+  }
+
+  std::string decoded;
+  decoded.reserve(token.length() / 2);
+
+  for (size_t i = 0; i < token.length(); i += 2) {
+    int val = 0;
+
+    for (size_t j = i; j < i + 2; ++j) {
+      char c = token[j];
+      val <<= 4;
+
+      if ((c >= '0') && (c <= '9')) {
+        val += c - '0';
+      } else if ((c >= 'A') && (c <= 'F')) {
+        val += c - 'A' + 10;
+      } else if ((c >= 'a') && (c <= 'f')) {
+        val += c - 'a' + 10;
+      } else {
+        return false;
+      }
+    }
+
+    decoded += (char) val;
+  }
+
+  size_t pos = decoded.find('/');
+
+  if ((pos == 0) || (pos == std::string::npos) ||
+      (decoded.find_first_not_of("0123456789") != pos)) {
+    return false;
+  }
+
+  cid = strtoull(decoded.c_str(), 0, 10);
+  name = decoded.substr(pos + 1);
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+ * State of a streamed bucket listing. The position in the listed container
+ * is kept as the last listed key without the prefix: the children maps are
+ * sorted by name, so every part of the listing starts with a lower bound
+ * lookup instead of walking the container from its first entry.
+ *
+ * The keys must be listed in lexicographic order. Files are listed under
+ * their name, which is also the order of the files map, but subcontainers
+ * are listed as name + "/". A subcontainer therefore follows the ones
+ * extending its name with a character below '/', e.g. "a-b/" < "a/", so it
+ * is deferred until the subcontainers map has moved past them.
+ */
+struct S3BucketListing {
+  //! subcontainer name and id
+  typedef std::pair<std::string, eos::IContainerMD::id_t> SubContainer;
+
+  eos::IContainerMDPtr cmd; //!< listed container, null if missing
+  std::string prefix; //!< key prefix of the listed container
+  std::string cursor; //!< last listed key without the prefix
+  uint64_t max_keys = 1000;
+  uint64_t count = 0; //!< number of listed keys
+  bool v2 = false; //!< ListObjectsV2 response
+  bool fetch_owner = true; //!< add the owner of the objects
+  bool done = false; //!< no more entries to list
+  std::string header; //!< response start, sent with the first part
+  std::string trailer; //!< response end, without the truncation status
+  std::string last_key; //!< last listed key, i.e. the V1 next marker
+
+  static constexpr uint64_t kBatchSize = 256; //!< entries per body part
+
+  /**
+   * Append the Contents entry of a file or of a container
+   */
+  void
+  AppendEntry(std::string& out, const std::string& key,
+              eos::IFileMD* fmd, eos::IContainerMD* cmd)
+  {
+    using namespace eos::common;
+    int errc = 0;
+    eos::IFileMD::ctime_t mtime;
+    uid_t uid;
+    gid_t gid;
+    out += "<Contents><Key>";
+    out += XmlEscape(key);
+    out += "</Key><LastModified>";
+
+    if (fmd) {
+      fmd->getMTime(mtime);
+      uid = fmd->getCUid();
+      gid = fmd->getCGid();
+    } else {
+      cmd->getMTime(mtime);
+      uid = cmd->getCUid();
+      gid = cmd->getCGid();
+    }
+
+    out += Timing::UnixTimestamp_to_ISO8601(mtime.tv_sec);
+    out += "</LastModified><ETag>";
+
+    if (fmd) {
+      out += "\"";
+      eos::appendChecksumOnStringAsHex(fmd, out);
+      out += "\"";
+    }
+
+    out += "</ETag><Size>";
+
+    if (fmd) {
+      std::string sconv;
+      out += StringConversion::GetSizeString(sconv, (unsigned long long)
+                                             fmd->getSize());
+    } else {
+      out += "0";
+    }
+
+    out += "</Size><StorageClass>STANDARD</StorageClass>";
+
+    if (fetch_owner) {
+      out += "<Owner><ID>";
+      out += Mapping::UidToUserName(uid, errc);
+      out += "</ID><DisplayName>";
+      out += Mapping::UidToUserName(uid, errc);
+      out += ":";
+      out += Mapping::GidToGroupName(gid, errc);
+      out += "</DisplayName></Owner>";
+    }
+
+    out += "</Contents>";
+  }
+
+  /**
+   * @return true if the key of subcontainer name sorts before the one of
+   *         the deferred subcontainer
+   */
+  static bool
+  IsDeferredBy(const std::string& deferred, const std::string& name)
+  {
+    return (name.length() > deferred.length()) &&
+           (name.compare(0, deferred.length(), deferred) == 0) &&
+           ((unsigned char) name[deferred.length()] < '/');
+  }
+
+  /**
+   * Get the subcontainers with a key after the cursor but a name up to the
+   * cursor, i.e. the ones deferred when the cursor was listed. These are
+   * the cursor itself and its prefixes followed by a character below '/'.
+   */
+  std::vector<SubContainer>
+  GetDeferred()
+  {
+    std::vector<SubContainer> deferred;
+
+    for (size_t i = 1; i <= cursor.length(); ++i) {
+      if (cursor[i - 1] == '/') {
+        // names never contain a slash
+        break;
+      }
+
+      if ((i < cursor.length()) && ((unsigned char) cursor[i] >= '/')) {
+        continue;
+      }
+
+      std::string name = cursor.substr(0, i);
+
+      try {
+        eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+        auto dmd = cmd->findContainer(name);
+
+        if (dmd) {
+          deferred.emplace_back(name, dmd->getId());
+        }
+      } catch (eos::MDException& e) {
+        // the entry was removed in the meantime
+      }
+    }
+
+    return deferred;
+  }
+
+  /**
+   * Get the next subcontainer in key order
+   *
+   * @param cit iterator over the subcontainers map
+   * @param deferred subcontainers read from the map but not listed yet
+   * @param out next subcontainer
+   *
+   * @return false if there are no subcontainers left
+   */
+  static bool
+  NextContainer(eos::ContainerMapIterator& cit,
+                std::vector<SubContainer>& deferred, SubContainer& out)
+  {
+    while (cit.valid()) {
+      if (!deferred.empty() && !IsDeferredBy(deferred.back().first, cit.key())) {
+        break;
+      }
+
+      deferred.emplace_back(cit.key(), cit.value());
+      cit.next();
+    }
+
+    if (deferred.empty()) {
+      return false;
+    }
+
+    out = std::move(deferred.back());
+    deferred.pop_back();
+    return true;
+  }
+
+  /**
+   * Produce the next part of the listing
+   *
+   * @return false once the listing is complete
+   */
+  bool
+  Next(std::string& out)
+  {
+    if (header.length()) {
+      out += header;
+      header.clear();
+    }
+
+    uint64_t batch = 0;
+
+    if (cmd && !done) {
+      // the iterators handle concurrent modifications of the maps
+      eos::FileMapIterator fit(cmd, cursor);
+      eos::ContainerMapIterator cit(cmd, cursor);
+      std::vector<SubContainer> deferred = GetDeferred();
+      SubContainer dir;
+      bool dir_valid = NextContainer(cit, deferred, dir);
+
+      while ((fit.valid() || dir_valid) && (batch < kBatchSize)) {
+        if (count == max_keys) {
+          break;
+        }
+
+        // merge files and subcontainers in key order
+        bool is_file = fit.valid() &&
+                       (!dir_valid || (fit.key() < dir.first + "/"));
+        cursor = (is_file ? fit.key() : dir.first + "/");
+        std::string key = prefix + cursor;
+
+        try {
+          eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
+
+          if (is_file) {
+            auto fmd = gOFS->eosFileService->getFileMD(fit.value());
+            AppendEntry(out, key, fmd.get(), nullptr);
+          } else {
+            auto dmd = gOFS->eosDirectoryService->getContainerMD(dir.second);
+            AppendEntry(out, key, nullptr, dmd.get());
+          }
+
+          last_key = key;
+          ++count;
+          ++batch;
+        } catch (eos::MDException& e) {
+          // the entry was removed in the meantime
+          eos_static_debug("msg=\"skip listing entry\" key=\"%s\" ec=%d emsg=\"%s\"",
+                           key.c_str(), e.getErrno(), e.getMessage().str().c_str());
+        }
+
+        if (is_file) {
+          fit.next();
+        } else {
+          dir_valid = NextContainer(cit, deferred, dir);
+        }
+      }
+
+      if ((batch < kBatchSize) || (count == max_keys)) {
+        done = true;
+
+        // the listing is truncated if entries are left after max-keys
+        if (fit.valid() || dir_valid) {
+          out += "<IsTruncated>true</IsTruncated>";
+
+          if (v2) {
+            out += "<NextContinuationToken>";
+            out += EncodeContinuationToken(cmd->getId(), cursor);
+            out += "</NextContinuationToken>";
+          } else {
+            out += "<NextMarker>";
+            out += XmlEscape(last_key);
+            out += "</NextMarker>";
+          }
+
+          Finish(out);
+          return false;
+        }
+      }
+    }
+
+    if (cmd && !done) {
+      return true;
+    }
+
+    out += "<IsTruncated>false</IsTruncated>";
+    Finish(out);
+    return false;
+  }
+
+  /**
+   * Append the end of the response
+   */
+  void
+  Finish(std::string& out)
+  {
+    if (v2) {
+      out += "<KeyCount>";
+      out += std::to_string(count);
+      out += "</KeyCount>";
+    }
+
+    out += trailer;
+  }
+};
+
 /*----------------------------------------------------------------------------*/
 eos::common::HttpResponse*
 S3Store::ListBucket(const std::string& bucket, const std::string& query)
@@ -234,20 +617,34 @@ S3Store::ListBucket(const std::string& bucket, const std::string& query)
 
   XrdOucEnv parameter(query.c_str());
   XrdOucString lPrefix, lBucket;
-  XrdMgmOfsDirectory bucketdir;
-  uint64_t cnt = 0;
-  uint64_t max_keys = 1000;
+  auto listing = std::make_shared<S3BucketListing>();
   std::string marker = "";
   std::string prefix = "";
-  bool marker_reached = true; //!< indicates start of output
+  std::string token = "";
   const char* val = 0;
 
+  if ((val = parameter.Get("list-type"))) {
+    listing->v2 = (std::string(val) == "2");
+  }
+
   if ((val = parameter.Get("max-keys"))) {
-    max_keys = strtoull(val, 0, 10);
+    listing->max_keys = strtoull(val, 0, 10);
   }
 
-  if ((val = parameter.Get("marker"))) {
-    marker = val;
+  if (listing->v2) {
+    // ListObjectsV2 only returns the owner on request
+    listing->fetch_owner = ((val = parameter.Get("fetch-owner")) &&
+                            (std::string(val) == "true"));
+
+    if ((val = parameter.Get("continuation-token"))) {
+      token = val;
+    }
+
+    if ((val = parameter.Get("start-after"))) {
+      marker = StringConversion::curl_default_unescaped(val);
+    }
+  } else if ((val = parameter.Get("marker"))) {
+    marker = StringConversion::curl_default_unescaped(val);
 
     if (marker == "(null)") {
       marker = "";
@@ -255,11 +652,7 @@ S3Store::ListBucket(const std::string& bucket, const std::string& query)
   }
 
   if ((val = parameter.Get("prefix"))) {
-    prefix = val;
-  }
-
-  if (marker.length()) {
-    marker_reached = false;
+    prefix = StringConversion::curl_default_unescaped(val);
   }
 
   // handle ending slash in bucket and prefix paths
@@ -275,10 +668,44 @@ S3Store::ListBucket(const std::string& bucket, const std::string& query)
     lPrefix += "/";
   }
 
+  listing->prefix = lPrefix.c_str();
   eos_static_info("msg=\"listing\" bucket=%s prefix=%s", bucket.c_str(),
                   lPrefix.c_str());
+  std::string directory = lBucket.c_str();
+  directory += lPrefix.c_str();
+
+  try {
+    RWMutexReadLock lock(gOFS->eosViewRWMutex);
+    listing->cmd = gOFS->eosView->getContainer(directory);
+  } catch (eos::MDException& e) {
+    // nothing to list
+    listing->cmd.reset();
+  }
+
+  if (token.length()) {
+    uint64_t cid = 0;
+
+    if (!DecodeContinuationToken(token, cid, listing->cursor) ||
+        (listing->cmd && (listing->cmd->getId() != cid))) {
+      return S3Handler::RestErrorResponse(eos::common::HttpResponse::BAD_REQUEST,
+                                          "InvalidArgument",
+                                          "The continuation token provided "
+                                          "is incorrect", bucket.c_str(), "");
+    }
+  } else if (marker.length()) {
+    // resume after the marker key, which might also be inside of a
+    // subdirectory
+    if (marker.compare(0, listing->prefix.length(), listing->prefix) == 0) {
+      listing->cursor = marker.substr(listing->prefix.length());
+    } else if (marker > listing->prefix) {
+      // all the keys are before the marker
+      listing->done = true;
+    }
+  }
+
   // Construct listing response
-  std::string result = XML_V1_UTF8;
+  std::string& result = listing->header;
+  result = XML_V1_UTF8;
   result += "<ListBucketResult xmlns=\"http://doc.s3.amazonaws.com/2006-03-01\">";
   result += "<Name>";
   result += bucket;
@@ -288,179 +715,43 @@ S3Store::ListBucket(const std::string& bucket, const std::string& query)
     result += "<Prefix/>";
   } else {
     result += "<Prefix>";
-    result += prefix;
+    result += XmlEscape(prefix);
     result += "</Prefix>";
   }
 
-  if ((!marker.length() || (!marker.c_str()))) {
+  if (listing->v2) {
+    if (token.length()) {
+      result += "<ContinuationToken>";
+      result += XmlEscape(token);
+      result += "</ContinuationToken>";
+    }
+
+    if (marker.length()) {
+      result += "<StartAfter>";
+      result += XmlEscape(marker);
+      result += "</StartAfter>";
+    }
+  } else if (!marker.length()) {
     result += "<Marker/>";
   } else {
     result += "<Marker>";
-    result += marker;
+    result += XmlEscape(marker);
     result += "</Marker>";
   }
 
   result += "<Delimiter>/</Delimiter>";
   result += "<MaxKeys>";
-  char smaxkeys[16];
-  snprintf(smaxkeys, sizeof(smaxkeys) - 1, "%llu",
-           (unsigned long long) max_keys);
-  result += smaxkeys;
+  result += std::to_string(listing->max_keys);
   result += "</MaxKeys>";
-  bool truncated = false;
-  size_t truncate_pos = result.length() + 13;
-  result += "<IsTruncated>false</IsTruncated>";
-  // list directory
-  std::string directory = lBucket.c_str();
-  directory += lPrefix.c_str();
-  int listrc = bucketdir.open(directory.c_str(), vid, (const char*) 0);
-
-  if (!listrc) {
-    const char* name = 0;
-
-    // loop over the directory contents
-    while ((name = bucketdir.nextEntry())) {
-      std::string entry = "";
-      std::string sname = name;
-
-      if ((sname == ".") || (sname == "..")) {
-        continue;
-      }
-
-      // don't return more than max-keys
-      if (cnt++ > max_keys) {
-        truncated = true;
-        break;
-      }
-
-      // construct object name
-      std::string objectname = lPrefix.c_str();
-      objectname += sname;
-      std::string fullname = lBucket.c_str();
-      fullname += objectname;
-
-      // check if output should begin
-      if (!marker_reached) {
-        if (marker == objectname) {
-          marker_reached = true;
-        }
-
-        continue;
-      }
-
-      {
-        // attempt file metadata retrieval
-        eos::common::RWMutexReadLock lock(gOFS->eosViewRWMutex);
-        std::shared_ptr<eos::IContainerMD> cmd;
-        std::shared_ptr<eos::IFileMD> fmd;
-        int errc = 0;
-
-        try {
-          fmd = gOFS->eosView->getFile(fullname);
-          entry = "<Contents>";
-          entry += "<Key>";
-          entry += objectname.c_str();
-          entry += "</Key>";
-          entry += "<LastModified>";
-          eos::IFileMD::ctime_t mtime;
-          fmd->getMTime(mtime);
-          entry += Timing::UnixTimestamp_to_ISO8601(mtime.tv_sec);
-          entry += "</LastModified>";
-          entry += "<ETag>\"";
-          eos::appendChecksumOnStringAsHex(fmd.get(), entry);
-          entry += "\"</ETag>";
-          entry += "<Size>";
-          std::string sconv;
-          entry += StringConversion::GetSizeString(sconv, (unsigned long long)
-                   fmd->getSize());
-          entry += "</Size>";
-          entry += "<StorageClass>STANDARD</StorageClass>";
-          entry += "<Owner>";
-          entry += "<ID>";
-          entry += Mapping::UidToUserName(fmd->getCUid(), errc);
-          entry += "</ID>";
-          entry += "<DisplayName>";
-          entry += Mapping::UidToUserName(fmd->getCUid(), errc);
-          entry += ":";
-          entry += Mapping::GidToGroupName(fmd->getCGid(), errc);
-          entry += "</DisplayName>";
-          entry += "</Owner>";
-          entry += "</Contents>";
-        } catch (eos::MDException& e) {
-          fmd.reset();
-
-          if (e.getErrno() != ENOENT) {
-            errno = e.getErrno();
-            eos_static_err("msg=\"could not open file\" ec=%d emsg=\"%s\" filepath=%s\n",
-                           e.getErrno(), e.getMessage().str().c_str(),
-                           fullname.c_str());
-            return S3Handler::RestErrorResponse(
-                     eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
-                     "Internal Error", "Unable to open path",
-                     fullname.c_str(), "");
-          }
-        }
-
-        // should be a container
-        if (!fmd) {
-          // attempt container metadata retrieval
-          try {
-            cmd = gOFS->eosView->getContainer(fullname);
-            entry = "<Contents>";
-            entry += "<Key>";
-            entry += objectname.c_str();
-            entry += "/";
-            entry += "</Key>";
-            entry += "<LastModified>";
-            eos::IContainerMD::ctime_t mtime;
-            cmd->getMTime(mtime);
-            entry += Timing::UnixTimestamp_to_ISO8601(mtime.tv_sec);
-            entry += "</LastModified>";
-            entry += "<ETag>";
-            entry += "</ETag>";
-            entry += "<Size>0</Size>";
-            entry += "<StorageClass>STANDARD</StorageClass>";
-            entry += "<Owner>";
-            entry += "<ID>";
-            entry += Mapping::UidToUserName(cmd->getCUid(), errc);
-            entry += "</ID>";
-            entry += "<DisplayName>";
-            entry += Mapping::UidToUserName(cmd->getCUid(), errc);
-            entry += ":";
-            entry += Mapping::GidToGroupName(cmd->getCGid(), errc);
-            entry += "</DisplayName>";
-            entry += "</Owner>";
-            entry += "</Contents>";
-          } catch (eos::MDException& e) {
-            cmd.reset();
-            errno = e.getErrno();
-            eos_static_err("msg=\"could not open directory\" ec=%d emsg=\"%s\" dirpath=%s\n",
-                           e.getErrno(), e.getMessage().str().c_str(),
-                           fullname.c_str());
-            return S3Handler::RestErrorResponse(
-                     eos::common::HttpResponse::INTERNAL_SERVER_ERROR,
-                     "Internal Error", "Unable to open path",
-                     fullname.c_str(), "");
-          }
-        }
-      }
-
-      // append this entry to the final result
-      result += entry;
-    }
-  }
-
-  bucketdir.close();
-
-  if (truncated) {
-    result.replace(truncate_pos, 18, "true</IsTruncated>");
-  }
-
-  result += "</ListBucketResult>";
+  // the truncation status and the continuation are only known at the end
+  listing->trailer = "</ListBucketResult>";
   response = new PlainHttpResponse();
   response->AddHeader("Content-Type", "application/xml");
   response->AddHeader("Connection", "close");
-  response->SetBody(result);
+  // the listing is produced while being sent
+  response->SetBodyProducer([listing](std::string & chunk) {
+    return listing->Next(chunk);
+  });
   return response;
 }
 
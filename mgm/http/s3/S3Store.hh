@@ -93,7 +93,11 @@ public:
   ListBuckets (const std::string &id);
 
   /**
-   * Get a bucket listing for a given S3 bucket
+   * Get a bucket listing for a given S3 bucket, ListObjectsV2 if the query
+   * has list-type=2. Pages continue after the marker, start-after key or
+   * continuation token through a lower bound lookup in the sorted children
+   * of the listed container, so the cost of a page does not depend on its
+   * position. The body is streamed while the entries are retrieved.
    *
    * @param bucket  the name of the bucket to list
    * @param query   the client request query string
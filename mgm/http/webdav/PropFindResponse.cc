@@ -32,6 +32,7 @@
 #include "common/Timing.hh"
 #include "common/Path.hh"
 #include "common/http/OwnCloud.hh"
+#include "namespace/Prefetcher.hh"
 #include <XrdOuc/XrdOucErrInfo.hh>
 
 EOSMGMNAMESPACE_BEGIN
@@ -162,54 +163,55 @@ PropFindResponse::BuildResponse(eos::common::HttpRequest* request)
       return this;
     }
   } else if (depth == "1") {
-    // Stat the resource and all child resources
-    XrdMgmOfsDirectory directory;
-    int listrc = directory.open(request->GetUrl().c_str(), *mVirtualIdentity,
-                                (const char*) 0);
+    // Stat the resource and stream the child resources, large directories
+    // would otherwise need the whole document in memory
+    mDirectory = std::make_shared<XrdMgmOfsDirectory>();
+    int listrc = mDirectory->open(request->GetUrl().c_str(), *mVirtualIdentity,
+                                  "ls.skip.prefetch=1");
     responseNode = BuildResponseNode(request->GetUrl().c_str(),
                                      request->GetUrl(true).c_str());
 
-    if (responseNode) {
-      multistatusNode->append_node(responseNode);
-    }
-
-    if (!listrc) {
-      const char* val;
-
-      while ((val = directory.nextEntry())) {
-        XrdOucString entryname = val;
-
-        // don't display . .., atomic(+version) uploads and version directories
-        if (entryname.beginswith(EOS_COMMON_PATH_VERSION_FILE_PREFIX) ||
-            entryname.beginswith(EOS_COMMON_PATH_ATOMIC_FILE_PREFIX) ||
-            entryname.beginswith(EOS_WEBDAV_HIDE_IN_PROPFIND_PREFIX) ||
-            entryname.beginswith("...eos.ino...") ||
-            (entryname == ".") ||
-            (entryname == "..")) {
-          // skip over . .., and hidden files
-          continue;
-        }
-
-        // one response node for each file...
-        eos::common::Path path((request->GetUrl() + std::string("/") + std::string(
-                                  val)).c_str());
-        eos::common::Path refpath((request->GetUrl(true) + std::string("/") +
-                                   std::string(val)).c_str());
-        responseNode = BuildResponseNode(path.GetPath(), refpath.GetPath());
-
-        if (responseNode) {
-          multistatusNode->append_node(responseNode);
-        } else {
-          // We might have a failed stat in the BuildResponseNode if there are
-          // symlinks present
-          SetResponseCode(HttpResponse::OK);
-        }
-      }
-    } else {
+    if (listrc) {
       eos_static_warning("msg=\"error opening directory - might be stalled/banned\"");
+      mDirectory.reset();
       SetResponseCode(ResponseCodes::FORBIDDEN);
       return this;
     }
+
+    mDirectoryUrl = request->GetUrl();
+    mDirectoryHrefUrl = request->GetUrl(true);
+    // The document start is sent first, the multistatus node is closed once
+    // all the children are listed
+    std::string head = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                       "<d:multistatus xmlns:d=\"DAV:\" ";
+    head += eos::common::OwnCloud::OwnCloudNs();
+    head += "=\"";
+    head += eos::common::OwnCloud::OwnCloudNsUrl();
+    head += "\">";
+
+    if (responseNode) {
+      rapidxml::print(std::back_inserter(head), *responseNode,
+                      rapidxml::print_no_indenting);
+    }
+
+    mXMLResponseDocument.clear();
+    // The first batch of children is stated before the response header is
+    // sent. A failed stat, e.g. because of symlinks, turns the response code
+    // into OK as when the whole document was built up front.
+    bool stat_failed = false;
+    bool more = StreamChildren(head, stat_failed);
+    SetResponseCode(stat_failed ? HttpResponse::OK : HttpResponse::MULTI_STATUS);
+    AddHeader("Content-Type", "application/xml; charset=utf-8");
+    SetBodyProducer([this, head, more](std::string & chunk) mutable {
+      if (!head.empty()) {
+        chunk.swap(head);
+        return more;
+      }
+
+      bool failed = false;
+      return StreamChildren(chunk, failed);
+    });
+    return this;
   } else if (depth == "1,noroot") {
     // Stat all child resources but not the requested resource
     SetResponseCode(HttpResponse::NOT_IMPLEMENTED);
@@ -231,6 +233,80 @@ PropFindResponse::BuildResponse(eos::common::HttpRequest* request)
   return this;
 }
 
+/*----------------------------------------------------------------------------*/
+bool
+PropFindResponse::StreamChildren(std::string& chunk, bool& stat_failed)
+{
+  if (!mDirectory) {
+    return false;
+  }
+
+  // url and href url of the next batch of children
+  std::vector<std::pair<std::string, std::string>> batch;
+  const char* val;
+
+  while ((batch.size() < kStreamBatchSize) && (val = mDirectory->nextEntry())) {
+    XrdOucString entryname = val;
+
+    // don't display . .., atomic(+version) uploads and version directories
+    if (entryname.beginswith(EOS_COMMON_PATH_VERSION_FILE_PREFIX) ||
+        entryname.beginswith(EOS_COMMON_PATH_ATOMIC_FILE_PREFIX) ||
+        entryname.beginswith(EOS_WEBDAV_HIDE_IN_PROPFIND_PREFIX) ||
+        entryname.beginswith("...eos.ino...") ||
+        (entryname == ".") ||
+        (entryname == "..")) {
+      // skip over . .., and hidden files
+      continue;
+    }
+
+    // one response node for each file...
+    eos::common::Path path((mDirectoryUrl + std::string("/") +
+                            std::string(val)).c_str());
+    eos::common::Path refpath((mDirectoryHrefUrl + std::string("/") +
+                               std::string(val)).c_str());
+    batch.emplace_back(path.GetPath(), refpath.GetPath());
+  }
+
+  if (batch.size()) {
+    // Fetch the metadata of the whole batch in parallel
+    eos::Prefetcher prefetcher(gOFS->eosView);
+
+    for (const auto& entry : batch) {
+      std::string raw_path = entry.first;
+      eos::mgm::NamespaceMap(raw_path, nullptr, *mVirtualIdentity);
+      prefetcher.stageItem(raw_path, false);
+    }
+
+    prefetcher.wait();
+  }
+
+  for (const auto& entry : batch) {
+    rapidxml::xml_node<>* responseNode = BuildResponseNode(entry.first,
+                                         entry.second);
+
+    // We might have a failed stat in the BuildResponseNode if there are
+    // symlinks present, the entry is then skipped
+    if (responseNode) {
+      rapidxml::print(std::back_inserter(chunk), *responseNode,
+                      rapidxml::print_no_indenting);
+    } else {
+      stat_failed = true;
+    }
+  }
+
+  // release the nodes of this batch
+  mXMLResponseDocument.clear();
+
+  if (batch.size() < kStreamBatchSize) {
+    chunk += "</d:multistatus>";
+    mDirectory->close();
+    mDirectory.reset();
+    return false;
+  }
+
+  return true;
+}
+
 /*----------------------------------------------------------------------------*/
 void
 PropFindResponse::ParseRequestPropertyTypes(rapidxml::xml_node<>* node)
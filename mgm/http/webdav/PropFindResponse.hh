@@ -43,6 +43,10 @@
 /*----------------------------------------------------------------------------*/
 #include <XrdOuc/XrdOucErrInfo.hh>
 /*----------------------------------------------------------------------------*/
+#include <memory>
+/*----------------------------------------------------------------------------*/
+
+class XrdMgmOfsDirectory;
 
 EOSMGMNAMESPACE_BEGIN;
 
@@ -84,6 +88,27 @@ public:
 protected:
   int mRequestPropertyTypes; //!< properties that were requested
   eos::common::VirtualIdentity *mVirtualIdentity; //!< virtual identity for this client
+  std::shared_ptr<XrdMgmOfsDirectory> mDirectory; //!< directory being streamed
+  std::string mDirectoryUrl; //!< url of the directory being streamed
+  std::string mDirectoryHrefUrl; //!< href url of the directory being streamed
+
+  /**
+   * Number of children stated for each part of a streamed response
+   */
+  static constexpr size_t kStreamBatchSize = 512;
+
+  /**
+   * Produce the next part of a streamed Depth:1 response. The metadata of
+   * the next batch of children is prefetched in parallel, then their
+   * response nodes are printed and released.
+   *
+   * @param chunk  buffer receiving the response nodes
+   * @param stat_failed  set to true if the stat of a child failed
+   *
+   * @return false once all the children are listed
+   */
+  bool
+  StreamChildren (std::string &chunk, bool &stat_failed);
 
 public:
 
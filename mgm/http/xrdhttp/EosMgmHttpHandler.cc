@@ -341,6 +341,26 @@ EosMgmHttpHandler::ProcessReq(XrdHttpExtReq& req)
                               response->GetResponseCodeDescription().c_str(),
                               oss_header.str().c_str(),
                               nullptr, content_length);
+  } else if (response->IsStreamed()) {
+    // Send the body part by part as it gets produced
+    if (req.StartChunkedResp(response->GetResponseCode(),
+                             response->GetResponseCodeDescription().c_str(),
+                             oss_header.str().c_str())) {
+      return -1;
+    }
+
+    std::string chunk;
+    bool more = true;
+
+    while (more) {
+      more = response->NextBodyChunk(chunk);
+
+      if (chunk.length() && req.ChunkResp(chunk.c_str(), chunk.length())) {
+        return -1;
+      }
+    }
+
+    return req.ChunkResp(nullptr, 0);
   } else {
     return req.SendSimpleResp(response->GetResponseCode(),
                               response->GetResponseCodeDescription().c_str(),
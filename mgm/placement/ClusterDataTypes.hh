@@ -25,6 +25,7 @@
 #define EOS_CLUSTERDATATYPES_HH
 
 #include "common/FileSystem.hh"
+#include <algorithm>
 #include <array>
 
 namespace eos::mgm::placement
@@ -125,6 +126,71 @@ struct Disk {
 
 static_assert(sizeof(Disk) == 8, "Disk data type not aligned to 8 bytes!");
 
+// Weight of the previous value in the disk utilisation EWMA, every new sample
+// contributes 1/2^kDiskLoadEwmaShift of the stored value
+constexpr uint8_t kDiskLoadEwmaShift = 1;
+// Utilisation values are stored in per mille
+constexpr uint16_t kMaxDiskUtil = 1000;
+
+// Live load of a disk as published by the FSTs, stored in a vector parallel
+// to the disks so that Disk stays at 8 bytes for the strategies not using it.
+// The utilisation values are in per mille, disk_util is smoothed with an EWMA
+// while open_files is the last reported number of open files plus the number
+// of placements done on the disk since then.
+struct DiskLoad {
+  mutable std::atomic<uint16_t> disk_util{0};
+  mutable std::atomic<uint16_t> net_util{0};
+  mutable std::atomic<uint32_t> open_files{0};
+
+  DiskLoad() = default;
+
+  DiskLoad(uint16_t _disk_util, uint16_t _net_util, uint32_t _open_files)
+    : disk_util(_disk_util), net_util(_net_util), open_files(_open_files)
+  {}
+
+  // explicit copy constructor as atomic types are not copyable
+  DiskLoad(const DiskLoad& other)
+    : DiskLoad(other.disk_util.load(std::memory_order_relaxed),
+               other.net_util.load(std::memory_order_relaxed),
+               other.open_files.load(std::memory_order_relaxed))
+  {
+  }
+
+  DiskLoad& operator=(const DiskLoad& other)
+  {
+    disk_util.store(other.disk_util.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    net_util.store(other.net_util.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+    open_files.store(other.open_files.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+    return *this;
+  }
+
+  // Expected response time of a new request relative to an idle disk, the
+  // queue of open files is served at a rate reduced by the busiest of the
+  // disk and the network, see M/M/1 response time 1/(1 - rho)
+  double cost() const
+  {
+    uint16_t util = std::min(std::max(disk_util.load(std::memory_order_relaxed),
+                                      net_util.load(std::memory_order_relaxed)),
+                             static_cast<uint16_t>(kMaxDiskUtil - 10));
+    return (open_files.load(std::memory_order_relaxed) + 1.0) /
+           (kMaxDiskUtil - util);
+  }
+
+  std::string to_string() const
+  {
+    std::stringstream ss;
+    ss << "DiskUtil: " << disk_util.load(std::memory_order_relaxed) << "\n"
+       << "NetUtil: " << net_util.load(std::memory_order_relaxed) << "\n"
+       << "OpenFiles: " << open_files.load(std::memory_order_relaxed);
+    return ss.str();
+  }
+};
+
+static_assert(sizeof(DiskLoad) == 8, "DiskLoad data type not aligned to 8 bytes!");
+
 // some common storage elements, these could be user defined in the future
 enum class StdBucketType : uint8_t {
   GROUP = 0,
@@ -230,6 +296,8 @@ struct Bucket {
 struct ClusterData {
   std::vector<Disk> disks;
   std::vector<Bucket> buckets;
+  // Optional, indexed like disks when populated
+  std::vector<DiskLoad> disk_loads;
 
   bool setDiskStatus(fsid_t id, ConfigStatus status)
   {
@@ -261,6 +329,40 @@ struct ClusterData {
     return true;
   }
 
+  // disk_util and net_util are fractions where 1 means fully busy
+  bool setDiskLoad(fsid_t id, double disk_util, double net_util,
+                   uint32_t open_files)
+  {
+    if (id == 0 || id > disk_loads.size()) {
+      return false;
+    }
+
+    auto to_permille = [](double util) -> uint16_t {
+      if (!(util > 0)) {
+        return 0;
+      }
+
+      return static_cast<uint16_t>(std::min(util, 1.0) * kMaxDiskUtil);
+    };
+    auto& load = disk_loads[id - 1];
+    int32_t prev = load.disk_util.load(std::memory_order_relaxed);
+    int32_t sample = to_permille(disk_util);
+    load.disk_util.store(prev + ((sample - prev) >> kDiskLoadEwmaShift),
+                         std::memory_order_relaxed);
+    load.net_util.store(to_permille(net_util), std::memory_order_relaxed);
+    load.open_files.store(open_files, std::memory_order_relaxed);
+    return true;
+  }
+
+  const DiskLoad* getDiskLoad(item_id_t id) const
+  {
+    if (id <= 0 || (size_t)id > disk_loads.size()) {
+      return nullptr;
+    }
+
+    return &disk_loads[id - 1];
+  }
+
   std::string getDisksAsString() const
   {
     std::string result_str;
@@ -271,6 +373,11 @@ struct ClusterData {
     for (const auto& d : disks) {
       result_str.append(d.to_string());
       result_str.append("\n");
+
+      if (auto load = getDiskLoad(d.id)) {
+        result_str.append(load->to_string());
+        result_str.append("\n");
+      }
     }
 
     return result_str;
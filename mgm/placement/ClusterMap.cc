@@ -76,6 +76,14 @@ ClusterMgr::setDiskWeight(fsid_t disk_id, uint8_t weight)
   return false;
 }
 
+bool
+ClusterMgr::setDiskLoad(fsid_t disk_id, double disk_util, double net_util,
+                        uint32_t open_files)
+{
+  eos::common::RCUReadLock rlock(cluster_mgr_rcu);
+  return mClusterData->setDiskLoad(disk_id, disk_util, net_util, open_files);
+}
+
 StorageHandler
 ClusterMgr::getStorageHandlerWithData()
 {
@@ -156,6 +164,7 @@ StorageHandler::addDisk(Disk disk, item_id_t bucket_id)
   }
 
   mData.disks[insert_pos] = disk;
+  mData.disk_loads.resize(mData.disks.size());
   mData.buckets[-bucket_id].items.push_back(disk.id);
   mData.buckets[-bucket_id].total_weight += disk.weight;
   return true;
@@ -169,6 +178,7 @@ StorageHandler::addDiskSequential(Disk disk, item_id_t bucket_id)
   }
 
   mData.disks.push_back(disk);
+  mData.disk_loads.resize(mData.disks.size());
   mData.buckets[-bucket_id].items.push_back(disk.id);
   mData.buckets[-bucket_id].total_weight += disk.weight;
   return true;
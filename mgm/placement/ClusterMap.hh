@@ -74,6 +74,8 @@ public:
   bool setDiskStatus(fsid_t disk_id, ConfigStatus status);
   bool setDiskStatus(fsid_t disk_id, ActiveStatus status);
   bool setDiskWeight(fsid_t disk_id, uint8_t weight);
+  bool setDiskLoad(fsid_t disk_id, double disk_util, double net_util,
+                   uint32_t open_files);
   // Not meant to be called directly! use storage handler, we might consider
   // making this private and friending if this is abused
   void addClusterData(ClusterData&& data);
@@ -1,8 +1,12 @@
 #include "mgm/placement/FlatScheduler.hh"
+#include "mgm/placement/LoadAwarePlacementStrategy.hh"
 #include "mgm/placement/RoundRobinPlacementStrategy.hh"
 #include "mgm/placement/WeightedRandomStrategy.hh"
 #include "mgm/placement/WeightedRoundRobinStrategy.hh"
+#include <cmath>
+#include <limits>
 #include <queue>
+#include <random>
 
 namespace eos::mgm::placement {
 
@@ -19,6 +23,8 @@ makePlacementStrategy(PlacementStrategyT type, size_t max_buckets)
     return std::make_unique<WeightedRandomPlacement>(type, max_buckets);
   case PlacementStrategyT::kWeightedRoundRobin:
     return std::make_unique<WeightedRoundRobinPlacement>(type, max_buckets);
+  case PlacementStrategyT::kLoadAware:
+    return std::make_unique<LoadAwarePlacement>(type, max_buckets);
   default:
     return nullptr;
   }
@@ -155,4 +161,495 @@ FlatScheduler::scheduleDefault(const ClusterData& cluster_data,
 }
 
 
+namespace {
+
+constexpr uint64_t kUnlimitedCapacity = std::numeric_limits<uint64_t>::max();
+// Fractional part of the golden ratio, successive multiples give a low
+// discrepancy sequence in [0, 1)
+constexpr double kGoldenRatioFrac = 0.6180339887498949;
+
+// Split n units over the items in proportion to their weights without going
+// over their capacity. Uses systematic sampling i.e. n equidistant points
+// starting at offset * step over the cumulative weights, so every item gets
+// either the floor or the ceil of its fair share. Whatever does not fit is
+// spread again over the items with capacity left. The capacities are updated
+// and the sum of the returned counts is less than n only if there is not
+// enough capacity.
+void
+distributeBatch(const std::vector<uint64_t>& weights,
+                std::vector<uint64_t>& capacities, uint64_t n, double offset,
+                std::vector<uint64_t>& counts)
+{
+  counts.assign(weights.size(), 0);
+
+  while (n) {
+    double total_wt = 0;
+
+    for (size_t i = 0; i < weights.size(); ++i) {
+      if (weights[i] && capacities[i]) {
+        total_wt += weights[i];
+      }
+    }
+
+    if (total_wt == 0) {
+      break;
+    }
+
+    const double step = total_wt / n;
+    const double inv_step = n / total_wt;
+    const double start = offset * step;
+    double next_point = start;
+    double cumulative_wt = 0;
+    uint64_t prev_points = 0;
+    uint64_t assigned = 0;
+
+    for (size_t i = 0; i < weights.size(); ++i) {
+      if (!weights[i] || !capacities[i]) {
+        continue;
+      }
+
+      cumulative_wt += weights[i];
+
+      // Cheap skip of the items without any sampling point, the common case
+      // for batches smaller than the number of items
+      if (cumulative_wt <= next_point) {
+        continue;
+      }
+
+      // Number of sampling points below the cumulative weight
+      double points = std::ceil((cumulative_wt - start) * inv_step);
+      uint64_t n_points = (points <= 0) ? 0 :
+                          std::min<uint64_t>(n, static_cast<uint64_t>(points));
+      uint64_t count = std::min(n_points - std::min(n_points, prev_points),
+                                capacities[i]);
+      prev_points = std::max(prev_points, n_points);
+      next_point = start + prev_points * step;
+      counts[i] += count;
+      capacities[i] -= count;
+      assigned += count;
+    }
+
+    if (assigned == 0) {
+      break;
+    }
+
+    n -= assigned;
+  }
+}
+
+struct BatchBucketInfo {
+  uint64_t generation {0}; // Batch that filled in the entry
+  bool weight_done {false};
+  bool disks_done {false};
+  uint64_t weight {0};
+  // Range of eligible disks in BatchScratch::disks, only for groups
+  uint32_t disk_begin {0};
+  uint32_t disk_count {0};
+};
+
+// Buffers reused by the batches scheduled from the same thread, the bucket
+// entries are invalidated by bumping the generation instead of clearing
+struct BatchScratch {
+  uint64_t generation {0};
+  std::vector<BatchBucketInfo> buckets;
+  std::vector<item_id_t> disks; // Eligible disks of the visited groups
+  std::vector<uint64_t> disk_capacities; // Replicas each disk can still take
+  std::vector<uint64_t> weights;
+  std::vector<uint64_t> capacities;
+  std::vector<uint64_t> counts;
+};
+
+// Placement state of a single batch. Only the buckets and groups that
+// receive files are visited, the weights of the buckets are estimated from
+// the static total weight of the groups and files that do not fit in a
+// bucket are spread over its siblings.
+class BatchPlacement {
+public:
+  BatchPlacement(const ClusterData& data, const PlacementArguments& args,
+                 uint32_t max_per_disk, double offset) :
+    mData(data), mArgs(args), mMaxPerDisk(max_per_disk), mOffset(offset),
+    mWeighted(args.strategy == PlacementStrategyT::kWeightedRandom ||
+              args.strategy == PlacementStrategyT::kWeightedRoundRobin),
+    mScratch(tlScratch)
+  {
+    ++mScratch.generation;
+
+    if (mScratch.buckets.size() < data.buckets.size()) {
+      mScratch.buckets.resize(data.buckets.size());
+    }
+
+    mScratch.disks.clear();
+    mScratch.disk_capacities.clear();
+  }
+
+  // Place up to n_files below the given bucket, one result is appended for
+  // every file placed. Returns the number of files placed.
+  uint64_t place(item_id_t bucket_id, uint64_t n_files,
+                 std::vector<PlacementResult>& results)
+  {
+    const auto& bucket = mData.buckets[-bucket_id];
+
+    if (bucket.bucket_type == get_bucket_type(StdBucketType::GROUP)) {
+      return placeInGroup(bucket_id, n_files, results);
+    }
+
+    std::vector<item_id_t> children;
+    std::vector<uint64_t> weights;
+    children.reserve(bucket.items.size());
+    weights.reserve(bucket.items.size());
+
+    for (const auto item_id : bucket.items) {
+      if (!isValidBucketId(item_id, mData)) {
+        continue;
+      }
+
+      uint64_t weight = estimateWeight(item_id);
+
+      if (weight) {
+        children.push_back(item_id);
+        weights.push_back(weight);
+      }
+    }
+
+    std::vector<uint64_t> capacities(children.size(), kUnlimitedCapacity);
+    std::vector<uint64_t> counts;
+    uint64_t n_placed = 0;
+
+    while (n_placed < n_files) {
+      distributeBatch(weights, capacities, n_files - n_placed, nextOffset(),
+                      counts);
+      uint64_t n_assigned = 0;
+
+      for (size_t i = 0; i < children.size(); ++i) {
+        if (counts[i] == 0) {
+          continue;
+        }
+
+        n_assigned += counts[i];
+        uint64_t n_child = place(children[i], counts[i], results);
+        n_placed += n_child;
+
+        // The child is full, the rest goes to its siblings in the next round
+        if (n_child < counts[i]) {
+          capacities[i] = 0;
+        }
+      }
+
+      if (n_assigned == 0) {
+        break;
+      }
+    }
+
+    return n_placed;
+  }
+
+private:
+  static thread_local BatchScratch tlScratch;
+
+  BatchBucketInfo& bucketInfo(item_id_t bucket_id)
+  {
+    auto& info = mScratch.buckets[-bucket_id];
+
+    if (info.generation != mScratch.generation) {
+      info = BatchBucketInfo();
+      info.generation = mScratch.generation;
+    }
+
+    return info;
+  }
+
+  // Weight of a bucket, the sum of the disk weights below it for the
+  // weighted strategies, 1 for any bucket that can hold a file otherwise
+  uint64_t estimateWeight(item_id_t bucket_id)
+  {
+    auto& info = bucketInfo(bucket_id);
+
+    if (info.weight_done) {
+      return info.weight;
+    }
+
+    info.weight_done = true;
+    const auto& bucket = mData.buckets[-bucket_id];
+    uint64_t weight = 0;
+
+    if (bucket.bucket_type == get_bucket_type(StdBucketType::GROUP)) {
+      if (bucket.items.size() >= mArgs.n_replicas) {
+        weight = mWeighted ? bucket.total_weight : 1;
+      }
+    } else {
+      for (const auto item_id : bucket.items) {
+        if (isValidBucketId(item_id, mData)) {
+          weight += estimateWeight(item_id);
+        }
+      }
+
+      if (!mWeighted) {
+        weight = std::min<uint64_t>(weight, 1);
+      }
+    }
+
+    info.weight = weight;
+    return weight;
+  }
+
+  // Same checks as PlacementStrategy::validDiskPlct without copying the
+  // arguments for every disk
+  bool isUsableDisk(item_id_t disk_id) const
+  {
+    if (disk_id <= 0 || (size_t)disk_id > mData.disks.size()) {
+      return false;
+    }
+
+    if (!mArgs.excludefs.empty() &&
+        std::find(mArgs.excludefs.begin(), mArgs.excludefs.end(),
+                  disk_id) != mArgs.excludefs.end()) {
+      return false;
+    }
+
+    const auto& disk = mData.disks[disk_id - 1];
+    return disk.active_status.load(std::memory_order_acquire) ==
+           eos::common::ActiveStatus::kOnline &&
+           disk.config_status.load(std::memory_order_acquire) >= mArgs.status;
+  }
+
+  uint64_t diskWeight(item_id_t disk_id) const
+  {
+    if (!mWeighted) {
+      return 1;
+    }
+
+    return mData.disks[disk_id - 1].weight.load(std::memory_order_relaxed);
+  }
+
+  double nextOffset()
+  {
+    mOffset += kGoldenRatioFrac;
+    mOffset -= std::floor(mOffset);
+    return mOffset;
+  }
+
+  // Max number of files, up to n_files, with distinct replicas that fit on
+  // disks with the given remaining capacities. F files fit if the disks can
+  // take n*F replicas with at most F replicas per disk.
+  uint64_t maxFilesInGroup(const uint64_t* capacities, uint32_t n_disks,
+                           uint64_t n_files) const
+  {
+    auto fits = [&](uint64_t n) {
+      uint64_t n_slots = 0;
+
+      for (uint32_t i = 0; i < n_disks; ++i) {
+        n_slots += std::min(capacities[i], n);
+      }
+
+      return n_slots >= n * mArgs.n_replicas;
+    };
+    uint64_t low = 0;
+    uint64_t high = n_files;
+
+    while (low < high) {
+      uint64_t mid = low + (high - low + 1) / 2;
+
+      if (fits(mid)) {
+        low = mid;
+      } else {
+        high = mid - 1;
+      }
+    }
+
+    return low;
+  }
+
+  // Lay the replicas out disk after disk and deal them to the files in
+  // stripes of n_files, since no disk gets more than n_files replicas the
+  // replicas of every file end up on distinct disks
+  uint64_t placeInGroup(item_id_t bucket_id, uint64_t n_files,
+                        std::vector<PlacementResult>& results)
+  {
+    auto& info = bucketInfo(bucket_id);
+
+    if (!info.disks_done) {
+      info.disks_done = true;
+      info.disk_begin = mScratch.disks.size();
+
+      for (const auto item_id : mData.buckets[-bucket_id].items) {
+        if (isUsableDisk(item_id) && diskWeight(item_id)) {
+          mScratch.disks.push_back(item_id);
+          mScratch.disk_capacities.push_back(mMaxPerDisk ? mMaxPerDisk :
+                                             kUnlimitedCapacity);
+          ++info.disk_count;
+        }
+      }
+    }
+
+    const uint64_t n_replicas = mArgs.n_replicas;
+
+    if (info.disk_count < n_replicas) {
+      return 0;
+    }
+
+    const item_id_t* disks = mScratch.disks.data() + info.disk_begin;
+    uint64_t* disk_capacities = mScratch.disk_capacities.data() +
+                                info.disk_begin;
+
+    if (mMaxPerDisk) {
+      n_files = maxFilesInGroup(disk_capacities, info.disk_count, n_files);
+
+      if (n_files == 0) {
+        return 0;
+      }
+    }
+
+    auto& weights = mScratch.weights;
+    auto& capacities = mScratch.capacities;
+    auto& counts = mScratch.counts;
+    weights.clear();
+    capacities.clear();
+
+    for (uint32_t i = 0; i < info.disk_count; ++i) {
+      weights.push_back(diskWeight(disks[i]));
+      capacities.push_back(std::min(disk_capacities[i], n_files));
+    }
+
+    distributeBatch(weights, capacities, n_files * n_replicas, nextOffset(),
+                    counts);
+    const size_t first = results.size();
+    results.resize(first + n_files, PlacementResult(n_replicas));
+    uint64_t slot = 0;
+
+    for (uint32_t i = 0; i < info.disk_count; ++i) {
+      if (mMaxPerDisk) {
+        disk_capacities[i] -= counts[i];
+      }
+
+      for (uint64_t k = 0; k < counts[i]; ++k, ++slot) {
+        results[first + slot % n_files].ids[slot / n_files] = disks[i];
+      }
+    }
+
+    for (uint64_t f = 0; f < n_files; ++f) {
+      auto& result = results[first + f];
+
+      if (!result.is_valid_placement(n_replicas)) {
+        result.err_msg = "Could not find enough items to place replicas";
+        result.ret_code = ENOSPC;
+        continue;
+      }
+
+      // Rotate the replicas so that the first one is not always taken from
+      // the first disks of the group
+      std::rotate(result.ids.begin(), result.ids.begin() + f % n_replicas,
+                  result.ids.begin() + n_replicas);
+      result.ret_code = 0;
+    }
+
+    return n_files;
+  }
+
+  const ClusterData& mData;
+  const PlacementArguments& mArgs;
+  const uint32_t mMaxPerDisk;
+  double mOffset;
+  const bool mWeighted;
+  BatchScratch& mScratch;
+};
+
+thread_local BatchScratch BatchPlacement::tlScratch;
+
+} // anonymous namespace
+
+std::vector<PlacementResult>
+FlatScheduler::scheduleBatch(const ClusterData& cluster_data,
+                             PlacementArguments args,
+                             size_t n_files,
+                             uint32_t max_per_disk)
+{
+  std::vector<PlacementResult> results;
+
+  if (n_files == 0) {
+    return results;
+  }
+
+  results.reserve(n_files);
+
+  if (!is_valid_placement_strategy(args.strategy)) {
+    args.strategy = mDefaultStrategy;
+  }
+
+  // The load aware placement depends on the load left by the previous
+  // placements so it can't be split upfront
+  if (!args.default_placement ||
+      args.strategy == PlacementStrategyT::kLoadAware) {
+    for (size_t i = 0; i < n_files; ++i) {
+      results.push_back(schedule(cluster_data, args));
+    }
+
+    return results;
+  }
+
+  PlacementResult err_result(args.n_replicas);
+
+  if (args.n_replicas == 0) {
+    err_result.err_msg = "Zero replicas requested";
+    err_result.ret_code = EINVAL;
+  } else if (args.n_replicas > err_result.ids.size()) {
+    err_result.err_msg = "Too many replicas requested";
+    err_result.ret_code = ERANGE;
+  } else if (!is_valid_placement_strategy(args.strategy) ||
+             mPlacementStrategy[strategy_index(args.strategy)] == nullptr) {
+    err_result.err_msg = "Not a valid PlacementStrategy";
+    err_result.ret_code = EINVAL;
+  } else if (args.forced_group_index >= 0) {
+    args.bucket_id = kBaseGroupOffset - args.forced_group_index;
+
+    if (!isValidBucketId(args.bucket_id, cluster_data)) {
+      err_result.err_msg = "Invalid forced group index";
+      err_result.ret_code = EINVAL;
+    }
+  } else if (!isValidBucketId(args.bucket_id, cluster_data) &&
+             args.bucket_id != 0) {
+    err_result.err_msg = "Bucket id out of range";
+    err_result.ret_code = ERANGE;
+  }
+
+  if (err_result.err_msg) {
+    results.assign(n_files, err_result);
+    return results;
+  }
+
+  // Round-robin strategies rotate the starting point of every batch, the
+  // random ones start at a random point
+  double offset = 0;
+
+  switch (args.strategy) {
+  case PlacementStrategyT::kRoundRobin: [[fallthrough]];
+  case PlacementStrategyT::kThreadLocalRoundRobin:
+    offset = mBatchCounter.fetch_add(1, std::memory_order_relaxed) *
+             kGoldenRatioFrac;
+    break;
+
+  case PlacementStrategyT::kFidRandom:
+    offset = args.fid * kGoldenRatioFrac;
+    break;
+
+  default: {
+    static thread_local std::mt19937_64 gen(std::random_device{}());
+    offset = std::uniform_real_distribution<double>(0, 1)(gen);
+  }
+  }
+
+  offset -= std::floor(offset);
+  BatchPlacement batch(cluster_data, args, max_per_disk, offset);
+  uint64_t n_placed = batch.place(args.bucket_id, n_files, results);
+
+  if (n_placed < n_files) {
+    PlacementResult result(args.n_replicas);
+    result.err_msg = "Could not find enough items to place replicas";
+    result.ret_code = ENOSPC;
+    results.insert(results.end(), n_files - n_placed, result);
+  }
+
+  return results;
+}
+
+
 } // namespace eos::mgm::placement
@@ -26,7 +26,9 @@
 #include "mgm/placement/ClusterDataTypes.hh"
 #include "mgm/placement/PlacementStrategy.hh"
 #include <algorithm>
+#include <atomic>
 #include <optional>
+#include <vector>
 
 namespace eos::mgm::placement {
 
@@ -41,6 +43,20 @@ public:
   PlacementResult schedule(const ClusterData& cluster_data,
                            PlacementArguments args);
 
+  // Place n_files files with the same layout in a single pass over the
+  // cluster data. The eligible disks and the capacity of every bucket are
+  // computed once per batch, then the files are split over the buckets and
+  // disks in proportion to their weights (uniformly for the non weighted
+  // strategies). No disk receives more than max_per_disk replicas from the
+  // batch, 0 means no limit. One result is returned per file, the files that
+  // could not be placed have their ret_code set. Only the default placement
+  // is batched, rule based and load aware placements are scheduled file by
+  // file.
+  std::vector<PlacementResult> scheduleBatch(const ClusterData& cluster_data,
+                                             PlacementArguments args,
+                                             size_t n_files,
+                                             uint32_t max_per_disk = 0);
+
 private:
   PlacementResult scheduleDefault(const ClusterData& cluster_data,
                                   PlacementArguments args);
@@ -48,6 +64,7 @@ private:
   std::array<std::unique_ptr<PlacementStrategy>, TOTAL_PLACEMENT_STRATEGIES>
       mPlacementStrategy;
   PlacementStrategyT mDefaultStrategy{PlacementStrategyT::Count};
+  std::atomic<uint64_t> mBatchCounter{0};
 };
 } // namespace eos::mgm::placement
 
@@ -187,6 +187,30 @@ FSScheduler::schedule(const std::string& spaceName,
   return result;
 }
 
+std::vector<PlacementResult>
+FSScheduler::scheduleBatch(const std::string& spaceName,
+                           PlacementArguments args,
+                           size_t n_files,
+                           uint32_t max_per_disk)
+{
+  if (!is_valid_placement_strategy(args.strategy)) {
+    args.strategy = getPlacementStrategy(spaceName);
+  }
+
+  eos::common::RCUReadLock rlock(cluster_rcu_mutex);
+  auto cluster_mgr = get_cluster_mgr(spaceName);
+
+  if (!cluster_mgr) {
+    eos_static_crit("msg=\"Scheduler is not yet initialized for space=%s\"",
+                    spaceName.c_str());
+    return std::vector<PlacementResult>(n_files);
+  }
+
+  auto cluster_data_ptr = cluster_mgr->getClusterData();
+  return scheduler->scheduleBatch(cluster_data_ptr(), std::move(args), n_files,
+                                  max_per_disk);
+}
+
 PlacementResult
 FSScheduler::schedule(const std::string& spaceName, uint8_t n_replicas)
 {
@@ -256,6 +280,28 @@ FSScheduler::setDiskWeight(const std::string& spaceName, fsid_t disk_id,
   return cluster_mgr->setDiskWeight(disk_id, weight);
 }
 
+bool
+FSScheduler::setDiskLoad(const std::string& spaceName, fsid_t disk_id,
+                         double disk_util, double net_util,
+                         uint32_t open_files)
+{
+  if (spaceName.empty() || disk_id == 0) {
+    return false;
+  }
+
+  eos::common::RCUReadLock rlock(cluster_rcu_mutex);
+  auto* cluster_mgr = get_cluster_mgr(spaceName);
+
+  if (!cluster_mgr) {
+    // Called periodically for every disk, don't flood the logs
+    eos_static_debug("msg=\"Scheduler is not yet initialized for\" space=%s",
+                     spaceName.c_str());
+    return false;
+  }
+
+  return cluster_mgr->setDiskLoad(disk_id, disk_util, net_util, open_files);
+}
+
 void
 FSScheduler::setPlacementStrategy(std::string_view strategy_sv)
 {
@@ -62,6 +62,10 @@ public:
 
   PlacementResult schedule(const std::string& spaceName, uint8_t n_replicas);
   PlacementResult schedule(const std::string& spaceName, PlacementArguments args);
+  std::vector<PlacementResult> scheduleBatch(const std::string& spaceName,
+                                             PlacementArguments args,
+                                             size_t n_files,
+                                             uint32_t max_per_disk = 0);
   void updateClusterData();
   bool setDiskStatus(const std::string& spaceName, fsid_t disk_id,
                      ConfigStatus status);
@@ -71,6 +75,11 @@ public:
   bool setDiskWeight(const std::string& spaceName, fsid_t disk_id,
                      uint8_t weight);
 
+  // Update the live load of a disk used by the load aware placement,
+  // utilisation values are fractions where 1 means fully busy
+  bool setDiskLoad(const std::string& spaceName, fsid_t disk_id,
+                   double disk_util, double net_util, uint32_t open_files);
+
   bool isRunning() const;
 
   void setPlacementStrategy(std::string_view strategy_sv);
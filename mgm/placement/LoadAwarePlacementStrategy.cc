@@ -0,0 +1,110 @@
+// ----------------------------------------------------------------------
+//! @file: LoadAwarePlacementStrategy.cc
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/placement/LoadAwarePlacementStrategy.hh"
+#include <random>
+
+namespace eos::mgm::placement
+{
+
+PlacementResult
+LoadAwarePlacement::placeFiles(const ClusterData& data, Args args)
+{
+  PlacementResult result(args.n_replicas);
+
+  if (!validateArgs(data, args, result)) {
+    return result;
+  }
+
+  static thread_local std::mt19937 gen(std::random_device{}());
+  const auto& items = data.buckets[-args.bucket_id].items;
+  std::uniform_int_distribution<size_t> dist(0, items.size() - 1);
+  int attempts = 0;
+  bool unknown_disk = false;
+  // Draw a random item usable for this placement, 0 if none is found
+  auto draw = [&](item_id_t other) -> item_id_t {
+    while (attempts++ < MAX_PLACEMENT_ATTEMPTS) {
+      item_id_t item_id = items[dist(gen)];
+
+      if (item_id == 0 || item_id == other || result.contains(item_id)) {
+        continue;
+      }
+
+      if (item_id > 0) {
+        if ((size_t)item_id > data.disks.size()) {
+          unknown_disk = true;
+          return 0;
+        }
+
+        if (!PlacementStrategy::validDiskPlct(item_id, data, args)) {
+          continue;
+        }
+      }
+
+      return item_id;
+    }
+
+    return 0;
+  };
+  int items_added = 0;
+
+  for (; items_added < args.n_replicas; ++items_added) {
+    attempts = 0;
+    item_id_t item_id = draw(0);
+
+    if (item_id == 0) {
+      break;
+    }
+
+    if (const DiskLoad* load = data.getDiskLoad(item_id)) {
+      // Not finding a second candidate is fine, the first one is used
+      item_id_t other_id = draw(item_id);
+      const DiskLoad* other_load = data.getDiskLoad(other_id);
+
+      if (other_load && (other_load->cost() < load->cost())) {
+        item_id = other_id;
+        load = other_load;
+      }
+
+      load->open_files.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    result.ids[items_added] = item_id;
+  }
+
+  if (unknown_disk) {
+    result.err_msg = "Disk ID unknown!";
+    result.ret_code = ERANGE;
+    return result;
+  }
+
+  if (items_added != args.n_replicas) {
+    result.err_msg = "Could not find enough items to place replicas";
+    result.ret_code = ENOSPC;
+    return result;
+  }
+
+  result.ret_code = 0;
+  return result;
+}
+
+} // namespace eos::mgm::placement
@@ -0,0 +1,45 @@
+// ----------------------------------------------------------------------
+//! @file: LoadAwarePlacementStrategy.hh
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "mgm/placement/PlacementStrategy.hh"
+namespace eos::mgm::placement {
+
+/**
+ * A placement strategy using the power of two choices: for every replica two
+ * disks are drawn at random from the group and the one with the lower
+ * DiskLoad::cost is used. Sampling only two candidates keeps the placement
+ * O(1) and, unlike always picking the least loaded disk, avoids herding all
+ * the writes on the same disk between two load updates. Every placement also
+ * bumps the open files of the chosen disk so that the decisions made before
+ * the next update see each other. Buckets above the group level are chosen
+ * uniformly at random. Without any load information this is a random placement.
+ */
+class LoadAwarePlacement : public PlacementStrategy {
+public:
+  LoadAwarePlacement(PlacementStrategyT strategy, size_t max_buckets) {}
+
+  virtual PlacementResult placeFiles(const ClusterData& data,
+                                     Args args) override;
+};
+
+} // namespace eos::mgm::placement
@@ -95,6 +95,7 @@ enum class PlacementStrategyT : uint8_t {
   kWeightedRandom,
   kWeightedRoundRobin,
   kGeoScheduler,
+  kLoadAware,
   Count
 };
 
@@ -148,6 +149,9 @@ constexpr PlacementStrategyT strategy_from_str(std::string_view strategy_sv)
   } else if (strategy_sv == "geoscheduler"sv ||
              strategy_sv == "geo"sv) {
     return PlacementStrategyT::kGeoScheduler;
+  } else if (strategy_sv == "loadaware"sv ||
+             strategy_sv == "p2c"sv) {
+    return PlacementStrategyT::kLoadAware;
   }
 
   // default to geoscheduler!
@@ -178,6 +182,9 @@ inline std::string strategy_to_str(PlacementStrategyT strategy)
   case PlacementStrategyT::kGeoScheduler:
     return "geoscheduler";
 
+  case PlacementStrategyT::kLoadAware:
+    return "loadaware";
+
   default:
     return "unknown";
   }
@@ -288,7 +295,7 @@ struct PlacementStrategy {
 
   static bool validDiskPlct(item_id_t disk_id,
                             const ClusterData& cluster_data,
-                            Args args)
+                            const Args& args)
   {
     if (disk_id <= 0) {
       return false;
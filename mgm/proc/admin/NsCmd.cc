@@ -45,6 +45,7 @@
 #include "mgm/Stat.hh"
 #include "mgm/ZMQ.hh"
 #include "mgm/convert/ConverterDriver.hh"
+#include "mgm/TransferScheduler.hh"
 #include "mgm/tgc/MultiSpaceTapeGc.hh"
 #include <sstream>
 
@@ -325,6 +326,8 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
   CacheStatistics fileCacheStats = gOFS->eosFileService->getCacheStatistics();
   CacheStatistics containerCacheStats =
     gOFS->eosDirectoryService->getCacheStatistics();
+  NegativeLookupCache::Stats negativeStats =
+    gOFS->mNegativeLookupCache.GetStats();
   common::MutexLatencyWatcher::LatencySpikes viewLatency =
     gOFS->mViewMutexWatcher.getLatencySpikes();
   double eosViewMutexPenultimateSecWriteLockTimePercentage =
@@ -359,6 +362,11 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
         << "\nuid=all gid=all ns.cache.containers.requests=" <<
         containerCacheStats.numRequests
         << "\nuid=all gid=all ns.cache.containers.hits=" << containerCacheStats.numHits
+        << "\nuid=all gid=all ns.cache.negative.maxsize=" << negativeStats.max_size
+        << "\nuid=all gid=all ns.cache.negative.occupancy=" <<
+        negativeStats.occupancy
+        << "\nuid=all gid=all ns.cache.negative.requests=" << negativeStats.requests
+        << "\nuid=all gid=all ns.cache.negative.hits=" << negativeStats.hits
         << "\nuid=all gid=all ns.total.files.changelog.size="
         << StringConversion::GetSizeString(clfsize, (unsigned long long) statf.st_size)
         << std::endl
@@ -415,6 +423,19 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
 
       oss << "uid=all gid=all ns.qclient.persistency_type="
           << qdb_group->getMetadataFlusher()->getPersistencyType() << "\n";
+      auto coalescing = qdb_group->getMetadataFlusher()->getCoalescingStats();
+
+      if (coalescing.mRequestsIn) {
+        oss << "uid=all gid=all ns.qclient.coalescing.requests_in="
+            << coalescing.mRequestsIn << "\n"
+            << "uid=all gid=all ns.qclient.coalescing.requests_out="
+            << coalescing.mRequestsOut << "\n"
+            << "uid=all gid=all ns.qclient.coalescing.bytes_in="
+            << coalescing.mBytesIn << "\n"
+            << "uid=all gid=all ns.qclient.coalescing.bytes_out="
+            << coalescing.mBytesOut << "\n";
+      }
+
       if (info.find("rtt_min") != info.end()) {
         oss << "uid=all gid=all ns.qclient.rtt_ms.min="
             << info["rtt_min"] / 1000 << std::endl
@@ -452,6 +473,12 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
         << std::endl;
     FsView::gFsView.DumpBalancerPoolInfo(oss, "uid=all gid=all ");
 
+    if (gOFS->mTransferScheduler) {
+      std::string tx_info;
+      gOFS->mTransferScheduler->PrintOut(tx_info, true);
+      oss << tx_info;
+    }
+
     // Only display the tape enabled state if it is set to true in order to
     // simplify the disk-only use of EOS
     if (gOFS->mTapeEnabled) {
@@ -583,6 +610,19 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
           << line << std::endl;
     }
 
+    if (negativeStats.max_size) {
+      oss << "ALL      Negative lookup cache max num    " << negativeStats.max_size
+          << std::endl
+          << "ALL      Negative lookup cache occupancy  " << negativeStats.occupancy
+          << std::endl
+          << "ALL      Negative lookup cache hit rate   " << std::fixed
+          << std::setprecision(2) << (negativeStats.requests ?
+                                      100.0 * negativeStats.hits / negativeStats.requests : 0.0)
+          << "% (" << negativeStats.hits << "/" << negativeStats.requests << ")"
+          << std::endl
+          << line << std::endl;
+    }
+
     oss << "ALL      eosViewRWMutex status            " <<
         (gOFS->mViewMutexWatcher.isLockedUp() ? "locked-up" : "available")
         << " (" << gOFS->mViewMutexWatcher.hangingSince() << "s) " << std::endl;
@@ -604,6 +644,15 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
       std::map<std::string, unsigned long long> info = perf_monitor->GetPerfMarkers();
       oss << "ALL      QClient Persistency              "
           << qdb_group->getMetadataFlusher()->getPersistencyType() << "\n";
+      auto coalescing = qdb_group->getMetadataFlusher()->getCoalescingStats();
+
+      if (coalescing.mRequestsIn) {
+        oss << "ALL      QClient coalesced writes         "
+            << coalescing.mRequestsOut << "/" << coalescing.mRequestsIn
+            << " requests " << coalescing.mBytesOut << "/"
+            << coalescing.mBytesIn << " bytes" << std::endl;
+      }
+
 
       if (info.find("rtt_min") != info.end()) {
         oss << "ALL      QClient overall RTT              "
@@ -664,6 +713,13 @@ NsCmd::StatSubcmd(const eos::console::NsProto_StatProto& stat,
         << std::endl;
     std::string_view prefix {"ALL      balancer info                    "};
     FsView::gFsView.DumpBalancerPoolInfo(oss, prefix);
+
+    if (gOFS->mTransferScheduler) {
+      std::string tx_info;
+      gOFS->mTransferScheduler->PrintOut(tx_info, false);
+      oss << tx_info;
+    }
+
     oss << line << std::endl
         << gOFS->mFidTracker.PrintStats() << std::endl
         << line << std::endl;
@@ -907,10 +963,19 @@ NsCmd::QuotaSizeSubcmd(const eos::console::NsProto_QuotaSizeProto& tree,
       return;
     }
 
-    std::unique_ptr<qclient::QClient> qcl =
-      std::make_unique<qclient::QClient>(gOFS->mQdbContactDetails.members,
-                                         gOFS->mQdbContactDetails.constructOptions());
-    eos::QuotaRecomputer recomputer(qcl.get(),
+    // Explore the quota node subtree in parallel over a few connections
+    const size_t num_connections = 4;
+    std::vector<std::unique_ptr<qclient::QClient>> qclients;
+    std::vector<qclient::QClient*> qcls;
+
+    for (size_t i = 0; i < num_connections; ++i) {
+      qclients.push_back(std::make_unique<qclient::QClient>
+                         (gOFS->mQdbContactDetails.members,
+                          gOFS->mQdbContactDetails.constructOptions()));
+      qcls.push_back(qclients.back().get());
+    }
+
+    eos::QuotaRecomputer recomputer(qcls,
                                     static_cast<QuarkNamespaceGroup*>(gOFS->namespaceGroup.get())->getExecutor());
     eos::MDStatus status = recomputer.recompute(cont_uri, cont_id, qnc);
 
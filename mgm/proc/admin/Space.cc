@@ -577,6 +577,10 @@ ProcCommand::Space()
                   (key == "drainer.node.nfs") ||
                   (key == "drainer.retries") ||
                   (key == "drainer.fs.ntx") ||
+                  (key == "transfer.fs.ntx") ||
+                  (key == "transfer.node.ntx") ||
+                  (key == "transfer.fs.rate") ||
+                  (key == "transfer.fs.maxload") ||
                   (key == "converter") ||
                   (key == "tracker") ||
                   (key == "inspector") ||
@@ -821,6 +821,10 @@ void SpaceCmd::ConfigSubcmd(const eos::console::SpaceProto_ConfigProto& config,
           (key == "drainer.node.nfs") ||
           (key == "drainer.retries") ||
           (key == "drainer.fs.ntx") ||
+          (key == "transfer.fs.ntx") ||
+          (key == "transfer.node.ntx") ||
+          (key == "transfer.fs.rate") ||
+          (key == "transfer.fs.maxload") ||
           (key == "converter") ||
           (key == "tracker") ||
           (key == "inspector") ||
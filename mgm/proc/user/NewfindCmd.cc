@@ -36,6 +36,7 @@
 #include "namespace/ns_quarkdb/FileMD.hh"
 #include "namespace/ns_quarkdb/NamespaceGroup.hh"
 #include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
 #include "namespace/utils/BalanceCalculator.hh"
 #include "namespace/utils/Checksum.hh"
 #include "namespace/utils/Stat.hh"
@@ -45,6 +46,34 @@
 
 EOSMGMNAMESPACE_BEGIN
 
+//! Number of QuarkDB connections and max number of workers used to explore
+//! the namespace
+static constexpr size_t sFindQdbConnections = 4;
+static constexpr size_t sFindWorkers = 8;
+
+//------------------------------------------------------------------------------
+// Get the QuarkDB connections used by the namespace exploration. They are
+// created by the first find and shared by all the following ones.
+//------------------------------------------------------------------------------
+static const std::vector<qclient::QClient*>&
+GetFindQClients()
+{
+  static std::vector<std::unique_ptr<qclient::QClient>> sOwned;
+  static const std::vector<qclient::QClient*> sQcls = []() {
+    std::vector<qclient::QClient*> qcls;
+
+    for (size_t i = 0; i < sFindQdbConnections; ++i) {
+      sOwned.push_back(std::make_unique<qclient::QClient>
+                       (gOFS->mQdbContactDetails.members,
+                        gOFS->mQdbContactDetails.constructOptions()));
+      qcls.push_back(sOwned.back().get());
+    }
+
+    return qcls;
+  }();
+  return sQcls;
+}
+
 
 template<typename T>
 static bool eliminateBasedOnFileMatch(const eos::console::FindProto& req,
@@ -952,13 +981,14 @@ class FindResultProvider
 public:
 
   //----------------------------------------------------------------------------
-  // QDB: Initialize NamespaceExplorer
+  // QDB: Initialize ParallelNamespaceExplorer, results are not DFS-ordered
   //----------------------------------------------------------------------------
-  FindResultProvider(qclient::QClient* qc, const std::string& target,
+  FindResultProvider(const std::vector<qclient::QClient*>& qc,
+                     const std::string& target,
                      const uint32_t depthlimit, const bool ignore_files,
                      bool skip_version_dirs, const eos::common::VirtualIdentity& v)
-    : qcl(qc), path(target), depthlimit(depthlimit), ignore_files(ignore_files),
-      mSkipVersionDirs(skip_version_dirs), mVid(v)
+    : qcls(qc), path(target), depthlimit(depthlimit),
+      ignore_files(ignore_files), mSkipVersionDirs(skip_version_dirs), mVid(v)
   {
     restart();
   }
@@ -975,8 +1005,9 @@ public:
       options.depthLimit = depthlimit;
       options.expansionDecider.reset(new TraversalFilter(mVid, mSkipVersionDirs));
       options.ignoreFiles = ignore_files;
-      explorer.reset(new NamespaceExplorer(path, options, *qcl,
-                                           static_cast<QuarkNamespaceGroup*>(gOFS->namespaceGroup.get())->getExecutor()));
+      explorer.reset(new ParallelNamespaceExplorer(path, options, qcls,
+                     static_cast<QuarkNamespaceGroup*>(gOFS->namespaceGroup.get())->getExecutor(),
+                     sFindWorkers));
     }
   }
 
@@ -1092,14 +1123,14 @@ private:
   std::set<std::string>::iterator fileIterator;
 
   //----------------------------------------------------------------------------
-  // QDB: NamespaceExplorer and QClient
+  // QDB: ParallelNamespaceExplorer and QClients
   //----------------------------------------------------------------------------
-  qclient::QClient* qcl = nullptr;
+  std::vector<qclient::QClient*> qcls;
   std::string path;
   uint32_t depthlimit;
   bool ignore_files;
   bool mSkipVersionDirs;
-  std::unique_ptr<NamespaceExplorer> explorer;
+  std::unique_ptr<ParallelNamespaceExplorer> explorer;
   eos::common::VirtualIdentity mVid;
 };
 
@@ -1188,9 +1219,6 @@ NewfindCmd::ProcessRequest() noexcept
   }
 
   errInfo.clear();
-  std::unique_ptr<qclient::QClient> qcl =
-    std::make_unique<qclient::QClient>(gOFS->mQdbContactDetails.members,
-                                       gOFS->mQdbContactDetails.constructOptions());
   std::unique_ptr<FindResultProvider> findResultProvider;
   int depthlimit = ((findRequest.Maxdepth__case() ==
                      eos::console::FindProto::MAXDEPTH__NOT_SET) ?
@@ -1228,8 +1256,8 @@ NewfindCmd::ProcessRequest() noexcept
     // read from the QDB backend
     try {
       findResultProvider.reset
-      (new FindResultProvider(qcl.get(), real_path, depthlimit, onlydirs,
-                              findRequest.skipversiondirs(), mVid));
+      (new FindResultProvider(GetFindQClients(), real_path, depthlimit,
+                              onlydirs, findRequest.skipversiondirs(), mVid));
     } catch (eos::MDException& e) {
       eos_static_info("msg=\"caught newfind exception\" orig_path=\"%s\" "
                       "rpath=\"%s\" errno=%d what=\"%s\"",
@@ -1249,6 +1277,7 @@ NewfindCmd::ProcessRequest() noexcept
 
   uint64_t treecount_aggregate_dircounter = 0;
   uint64_t treecount_aggregate_filecounter = 0;
+  std::string treecount_path;
   uint64_t dircounter = 0;
   uint64_t filecounter = 0;
   // For general users, cannot return more than 50k dirs and 100k files with one find,
@@ -1260,7 +1289,7 @@ NewfindCmd::ProcessRequest() noexcept
   static uint64_t dir_limit = 50000;
   static uint64_t file_limit = 100000;
   Access::GetFindLimits(mVid, dir_limit, file_limit);
-  // @note assume that findResultProvider will serve results DFS-ordered
+  // @note findResultProvider serves the results in no particular order
   FindResult findResult;
   std::shared_ptr<eos::IContainerMD> cMD;
   std::shared_ptr<eos::IFileMD> fMD;
@@ -1331,6 +1360,12 @@ NewfindCmd::ProcessRequest() noexcept
       } else {
         treecount_aggregate_dircounter += findResult.numContainers;
         treecount_aggregate_filecounter += findResult.numFiles;
+
+        // The top directory of the tree has the shortest path
+        if (treecount_path.empty() ||
+            (findResult.path.length() < treecount_path.length())) {
+          treecount_path = findResult.path;
+        }
       }
 
       dircounter++;
@@ -1453,7 +1488,7 @@ NewfindCmd::ProcessRequest() noexcept
   gOFS->MgmStats.Add("NewfindEntries", mVid.uid, mVid.gid, filecounter);
 
   if (findRequest.treecount()) {
-    printPath(mOfsOutStream, findRequest, findResult.path);
+    printPath(mOfsOutStream, findRequest, treecount_path);
     mOfsOutStream << " sum.nfiles=" << treecount_aggregate_filecounter
                   << " sum.ndirectories=" << treecount_aggregate_dircounter <<
                   std::endl;
@@ -1542,9 +1577,6 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
   }
 
   errInfo.clear();
-  std::unique_ptr<qclient::QClient> qcl =
-    std::make_unique<qclient::QClient>(gOFS->mQdbContactDetails.members,
-                                       gOFS->mQdbContactDetails.constructOptions());
   std::unique_ptr<FindResultProvider> findResultProvider;
   int depthlimit = findRequest.Maxdepth__case() ==
                    eos::console::FindProto::MAXDEPTH__NOT_SET ?
@@ -1579,8 +1611,8 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
     // read from the back-end
     try {
       findResultProvider.reset
-      (new FindResultProvider(qcl.get(), real_path, depthlimit, onlydirs,
-                              findRequest.skipversiondirs(), mVid));
+      (new FindResultProvider(GetFindQClients(), real_path, depthlimit,
+                              onlydirs, findRequest.skipversiondirs(), mVid));
     } catch (eos::MDException& e) {
       eos_static_info("msg=\"caught newfind exception\" orig_path=\"%s\" "
                       "rpath=\"%s\" errno=%d what=\"%s\"",
@@ -1613,7 +1645,7 @@ NewfindCmd::ProcessRequest(grpc::ServerWriter<eos::console::ReplyProto>* writer)
   static uint64_t dir_limit = 50000;
   static uint64_t file_limit = 100000;
   Access::GetFindLimits(mVid, dir_limit, file_limit);
-  // @note assume that findResultProvider will serve results DFS-ordered
+  // @note findResultProvider serves the results in no particular order
   FindResult findResult;
   std::shared_ptr<eos::IContainerMD> cMD;
   std::shared_ptr<eos::IFileMD> fMD;
@@ -212,7 +212,21 @@ FsChangeListener::NotifyEvent(const Event& event)
   if (IsEventInteresting(event)) {
     {
       std::lock_guard lock(mMutex);
+
+      // Coalesce with the pending event of the same key, consumers read the
+      // current value of the key anyway. The most recent event wins so that
+      // an update and a deletion are never delivered out of order.
+      auto it = mPendingKeys.find(std::make_pair(event.fileSystemQueue,
+                                  event.key));
+
+      if (it != mPendingKeys.end()) {
+        *it->second = event;
+        return;
+      }
+
       mPendingEvents.emplace_back(event);
+      mPendingKeys.emplace(std::make_pair(event.fileSystemQueue, event.key),
+                           std::prev(mPendingEvents.end()));
     }
     mCv.notify_one();
   }
@@ -233,6 +247,7 @@ FsChangeListener::WaitForEvent(Event& out, std::chrono::seconds timeout)
   }
 
   out = mPendingEvents.front();
+  mPendingKeys.erase(std::make_pair(out.fileSystemQueue, out.key));
   mPendingEvents.pop_front();
   return true;
 }
@@ -27,6 +27,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <utility>
 #include <list>
 #include <mutex>
 #include <condition_variable>
@@ -175,6 +176,10 @@ private:
   mutable std::mutex mMutex;
   std::condition_variable mCv;
   std::list<Event> mPendingEvents;
+  //! Pending events by (file system queue, key), a new event for a key which
+  //! is already pending replaces the pending one
+  std::map<std::pair<std::string, std::string>,
+      std::list<Event>::iterator> mPendingKeys;
   //! Mutex protecting access to mMapInterests
   mutable eos::common::RWMutex mMutexMap;
   //! Map of channel to set of interest keys
@@ -96,7 +96,7 @@ XrdMqOfsFile::open(const char* queuename, XrdSfsFileOpenMode openMode,
   eos_info("connecting queue: %s", queuename);
   MAYREDIRECT;
   mQueueName = queuename;
-  XrdSysMutexHelper scope_lock(gMqFS->mQueueOutMutex);
+  std::unique_lock<std::shared_mutex> scope_lock(gMqFS->mQueueOutMutex);
 
   //  printf("%s %s %s\n",mQueueName.c_str(),gMqFS->QueuePrefix.c_str(),opaque);
   // check if this queue is accepted by the broker
@@ -138,6 +138,7 @@ XrdMqOfsFile::open(const char* queuename, XrdSfsFileOpenMode openMode,
   mMsgOut->AdvisoryFlushBackLog = advisoryflushbacklog;
   mMsgOut->BrokenByFlush = false;
   gMqFS->mQueueOut.insert(std::make_pair(mQueueName, mMsgOut));
+  gMqFS->ClearWildcardMatches();
   eos_info("connected queue: %s", mQueueName.c_str());
   mIsOpen = true;
   return SFS_OK;
@@ -179,13 +180,10 @@ XrdMqOfsFile::stat(struct stat* buf)
     amg.kMessageHeader.kSenderId = gMqFS->BrokerId;
     amg.Encode();
     // amg.Print();
-    XrdSmartOucEnv* env = new XrdSmartOucEnv(amg.GetMessageBuffer());
-    XrdMqOfsMatches matches(gMqFS->QueueAdvisory.c_str(), env, tident,
+    XrdOucEnv env(amg.GetMessageBuffer());
+    XrdMqOfsMatches matches(gMqFS->QueueAdvisory.c_str(), &env, tident,
                             XrdMqMessageHeader::kQueryMessage, mQueueName.c_str());
-
-    if (!gMqFS->Deliver(matches)) {
-      delete env;
-    }
+    gMqFS->Deliver(matches);
 
     ZTRACE(stat, "Grabbing message");
     memset(buf, 0, sizeof(struct stat));
@@ -258,7 +256,7 @@ XrdMqOfsFile::close()
   mIsOpen = false;
   eos_info("disconnecting queue: %s", mQueueName.c_str());
   {
-    XrdSysMutexHelper scope_lock(gMqFS->mQueueOutMutex);
+    std::unique_lock<std::shared_mutex> scope_lock(gMqFS->mQueueOutMutex);
 
     if ((gMqFS->mQueueOut.count(mQueueName)) &&
         (mMsgOut = gMqFS->mQueueOut[mQueueName])) {
@@ -267,6 +265,7 @@ XrdMqOfsFile::close()
       // Take away all pending messages
       mMsgOut->RetrieveMessages();
       gMqFS->mQueueOut.erase(mQueueName);
+      gMqFS->ClearWildcardMatches();
       delete mMsgOut;
     }
 
@@ -284,13 +283,10 @@ XrdMqOfsFile::close()
     amg.kMessageHeader.kSenderId = gMqFS->BrokerId;
     amg.Encode();
     //    amg.Print();
-    XrdSmartOucEnv* env = new XrdSmartOucEnv(amg.GetMessageBuffer());
-    XrdMqOfsMatches matches(gMqFS->QueueAdvisory.c_str(), env, tident,
+    XrdOucEnv env(amg.GetMessageBuffer());
+    XrdMqOfsMatches matches(gMqFS->QueueAdvisory.c_str(), &env, tident,
                             XrdMqMessageHeader::kStatusMessage, mQueueName.c_str());
-
-    if (!gMqFS->Deliver(matches)) {
-      delete env;
-    }
+    gMqFS->Deliver(matches);
   }
   eos_info("disconnected queue: %s", mQueueName.c_str());
   return SFS_OK;
@@ -330,7 +326,8 @@ XrdSfsFileSystem* XrdSfsGetFileSystem(XrdSfsFileSystem* native_fs,
 // Constructor
 //------------------------------------------------------------------------------
 XrdMqOfs::XrdMqOfs(XrdSysError* ep):
-  myPort(1097), mDeliveredMessages(0ull), mFanOutMessages(0ull),
+  myPort(1097), mPendingMessages(0), mDeliveredMessages(0ull),
+  mFanOutMessages(0ull),
   mMaxQueueBacklog(MQOFSMAXQUEUEBACKLOG),
   mRejectQueueBacklog(MQOFSREJECTQUEUEBACKLOG), mQdbCluster(), mQdbPassword(),
   mQdbContactDetails(), mQcl(nullptr)
@@ -353,7 +350,6 @@ XrdMqOfs::XrdMqOfs(XrdSysError* ep):
   HostName = 0;
   HostPref = 0;
   eos_info("Addr:mQueueOutMutex: 0x%llx", &mQueueOutMutex);
-  eos_info("Addr:MessageMutex:   0x%llx", &mMsgsMutex);
 }
 
 //------------------------------------------------------------------------------
@@ -612,7 +608,7 @@ XrdMqOfs::stat(const char* queuename, struct stat* buf, XrdOucErrInfo& error,
   ZTRACE(stat, "stat by buf: " << queuename);
   std::string squeue = queuename;
   {
-    XrdSysMutexHelper scope_lock(mQueueOutMutex);
+    std::shared_lock<std::shared_mutex> scope_lock(mQueueOutMutex);
 
     if ((!gMqFS->mQueueOut.count(squeue)) ||
         (!(msg_out = gMqFS->mQueueOut[squeue]))) {
@@ -633,13 +629,10 @@ XrdMqOfs::stat(const char* queuename, struct stat* buf, XrdOucErrInfo& error,
     amg.kMessageHeader.kSenderId = gMqFS->BrokerId;
     amg.Encode();
     //    amg.Print();
-    XrdSmartOucEnv* env = new XrdSmartOucEnv(amg.GetMessageBuffer());
-    XrdMqOfsMatches matches(gMqFS->QueueAdvisory.c_str(), env, tident,
+    XrdOucEnv env(amg.GetMessageBuffer());
+    XrdMqOfsMatches matches(gMqFS->QueueAdvisory.c_str(), &env, tident,
                             XrdMqMessageHeader::kQueryMessage, queuename);
-
-    if (!gMqFS->Deliver(matches)) {
-      delete env;
-    }
+    gMqFS->Deliver(matches);
   }
   // this should be the case always ...
   ZTRACE(stat, "Waiting for message");
@@ -748,7 +741,7 @@ XrdMqOfs::Statistics()
       rc = write(fd, line, strlen(line));
       sprintf(line, "mq.total                  %lld\n", NoMessages);
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.queued                 %d\n", (int)Messages.size());
+      sprintf(line, "mq.queued                 %d\n", (int)mPendingMessages.load());
       rc = write(fd, line, strlen(line));
       sprintf(line, "mq.nqueues                %d\n", (int)mQueueOut.size());
       rc = write(fd, line, strlen(line));
@@ -795,7 +788,7 @@ XrdMqOfs::Statistics()
     ZTRACE(getstats, "Discarded Monitoring Messages : " <<
            DiscardedMonitoringMessages);
     ZTRACE(getstats, "No        Messages            : " << NoMessages);
-    ZTRACE(getstats, "Queue     Messages            : " << Messages.size());
+    ZTRACE(getstats, "Queue     Messages            : " << mPendingMessages.load());
     ZTRACE(getstats, "#Queues                       : " << mQueueOut.size());
     ZTRACE(getstats, "Deferred  Messages (backlog)  : " << BacklogDeferred);
     ZTRACE(getstats, "Backlog   Messages Hits       : " << QueueBacklogHits);
@@ -1139,8 +1132,7 @@ XrdMqOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
   }
 
   // check for backlog
-  if ((long long)Messages.size() > MaxMessageBacklog) {
-    // this is not absolutely threadsafe .... better would lock
+  if (mPendingMessages.load() > MaxMessageBacklog) {
     BacklogDeferred++;
     eos_static_err("%s", "msg=\"too many pending messages, reject message\"");
     gMqFS->Emsg(epname, error, ENOMEM, "accept message - too many pending messages",
@@ -1170,7 +1162,7 @@ XrdMqOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
     opaque.assign(args.Arg2, 0, args.Arg2Len);
   }
 
-  XrdSmartOucEnv* env = new XrdSmartOucEnv(opaque.c_str());
+  std::unique_ptr<XrdOucEnv> env(new XrdOucEnv(opaque.c_str()));
 
   if (!env) {
     gMqFS->Emsg(epname, error, ENOMEM, "allocate memory", "");
@@ -1182,7 +1174,6 @@ XrdMqOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
 
   if (!mh.Decode(opaque.c_str())) {
     gMqFS->Emsg(epname, error, EINVAL, "decode message header", "");
-    delete env;
     return SFS_ERROR;
   }
 
@@ -1201,9 +1192,8 @@ XrdMqOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
   int p2 = envstring.find("&", p1 + 1);
   envstring.erase(p1, p2 - 1);
   envstring.insert(mh.GetHeaderBuffer(), p1);
-  delete env;
-  env = new XrdSmartOucEnv(envstring.c_str());
-  XrdMqOfsMatches matches(mh.kReceiverQueue.c_str(), env, tident, mh.kType,
+  env.reset(new XrdOucEnv(envstring.c_str()));
+  XrdMqOfsMatches matches(mh.kReceiverQueue.c_str(), env.get(), tident, mh.kType,
                           mh.kSenderId.c_str());
   Deliver(matches);
 
@@ -1219,11 +1209,6 @@ XrdMqOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
     }
 
     TRACES(backlogmessage.c_str());
-
-    if (!matches.message->Refs()) {
-      delete env;
-    }
-
     return SFS_ERROR;
   }
 
@@ -1259,10 +1244,6 @@ XrdMqOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
       ismonitor = true;
     }
 
-    int envlen;
-    std::string c = env->Env(envlen);
-    delete env;
-
     // This is a new hook for special monitoring message, to just accept them
     // and if nobody listens they just go to nirvana.
     if (!ismonitor) {
@@ -1290,12 +1271,11 @@ bool
 XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
 {
   EPNAME("Deliver");
-  XrdSysMutexHelper scope_lock(mQueueOutMutex);
+  std::shared_lock<std::shared_mutex> scope_lock(mQueueOutMutex);
   const char* tident = Matches.mTident;
   std::string sendername = Matches.sendername.c_str();
   // Store all the queues where we need to deliver this message
   std::vector<XrdMqMessageOut*> matched_out_queues;
-  Matches.message->procmutex.Lock();
 
   // If we have a status message we have to do a complete loop
   if (((Matches.messagetype) == XrdMqMessageHeader::kStatusMessage) ||
@@ -1324,44 +1304,27 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
       }
     }
   } else {
-    // If we have a wildcard match we have to do a complete loop
+    // If we have a wildcard match we use the cached matching queues
     if ((Matches.queuename.find("*") != STR_NPOS)) {
-      for (auto it = mQueueOut.begin(); it != mQueueOut.end(); ++it) {
-        XrdMqMessageOut* msg_out = it->second;
-
-        // fprintf(stderr,"current queue name: %s <=> sender :%s\n",
-        //        it->first.c_str(), sendername.c_str());
+      for (auto msg_out : GetWildcardMatches(Matches.queuename.c_str())) {
         // If this would be a loop back message we continue
-        if (sendername == it->first) {
+        if (sendername == msg_out->QueueName.c_str()) {
           // avoid feedback to the same queue
           continue;
         }
 
-        XrdOucString Key = it->first.c_str();
-        XrdOucString nowildcard = Matches.queuename;
-        nowildcard.replace("*", "");
-        int nmatch = Key.matches(Matches.queuename.c_str(), '*');
-
-        if (nmatch == nowildcard.length()) {
-          // this is a match
-          ZTRACE(fsctl, "Adding Wildcard matched Message to Queuename: "
-                 << msg_out->QueueName.c_str());
-          matched_out_queues.push_back(msg_out);
-        }
+        ZTRACE(fsctl, "Adding Wildcard matched Message to Queuename: "
+               << msg_out->QueueName.c_str());
+        matched_out_queues.push_back(msg_out);
       }
     } else {
       // We have just to find one named queue
-      std::string queuename = Matches.queuename.c_str();
-      XrdMqMessageOut* msg_out = 0;
-
-      if (mQueueOut.count(queuename)) {
-        msg_out = mQueueOut[queuename];
-      }
+      auto it = mQueueOut.find(Matches.queuename.c_str());
 
-      if (msg_out) {
+      if ((it != mQueueOut.end()) && it->second) {
         ZTRACE(fsctl, "Adding full matched Message to Queuename: " <<
-               msg_out->QueueName.c_str());
-        matched_out_queues.push_back(msg_out);
+               it->second->QueueName.c_str());
+        matched_out_queues.push_back(it->second);
       }
     }
   }
@@ -1370,22 +1333,20 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
   if (matched_out_queues.size()) {
     Matches.backlog = false;
     Matches.backlogrejected = false;
+    // Payload shared by all the queues, built on the first delivery
+    std::shared_ptr<const XrdMqOfsMessage> message;
 
-    // Lock all matched queues at once
     for (auto msg_out : matched_out_queues) {
-      msg_out->Lock();
-    }
+      size_t backlog = msg_out->mMsgQueue.Size();
 
-    for (auto msg_out : matched_out_queues) {
       // check for backlog on this queue and set a warning flag
-      if (msg_out->mMsgQueue.size() > mMaxQueueBacklog) {
+      if (backlog > mMaxQueueBacklog) {
         // Only set the backlog flag if the queue has not set the advisory
         // flush back log flag
         if (!msg_out->AdvisoryFlushBackLog) {
           Matches.backlog = true;
         } else {
-          if (!msg_out->BrokenByFlush) {
-            msg_out->BrokenByFlush = true;
+          if (!msg_out->BrokenByFlush.exchange(true)) {
             TRACES("warning: queue " << msg_out->QueueName
                    << " is broken by backlog flush of "
                    << mMaxQueueBacklog  << " message!");
@@ -1402,22 +1363,19 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
                  << " message!");
         }
       } else {
-        if (msg_out->BrokenByFlush) {
-          msg_out->BrokenByFlush = false;
+        if (msg_out->BrokenByFlush.exchange(false)) {
           TRACES("warning: re-enabling queue " << msg_out->QueueName
-                 << " backlog is now " << msg_out->mMsgQueue.size()
-                 << " messages!");
+                 << " backlog is now " << backlog << " messages!");
         }
       }
 
-      if (msg_out->mMsgQueue.size() > mRejectQueueBacklog) {
+      if (backlog > mRejectQueueBacklog) {
         // Only set the reject flag if the queue has not set the advisory
         // flush back log flag
         if (!msg_out->AdvisoryFlushBackLog) {
           Matches.backlogrejected = true;
         } else {
-          if (!msg_out->BrokenByFlush) {
-            msg_out->BrokenByFlush = true;
+          if (!msg_out->BrokenByFlush.exchange(true)) {
             TRACES("warning: queue " << msg_out->QueueName
                    << " is broken by backlog flush of " << mRejectQueueBacklog
                    << " message!");
@@ -1438,70 +1396,85 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
           // get out of this situation
           Matches.matches++;
 
-          if (Matches.matches == 1) {
-            // add to the message hash
-            std::string messageid = Matches.message->Get(XMQHEADER);
-            XrdSysMutexHelper scope_lock(gMqFS->mMsgsMutex);
-            gMqFS->Messages.insert(std::pair<std::string, XrdSmartOucEnv*> (messageid,
-                                   Matches.message));
+          if (!message) {
+            int envlen;
+            message = std::make_shared<const XrdMqOfsMessage>
+                      (Matches.message->Env(envlen));
           }
 
           ZTRACE(fsctl, "Adding Message to Queuename: " << msg_out->QueueName.c_str());
-          msg_out->mMsgQueue.push_back(Matches.message);
-          Matches.message->AddRefs(1);
+          msg_out->mMsgQueue.Push(message);
         }
       }
     }
+  }
 
-    // Unlock all matched queues at once
-    for (auto msg_out : matched_out_queues) {
-      msg_out->UnLock();
+  return (Matches.matches > 0);
+}
+
+//------------------------------------------------------------------------------
+// Get the queues matching a wildcard queue name
+//------------------------------------------------------------------------------
+const std::vector<XrdMqMessageOut*>&
+XrdMqOfs::GetWildcardMatches(const std::string& pattern)
+{
+  std::unique_lock<std::mutex> lock(mWildcardMutex);
+  auto it = mWildcardMatches.find(pattern);
+
+  if (it != mWildcardMatches.end()) {
+    return it->second;
+  }
+
+  std::vector<XrdMqMessageOut*> matched_out_queues;
+  XrdOucString nowildcard = pattern.c_str();
+  nowildcard.replace("*", "");
+
+  for (auto it = mQueueOut.begin(); it != mQueueOut.end(); ++it) {
+    XrdOucString Key = it->first.c_str();
+    int nmatch = Key.matches(pattern.c_str(), '*');
+
+    if (nmatch == nowildcard.length()) {
+      matched_out_queues.push_back(it->second);
     }
   }
 
-  Matches.message->procmutex.UnLock();
-  return (Matches.matches > 0);
+  // References to the other entries stay valid on insertion
+  return mWildcardMatches.emplace(pattern,
+                                  std::move(matched_out_queues)).first->second;
+}
+
+//------------------------------------------------------------------------------
+// Message constructor
+//------------------------------------------------------------------------------
+XrdMqOfsMessage::XrdMqOfsMessage(const char* data):
+  mData(data ? data : "")
+{
+  ++gMqFS->mPendingMessages;
+}
+
+//------------------------------------------------------------------------------
+// Message destructor
+//------------------------------------------------------------------------------
+XrdMqOfsMessage::~XrdMqOfsMessage()
+{
+  --gMqFS->mPendingMessages;
+  ++gMqFS->mFanOutMessages;
 }
 
 //------------------------------------------------------------------------------
 // Collect all messages from the queue and append them to the internal
-// buffer. Also delete messages if this was the last reference towards them.
+// buffer. Messages are released once retrieved by all their queues.
 //------------------------------------------------------------------------------
 size_t
 XrdMqMessageOut::RetrieveMessages()
 {
-  XrdSmartOucEnv* message {nullptr};
+  std::shared_ptr<const XrdMqOfsMessage> message;
   XrdSysMutexHelper scope_lock(mMutex);
 
-  while (mMsgQueue.size()) {
-    message = mMsgQueue.front();
-    mMsgQueue.pop_front();
-    message->procmutex.Lock();
-    // fprintf(stderr,"%llu %s Message %llu nref: %d\n", (unsigned long long)
-    // &mMsgQueue, QueueName.c_str(), (unsigned long long) message, message->Refs());
-    int len;
-    mMsgBuffer += message->Env(len);
+  while (mMsgQueue.Pop(message)) {
+    mMsgBuffer += message->mData;
     ++gMqFS->mDeliveredMessages;
-    message->DecRefs();
-
-    if (message->Refs() <= 0) {
-      // We can delete this message from the queue!
-      const char* ptr = message->Get(XMQHEADER);
-
-      if (ptr) {
-        std::string msg_id = message->Get(XMQHEADER);
-        XrdSysMutexHelper scope_lock(gMqFS->mMsgsMutex);
-        gMqFS->Messages.erase(msg_id.c_str());
-      }
-
-      message->procmutex.UnLock();
-      // fprintf(stderr,"%s delete %llu \n", QueueName.c_str(),
-      // (unsigned long long) message);
-      delete message;
-      ++gMqFS->mFanOutMessages;
-    } else {
-      message->procmutex.UnLock();
-    }
+    message.reset();
   }
 
   return mMsgBuffer.length();
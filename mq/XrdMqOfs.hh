@@ -42,8 +42,10 @@
 #include <map>
 #include <string>
 #include <vector>
-#include <deque>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
 // if we have too many messages pending we don't take new ones for the moment
 #define MQOFSMAXMESSAGEBACKLOG 100000
@@ -69,36 +71,108 @@ class QClient;
 }
 
 //------------------------------------------------------------------------------
-//! Class XrdSmartOucEnv
+//! Class XrdMqOfsMessage - immutable payload of a message shared by all the
+//! queues it is delivered to, released once every queue retrieved it
 //------------------------------------------------------------------------------
-class XrdSmartOucEnv : public XrdOucEnv
+class XrdMqOfsMessage
 {
 public:
-  XrdSmartOucEnv(const char* vardata = 0, int vardlen = 0) :
-    XrdOucEnv(vardata, vardlen), nref(0)
-  {}
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  XrdMqOfsMessage(const char* data);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~XrdMqOfsMessage();
 
-  virtual ~XrdSmartOucEnv() {}
+  const std::string mData;
+};
+
+//------------------------------------------------------------------------------
+//! Class XrdMqOfsQueue
+//!
+//! @description Lock-free multi-producer single-consumer queue of messages.
+//!   Producers only exchange the head node, the consumer owns the tail node.
+//!   The size is tracked to enforce the backlog limits of the queue.
+//------------------------------------------------------------------------------
+class XrdMqOfsQueue
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  XrdMqOfsQueue():
+    mHead(new Node()), mTail(mHead.load()), mSize(0)
+  {}
 
-  int Refs()
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~XrdMqOfsQueue()
   {
-    return nref;
+    std::shared_ptr<const XrdMqOfsMessage> msg;
+
+    while (Pop(msg)) {}
+
+    delete mTail;
   }
 
-  void DecRefs()
+  XrdMqOfsQueue(const XrdMqOfsQueue&) = delete;
+  XrdMqOfsQueue& operator=(const XrdMqOfsQueue&) = delete;
+
+  //----------------------------------------------------------------------------
+  //! Append a message, can be called concurrently
+  //----------------------------------------------------------------------------
+  void Push(std::shared_ptr<const XrdMqOfsMessage> msg)
   {
-    --nref;
+    Node* node = new Node();
+    node->mMsg = std::move(msg);
+    mSize.fetch_add(1, std::memory_order_relaxed);
+    Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+    prev->mNext.store(node, std::memory_order_release);
   }
 
-  void AddRefs(int nrefs)
+  //----------------------------------------------------------------------------
+  //! Take the oldest message, must not be called concurrently. A message
+  //! which is being pushed might only be visible at the next call.
+  //!
+  //! @return true if a message was taken, otherwise false
+  //----------------------------------------------------------------------------
+  bool Pop(std::shared_ptr<const XrdMqOfsMessage>& msg)
   {
-    nref += nrefs;
+    Node* next = mTail->mNext.load(std::memory_order_acquire);
+
+    if (next == nullptr) {
+      return false;
+    }
+
+    // next becomes the new tail node
+    msg = std::move(next->mMsg);
+    delete mTail;
+    mTail = next;
+    mSize.fetch_sub(1, std::memory_order_relaxed);
+    return true;
   }
 
-  XrdSysMutex procmutex;
+  //----------------------------------------------------------------------------
+  //! Get number of messages in the queue
+  //----------------------------------------------------------------------------
+  size_t Size() const
+  {
+    return mSize.load(std::memory_order_relaxed);
+  }
 
 private:
-  std::atomic<int> nref;
+  struct Node {
+    std::atomic<Node*> mNext {nullptr};
+    std::shared_ptr<const XrdMqOfsMessage> mMsg;
+  };
+
+  std::atomic<Node*> mHead; ///< Last pushed node
+  Node* mTail; ///< Node before the oldest message, owned by the consumer
+  std::atomic<size_t> mSize; ///< Number of messages in the queue
 };
 
 //------------------------------------------------------------------------------
@@ -110,7 +184,7 @@ public:
   //----------------------------------------------------------------------------
   //! Constructor
   //----------------------------------------------------------------------------
-  XrdMqOfsMatches(const char* qname, XrdSmartOucEnv* msg, const char* t,
+  XrdMqOfsMatches(const char* qname, XrdOucEnv* msg, const char* t,
                   int type, const char* sender = "ignore"):
     matches(0), messagetype(type), backlog(false), backlogrejected(false),
     backlogqueues(""), sendername(sender), queuename(qname), message(msg),
@@ -129,7 +203,7 @@ public:
   XrdOucString backlogqueues;
   XrdOucString sendername;
   XrdOucString queuename;
-  XrdSmartOucEnv* message;
+  XrdOucEnv* message;
   const char* mTident;
 };
 
@@ -145,9 +219,7 @@ public:
   XrdMqMessageOut(const char* queuename):
     AdvisoryStatus(false), AdvisoryQuery(false), AdvisoryFlushBackLog(false),
     BrokenByFlush(false), QueueName(queuename), mMsgBuffer("")
-  {
-    mMsgQueue.clear();
-  }
+  {}
 
   //----------------------------------------------------------------------------
   //! Destructor
@@ -157,25 +229,9 @@ public:
     RetrieveMessages();
   }
 
-  //----------------------------------------------------------------------------
-  //! Lock current object
-  //----------------------------------------------------------------------------
-  void Lock() const
-  {
-    mMutex.Lock();
-  }
-
-  //----------------------------------------------------------------------------
-  //! Unlock current object
-  //----------------------------------------------------------------------------
-  void UnLock() const
-  {
-    mMutex.UnLock();
-  }
-
   //----------------------------------------------------------------------------
   //! Collect all messages from the queue and append them to the internal
-  //! buffer. Also delete messages if this was the last reference towards them.
+  //! buffer. Messages are released once retrieved by all their queues.
   //!
   //! @return size of the internal buffer
   //----------------------------------------------------------------------------
@@ -184,14 +240,14 @@ public:
   bool AdvisoryStatus;
   bool AdvisoryQuery;
   bool AdvisoryFlushBackLog;
-  bool BrokenByFlush;
+  std::atomic<bool> BrokenByFlush;
   XrdOucString QueueName;
   std::string mMsgBuffer;
   XrdSysSemWait DeletionSem;
-  std::deque<XrdSmartOucEnv*> mMsgQueue;
+  XrdMqOfsQueue mMsgQueue;
 
 private:
-  mutable XrdSysMutex mMutex; ///< Mutex protecting access to the msg queue
+  XrdSysMutex mMutex; ///< Mutex serializing the consumers of the msg queue
 };
 
 //------------------------------------------------------------------------------
@@ -381,8 +437,8 @@ public:
   XrdOucString QueuePrefix; ///< Prefix of the accepted queues to server
   XrdOucString QueueAdvisory; ///< "<queueprefix>/*" for advisory message matches
   XrdOucString BrokerId; ///< Manger id + queue name as path
-  std::map<std::string, XrdSmartOucEnv*> Messages; ///< Hash with all messages
-  XrdSysMutex mMsgsMutex;  ///< Mutex protecting the message hash
+  //! Number of messages not yet retrieved by all their queues
+  std::atomic<long long> mPendingMessages;
 
   XrdSysMutex  StatLock;
   time_t       StartupTime;
@@ -408,7 +464,12 @@ private:
   static std::string sLeaseKey;
   //! Hash of all output's connected
   std::map<std::string, XrdMqMessageOut*> mQueueOut;
-  XrdSysMutex mQueueOutMutex;  ///< Mutex protecting the output hash
+  //! Mutex protecting the output hash, shared while delivering messages
+  std::shared_mutex mQueueOutMutex;
+  //! Cache of the queues matching a wildcard queue name, valid as long as
+  //! no queue is connected or disconnected
+  std::map<std::string, std::vector<XrdMqMessageOut*>> mWildcardMatches;
+  std::mutex mWildcardMutex; ///< Mutex protecting the wildcard cache
   std::string mQdbCluster; ///< Quarkdb cluster info host1:port1 host2:port2 ..
   std::string mQdbPassword; ///< Quarkdb cluster password
   eos::QdbContactDetails mQdbContactDetails; ///< QuarkDB contact details
@@ -446,6 +507,25 @@ private:
   //----------------------------------------------------------------------------
   std::string GetLeaseHolder();
 
+  //----------------------------------------------------------------------------
+  //! Get the queues matching a wildcard queue name, mQueueOutMutex must be
+  //! held at least in shared mode
+  //!
+  //! @param pattern queue name containing wildcards
+  //!
+  //! @return queues matching the pattern
+  //----------------------------------------------------------------------------
+  const std::vector<XrdMqMessageOut*>&
+  GetWildcardMatches(const std::string& pattern);
+
+  //----------------------------------------------------------------------------
+  //! Invalidate the wildcard cache, mQueueOutMutex must be held exclusively
+  //----------------------------------------------------------------------------
+  void ClearWildcardMatches()
+  {
+    mWildcardMatches.clear();
+  }
+
   int getStats(char* buff, int blen)
   {
     return 0;
@@ -33,20 +33,29 @@ EOSNSNAMESPACE_BEGIN
 
 //------------------------------------------------------------------------------
 //! Class FileMapIterator
+//!
+//! The map is sorted by name, if it gets modified while iterating then the
+//! iteration resumes after the last returned name. Entries added before the
+//! current position are not returned.
 //------------------------------------------------------------------------------
 class FileMapIterator
 {
 public:
   FileMapIterator(IContainerMDPtr cont)
-    : container(cont), iResized(false), iValid(false) {
+    : container(cont), iValid(false) {
     iter = cont->filesBegin();
     iGeneration = generation();
-    if (!iterEnd()) {
-      iValid = true;
-      iKey = iter->first;
-      iValue = iter->second;
-      iShown.insert(iKey);
-    }
+    update();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Constructor starting after the given name, used to continue a listing
+  //----------------------------------------------------------------------------
+  FileMapIterator(IContainerMDPtr cont, const std::string& start_after)
+    : container(cont), iValid(false) {
+    seek(start_after);
+    iGeneration = generation();
+    update();
   }
 
   bool valid() const {
@@ -60,62 +69,15 @@ public:
   void next() {
     eos::MDLocking::ContainerReadLock readLocker(container.get());
 
-    // check for a re-sized map
     if (generation() != iGeneration) {
-      iResized = true;
-      // the hash_map has been re-organized
-      iter = container->filesBegin();
-      if (iterEnd()) {
-	iValid = false;
-	return;
-      }
-
-      do {
-	if (!iShown.count(iter->first)) {
-	  break;
-	} else {
-	  iter++;
-	  if (iterEnd()) {
-	    iValid = false;
-	    return;
-	  }
-	}
-      } while (1);
-
+      // the map has been modified, the iterator is no longer usable
+      seek(iKey);
       iGeneration = generation();
     } else {
-      // check for a re-sized map
-      if (iResized) {
-	// in this case we always have to check if a value was already shown
-	iter++;
-	if (!iterEnd()) {
-	  do {
-	    if (!iShown.count(iter->first)) {
-	      break;
-	    } else {
-	      iter++;
-	      if (iterEnd()) {
-		iValid = false;
-		return;
-	      }
-	    }
-	  } while (1);
-	} else {
-	  iValid = false;
-	  return;
-	}
-      } else {
-	iter++;
-      }
+      iter++;
     }
 
-    if (!iterEnd()) {
-      iKey = iter->first;
-      iValue = iter->second;
-      iShown.insert(iKey);
-    } else {
-      iValid = false;
-    }
+    update();
   }
 
   std::string key() const {
@@ -131,34 +93,62 @@ public:
   }
 
 private:
+  //----------------------------------------------------------------------------
+  //! Position the iterator on the first entry after the given name
+  //----------------------------------------------------------------------------
+  void seek(const std::string& name) {
+    iter = container->filesLowerBound(name);
+
+    if (!iterEnd() && (iter->first == name)) {
+      iter++;
+    }
+  }
 
+  //----------------------------------------------------------------------------
+  //! Update current entry
+  //----------------------------------------------------------------------------
+  void update() {
+    iValid = !iterEnd();
+
+    if (iValid) {
+      iKey = iter->first;
+      iValue = iter->second;
+    }
+  }
 
   IContainerMDPtr container;
   eos::IContainerMD::FileMap::const_iterator iter;
-  std::set<std::string> iShown;
   std::string iKey;
-  uint64_t iValue;
+  uint64_t iValue {0};
   uint64_t iGeneration;
-  bool iResized;
   bool iValid;
 };
 
 //------------------------------------------------------------------------------
 //! Class ContainerIterator
+//!
+//! The map is sorted by name, if it gets modified while iterating then the
+//! iteration resumes after the last returned name. Entries added before the
+//! current position are not returned.
 //------------------------------------------------------------------------------
 class ContainerMapIterator
 {
 public:
   ContainerMapIterator(IContainerMDPtr cont)
-    : container(cont), iResized(false), iValid(false) {
+    : container(cont), iValid(false) {
     iter = cont->subcontainersBegin();
     iGeneration = generation();
-    if (!iterEnd()) {
-      iValid = true;
-      iKey = iter->first;
-      iValue = iter->second;
-      iShown.insert(iKey);
-    }
+    update();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Constructor starting after the given name, used to continue a listing
+  //----------------------------------------------------------------------------
+  ContainerMapIterator(IContainerMDPtr cont, const std::string& start_after)
+    : container(cont), iValid(false) {
+    seek(start_after);
+    iGeneration = generation();
+    update();
   }
 
   bool valid() const {
@@ -172,62 +162,15 @@ public:
   void next() {
     eos::MDLocking::ContainerReadLock readLocker(container.get());
 
-    // check for a re-sized map
     if (generation() != iGeneration) {
-      iResized = true;
-      // the hash_map has been re-organized
-      iter = container->subcontainersBegin();
-      if (iterEnd()) {
-	iValid = false;
-	return;
-      }
-
-      do {
-	if (!iShown.count(iter->first)) {
-	  break;
-	} else {
-	  iter++;
-	  if (iterEnd()) {
-	    iValid = false;
-	    return;
-	  }
-	}
-      } while (1);
-
+      // the map has been modified, the iterator is no longer usable
+      seek(iKey);
       iGeneration = generation();
     } else {
-      // check for a re-sized map
-      if (iResized) {
-	// in this case we always have to check if a value was already shown
-	iter++;
-	if (!iterEnd()) {
-	  do {
-	    if (!iShown.count(iter->first)) {
-	      break;
-	    } else {
-	      iter++;
-	      if (iterEnd()) {
-		iValid = false;
-		return;
-	      }
-	    }
-	  } while (1);
-	} else {
-	  iValid = false;
-	  return;
-	}
-      } else {
-	iter++;
-      }
+      iter++;
     }
 
-    if (!iterEnd()) {
-      iKey = iter->first;
-      iValue = iter->second;
-      iShown.insert(iKey);
-    } else {
-      iValid = false;
-    }
+    update();
   }
 
   std::string key() const {
@@ -243,14 +186,34 @@ public:
   }
 
 private:
+  //----------------------------------------------------------------------------
+  //! Position the iterator on the first entry after the given name
+  //----------------------------------------------------------------------------
+  void seek(const std::string& name) {
+    iter = container->subcontainersLowerBound(name);
+
+    if (!iterEnd() && (iter->first == name)) {
+      iter++;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Update current entry
+  //----------------------------------------------------------------------------
+  void update() {
+    iValid = !iterEnd();
+
+    if (iValid) {
+      iKey = iter->first;
+      iValue = iter->second;
+    }
+  }
 
   IContainerMDPtr container;
   eos::IContainerMD::ContainerMap::const_iterator iter;
-  std::set<std::string> iShown;
   std::string iKey;
-  uint64_t iValue;
+  uint64_t iValue {0};
   uint64_t iGeneration;
-  bool iResized;
   bool iValid;
 };
 
@@ -26,6 +26,7 @@
 
 #include "namespace/Namespace.hh"
 #include "namespace/utils/Buffer.hh"
+#include "namespace/utils/ChildMap.hh"
 #include "namespace/utils/LocalityHint.hh"
 #include "namespace/interface/Identifiers.hh"
 #include "common/Murmur3.hh"
@@ -89,10 +90,9 @@ public:
   typedef struct timespec tmtime_t;
   typedef std::map<std::string, std::string> XAttrMap;
 
-  using ContainerMap = google::dense_hash_map<std::string, IContainerMD::id_t,
-        Murmur3::MurmurHasher<std::string> >;
-  using FileMap = google::dense_hash_map<std::string, IContainerMD::id_t,
-        Murmur3::MurmurHasher<std::string> >;
+  //! Children maps are sorted by name, see ChildMap
+  using ContainerMap = ChildMap;
+  using FileMap = ChildMap;
 
   template<typename ObjectMDPtr, typename LockType> friend class
     NSObjectMDBaseLock;
@@ -514,6 +514,12 @@ protected:
   virtual eos::IContainerMD::ContainerMap::const_iterator
   subcontainersEnd() = 0;
 
+  //----------------------------------------------------------------------------
+  //! Get iterator to the first subcontainer not less than the given name
+  //----------------------------------------------------------------------------
+  virtual eos::IContainerMD::ContainerMap::const_iterator
+  subcontainersLowerBound(const std::string& name) = 0;
+
   //----------------------------------------------------------------------------
   //! Get generation value to check interator validity
   //----------------------------------------------------------------------------
@@ -531,6 +537,12 @@ protected:
   virtual eos::IContainerMD::FileMap::const_iterator
   filesEnd() = 0;
 
+  //----------------------------------------------------------------------------
+  //! Get iterator to the first file not less than the given name
+  //----------------------------------------------------------------------------
+  virtual eos::IContainerMD::FileMap::const_iterator
+  filesLowerBound(const std::string& name) = 0;
+
   //----------------------------------------------------------------------------
   //! Get generation value to check interator validity
   //----------------------------------------------------------------------------
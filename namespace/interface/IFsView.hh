@@ -27,7 +27,7 @@
 #include "namespace/Namespace.hh"
 #include "namespace/MDException.hh"
 #include "namespace/interface/IFileMDSvc.hh"
-#include <google/dense_hash_set>
+#include "namespace/utils/FidBitmap.hh"
 #include <set>
 
 EOSNSNAMESPACE_BEGIN
@@ -73,15 +73,14 @@ class IFsView: public IFileMDChangeListener
 public:
 
   //------------------------------------------------------------------------
-  // Google sparse table is used for much lower memory overhead per item
-  // than a list and it's fragmented structure speeding up deletions.
-  // The filelists we keep are quite big - a list would be faster
-  // but more memory consuming, a vector would be slower but less
-  // memory consuming. We changed to dense hash set since it is much faster
-  // and the memory overhead is not visible in a million file namespace.
+  // The file lists are kept in memory for every file system and can hold
+  // hundreds of millions of entries. Initially a google sparse table and
+  // then a dense hash set were used, but the latter costs more than 16 bytes
+  // per entry. File ids are allocated from a monotonic counter therefore a
+  // compressed bitmap partitioned by id range needs only a few bits per
+  // entry, iterates in id order and supports set operations.
   //------------------------------------------------------------------------
-  typedef google::dense_hash_set <IFileMD::id_t,
-          Murmur3::MurmurHasher<uint64_t> > FileList;
+  typedef FidBitmap FileList;
 
   //----------------------------------------------------------------------------
   //! Contructor
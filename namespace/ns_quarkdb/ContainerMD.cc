@@ -49,10 +49,6 @@ QuarkContainerMD::QuarkContainerMD(IContainerMD::id_t id, IFileMDSvc* file_svc,
     pFilesKey(stringify(id) + constants::sMapFilesSuffix),
     pDirsKey(stringify(id) + constants::sMapDirsSuffix)
 {
-  mSubcontainers->set_deleted_key("");
-  mFiles->set_deleted_key("");
-  mSubcontainers->set_empty_key("##_EMPTY_##");
-  mFiles->set_empty_key("##_EMPTY_##");
   mCont.set_id(id);
   mCont.set_mode(040755);
   mClock = std::chrono::high_resolution_clock::now().time_since_epoch().count();
@@ -925,15 +921,8 @@ QuarkContainerMD::getEnv(std::string& env, bool escapeAnd)
 IContainerMD::ContainerMap
 QuarkContainerMD::copyContainerMap() const
 {
-  IContainerMD::ContainerMap retval;
-  retval.set_deleted_key("");
-  retval.set_empty_key("##_EMPTY_##");
-  return runReadOp([this, &retval]() {
-    for (auto it = mSubcontainers->begin(); it != mSubcontainers->end(); ++it) {
-      retval.insert(std::make_pair(it->first, it->second));
-    }
-
-    return retval;
+  return runReadOp([this]() {
+    return IContainerMD::ContainerMap(*mSubcontainers);
   });
 }
 
@@ -943,15 +932,8 @@ QuarkContainerMD::copyContainerMap() const
 IContainerMD::FileMap
 QuarkContainerMD::copyFileMap() const
 {
-  IContainerMD::FileMap retval;
-  retval.set_deleted_key("");
-  retval.set_empty_key("##_EMPTY_##");
-  return runReadOp([this, &retval]() {
-    for (auto it = mFiles->begin(); it != mFiles->end(); ++it) {
-      retval.insert(std::make_pair(it->first, it->second));
-    }
-
-    return retval;
+  return runReadOp([this]() {
+    return IContainerMD::FileMap(*mFiles);
   });
 }
 
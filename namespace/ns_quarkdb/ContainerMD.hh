@@ -605,14 +605,22 @@ private:
     return mSubcontainers->end();
   }
 
+  //----------------------------------------------------------------------------
+  //! Get iterator to the first subcontainer not less than the given name
+  //----------------------------------------------------------------------------
+  virtual eos::IContainerMD::ContainerMap::const_iterator
+  subcontainersLowerBound(const std::string& name) override
+  {
+    // No lock here, only ContainerMapIterator can call us, which locks the mutex.
+    return mSubcontainers->lower_bound(name);
+  }
+
   //----------------------------------------------------------------------------
   //! Get generation value to check iterator validity
   //----------------------------------------------------------------------------
   virtual uint64_t getContainerMapGeneration() override
   {
-    const uint64_t bc = mSubcontainers->bucket_count();
-    return reinterpret_cast<std::uintptr_t>(&*mSubcontainers->end()) ^
-           ((bc << 48) | (bc >> 16));
+    return mSubcontainers->getGeneration();
   }
 
   //----------------------------------------------------------------------------
@@ -635,14 +643,22 @@ private:
     return mFiles->end();
   }
 
+  //----------------------------------------------------------------------------
+  //! Get iterator to the first file not less than the given name
+  //----------------------------------------------------------------------------
+  virtual eos::IContainerMD::FileMap::const_iterator
+  filesLowerBound(const std::string& name) override
+  {
+    // No lock here, only FileMapIterator can call us, which locks the mutex.
+    return mFiles->lower_bound(name);
+  }
+
   //----------------------------------------------------------------------------
   //! Get generation value to check iterator validity
   //----------------------------------------------------------------------------
   virtual uint64_t getFileMapGeneration() override
   {
-    const uint64_t bc = mFiles->bucket_count();
-    return reinterpret_cast<std::uintptr_t>(&*mFiles->end()) ^
-           ((bc << 48) | (bc >> 16));
+    return mFiles->getGeneration();
   }
 
   eos::ns::ContainerMdProto mCont;      ///< Protobuf container representation
@@ -32,6 +32,7 @@
 #include "namespace/ns_quarkdb/accounting/ContainerAccounting.hh"
 #include "namespace/ns_quarkdb/CacheRefreshListener.hh"
 #include "namespace/ns_quarkdb/VersionEnforcement.hh"
+#include "common/StringUtils.hh"
 #include <folly/executors/IOThreadPoolExecutor.h>
 
 EOSNSNAMESPACE_BEGIN
@@ -154,6 +155,14 @@ bool QuarkNamespaceGroup::initialize(eos::common::RWMutex* nsMtx,
     flusherRocksDBOptions = it->second;
   }
 
+  it = config.find("qclient_flusher_coalesce_ms");
+
+  if ((it != config.end()) &&
+      !eos::common::StringToNumeric(it->second, flusherCoalesceMs)) {
+    err = "could not parse qclient_flusher_coalesce_ms!";
+    return false;
+  }
+
   return true;
 }
 
@@ -295,6 +304,11 @@ MetadataFlusher* QuarkNamespaceGroup::getMetadataFlusher()
       mMetadataFlusher.reset(new MetadataFlusher(path, contactDetails,
                                                  flusherType, flusherRocksDBOptions));
     }
+
+    if (flusherCoalesceMs) {
+      mMetadataFlusher->enableCoalescing(std::chrono::milliseconds(
+                                           flusherCoalesceMs));
+    }
   }
 
   return mMetadataFlusher.get();
@@ -160,6 +160,7 @@ private:
   std::string flusherQuotaTag;      //< Tag for quota flusher
   std::string flusherType;          //< Type of flusher
   std::string flusherRocksDBOptions; //< RocksDB options for flusher
+  uint64_t flusherCoalesceMs {0};   //< Coalescing window of the MD flusher
   //----------------------------------------------------------------------------
   // Initialize file and container services
   //----------------------------------------------------------------------------
@@ -17,6 +17,7 @@
  ************************************************************************/
 
 #include "namespace/ns_quarkdb/accounting/ContainerAccounting.hh"
+#include "namespace/ns_quarkdb/accounting/ContainerLevels.hh"
 #include <iostream>
 #include <chrono>
 
@@ -34,7 +35,6 @@ QuarkContainerAccounting::QuarkContainerAccounting(IContainerMDSvc* svc, int32_t
   // If update interval is 0 then we disable async updates
   if (mUpdateIntervalSec) {
     mThread.reset(&QuarkContainerAccounting::AssistedPropagateUpdates, this);
-    mQueueForUpdateThread.reset(&QuarkContainerAccounting::AssistedQueueForUpdate,this);
   }
 }
 
@@ -43,11 +43,8 @@ QuarkContainerAccounting::QuarkContainerAccounting(IContainerMDSvc* svc, int32_t
 //----------------------------------------------------------------------------
 QuarkContainerAccounting::~QuarkContainerAccounting()
 {
-  // Stop the AsyncQueueUpdate thread by queuing containerID = 0
-  mIdTreeInfosToUpdateQueue.emplace(0,TreeInfos{0,0,0});
   if (mUpdateIntervalSec) {
     mThread.join();
-    mQueueForUpdateThread.join();
   }
 }
 
@@ -101,12 +98,15 @@ QuarkContainerAccounting::RemoveTree(IContainerMD* obj, TreeInfos treeAccounting
 void
 QuarkContainerAccounting::QueueForUpdate(IContainerMD::id_t id, TreeInfos treeAccounting)
 {
-  if(id) {
-    // The condition to stop the queueing thread is that the id = 0. The minimum container id is 1 and
-    // corresponds to "/"
-    // We therefore prevent users to queue the container id = 0 for update (which should not happen!)
-    mIdTreeInfosToUpdateQueue.emplace(id,treeAccounting);
+  // The minimum container id is 1 and corresponds to "/"
+  if (id == 0) {
+    return;
   }
+
+  // Only merge the delta here, walking up the tree is left to the
+  // propagation which does it once per container and interval
+  std::lock_guard<std::mutex> scope_lock(mMutexBatch);
+  mBatch[mAccumulateIndx].mMap[id] += treeAccounting;
 }
 
 //------------------------------------------------------------------------------
@@ -120,15 +120,6 @@ noexcept
   PropagateUpdates(&assistant);
 }
 
-//------------------------------------------------------------------------------
-// Submits container and size changes in order to propagate them to the hierarchical structure later on.
-// Method ran by an asynchronous thread.
-//------------------------------------------------------------------------------
-void QuarkContainerAccounting::AssistedQueueForUpdate(ThreadAssistant& assistant) noexcept
-{
-  AsyncQueueForUpdate(&assistant);
-}
-
 //------------------------------------------------------------------------------
 // Propagate updates in the hierarchical structure
 //------------------------------------------------------------------------------
@@ -145,20 +136,8 @@ QuarkContainerAccounting::PropagateUpdates(ThreadAssistant* assistant)
 
     auto& batch = mBatch[mCommitIndx];
 
-    if(!batch.mMap.empty()){
-      for (auto const& elem : batch.mMap) {
-        try {
-          auto cont = mContainerMDSvc->getContainerMD(elem.first);
-          eos::MDLocking::ContainerWriteLock contLock(cont.get());
-          cont->updateTreeSize(elem.second.dsize);
-          cont->updateTreeFiles(elem.second.dtreefiles);
-          cont->updateTreeContainers(elem.second.dtreecontainers);
-          mContainerMDSvc->updateStore(cont.get());
-        } catch (const MDException& e) {
-          // TODO: (esindril) error message using default logging
-          continue;
-        }
-      }
+    if (!batch.mMap.empty()) {
+      ApplyUpdates(batch.mMap);
     }
 
     batch.mMap.clear();
@@ -176,55 +155,56 @@ QuarkContainerAccounting::PropagateUpdates(ThreadAssistant* assistant)
 }
 
 //------------------------------------------------------------------------------
-// For each containerId and its associated size modified, this function
-// will go up the tree from container to '/' and submit the entire tree for
-// modification in the PropagateUpdate thread
+// Apply the deltas of the batch level by level
 //------------------------------------------------------------------------------
-void QuarkContainerAccounting::AsyncQueueForUpdate(ThreadAssistant* assistant)
+void
+QuarkContainerAccounting::ApplyUpdates(
+  std::unordered_map<IContainerMD::id_t, TreeInfos>& deltas)
 {
-  std::pair<eos::IContainerMD::id_t,TreeInfos> contIdTreeInfos;
-  std::vector<IContainerMD::id_t> idsToUpdate;
+  ContainerLevels levels([this](IContainerMD::id_t id) -> IContainerMD::id_t {
+    try {
+      // One operation, no need to lock the container
+      return mContainerMDSvc->getContainerMD(id)->getParentId();
+    } catch (const MDException& e) {
+      return 0;
+    }
+  });
 
-  while ((assistant && !assistant->terminationRequested()) || (!assistant)) {
-    uint16_t deepness = 0;
+  for (const auto& elem : deltas) {
+    levels.add(elem.first);
+  }
 
-    mIdTreeInfosToUpdateQueue.wait_pop(contIdTreeInfos);
-    if(!contIdTreeInfos.first) {
-      // Container ID = 0 (see ~QuarkContainerAccounting()), we
-      // stop this thread
-      break;
-    }
+  // Deepest level first, each container adds its final delta to its parent
+  // before the parent level is processed
+  for (size_t depth = levels.getNumLevels(); depth-- > 0;) {
+    for (auto id : levels.getLevel(depth)) {
+      auto it = deltas.find(id);
 
-    IContainerMD::id_t id = contIdTreeInfos.first;
-    // Go up the tree and give the ids to update to the batch that will
-    // be taken by the PropagateUpdate thread
-    while ((id > 1) && (deepness < 255)) {
-      try {
-        idsToUpdate.push_back(id);
-        auto cont = mContainerMDSvc->getContainerMD(id);
-        // One operation, no need to lock the container
-        id = cont->getParentId();
-        ++deepness;
-      } catch (const MDException& e) {
-        // TODO (esindril): error message using default logging
-        break;
+      if ((it == deltas.end()) || ((it->second.dsize == 0) &&
+                                   (it->second.dtreefiles == 0) &&
+                                   (it->second.dtreecontainers == 0))) {
+        continue;
       }
-    }
 
-    std::lock_guard<std::mutex> scope_lock(mMutexBatch);
-    auto& batch = mBatch[mAccumulateIndx];
+      const TreeInfos delta = it->second;
+      IContainerMD::id_t parent = levels.getParent(id);
 
-    for (auto idToUpdate : idsToUpdate) {
-      auto it_map = batch.mMap.find(idToUpdate);
+      if (parent) {
+        deltas[parent] += delta;
+      }
 
-      if (it_map != batch.mMap.end()) {
-        it_map->second += contIdTreeInfos.second;
-      } else {
-        batch.mMap.emplace(idToUpdate, contIdTreeInfos.second);
+      try {
+        auto cont = mContainerMDSvc->getContainerMD(id);
+        eos::MDLocking::ContainerWriteLock contLock(cont.get());
+        cont->updateTreeSize(delta.dsize);
+        cont->updateTreeFiles(delta.dtreefiles);
+        cont->updateTreeContainers(delta.dtreecontainers);
+        mContainerMDSvc->updateStore(cont.get());
+      } catch (const MDException& e) {
+        // TODO: (esindril) error message using default logging
+        continue;
       }
     }
-
-    idsToUpdate.clear();
   }
 }
 
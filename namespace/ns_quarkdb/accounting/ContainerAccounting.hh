@@ -32,7 +32,6 @@
 #include <utility>
 #include <unordered_map>
 #include <atomic>
-#include "common/ConcurrentQueue.hh"
 
 EOSNSNAMESPACE_BEGIN
 
@@ -115,21 +114,16 @@ public:
   void QueueForUpdate(IContainerMD::id_t pid, TreeInfos treeInfos);
 
   //----------------------------------------------------------------------------
-  //! Propagate updates in the hierarchical structure
+  //! Propagate updates in the hierarchical structure. The deltas of the batch
+  //! are applied level by level starting from the deepest containers so that
+  //! every ancestor is updated only once with the aggregated delta of all its
+  //! modified descendants.
   //!
   //! @param assistant thread doing the propagation or null by default if the
   //!        update should be done in the calling thread.
   //----------------------------------------------------------------------------
   void PropagateUpdates(ThreadAssistant* assistant = nullptr);
 
-  //----------------------------------------------------------------------------
-  //! Queue container ids and size to update the tree size
-  //!
-  //! @param assistant thread doing the queueing or null by default if the
-  //!        update should be done in the calling thread.
-  //----------------------------------------------------------------------------
-  void AsyncQueueForUpdate(ThreadAssistant * assistant = nullptr);
-
 private:
 
   //----------------------------------------------------------------------------
@@ -141,16 +135,16 @@ private:
   void AssistedPropagateUpdates(ThreadAssistant& assistant) noexcept;
 
   //----------------------------------------------------------------------------
-  //! Queue containerIds and size to update in thein the hierarchical structure. Method ran by the
-  //! asynchronous thread.
+  //! Apply the deltas of the batch, the map is consumed
   //!
-  //! @param assistant thread doing the propagation
+  //! @param deltas map of container ids to the deltas of their direct
+  //!        children, the propagation to the ancestors is done here
   //----------------------------------------------------------------------------
-  void AssistedQueueForUpdate(ThreadAssistant& assistant) noexcept;
+  void ApplyUpdates(std::unordered_map<IContainerMD::id_t, TreeInfos>& deltas);
 
-  //! Update structure containing the nodes that need an update. We try to
-  //! optimise the number of updates to the backend by computing the final
-  //! size deltas from a number of individual updates.
+  //! Update structure containing the containers whose direct children
+  //! changed. Updates to the same container are merged, the propagation to
+  //! the ancestors happens only when the batch is committed.
   struct UpdateT {
     std::unordered_map<IContainerMD::id_t, TreeInfos> mMap; ///< Map updates
   };
@@ -163,10 +157,8 @@ private:
   uint8_t mAccumulateIndx; ///< Index of the batch accumulating updates
   uint8_t mCommitIndx; ///< Index o the batch committing updates
   AssistedThread mThread; ///< Thread updating the namespace
-  AssistedThread mQueueForUpdateThread; ///< Thread update queueing thread
   uint32_t mUpdateIntervalSec; ///< Interval in seconds when updates are pushed
   IContainerMDSvc* mContainerMDSvc; ///< container MD service
-  eos::common::ConcurrentQueue<std::pair<IContainerMD::id_t, TreeInfos>>  mIdTreeInfosToUpdateQueue; ///< Queue containing containerIds and their corresponding infos to update
 };
 
 EOSNSNAMESPACE_END
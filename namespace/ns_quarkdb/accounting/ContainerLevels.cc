@@ -0,0 +1,80 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/accounting/ContainerLevels.hh"
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Add container and its ancestors
+//------------------------------------------------------------------------------
+void
+ContainerLevels::add(IContainerMD::id_t id)
+{
+  std::vector<IContainerMD::id_t> chain;
+
+  // Walk up until reaching the root or an already known container
+  while ((id > 1) && (chain.size() < mMaxDepth) && !mNodes.count(id)) {
+    mNodes.emplace(id, Node{0, kUnknownDepth});
+    chain.push_back(id);
+    id = mParentFunc(id);
+  }
+
+  if (chain.empty()) {
+    return;
+  }
+
+  IContainerMD::id_t parent = 0;
+  uint32_t depth = 0;
+  auto it = mNodes.find(id);
+
+  // A known container with an unknown depth is part of the current chain,
+  // which means there is a loop. In that case the chain stops there as it
+  // does when reaching the root or the max depth.
+  if ((id > 1) && (it != mNodes.end()) &&
+      (it->second.mDepth != kUnknownDepth)) {
+    parent = id;
+    depth = it->second.mDepth + 1;
+  }
+
+  for (auto rit = chain.rbegin(); rit != chain.rend(); ++rit) {
+    auto& node = mNodes[*rit];
+    node.mParent = parent;
+    node.mDepth = depth;
+
+    if (mLevels.size() <= depth) {
+      mLevels.resize(depth + 1);
+    }
+
+    mLevels[depth].push_back(*rit);
+    parent = *rit;
+    ++depth;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get parent of a container in the set
+//------------------------------------------------------------------------------
+IContainerMD::id_t
+ContainerLevels::getParent(IContainerMD::id_t id) const
+{
+  auto it = mNodes.find(id);
+  return ((it == mNodes.end()) ? 0 : it->second.mParent);
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+//! @brief Containers grouped by depth for level by level propagation
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "namespace/interface/IContainerMD.hh"
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Set of containers together with all their ancestors, grouped by depth.
+//! Updates collected for a batch of containers can then be applied from the
+//! deepest level up to the top one, so that every ancestor is touched only
+//! once with the aggregated value of all its updated descendants instead of
+//! once per update.
+//!
+//! The root container (id 1) is never part of the set, as for the existing
+//! propagation. Depth 0 is the top most container of a chain, usually a
+//! child of the root. The parent of a depth 0 container is reported as 0.
+//------------------------------------------------------------------------------
+class ContainerLevels
+{
+public:
+  //! Function returning the parent of a container or 0 if it can't be found
+  using ParentFunc = std::function<IContainerMD::id_t(IContainerMD::id_t)>;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param parent_func function used to look up the parent of a container
+  //! @param max_depth max number of ancestors looked up from a container,
+  //!        also protects against loops in a corrupted namespace
+  //----------------------------------------------------------------------------
+  ContainerLevels(ParentFunc parent_func, uint32_t max_depth = 255):
+    mParentFunc(std::move(parent_func)), mMaxDepth(max_depth)
+  {}
+
+  //----------------------------------------------------------------------------
+  //! Add container and its ancestors, each parent is looked up only once
+  //----------------------------------------------------------------------------
+  void add(IContainerMD::id_t id);
+
+  //----------------------------------------------------------------------------
+  //! Get number of levels
+  //----------------------------------------------------------------------------
+  inline size_t getNumLevels() const
+  {
+    return mLevels.size();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get containers at the given depth
+  //----------------------------------------------------------------------------
+  inline const std::vector<IContainerMD::id_t>& getLevel(size_t depth) const
+  {
+    return mLevels[depth];
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get parent of a container in the set or 0 for the top level ones
+  //----------------------------------------------------------------------------
+  IContainerMD::id_t getParent(IContainerMD::id_t id) const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of containers in the set
+  //----------------------------------------------------------------------------
+  inline size_t size() const
+  {
+    return mNodes.size();
+  }
+
+private:
+  //! Position of a container in the tree
+  struct Node {
+    IContainerMD::id_t mParent; ///< Parent id, 0 for the top level
+    uint32_t mDepth; ///< Depth, kUnknownDepth while being resolved
+  };
+
+  static constexpr uint32_t kUnknownDepth = UINT32_MAX;
+  ParentFunc mParentFunc; ///< Parent look up
+  uint32_t mMaxDepth; ///< Max ancestors looked up from a container
+  std::unordered_map<IContainerMD::id_t, Node> mNodes; ///< Known containers
+  std::vector<std::vector<IContainerMD::id_t>> mLevels; ///< Ids by depth
+};
+
+EOSNSNAMESPACE_END
@@ -42,8 +42,6 @@ FileSystemHandler::FileSystemHandler(IFileMD::location_t loc,
     target = Target::kRegular;
   }
 
-  mContents.set_deleted_key(0);
-  mContents.set_empty_key(0xffffffffffffffffll);
 }
 
 //------------------------------------------------------------------------------
@@ -56,8 +54,6 @@ FileSystemHandler::FileSystemHandler(folly::Executor* executor,
   : location(0), pExecutor(executor), pQcl(qcl), pFlusher(flusher)
 {
   target = Target::kNoReplicaList;
-  mContents.set_deleted_key(0);
-  mContents.set_empty_key(0xffffffffffffffffll);
 }
 
 //------------------------------------------------------------------------------
@@ -116,8 +112,6 @@ FileSystemHandler* FileSystemHandler::triggerCacheLoad()
 {
   pFlusher->synchronize();
   IFsView::FileList temporaryContents;
-  temporaryContents.set_deleted_key(0);
-  temporaryContents.set_empty_key(0xffffffffffffffffll);
 
   for (auto it = getStreamingFileList(); it->valid(); it->next()) {
     temporaryContents.insert(it->getElement());
@@ -131,7 +125,6 @@ FileSystemHandler* FileSystemHandler::triggerCacheLoad()
   mChangeList.apply(mContents);
   mChangeList.clear();
   mCacheStatus = CacheStatus::kLoaded;
-  mContents.resize(0);
   return this;
 }
 
@@ -177,7 +170,6 @@ void FileSystemHandler::erase(FileIdentifier identifier)
     eos_assert(mCacheStatus == CacheStatus::kLoaded);
     // Write directly into mContents
     mContents.erase(identifier.getUnderlyingUInt64());
-    mContents.resize(0);
   }
 
   lock.unlock();
@@ -235,7 +227,6 @@ void FileSystemHandler::nuke()
 {
   std::unique_lock<std::shared_timed_mutex> lock(mMutex);
   mContents.clear();
-  mContents.resize(0);
   pFlusher->del(getRedisKey());
 }
 
@@ -256,7 +247,7 @@ bool FileSystemHandler::hasFileId(IFileMD::id_t file)
 {
   ensureContentsLoaded();
   std::shared_lock<std::shared_timed_mutex> lock(mMutex);
-  return mContents.find(file) != mContents.end();
+  return (mContents.count(file) != 0);
 }
 
 //------------------------------------------------------------------------------
@@ -281,7 +272,6 @@ FileSystemHandler::clearCache(std::chrono::seconds inactive_timeout)
   if (mMutex.try_lock_for(100ms)) {
     if (mCacheStatus == CacheStatus::kLoaded) {
       mContents.clear();
-      mContents.resize(0);
       mCacheStatus = CacheStatus::kNotLoaded;
     }
 
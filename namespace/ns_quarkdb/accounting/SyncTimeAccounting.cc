@@ -17,6 +17,7 @@
  ************************************************************************/
 
 #include "namespace/ns_quarkdb/accounting/SyncTimeAccounting.hh"
+#include "namespace/ns_quarkdb/accounting/ContainerLevels.hh"
 #include <iostream>
 #include <chrono>
 
@@ -75,17 +76,7 @@ void
 QuarkSyncTimeAccounting::QueueForUpdate(IContainerMD::id_t id)
 {
   std::lock_guard<std::mutex> scope_lock(mMutexBatch);
-  auto& batch = mBatch[mAccumulateIndx];
-  auto it_map = batch.mMap.find(id);
-
-  if (it_map != batch.mMap.end()) {
-    auto& it_lst = it_map->second;
-    // Move it from current location to the end of the list (most recent)
-    batch.mLstUpd.splice(batch.mLstUpd.end(), batch.mLstUpd, it_lst);
-  } else {
-    auto it_new = batch.mLstUpd.emplace(batch.mLstUpd.end(), id);
-    batch.mMap[id] = it_new;
-  }
+  (void) mBatch[mAccumulateIndx].mSet.insert(id);
 }
 
 void QuarkSyncTimeAccounting::setNamespaceStats(INamespaceStats* namespaceStats) {
@@ -121,75 +112,20 @@ QuarkSyncTimeAccounting::PropagateUpdates(ThreadAssistant* assistant)
       std::swap(mAccumulateIndx, mCommitIndx);
     }
 
-    uint16_t deepness = 0;
-    IContainerMD::id_t id = 0;
-    std::set<IContainerMD::id_t> upd_nodes;
-    auto& lst = mBatch[mCommitIndx].mLstUpd;
-
-    // Start updating form the last node (most recent) and also collect the
-    // nodes that we've updated so that older updates don't propagate further
-    // up than strictly necessary.
+    auto& upd_set = mBatch[mCommitIndx].mSet;
     struct timeval start;
     struct timeval stop;
     struct timezone tz;
     gettimeofday(&start, &tz);
-    for (auto it_id = lst.rbegin(); it_id != lst.rend(); ++it_id) {
-      deepness = 0;
-      id = *it_id;
-
-      if (id == 0u) {
-        continue;
-      }
-
-      eos_debug("Container_id=%lu sync time", id);
-      IContainerMD::ctime_t mtime {0};
-
-      while ((id > 1) && (deepness < 255)) {
-        std::shared_ptr<IContainerMD> cont;
-
-        // If node is already in the set of updates then don't bother
-        // propagating this update
-        if (upd_nodes.count(id)) {
-          break;
-        }
 
-        try {
-          cont = mContainerMDSvc->getContainerMD(id);
-          eos::MDLocking::ContainerWriteLock locker(cont.get());
-
-          // Only traverse if there there is an attribute saying so
-          if (!cont->hasAttribute("sys.mtime.propagation")) {
-            break;
-          }
-
-          // If there was a temporary ETAG this has not to be removed
-          if (cont->hasAttribute("sys.tmp.etag")) {
-            cont->removeAttribute("sys.tmp.etag");
-          }
-
-          if (deepness == 0u) {
-            cont->getMTime(mtime);
-          }
-
-          if (!cont->setTMTime(mtime) && deepness) {
-            break;
-          }
-
-          (void) upd_nodes.insert(id);
-          mContainerMDSvc->updateStore(cont.get());
-        } catch (MDException& e) {
-          cont = nullptr;
-          break;
-        }
-
-        id = cont->getParentId();
-        ++deepness;
-      }
+    if (!upd_set.empty()) {
+      ApplyUpdates(upd_set);
     }
+
     gettimeofday(&stop, &tz);                                 \
     double execTime = ((stop.tv_sec-start.tv_sec)*1000.0) + ((stop.tv_usec-start.tv_usec)/1000.0);
     if(mNamespaceStats != nullptr){
-      mNamespaceStats->Add("QuarkSyncTimeAccounting",0,0,lst.size());
+      mNamespaceStats->Add("QuarkSyncTimeAccounting",0,0,upd_set.size());
       mNamespaceStats->AddExec("QuarkSyncTimeAccounting",execTime);
     }
     // Clean up the batch
@@ -207,4 +143,98 @@ QuarkSyncTimeAccounting::PropagateUpdates(ThreadAssistant* assistant)
   }
 }
 
+//------------------------------------------------------------------------------
+// Propagate the mtime of the given containers level by level
+//------------------------------------------------------------------------------
+void
+QuarkSyncTimeAccounting::ApplyUpdates(
+  const std::unordered_set<IContainerMD::id_t>& ids)
+{
+  // Containers without the propagation attribute stop the walk up the tree
+  // so that their ancestors are not looked up
+  ContainerLevels levels([this](IContainerMD::id_t id) -> IContainerMD::id_t {
+    try {
+      auto cont = mContainerMDSvc->getContainerMD(id);
+      eos::MDLocking::ContainerReadLock locker(cont.get());
+
+      if (!cont->hasAttribute("sys.mtime.propagation")) {
+        return 0;
+      }
+
+      return cont->getParentId();
+    } catch (const MDException& e) {
+      return 0;
+    }
+  });
+
+  for (auto id : ids) {
+    levels.add(id);
+  }
+
+  // Most recent mtime propagated from the descendants of each container
+  std::unordered_map<IContainerMD::id_t, IContainerMD::ctime_t> pending;
+
+  for (size_t depth = levels.getNumLevels(); depth-- > 0;) {
+    for (auto id : levels.getLevel(depth)) {
+      bool origin = (ids.count(id) != 0);
+      auto it = pending.find(id);
+
+      if (!origin && (it == pending.end())) {
+        continue;
+      }
+
+      eos_debug("Container_id=%lu sync time", id);
+      IContainerMD::ctime_t mtime {0};
+
+      try {
+        auto cont = mContainerMDSvc->getContainerMD(id);
+        eos::MDLocking::ContainerWriteLock locker(cont.get());
+
+        // Only traverse if there there is an attribute saying so
+        if (!cont->hasAttribute("sys.mtime.propagation")) {
+          continue;
+        }
+
+        // If there was a temporary ETAG this has not to be removed
+        if (cont->hasAttribute("sys.tmp.etag")) {
+          cont->removeAttribute("sys.tmp.etag");
+        }
+
+        if (origin) {
+          cont->getMTime(mtime);
+        }
+
+        if ((it != pending.end()) &&
+            ((it->second.tv_sec > mtime.tv_sec) ||
+             ((it->second.tv_sec == mtime.tv_sec) &&
+              (it->second.tv_nsec > mtime.tv_nsec)))) {
+          mtime = it->second;
+        }
+
+        // Containers which are not modified themselves stop the propagation
+        // if their sync time is already more recent
+        if (!cont->setTMTime(mtime) && !origin) {
+          continue;
+        }
+
+        mContainerMDSvc->updateStore(cont.get());
+      } catch (MDException& e) {
+        continue;
+      }
+
+      IContainerMD::id_t parent = levels.getParent(id);
+
+      if (parent) {
+        auto& parent_mtime = pending[parent];
+
+        if ((mtime.tv_sec > parent_mtime.tv_sec) ||
+            ((mtime.tv_sec == parent_mtime.tv_sec) &&
+             (mtime.tv_nsec > parent_mtime.tv_nsec))) {
+          parent_mtime = mtime;
+        }
+      }
+    }
+  }
+}
+
 EOSNSNAMESPACE_END
@@ -29,8 +29,8 @@
 #include "common/RWMutex.hh"
 #include "common/AssistedThread.hh"
 #include <mutex>
-#include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <atomic>
 #include "namespace/interface/INamespaceStats.hh"
 
@@ -108,20 +108,23 @@ private:
   //----------------------------------------------------------------------------
   void AssistedPropagateUpdates(ThreadAssistant& assistant) noexcept;
 
-  //! Update structure containing a list of the nodes that need an update in
-  //! the order that the updates need to be applied and also a map used for
-  //! filtering out multiple updates to the same container ID. Try to optimise
-  //! the number of updates to a container by keeping only the last one.
+  //----------------------------------------------------------------------------
+  //! Propagate the mtime of the given containers level by level, every
+  //! ancestor is updated at most once with the most recent mtime of its
+  //! modified descendants.
+  //!
+  //! @param ids containers whose mtime changed
+  //----------------------------------------------------------------------------
+  void ApplyUpdates(const std::unordered_set<IContainerMD::id_t>& ids);
+
+  //! Update structure containing the containers whose mtime changed, multiple
+  //! updates to the same container are merged
   struct UpdateT {
-    std::list<IContainerMD::id_t> mLstUpd; ///< Ordered list of updates
-    //! Map used for fast search/insert operations
-    std::unordered_map<IContainerMD::id_t,
-        std::list<IContainerMD::id_t>::iterator > mMap;
+    std::unordered_set<IContainerMD::id_t> mSet; ///< Containers to update
 
     void Clean()
     {
-      mLstUpd.clear();
-      mMap.clear();
+      mSet.clear();
     }
   };
 
@@ -158,21 +158,9 @@ void SearchNode::stageChildren()
   }
 
   childrenLoaded = true;
-  // containerMap is hashmap, thus unsorted... must sort first by filename.. sigh.
-  // storing into a vector and calling std::sort might be faster, TODO
-//  std::map<std::string, IContainerMD::id_t, FilesystemEntryComparator> sortedContainerMap; // Why not the std::less<string> comparator?
-//  for (auto it = containerMap->cbegin(); it != containerMap->cend(); ++it) {
-//    sortedContainerMap[it->first] = it->second;
-//  }
-  std::vector<std::pair<std::string, IContainerMD::id_t>> v;
 
+  // containerMap is sorted by filename
   for (auto it = containerMap->begin(); it != containerMap->end(); ++it) {
-    v.emplace_back(std::pair<std::string, IContainerMD::id_t> {it->first, it->second});
-  }
-
-  std::sort(v.begin(), v.end());
-
-  for (auto it = v.begin(); it != v.end(); ++it) {
     children.emplace_back(new SearchNode(explorer, id,
                                          ContainerIdentifier(it->second), this, executor, ignoreFiles));
   }
@@ -0,0 +1,495 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
+#include "namespace/utils/Attributes.hh"
+#include "common/FutureWrapper.hh"
+#include "common/Path.hh"
+#include <iostream>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ParallelNamespaceExplorer::ParallelNamespaceExplorer(
+  const std::string& path, const ExplorationOptions& options,
+  const std::vector<qclient::QClient*>& qcls, folly::Executor* exec,
+  size_t num_workers, size_t max_frontier)
+  : mOptions(options), mQcls(qcls), mExecutor(exec),
+    mMaxWorkers(num_workers ? num_workers : 1), mMaxFrontier(max_frontier)
+{
+  if (mOptions.populateLinkedAttributes && !mOptions.view) {
+    throw_mdexception(EINVAL, "ParallelNamespaceExplorer: asked to populate "
+                      "linked attrs, but view not provided");
+  }
+
+  if (mQcls.empty()) {
+    throw_mdexception(EINVAL, "ParallelNamespaceExplorer: no QClient provided");
+  }
+
+  mMaxPendingBatches = 2 * mMaxWorkers;
+  // Resolve the starting container, this part is synchronous by necessity
+  qclient::QClient& qcl = *mQcls[0];
+  std::vector<std::string> pathParts = eos::common::SplitPath(path);
+  ContainerIdentifier parentId(1);
+  ContainerIdentifier id(1);
+  std::string fullPath = "/";
+
+  for (size_t i = 0; i < pathParts.size(); ++i) {
+    parentId = id;
+
+    try {
+      id = MetadataFetcher::getContainerIDFromName(qcl, parentId,
+           pathParts[i]).get();
+    } catch (const MDException& exc) {
+      // Maybe the last chunk is a file, then it's the only item to return
+      if ((i != pathParts.size() - 1) || (exc.getErrno() != ENOENT)) {
+        throw;
+      }
+
+      // This may throw again, propagate to caller if so
+      FileIdentifier fid = MetadataFetcher::getFileIDFromName(qcl, parentId,
+                           pathParts[i]).get();
+      NamespaceItem item;
+      item.isFile = true;
+      item.expansionFilteredOut = false;
+      item.fileMd = MetadataFetcher::getFileFromId(qcl, fid).get();
+      item.fullPath = fullPath + item.fileMd.name();
+      mBatches.emplace_back();
+      mBatches.back().push_back(std::move(item));
+      return;
+    }
+
+    fullPath += pathParts[i];
+    fullPath += "/";
+  }
+
+  mFrontier.push_back(Task{id, parentId, fullPath});
+  mPending = 1;
+  mActiveWorkers = 1;
+  mWorkers.emplace_back(&ParallelNamespaceExplorer::work, this,
+                        std::ref(*mQcls[0]));
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ParallelNamespaceExplorer::~ParallelNamespaceExplorer()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+
+  mWorkCv.notify_all();
+  mSpaceCv.notify_all();
+
+  for (auto& worker : mWorkers) {
+    worker.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Fetch next item
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::fetch(NamespaceItem& result)
+{
+  while (mCurrentPos >= mCurrent.size()) {
+    if (!fetchBatch(mCurrent)) {
+      return false;
+    }
+
+    mCurrentPos = 0;
+  }
+
+  result = std::move(mCurrent[mCurrentPos++]);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Fetch next batch of items
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::fetchBatch(std::vector<NamespaceItem>& batch)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mOutputCv.wait(lock, [this]() {
+    return !mBatches.empty() || (mActiveWorkers == 0);
+  });
+
+  if (mBatches.empty()) {
+    batch.clear();
+    return false;
+  }
+
+  batch = std::move(mBatches.front());
+  mBatches.pop_front();
+  mSpaceCv.notify_one();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Worker loop
+//------------------------------------------------------------------------------
+void
+ParallelNamespaceExplorer::work(qclient::QClient& qcl)
+{
+  std::vector<Task> local;
+  std::vector<Task> tasks;
+  std::vector<NamespaceItem> out;
+  bool stopped = false;
+
+  while (takeTasks(local, tasks)) {
+    size_t num_tasks = tasks.size();
+    expand(qcl, tasks, local, out);
+    completeTasks(num_tasks);
+
+    // Don't sit on results while waiting for more work
+    if ((out.size() >= kBatchSize) || local.empty()) {
+      if (!pushBatch(out)) {
+        stopped = true;
+        break;
+      }
+    }
+  }
+
+  if (!stopped) {
+    (void) pushBatch(out);
+  }
+
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  if (--mActiveWorkers == 0) {
+    mOutputCv.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Take tasks to expand
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::takeTasks(std::vector<Task>& local,
+                                     std::vector<Task>& tasks)
+{
+  tasks.clear();
+
+  while (!local.empty() && (tasks.size() < kPipelineDepth)) {
+    tasks.push_back(std::move(local.back()));
+    local.pop_back();
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (!tasks.empty()) {
+    return !mStop;
+  }
+
+  mWorkCv.wait(lock, [this]() {
+    return mStop || !mFrontier.empty() || (mPending == 0);
+  });
+
+  if (mStop) {
+    return false;
+  }
+
+  // Take the most recent containers, this keeps the frontier small as the
+  // exploration stays close to depth-first
+  while (!mFrontier.empty() && (tasks.size() < kPipelineDepth)) {
+    tasks.push_back(std::move(mFrontier.back()));
+    mFrontier.pop_back();
+  }
+
+  return !tasks.empty();
+}
+
+//------------------------------------------------------------------------------
+// Expand the given containers
+//------------------------------------------------------------------------------
+void
+ParallelNamespaceExplorer::expand(qclient::QClient& qcl,
+                                  std::vector<Task>& tasks,
+                                  std::vector<Task>& local,
+                                  std::vector<NamespaceItem>& out)
+{
+  using FileMdIterator = FutureVectorIterator<eos::ns::FileMdProto>;
+  const size_t num = tasks.size();
+  std::vector<common::FutureWrapper<eos::ns::ContainerMdProto>> mds;
+  std::vector<common::FutureWrapper<IContainerMD::ContainerMap>> maps;
+  mds.reserve(num);
+  maps.reserve(num);
+
+  // Send the requests of all the containers before waiting for any of them
+  for (const auto& task : tasks) {
+    mds.emplace_back(MetadataFetcher::getContainerFromId(qcl, task.id));
+    maps.emplace_back(MetadataFetcher::getContainerMap(qcl, task.id));
+  }
+
+  // Decide on the expansion and send the file queries of all the containers
+  std::vector<NamespaceItem> items(num);
+  std::vector<std::unique_ptr<FileMdIterator>> files(num);
+  std::vector<folly::Future<uint64_t>> fileCounts;
+  fileCounts.reserve(num);
+
+  for (size_t i = 0; i < num; ++i) {
+    fileCounts.emplace_back(folly::makeFuture<uint64_t>(0));
+
+    // Same as SearchNode::canVisit, skip containers which can't be retrieved
+    if (mds[i].hasException() || maps[i].hasException()) {
+      continue;
+    }
+
+    NamespaceItem& item = items[i];
+    item.isFile = false;
+    item.fullPath = tasks[i].fullPath;
+    item.containerMd = std::move(mds[i].get());
+    item.numContainers = maps[i]->size();
+    handleLinkedAttrs(item);
+    item.expansionFilteredOut = false;
+
+    if (mOptions.expansionDecider) {
+      item.expansionFilteredOut =
+        !mOptions.expansionDecider->shouldExpandContainer(item.containerMd,
+            item.attrs, item.fullPath);
+    }
+
+    eos::common::Path cpath{item.fullPath};
+    item.expansionFilteredOut = (item.expansionFilteredOut ||
+                                 (cpath.GetSubPathSize() >=
+                                  mOptions.depthLimit));
+
+    if (mOptions.ignoreFiles || item.expansionFilteredOut) {
+      fileCounts[i] = MetadataFetcher::countContents(qcl, tasks[i].id).first;
+    } else {
+      files[i].reset(new FileMdIterator(
+                       MetadataFetcher::getFileMDsInContainer(qcl, tasks[i].id,
+                           mExecutor)));
+    }
+  }
+
+  for (size_t i = 0; i < num; ++i) {
+    NamespaceItem& item = items[i];
+
+    if (item.fullPath.empty()) {
+      continue;
+    }
+
+    const uint64_t expectedParent =
+      tasks[i].expectedParent.getUnderlyingUInt64();
+
+    if (!item.expansionFilteredOut &&
+        (item.containerMd.parent_id() != expectedParent)) {
+      std::cerr << "WARNING: Container #" << item.containerMd.id() <<
+                " was expected to have #" << expectedParent <<
+                " as parent; instead it has #" <<
+                item.containerMd.parent_id() << std::endl;
+    }
+
+    if (files[i]) {
+      item.numFiles = files[i]->size();
+    } else {
+      item.numFiles = std::move(fileCounts[i]).get();
+    }
+
+    const bool expand = !item.expansionFilteredOut;
+    const std::string fullPath = item.fullPath;
+    const ContainerIdentifier id(item.containerMd.id());
+    out.push_back(std::move(item));
+
+    if (files[i]) {
+      NamespaceItem fileItem;
+      fileItem.isFile = true;
+      fileItem.expansionFilteredOut = false;
+
+      while (true) {
+        try {
+          if (!files[i]->fetchNext(fileItem.fileMd)) {
+            break;
+          }
+        } catch (MDException& exc) {
+          // Skip files which can't be retrieved
+          continue;
+        }
+
+        fileItem.fullPath = fullPath + fileItem.fileMd.name();
+        handleLinkedAttrs(fileItem);
+        out.push_back(fileItem);
+      }
+
+      files[i].reset();
+    }
+
+    if (!expand || maps[i]->empty()) {
+      continue;
+    }
+
+    // Queue the subcontainers, to the shared frontier if there is room left
+    // otherwise the worker continues on its own
+    std::vector<Task> children;
+    children.reserve(maps[i]->size());
+
+    for (const auto& elem : maps[i].get()) {
+      children.push_back(Task{ContainerIdentifier(elem.second), id,
+                              fullPath + elem.first + "/"});
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mPending += children.size();
+    size_t shared = 0;
+
+    while (!children.empty() && (mFrontier.size() < mMaxFrontier)) {
+      mFrontier.push_back(std::move(children.back()));
+      children.pop_back();
+      ++shared;
+    }
+
+    maybeAddWorker();
+    lock.unlock();
+
+    for (auto& child : children) {
+      local.push_back(std::move(child));
+    }
+
+    if (shared == 1) {
+      mWorkCv.notify_one();
+    } else if (shared > 1) {
+      mWorkCv.notify_all();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Hand over a batch of results
+//------------------------------------------------------------------------------
+bool
+ParallelNamespaceExplorer::pushBatch(std::vector<NamespaceItem>& out)
+{
+  if (out.empty()) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mSpaceCv.wait(lock, [this]() {
+    return mStop || (mBatches.size() < mMaxPendingBatches);
+  });
+
+  if (mStop) {
+    out.clear();
+    return false;
+  }
+
+  mBatches.push_back(std::move(out));
+  out.clear();
+  mOutputCv.notify_one();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Start one more worker if the frontier is long enough
+//------------------------------------------------------------------------------
+void
+ParallelNamespaceExplorer::maybeAddWorker()
+{
+  if (mStop || (mWorkers.size() >= mMaxWorkers) ||
+      (mFrontier.size() <= kPipelineDepth)) {
+    return;
+  }
+
+  // The calling worker is still active, so the exploration can not be seen
+  // as over before the new one starts
+  ++mActiveWorkers;
+  mWorkers.emplace_back(&ParallelNamespaceExplorer::work, this,
+                        std::ref(*mQcls[mWorkers.size() % mQcls.size()]));
+}
+
+//------------------------------------------------------------------------------
+// Mark the given number of tasks as done
+//------------------------------------------------------------------------------
+void
+ParallelNamespaceExplorer::completeTasks(size_t num)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mPending -= num;
+
+  if (mPending == 0) {
+    mWorkCv.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Handle linked attributes
+//------------------------------------------------------------------------------
+void
+ParallelNamespaceExplorer::handleLinkedAttrs(NamespaceItem& result)
+{
+  google::protobuf::Map<std::string, std::string> const* attrMap = nullptr;
+
+  if (result.isFile) {
+    attrMap = &result.fileMd.xattrs();
+  } else {
+    attrMap = &result.containerMd.xattrs();
+  }
+
+  result.attrs = {attrMap->begin(), attrMap->end() };
+
+  if (!mOptions.populateLinkedAttributes) {
+    return;
+  }
+
+  auto link = attrMap->find("sys.attr.link");
+
+  if (link == attrMap->end()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mAttrsMutex);
+    auto cached = mCachedAttrs.find(link->second);
+
+    if (cached != mCachedAttrs.end()) {
+      populateLinkedAttributes(cached->second, result.attrs,
+                               mOptions.prefixLinks);
+      return;
+    }
+  }
+
+  // Cache miss, several workers might look up the same link concurrently
+  // which is harmless
+  eos::IContainerMD::XAttrMap toStoreIntoCache;
+
+  try {
+    FileOrContainerMD item = mOptions.view->getItem(link->second, true).get();
+
+    if (item.file) {
+      toStoreIntoCache = item.file->getAttributes();
+    } else {
+      toStoreIntoCache = item.container->getAttributes();
+    }
+  } catch (eos::MDException& e) {
+    // toStoreIntoCache remains empty
+  }
+
+  populateLinkedAttributes(toStoreIntoCache, result.attrs,
+                           mOptions.prefixLinks);
+  std::lock_guard<std::mutex> lock(mAttrsMutex);
+  mCachedAttrs[link->second] = std::move(toStoreIntoCache);
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,190 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Class for exploring the namespace with a pool of workers
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace folly
+{
+class Executor;
+}
+
+namespace qclient
+{
+class QClient;
+}
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Recursively explore the QuarkDB namespace starting from some path, same as
+//! the NamespaceExplorer, but expanding independent subtrees in parallel on a
+//! pool of workers. The items are the same as the ones returned by the
+//! NamespaceExplorer, but the order is NOT depth-first: a container is
+//! returned before its own files, otherwise there is no ordering guarantee.
+//!
+//! Each worker uses one of the given QClient connections and pipelines the
+//! metadata requests of several containers at once. Containers waiting to be
+//! expanded are kept in a shared frontier of bounded size, once it is full
+//! the workers continue depth-first on their own subtrees. The exploration
+//! starts with a single worker, another one is started whenever more than
+//! kPipelineDepth containers wait in the frontier, so that small subtrees
+//! do not pay for threads they can not keep busy. The results are
+//! handed over in batches and the workers block when the consumer does not
+//! keep up, so memory stays bounded whatever the size of the subtree.
+//!
+//! The expansion decider, if any, is called concurrently from the workers.
+//------------------------------------------------------------------------------
+class ParallelNamespaceExplorer
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor, the workers start exploring right away
+  //!
+  //! @param path path to explore
+  //! @param options exploration options
+  //! @param qcls QClient connections used by the workers, no ownership
+  //! @param exec executor for the metadata futures
+  //! @param num_workers max number of workers
+  //! @param max_frontier max number of containers in the shared frontier
+  //----------------------------------------------------------------------------
+  ParallelNamespaceExplorer(const std::string& path,
+                            const ExplorationOptions& options,
+                            const std::vector<qclient::QClient*>& qcls,
+                            folly::Executor* exec, size_t num_workers = 8,
+                            size_t max_frontier = 100000);
+
+  //----------------------------------------------------------------------------
+  //! Destructor, stops the workers even if the exploration is not over
+  //----------------------------------------------------------------------------
+  ~ParallelNamespaceExplorer();
+
+  ParallelNamespaceExplorer(const ParallelNamespaceExplorer&) = delete;
+  ParallelNamespaceExplorer& operator=(const ParallelNamespaceExplorer&) =
+    delete;
+
+  //----------------------------------------------------------------------------
+  //! Fetch next item, block if none is available yet
+  //!
+  //! @return false when the exploration is over
+  //----------------------------------------------------------------------------
+  bool fetch(NamespaceItem& result);
+
+  //----------------------------------------------------------------------------
+  //! Fetch next batch of items, block if none is available yet. Must not be
+  //! mixed with fetch.
+  //!
+  //! @param batch filled with the items, previous content is discarded
+  //!
+  //! @return false when the exploration is over
+  //----------------------------------------------------------------------------
+  bool fetchBatch(std::vector<NamespaceItem>& batch);
+
+private:
+  //! Container waiting to be expanded
+  struct Task {
+    ContainerIdentifier id;
+    ContainerIdentifier expectedParent;
+    std::string fullPath; ///< Full path ending with '/'
+  };
+
+  //! Number of containers whose requests are in flight at once per worker
+  static constexpr size_t kPipelineDepth = 16;
+  //! Number of items per batch handed to the consumer
+  static constexpr size_t kBatchSize = 1024;
+
+  ExplorationOptions mOptions;
+  std::vector<qclient::QClient*> mQcls;
+  folly::Executor* mExecutor;
+  size_t mMaxWorkers;
+  size_t mMaxFrontier;
+  size_t mMaxPendingBatches;
+  std::mutex mMutex; ///< Protects the frontier and the output batches
+  std::condition_variable mWorkCv; ///< Signals new work or termination
+  std::condition_variable mOutputCv; ///< Signals new batch or termination
+  std::condition_variable mSpaceCv; ///< Signals space for a new batch
+  std::vector<Task> mFrontier; ///< Containers waiting for any worker
+  std::deque<std::vector<NamespaceItem>> mBatches; ///< Ready results
+  uint64_t mPending {0}; ///< Containers queued or being expanded
+  size_t mActiveWorkers {0}; ///< Workers still running
+  bool mStop {false}; ///< Set to stop the workers early
+  std::vector<std::thread> mWorkers; ///< Started workers, grows under mMutex
+  std::vector<NamespaceItem> mCurrent; ///< Batch being consumed by fetch
+  size_t mCurrentPos {0}; ///< Position in mCurrent
+  std::mutex mAttrsMutex; ///< Protects the linked attributes cache
+  std::map<std::string, eos::IContainerMD::XAttrMap> mCachedAttrs;
+
+  //----------------------------------------------------------------------------
+  //! Worker loop
+  //!
+  //! @param qcl connection used by the worker
+  //----------------------------------------------------------------------------
+  void work(qclient::QClient& qcl);
+
+  //----------------------------------------------------------------------------
+  //! Take up to kPipelineDepth tasks, from the local stack first, otherwise
+  //! from the shared frontier. Block until work is available.
+  //!
+  //! @return false if there is nothing left to do
+  //----------------------------------------------------------------------------
+  bool takeTasks(std::vector<Task>& local, std::vector<Task>& tasks);
+
+  //----------------------------------------------------------------------------
+  //! Expand the given containers, queue their subcontainers and append the
+  //! resulting items to the output
+  //----------------------------------------------------------------------------
+  void expand(qclient::QClient& qcl, std::vector<Task>& tasks,
+              std::vector<Task>& local, std::vector<NamespaceItem>& out);
+
+  //----------------------------------------------------------------------------
+  //! Hand over a batch of results, block while too many batches are pending
+  //!
+  //! @return false if the exploration was stopped
+  //----------------------------------------------------------------------------
+  bool pushBatch(std::vector<NamespaceItem>& out);
+
+  //----------------------------------------------------------------------------
+  //! Start one more worker if the frontier is long enough, with mMutex held
+  //----------------------------------------------------------------------------
+  void maybeAddWorker();
+
+  //----------------------------------------------------------------------------
+  //! Mark the given number of tasks as done
+  //----------------------------------------------------------------------------
+  void completeTasks(size_t num);
+
+  //----------------------------------------------------------------------------
+  //! Handle linked attributes, thread-safe version of the NamespaceExplorer
+  //! one
+  //----------------------------------------------------------------------------
+  void handleLinkedAttrs(NamespaceItem& result);
+};
+
+EOSNSNAMESPACE_END
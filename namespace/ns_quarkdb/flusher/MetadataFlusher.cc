@@ -73,9 +73,94 @@ MetadataFlusher::MetadataFlusher(const std::string& path,
 MetadataFlusher::~MetadataFlusher()
 {
   sizePrinter.join();
+  coalescingThread.join();
   synchronize();
 }
 
+//------------------------------------------------------------------------------
+// Enable coalescing of the requests
+//------------------------------------------------------------------------------
+void MetadataFlusher::enableCoalescing(std::chrono::milliseconds window)
+{
+  coalescingThread.join();
+  flushCoalesced();
+  mCoalescingWindow = window;
+  mCoalescing = (window.count() > 0);
+
+  if (mCoalescing) {
+    coalescingThread.reset(&MetadataFlusher::coalescingLoop, this);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the coalescing counters
+//------------------------------------------------------------------------------
+RequestCoalescer::Stats MetadataFlusher::getCoalescingStats()
+{
+  std::unique_lock<std::mutex> lock(mCoalescerMutex);
+  return mCoalescer.getStats();
+}
+
+//------------------------------------------------------------------------------
+// Queue a request, either directly in the background flusher or in the
+// coalescing buffer
+//------------------------------------------------------------------------------
+void MetadataFlusher::push(std::vector<std::string>&& req)
+{
+  if (!mCoalescing) {
+    backgroundFlusher.pushRequest(req);
+    return;
+  }
+
+  bool full = false;
+  {
+    std::unique_lock<std::mutex> lock(mCoalescerMutex);
+    mCoalescer.add(std::move(req));
+    full = (mCoalescer.size() >= kMaxCoalesced);
+  }
+
+  if (full) {
+    flushCoalesced();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Push the coalesced requests to the background flusher
+//------------------------------------------------------------------------------
+void MetadataFlusher::flushCoalesced()
+{
+  // Batches must reach the background flusher in the order they were
+  // extracted, the buffer lock is only held for the extraction
+  std::unique_lock<std::mutex> flush_lock(mFlushMutex);
+  std::vector<RequestCoalescer::Request> reqs;
+  {
+    std::unique_lock<std::mutex> lock(mCoalescerMutex);
+
+    if (mCoalescer.size() == 0) {
+      return;
+    }
+
+    reqs = mCoalescer.extract();
+  }
+
+  for (const auto& req : reqs) {
+    backgroundFlusher.pushRequest(req);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Flush the coalesced requests at the end of every window
+//------------------------------------------------------------------------------
+void MetadataFlusher::coalescingLoop(qclient::ThreadAssistant& assistant)
+{
+  while (!assistant.terminationRequested()) {
+    assistant.wait_for(mCoalescingWindow);
+    flushCoalesced();
+  }
+
+  flushCoalesced();
+}
+
 //------------------------------------------------------------------------------
 // Regularly print queue statistics
 //------------------------------------------------------------------------------
@@ -93,6 +178,16 @@ void MetadataFlusher::queueSizeMonitoring(qclient::ThreadAssistant& assistant)
                       backgroundFlusher.getEndingIndex());
     }
 
+    if (mCoalescing) {
+      auto stats = getCoalescingStats();
+      eos_static_info("id=%s coalesced-requests-in=%llu coalesced-requests-out=%llu"
+                      " coalesced-bytes-in=%llu coalesced-bytes-out=%llu",
+                      id.c_str(), (unsigned long long) stats.mRequestsIn,
+                      (unsigned long long) stats.mRequestsOut,
+                      (unsigned long long) stats.mBytesIn,
+                      (unsigned long long) stats.mBytesOut);
+    }
+
     assistant.wait_for(std::chrono::seconds(10));
   }
 }
@@ -103,7 +198,7 @@ void MetadataFlusher::queueSizeMonitoring(qclient::ThreadAssistant& assistant)
 void MetadataFlusher::hset(const std::string& key, const std::string& field,
                            const std::string& value)
 {
-  backgroundFlusher.pushRequest({"HSET", key, field, value});
+  push({"HSET", key, field, value});
 }
 
 //------------------------------------------------------------------------------
@@ -112,7 +207,7 @@ void MetadataFlusher::hset(const std::string& key, const std::string& field,
 void MetadataFlusher::hincrby(const std::string& key, const std::string& field,
                               int64_t value)
 {
-  backgroundFlusher.pushRequest({"HINCRBY", key, field, std::to_string(value)});
+  push({"HINCRBY", key, field, std::to_string(value)});
 }
 
 //------------------------------------------------------------------------------
@@ -120,7 +215,7 @@ void MetadataFlusher::hincrby(const std::string& key, const std::string& field,
 //------------------------------------------------------------------------------
 void MetadataFlusher::del(const std::string& key)
 {
-  backgroundFlusher.pushRequest({"DEL", key});
+  push({"DEL", key});
 }
 
 //------------------------------------------------------------------------------
@@ -128,7 +223,7 @@ void MetadataFlusher::del(const std::string& key)
 //------------------------------------------------------------------------------
 void MetadataFlusher::hdel(const std::string& key, const std::string& field)
 {
-  backgroundFlusher.pushRequest({"HDEL", key, field});
+  push({"HDEL", key, field});
 }
 
 //------------------------------------------------------------------------------
@@ -136,7 +231,7 @@ void MetadataFlusher::hdel(const std::string& key, const std::string& field)
 //------------------------------------------------------------------------------
 void MetadataFlusher::sadd(const std::string& key, const std::string& field)
 {
-  backgroundFlusher.pushRequest({"SADD", key, field});
+  push({"SADD", key, field});
 }
 
 //------------------------------------------------------------------------------
@@ -144,7 +239,7 @@ void MetadataFlusher::sadd(const std::string& key, const std::string& field)
 //------------------------------------------------------------------------------
 void MetadataFlusher::srem(const std::string& key, const std::string& field)
 {
-  backgroundFlusher.pushRequest({"SREM", key, field});
+  push({"SREM", key, field});
 }
 
 //------------------------------------------------------------------------------
@@ -159,7 +254,7 @@ void MetadataFlusher::srem(const std::string& key,
     req.emplace_back(*it);
   }
 
-  backgroundFlusher.pushRequest(req);
+  push(std::move(req));
 }
 
 //------------------------------------------------------------------------------
@@ -167,6 +262,8 @@ void MetadataFlusher::srem(const std::string& key,
 //------------------------------------------------------------------------------
 void MetadataFlusher::synchronize(ItemIndex targetIndex)
 {
+  flushCoalesced();
+
   if (targetIndex < 0) {
     targetIndex = backgroundFlusher.getEndingIndex() - 1;
   }
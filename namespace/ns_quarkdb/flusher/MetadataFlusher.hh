@@ -25,10 +25,14 @@
 #include "namespace/interface/IContainerMDSvc.hh"
 #include "namespace/interface/IContainerMD.hh"
 #include "namespace/ns_quarkdb/Constants.hh"
+#include "namespace/ns_quarkdb/flusher/RequestCoalescer.hh"
 #include "qclient/BackgroundFlusher.hh"
 #include "qclient/AssistedThread.hh"
+#include <atomic>
+#include <chrono>
 #include <list>
 #include <map>
+#include <mutex>
 
 EOSNSNAMESPACE_BEGIN
 
@@ -77,7 +81,7 @@ public:
   template<typename... Args>
   void exec(const Args... args)
   {
-    backgroundFlusher.pushRequest(std::vector<std::string> {args...});
+    push(std::vector<std::string> {args...});
   }
 
   void del(const std::string& key);
@@ -92,26 +96,56 @@ public:
 
   void execute(const std::vector<std::string>& req)
   {
-    backgroundFlusher.pushRequest(req);
+    push(std::vector<std::string>(req));
   }
 
+  //----------------------------------------------------------------------------
+  //! Enable coalescing of the requests: they are buffered for the given
+  //! window and the updates superseded within the window are dropped before
+  //! reaching the background flusher, see RequestCoalescer. Requests buffered
+  //! are not yet persisted in the local journal, a crash loses at most one
+  //! window of updates. Must be called before any request is queued.
+  //!
+  //! @param window coalescing window, 0 disables coalescing
+  //----------------------------------------------------------------------------
+  void enableCoalescing(std::chrono::milliseconds window);
+
+  //----------------------------------------------------------------------------
+  //! Get the coalescing counters i.e. requests and bytes queued by the
+  //! callers vs. pushed to the background flusher
+  //----------------------------------------------------------------------------
+  RequestCoalescer::Stats getCoalescingStats();
+
   //----------------------------------------------------------------------------
   //! Block until the queue has flushed all pending entries at the time of
   //! calling. Example: synchronize is called when pending items in the queue
   //! are [1500, 2000]. The calling thread sleeps up to the point that entry
   //! #2000 is flushed - of course, at that point other items might have been
-  //! added to the queue, but we don't wait.
+  //! added to the queue, but we don't wait. Requests buffered for coalescing
+  //! are pushed to the queue first.
   //----------------------------------------------------------------------------
   void synchronize(ItemIndex targetIndex = -1);
 
   std::string getPersistencyType();
 
 private:
+  //! Max number of buffered requests before forcing a flush of the buffer
+  static constexpr size_t kMaxCoalesced = 100000;
+
   void queueSizeMonitoring(qclient::ThreadAssistant& assistant);
+  void push(std::vector<std::string>&& req);
+  void flushCoalesced();
+  void coalescingLoop(qclient::ThreadAssistant& assistant);
   std::string id;
   std::string persistencyConfig;
   FlusherNotifier notifier;
   qclient::BackgroundFlusher backgroundFlusher;
+  std::atomic<bool> mCoalescing {false};
+  std::chrono::milliseconds mCoalescingWindow {0};
+  std::mutex mCoalescerMutex; ///< Protects the coalescer
+  std::mutex mFlushMutex; ///< Keeps the order of the flushed batches
+  RequestCoalescer mCoalescer;
+  qclient::AssistedThread coalescingThread;
   qclient::AssistedThread sizePrinter;
 };
 
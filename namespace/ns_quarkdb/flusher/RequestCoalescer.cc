@@ -0,0 +1,132 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/flusher/RequestCoalescer.hh"
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Add request to the buffer
+//------------------------------------------------------------------------------
+void
+RequestCoalescer::add(Request&& req)
+{
+  ++mStats.mRequestsIn;
+  mStats.mBytesIn += getRequestSize(req);
+  char family = 0;
+  size_t num_args = 0;
+
+  if (!req.empty()) {
+    const std::string& cmd = req[0];
+
+    if (cmd == "HSET" || cmd == "HDEL") {
+      family = 'h';
+      num_args = (cmd == "HSET" ? 4 : 3);
+    } else if (cmd == "LHSET" || cmd == "LHDEL") {
+      family = 'l';
+      num_args = (cmd == "LHSET" ? 5 : 3);
+    } else if (cmd == "SADD" || cmd == "SREM") {
+      family = 's';
+      num_args = 3;
+    } else if (cmd == "HINCRBY" || cmd == "HINCRBYMULTI") {
+      // Pin the fields, an earlier write of the value they increment must
+      // not be dropped. HINCRBYMULTI takes triplets of key, field, value.
+      for (size_t i = 1; i + 1 < req.size(); i += 3) {
+        mLastWrite.erase(getIndexKey('h', req[i], req[i + 1]));
+      }
+    } else if (cmd != "DEL") {
+      // Unknown side effects, don't merge anything across this request
+      mLastWrite.clear();
+    }
+  }
+
+  if (family) {
+    if (req.size() == num_args) {
+      auto ins = mLastWrite.emplace(getIndexKey(family, req[1], req[2]),
+                                    mPending.size());
+
+      if (!ins.second) {
+        mPending[ins.first->second].reset();
+        ins.first->second = mPending.size();
+      }
+    } else {
+      // Multi-field request, pin all the fields
+      for (size_t i = 2; i < req.size(); ++i) {
+        mLastWrite.erase(getIndexKey(family, req[1], req[i]));
+      }
+    }
+  }
+
+  mPending.emplace_back(std::move(req));
+}
+
+//------------------------------------------------------------------------------
+// Extract the buffered requests that were not superseded
+//------------------------------------------------------------------------------
+std::vector<RequestCoalescer::Request>
+RequestCoalescer::extract()
+{
+  std::vector<Request> out;
+  out.reserve(mPending.size());
+
+  for (auto& req : mPending) {
+    if (req) {
+      ++mStats.mRequestsOut;
+      mStats.mBytesOut += getRequestSize(*req);
+      out.emplace_back(std::move(*req));
+    }
+  }
+
+  mPending.clear();
+  mLastWrite.clear();
+  return out;
+}
+
+//------------------------------------------------------------------------------
+// Get the size in bytes of a request
+//------------------------------------------------------------------------------
+uint64_t
+RequestCoalescer::getRequestSize(const Request& req)
+{
+  uint64_t sz = 0ull;
+
+  for (const auto& arg : req) {
+    sz += arg.size();
+  }
+
+  return sz;
+}
+
+//------------------------------------------------------------------------------
+// Build index key of a field or member
+//------------------------------------------------------------------------------
+std::string
+RequestCoalescer::getIndexKey(char family, const std::string& key,
+                              const std::string& field)
+{
+  std::string index_key;
+  index_key.reserve(key.size() + field.size() + 3);
+  index_key += family;
+  index_key += '\0';
+  index_key += key;
+  index_key += '\0';
+  index_key += field;
+  return index_key;
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,103 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Merge redundant metadata updates before they are flushed to QuarkDB
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Buffer of redis requests where a request overwriting a single hash field
+//! (HSET, HDEL, LHSET, LHDEL) or a single set member (SADD, SREM) drops the
+//! previous buffered request on the same field or member. The requests are
+//! blind writes so only the last one decides the final state, e.g. SADD x
+//! followed by SREM x collapses into SREM x. The order of the remaining
+//! requests is preserved. Requests whose result depends on the current value
+//! (HINCRBY) pin the fields they touch, while unknown commands act as a
+//! barrier and are never merged across. Not thread-safe.
+//------------------------------------------------------------------------------
+class RequestCoalescer
+{
+public:
+  using Request = std::vector<std::string>;
+
+  //! Counters of the requests added to and extracted from the coalescer
+  struct Stats {
+    uint64_t mRequestsIn {0ull};
+    uint64_t mRequestsOut {0ull};
+    uint64_t mBytesIn {0ull};
+    uint64_t mBytesOut {0ull};
+  };
+
+  //----------------------------------------------------------------------------
+  //! Add request to the buffer
+  //----------------------------------------------------------------------------
+  void add(Request&& req);
+
+  //----------------------------------------------------------------------------
+  //! Extract the buffered requests that were not superseded, in the order
+  //! they were added, and reset the buffer
+  //----------------------------------------------------------------------------
+  std::vector<Request> extract();
+
+  //----------------------------------------------------------------------------
+  //! Get number of requests added since the last extraction
+  //----------------------------------------------------------------------------
+  size_t size() const
+  {
+    return mPending.size();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get counters accumulated since construction
+  //----------------------------------------------------------------------------
+  const Stats& getStats() const
+  {
+    return mStats;
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Get the size in bytes of a request
+  //----------------------------------------------------------------------------
+  static uint64_t getRequestSize(const Request& req);
+
+  //----------------------------------------------------------------------------
+  //! Build index key of a field or member, the family separates hashes,
+  //! locality hashes and sets
+  //----------------------------------------------------------------------------
+  static std::string getIndexKey(char family, const std::string& key,
+                                 const std::string& field);
+
+  //! Buffered requests, superseded ones are reset
+  std::vector<std::optional<Request>> mPending;
+  //! Map of index key to position of the last request writing it
+  std::unordered_map<std::string, size_t> mLastWrite;
+  Stats mStats;
+};
+
+EOSNSNAMESPACE_END
@@ -21,6 +21,8 @@
 #include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
 #include "namespace/ns_quarkdb/inspector/ContainerScanner.hh"
 #include "namespace/ns_quarkdb/inspector/FileScanner.hh"
+#include "namespace/ns_quarkdb/inspector/ParallelScanner.hh"
+#include "namespace/ns_quarkdb/inspector/NamespaceExporter.hh"
 #include "namespace/ns_quarkdb/inspector/Printing.hh"
 #include "namespace/ns_quarkdb/inspector/OutputSink.hh"
 #include "namespace/ns_quarkdb/inspector/FileMetadataFilter.hh"
@@ -44,6 +46,7 @@
 #include <qclient/ResponseParsing.hh>
 #include <google/protobuf/util/json_util.h>
 #include <json/json.h>
+#include <fstream>
 EOSNSNAMESPACE_BEGIN
 
 //------------------------------------------------------------------------------
@@ -127,6 +130,16 @@ void Inspector::setMetadataFilter(std::unique_ptr<FileMetadataFilter> filter)
   mMetadataFilter = std::move(filter);
 }
 
+//------------------------------------------------------------------------------
+// Scan the file and container metadata with the given number of workers
+//------------------------------------------------------------------------------
+void Inspector::setParallelScan(const std::vector<qclient::QClient*>& qcls,
+                                size_t workers)
+{
+  mScanQcls = qcls;
+  mScanWorkers = (qcls.empty() ? 0 : workers);
+}
+
 //------------------------------------------------------------------------------
 // Is the connection to QDB ok? If not, pointless to run anything else.
 //------------------------------------------------------------------------------
@@ -368,6 +381,11 @@ int Inspector::scanDirs(bool onlyNoAttrs, bool fullPaths, bool countContents,
     countContents = true;
   }
 
+  if (mScanWorkers > 0) {
+    return scanDirsParallel(onlyNoAttrs, fullPaths, countContents,
+                            countThreshold);
+  }
+
   ContainerPrintingOptions opts;
   ContainerScanner containerScanner(mQcl, fullPaths, countContents);
 
@@ -404,6 +422,49 @@ int Inspector::scanDirs(bool onlyNoAttrs, bool fullPaths, bool countContents,
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// Parallel version of scanDirs, the output is sorted by container id
+//------------------------------------------------------------------------------
+int Inspector::scanDirsParallel(bool onlyNoAttrs, bool fullPaths,
+                                bool countContents, size_t countThreshold)
+{
+  ContainerPrintingOptions opts;
+  ParallelContainerScanner::Options scanOpts;
+  scanOpts.workers = mScanWorkers;
+  scanOpts.fullPaths = fullPaths;
+  scanOpts.counts = countContents;
+
+  if (onlyNoAttrs) {
+    scanOpts.filter = [](const eos::ns::ContainerMdProto& proto) {
+      return proto.xattrs().empty();
+    };
+  }
+
+  ParallelContainerScanner scanner(mScanQcls, scanOpts);
+  ParallelContainerScanner::Item result;
+
+  while (scanner.fetch(result)) {
+    if (countThreshold > 0 &&
+        (result.fileCount + result.containerCount) < countThreshold) {
+      continue;
+    }
+
+    ContainerScanner::Item item(std::move(result.proto),
+                                std::move(result.fullPath),
+                                result.fileCount, result.containerCount);
+    mOutputSink.print(item.proto, opts, item, countContents);
+  }
+
+  std::string errorString;
+
+  if (scanner.hasError(errorString)) {
+    mOutputSink.err(errorString);
+    return 1;
+  }
+
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 // Fetch path or name from a combination of FileMdProto +
 // FileScanner::Item, return as much information as is available
@@ -466,6 +527,10 @@ int Inspector::scanFileMetadata(bool onlySizes, bool fullPaths,
     return -1;
   }
 
+  if (mScanWorkers > 0) {
+    return scanFileMetadataParallel(onlySizes, fullPaths, findUnknownFsids);
+  }
+
   FileScanner fileScanner(mQcl, fullPaths);
   FilePrintingOptions opts;
 
@@ -506,6 +571,113 @@ int Inspector::scanFileMetadata(bool onlySizes, bool fullPaths,
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// Parallel version of scanFileMetadata, the output is sorted by file id. The
+// filters are evaluated by the scanner workers.
+//------------------------------------------------------------------------------
+int Inspector::scanFileMetadataParallel(bool onlySizes, bool fullPaths,
+                                        bool findUnknownFsids)
+{
+  FilePrintingOptions opts;
+  ParallelFileScanner::Options scanOpts;
+  scanOpts.workers = mScanWorkers;
+  scanOpts.fullPaths = fullPaths;
+  FileMetadataFilter* metadataFilter = mMetadataFilter.get();
+
+  if (findUnknownFsids || metadataFilter) {
+    scanOpts.filter = [&](const eos::ns::FileMdProto& proto) {
+      if (findUnknownFsids && checkLocations(proto, validFsIds)) {
+        return false;
+      }
+
+      return !metadataFilter || metadataFilter->check(proto);
+    };
+  }
+
+  ParallelFileScanner scanner(mScanQcls, scanOpts);
+  ParallelFileScanner::Item result;
+
+  while (scanner.fetch(result)) {
+    if (onlySizes) {
+      mOutputSink.print(std::to_string(result.proto.size()));
+      continue;
+    }
+
+    FileScanner::Item item(std::move(result.proto),
+                           std::move(result.fullPath));
+    mOutputSink.print(item.proto, opts, item);
+  }
+
+  std::string errorString;
+
+  if (scanner.hasError(errorString)) {
+    mOutputSink.err(errorString);
+    return 1;
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Export all file and container metadata in columnar format
+//------------------------------------------------------------------------------
+int Inspector::exportNamespace(const std::string& prefix, uint64_t chunkSize,
+                               bool requireConsistent, std::ostream& out,
+                               std::ostream& err)
+{
+  const std::string filesPath = prefix + ".files.eosns";
+  const std::string containersPath = prefix + ".containers.eosns";
+  std::ofstream files(filesPath, std::ios::binary | std::ios::trunc);
+  std::ofstream containers(containersPath, std::ios::binary | std::ios::trunc);
+
+  if (!files || !containers) {
+    err << "Could not open " << filesPath << " or " << containersPath <<
+        " for writing" << std::endl;
+    return 1;
+  }
+
+  std::vector<qclient::QClient*> qcls = mScanQcls;
+  NamespaceExporter::Options opts;
+  opts.workers = mScanWorkers;
+  opts.chunkSize = chunkSize;
+
+  if (qcls.empty()) {
+    qcls.push_back(&mQcl);
+    opts.workers = 1;
+  }
+
+  NamespaceExporter exporter(qcls, opts);
+  NamespaceExporter::Summary summary;
+  std::string errorString;
+
+  if (!exporter.run(files, containers, summary, errorString)) {
+    err << errorString << std::endl;
+    return 1;
+  }
+
+  out << "Exported " << summary.files << " files into " << filesPath <<
+      " and " << summary.containers << " containers into " << containersPath <<
+      std::endl;
+
+  if (!summary.raft) {
+    out << "QuarkDB runs in standalone mode, the export is consistent only "
+        "if nothing was writing to it, e.g. when started on a checkpoint" <<
+        std::endl;
+    return 0;
+  }
+
+  if (summary.consistent) {
+    out << "Consistent with last applied raft index " << summary.startIndex <<
+        std::endl;
+    return 0;
+  }
+
+  err << "QuarkDB applied writes during the export, last applied raft index "
+      "moved from " << summary.startIndex << " to " << summary.endIndex <<
+      std::endl;
+  return requireConsistent ? 1 : 0;
+}
+
 //------------------------------------------------------------------------------
 // Scan all deathrow entries
 //------------------------------------------------------------------------------
@@ -92,6 +92,19 @@ public:
   //----------------------------------------------------------------------------
   int scanFileMetadata(bool onlySizes, bool fullPaths, bool onlyUnknownFsids);
 
+  //----------------------------------------------------------------------------
+  //! Export all file and container metadata in columnar format, into
+  //! <prefix>.files.eosns and <prefix>.containers.eosns, see
+  //! NamespaceExporter.
+  //!
+  //! @param prefix prefix of the output files
+  //! @param chunkSize number of entries per chunk
+  //! @param requireConsistent fail if QDB applied writes during the export
+  //----------------------------------------------------------------------------
+  int exportNamespace(const std::string& prefix, uint64_t chunkSize,
+                      bool requireConsistent, std::ostream& out,
+                      std::ostream& err);
+
   //----------------------------------------------------------------------------
   //! Scan all deathrow entries
   //----------------------------------------------------------------------------
@@ -218,6 +231,18 @@ public:
   //----------------------------------------------------------------------------
   void setMetadataFilter(std::unique_ptr<FileMetadataFilter> filter);
 
+  //----------------------------------------------------------------------------
+  //! Scan the file and container metadata with the given number of workers,
+  //! see ParallelScanner. Used by scanFileMetadata and scanDirs, 0 workers
+  //! means a single cursor scan. Also used by exportNamespace, which scans
+  //! over the main connection with a single worker by default.
+  //!
+  //! @param qcls connections shared by the workers, no ownership
+  //! @param workers number of workers
+  //----------------------------------------------------------------------------
+  void setParallelScan(const std::vector<qclient::QClient*>& qcls,
+                       size_t workers);
+
 private:
   std::map<std::string, std::string> mgmConfiguration;
   std::set<int64_t> validFsIds;
@@ -226,6 +251,20 @@ private:
   OutputSink& mOutputSink;
 
   std::unique_ptr<FileMetadataFilter> mMetadataFilter;
+  std::vector<qclient::QClient*> mScanQcls;
+  size_t mScanWorkers = 0;
+
+  //----------------------------------------------------------------------------
+  //! Parallel version of scanDirs
+  //----------------------------------------------------------------------------
+  int scanDirsParallel(bool onlyNoAttrs, bool fullPaths, bool countContents,
+                       size_t countThreshold);
+
+  //----------------------------------------------------------------------------
+  //! Parallel version of scanFileMetadata
+  //----------------------------------------------------------------------------
+  int scanFileMetadataParallel(bool onlySizes, bool fullPaths,
+                               bool findUnknownFsids);
 
   //----------------------------------------------------------------------------
   //! Check if given path is a good choice as a destination for repaired
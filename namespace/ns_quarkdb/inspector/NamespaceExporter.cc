@@ -0,0 +1,418 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/inspector/NamespaceExporter.hh"
+#include "namespace/ns_quarkdb/inspector/ParallelScanner.hh"
+#include "namespace/ns_quarkdb/inspector/Printing.hh"
+#include "common/ParseUtils.hh"
+#include "common/StringUtils.hh"
+#include "proto/NamespaceExport.pb.h"
+#include <qclient/QClient.hh>
+#include <qclient/ResponseParsing.hh>
+#include <zlib.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <future>
+#include <thread>
+
+EOSNSNAMESPACE_BEGIN
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Size of the frame header: magic, type, uncompressed and compressed size
+//------------------------------------------------------------------------------
+constexpr size_t kFrameHeaderSize = 4 * sizeof(uint32_t);
+
+//------------------------------------------------------------------------------
+// What differs between exporting files and containers
+//------------------------------------------------------------------------------
+template<typename Proto>
+struct ExportTraits;
+
+template<>
+struct ExportTraits<eos::ns::FileMdProto> {
+  using Columns = eos::ns::FileColumnsProto;
+  static constexpr NamespaceExporter::FrameType kFrameType =
+    NamespaceExporter::FrameType::kFileColumns;
+
+  static void append(Columns& cols, const eos::ns::FileMdProto& proto)
+  {
+    struct timespec ctime = Printing::parseTimespec(proto.ctime());
+    struct timespec mtime = Printing::parseTimespec(proto.mtime());
+    cols.add_id(proto.id());
+    cols.add_cont_id(proto.cont_id());
+    cols.add_uid(proto.uid());
+    cols.add_gid(proto.gid());
+    cols.add_size(proto.size());
+    cols.add_layout_id(proto.layout_id());
+    cols.add_flags(proto.flags());
+    cols.add_name(proto.name());
+    cols.add_link_name(proto.link_name());
+    cols.add_ctime_sec(ctime.tv_sec);
+    cols.add_ctime_nsec(ctime.tv_nsec);
+    cols.add_mtime_sec(mtime.tv_sec);
+    cols.add_mtime_nsec(mtime.tv_nsec);
+    cols.add_checksum(proto.checksum());
+    cols.add_num_locations(proto.locations_size());
+    cols.mutable_locations()->MergeFrom(proto.locations());
+    cols.add_num_unlink_locations(proto.unlink_locations_size());
+    cols.mutable_unlink_locations()->MergeFrom(proto.unlink_locations());
+    cols.add_num_xattrs(proto.xattrs_size());
+  }
+};
+
+template<>
+struct ExportTraits<eos::ns::ContainerMdProto> {
+  using Columns = eos::ns::ContainerColumnsProto;
+  static constexpr NamespaceExporter::FrameType kFrameType =
+    NamespaceExporter::FrameType::kContainerColumns;
+
+  static void append(Columns& cols, const eos::ns::ContainerMdProto& proto)
+  {
+    struct timespec ctime = Printing::parseTimespec(proto.ctime());
+    struct timespec mtime = Printing::parseTimespec(proto.mtime());
+    struct timespec stime = Printing::parseTimespec(proto.stime());
+    cols.add_id(proto.id());
+    cols.add_parent_id(proto.parent_id());
+    cols.add_uid(proto.uid());
+    cols.add_gid(proto.gid());
+    cols.add_mode(proto.mode());
+    cols.add_flags(proto.flags());
+    cols.add_name(proto.name());
+    cols.add_tree_size(proto.tree_size());
+    cols.add_tree_files(proto.tree_files());
+    cols.add_tree_containers(proto.tree_containers());
+    cols.add_ctime_sec(ctime.tv_sec);
+    cols.add_ctime_nsec(ctime.tv_nsec);
+    cols.add_mtime_sec(mtime.tv_sec);
+    cols.add_mtime_nsec(mtime.tv_nsec);
+    cols.add_stime_sec(stime.tv_sec);
+    cols.add_stime_nsec(stime.tv_nsec);
+    cols.add_num_xattrs(proto.xattrs_size());
+  }
+};
+
+//------------------------------------------------------------------------------
+// Build the header frame of a table
+//------------------------------------------------------------------------------
+eos::ns::ExportHeaderProto
+buildHeader(const std::string& kind, const NamespaceExporter::Summary& summary)
+{
+  eos::ns::ExportHeaderProto header;
+  header.set_version(NamespaceExporter::kVersion);
+  header.set_kind(kind);
+  header.set_raft(summary.raft);
+  header.set_raft_last_applied(summary.startIndex);
+  header.set_timestamp(time(nullptr));
+  return header;
+}
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+NamespaceExporter::NamespaceExporter(const std::vector<qclient::QClient*>& qcls,
+                                     const Options& opts)
+  : mQcls(qcls), mOpts(opts)
+{
+  mOpts.workers = std::max<size_t>(mOpts.workers, 1);
+  mOpts.chunkSize = std::min<uint64_t>(std::max<uint64_t>(mOpts.chunkSize, 1),
+                                       UINT32_MAX);
+}
+
+//------------------------------------------------------------------------------
+// Export the namespace
+//------------------------------------------------------------------------------
+bool
+NamespaceExporter::run(std::ostream& files, std::ostream& containers,
+                       Summary& summary, std::string& err)
+{
+  summary = Summary();
+
+  if (mQcls.empty()) {
+    err = "no QClient connection given";
+    return false;
+  }
+
+  if (!getLastApplied(*mQcls[0], summary.raft, summary.startIndex, err)) {
+    return false;
+  }
+
+  std::string payload;
+  buildHeader("files", summary).SerializeToString(&payload);
+  std::string frame = buildFrame(FrameType::kHeader, payload,
+                                 mOpts.compressionLevel);
+
+  if (frame.empty()) {
+    err = SSTR("Invalid compression level " << mOpts.compressionLevel);
+    return false;
+  }
+
+  files.write(frame.data(), frame.size());
+  buildHeader("containers", summary).SerializeToString(&payload);
+  frame = buildFrame(FrameType::kHeader, payload, mOpts.compressionLevel);
+  containers.write(frame.data(), frame.size());
+  // Scan both tables at the same time
+  uint64_t fileChunks = 0;
+  uint64_t containerChunks = 0;
+  std::string fileErr;
+  bool fileOk = false;
+  std::thread fileThread([&]() {
+    fileOk = exportTable<eos::ns::FileMdProto>(files, summary.files, fileChunks,
+             fileErr);
+  });
+  bool containerOk = exportTable<eos::ns::ContainerMdProto>(containers,
+                     summary.containers, containerChunks, err);
+  fileThread.join();
+
+  if (!fileOk) {
+    err = fileErr;
+    return false;
+  }
+
+  if (!containerOk) {
+    return false;
+  }
+
+  bool raft = false;
+
+  if (!getLastApplied(*mQcls[0], raft, summary.endIndex, err)) {
+    return false;
+  }
+
+  summary.consistent = raft && summary.raft &&
+                       (summary.startIndex == summary.endIndex);
+  eos::ns::ExportTrailerProto trailer;
+  trailer.set_raft_last_applied(summary.endIndex);
+  trailer.set_consistent(summary.consistent);
+  trailer.set_num_entries(summary.files);
+  trailer.set_num_chunks(fileChunks);
+  trailer.SerializeToString(&payload);
+  frame = buildFrame(FrameType::kTrailer, payload, mOpts.compressionLevel);
+  files.write(frame.data(), frame.size());
+  trailer.set_num_entries(summary.containers);
+  trailer.set_num_chunks(containerChunks);
+  trailer.SerializeToString(&payload);
+  frame = buildFrame(FrameType::kTrailer, payload, mOpts.compressionLevel);
+  containers.write(frame.data(), frame.size());
+  files.flush();
+  containers.flush();
+
+  if (!files || !containers) {
+    err = "Error while writing the export";
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Write all the chunks of one table
+//------------------------------------------------------------------------------
+template<typename Proto>
+bool
+NamespaceExporter::exportTable(std::ostream& out, uint64_t& entries,
+                               uint64_t& chunks, std::string& err)
+{
+  using Columns = typename ExportTraits<Proto>::Columns;
+  typename ParallelScanner<Proto>::Options scanOpts;
+  scanOpts.workers = mOpts.workers;
+  ParallelScanner<Proto> scanner(mQcls, scanOpts);
+  typename ParallelScanner<Proto>::Item item;
+  // Chunks being compressed, written in order once done
+  std::deque<std::future<std::string>> pending;
+  Columns columns;
+  uint64_t rows = 0;
+  const int level = mOpts.compressionLevel;
+
+  bool compressed = true;
+  auto writeUntil = [&](size_t maxPending) {
+    while (pending.size() > maxPending) {
+      std::string frame = pending.front().get();
+      pending.pop_front();
+      compressed = compressed && !frame.empty();
+      out.write(frame.data(), frame.size());
+    }
+  };
+  auto submit = [&]() {
+    pending.push_back(std::async(std::launch::async,
+    [cols = std::move(columns), level]() {
+      std::string payload;
+      cols.SerializeToString(&payload);
+      return buildFrame(ExportTraits<Proto>::kFrameType, payload, level);
+    }));
+    columns.Clear();
+    rows = 0;
+    ++chunks;
+    writeUntil(mOpts.workers);
+  };
+
+  while (scanner.fetch(item)) {
+    ExportTraits<Proto>::append(columns, item.proto);
+    ++entries;
+
+    if (++rows == mOpts.chunkSize) {
+      submit();
+    }
+  }
+
+  if (rows > 0) {
+    submit();
+  }
+
+  writeUntil(0);
+
+  if (scanner.hasError(err)) {
+    return false;
+  }
+
+  if (!compressed) {
+    err = "Error while compressing a chunk";
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Compress the given payload into a full frame, empty on failure
+//------------------------------------------------------------------------------
+std::string
+NamespaceExporter::buildFrame(FrameType type, const std::string& payload,
+                              int level)
+{
+  uLongf compressedSize = compressBound(payload.size());
+  std::string frame(kFrameHeaderSize + compressedSize, '\0');
+
+  if (compress2((Bytef*) &frame[kFrameHeaderSize], &compressedSize,
+                (const Bytef*) payload.data(), payload.size(), level) != Z_OK) {
+    return std::string();
+  }
+
+  // The frame header stores the sizes on 32 bits
+  if ((payload.size() > UINT32_MAX) || (compressedSize > UINT32_MAX)) {
+    return std::string();
+  }
+
+  frame.resize(kFrameHeaderSize + compressedSize);
+  const uint32_t header[4] = {kFrameMagic, static_cast<uint32_t>(type),
+                              static_cast<uint32_t>(payload.size()),
+                              static_cast<uint32_t>(compressedSize)
+                             };
+  memcpy(&frame[0], header, kFrameHeaderSize);
+  return frame;
+}
+
+//------------------------------------------------------------------------------
+// Read the next frame of an export
+//------------------------------------------------------------------------------
+bool
+NamespaceExporter::readFrame(std::istream& in, FrameType& type,
+                             std::string& payload, std::string& err)
+{
+  err.clear();
+  uint32_t header[4];
+  in.read((char*) header, kFrameHeaderSize);
+
+  if (in.gcount() == 0 && in.eof()) {
+    return false;
+  }
+
+  if (in.gcount() != (std::streamsize) kFrameHeaderSize) {
+    err = "Truncated frame header";
+    return false;
+  }
+
+  if (header[0] != kFrameMagic) {
+    err = "Invalid frame magic, not a namespace export";
+    return false;
+  }
+
+  type = static_cast<FrameType>(header[1]);
+  std::string compressed(header[3], '\0');
+  in.read(&compressed[0], compressed.size());
+
+  if (in.gcount() != (std::streamsize) compressed.size()) {
+    err = "Truncated frame payload";
+    return false;
+  }
+
+  payload.resize(header[2]);
+  uLongf size = payload.size();
+
+  if ((uncompress((Bytef*) &payload[0], &size, (const Bytef*) compressed.data(),
+                  compressed.size()) != Z_OK) || (size != payload.size())) {
+    err = "Corrupted frame payload";
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get the last applied raft index of QDB
+//------------------------------------------------------------------------------
+bool
+NamespaceExporter::getLastApplied(qclient::QClient& qcl, bool& raft,
+                                  uint64_t& index, std::string& err)
+{
+  qclient::redisReplyPtr reply = qcl.exec("RAFT-INFO").get();
+  raft = false;
+  index = 0;
+
+  if (!reply) {
+    err = "QuarkDB backend not available!";
+    return false;
+  }
+
+  // Standalone mode, no raft journal
+  if (reply->type == REDIS_REPLY_ERROR) {
+    return true;
+  }
+
+  if (reply->type == REDIS_REPLY_ARRAY) {
+    const std::string prefix = "LAST-APPLIED ";
+
+    for (size_t i = 0; i < reply->elements; ++i) {
+      const redisReply* element = reply->element[i];
+
+      if ((element->type != REDIS_REPLY_STRING) &&
+          (element->type != REDIS_REPLY_STATUS)) {
+        continue;
+      }
+
+      std::string line(element->str, element->len);
+
+      if (eos::common::startsWith(line, prefix) &&
+          common::ParseUInt64(line.substr(prefix.size()), index)) {
+        raft = true;
+        return true;
+      }
+    }
+  }
+
+  err = SSTR("Received unexpected response to RAFT-INFO: " <<
+             qclient::describeRedisReply(reply));
+  return false;
+}
+
+EOSNSNAMESPACE_END
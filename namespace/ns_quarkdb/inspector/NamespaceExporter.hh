@@ -0,0 +1,153 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Class exporting all file and container metadata in columnar format
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace qclient
+{
+class QClient;
+}
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Export the whole namespace for offline analysis, one file for the files
+//! and one for the containers, see NamespaceExport.proto for the layout.
+//!
+//! Both tables are scanned at the same time with ParallelScanner. Entries
+//! are grouped in chunks of columns, which are serialized and compressed by
+//! a bounded number of tasks running in parallel, and written in id order.
+//!
+//! The view is consistent when no write was applied by QDB between the start
+//! and the end of the export, which is checked through the last applied
+//! index of the raft journal. On a live instance the MGM keeps writing, so a
+//! point-in-time export is rather taken from a standalone QDB started on a
+//! checkpoint of the raft cluster. Standalone QDBs have no journal, the
+//! consistency of the export is then unknown to the exporter.
+//------------------------------------------------------------------------------
+class NamespaceExporter
+{
+public:
+  //! Version of the export format
+  static constexpr uint32_t kVersion = 1;
+
+  //! Type of the frames, each frame starts with kFrameMagic, its type, its
+  //! uncompressed and its compressed size, as 32 bit integers in host byte
+  //! order like the QDB serialization
+  enum class FrameType : uint32_t {
+    kHeader = 1,
+    kFileColumns = 2,
+    kContainerColumns = 3,
+    kTrailer = 4
+  };
+
+  static constexpr uint32_t kFrameMagic = 0x58534e45; // "ENSX"
+
+  struct Options {
+    size_t workers = 8; ///< Number of scanning workers per table
+    uint64_t chunkSize = 100000; ///< Entries per chunk, at most UINT32_MAX
+    int compressionLevel = 6; ///< zlib compression level
+  };
+
+  struct Summary {
+    uint64_t files = 0;
+    uint64_t containers = 0;
+    bool raft = false; ///< false if the raft indices are not available
+    uint64_t startIndex = 0; ///< Last applied raft index at the start
+    uint64_t endIndex = 0; ///< Last applied raft index at the end
+    bool consistent = false; ///< Raft mode and no write during the export
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param qcls QClient connections used by the workers, no ownership
+  //! @param opts export options
+  //----------------------------------------------------------------------------
+  NamespaceExporter(const std::vector<qclient::QClient*>& qcls,
+                    const Options& opts);
+
+  //----------------------------------------------------------------------------
+  //! Export the namespace
+  //!
+  //! @param files stream receiving the file table
+  //! @param containers stream receiving the container table
+  //! @param summary filled with the counts and the consistency of the export
+  //! @param err error message
+  //!
+  //! @return false on error, the outputs are then incomplete
+  //----------------------------------------------------------------------------
+  bool run(std::ostream& files, std::ostream& containers, Summary& summary,
+           std::string& err);
+
+  //----------------------------------------------------------------------------
+  //! Read the next frame of an export
+  //!
+  //! @param in input stream
+  //! @param type type of the frame
+  //! @param payload uncompressed payload, a serialized proto
+  //! @param err error message, empty when the end of the stream is reached
+  //!
+  //! @return true if a frame was read
+  //----------------------------------------------------------------------------
+  static bool readFrame(std::istream& in, FrameType& type, std::string& payload,
+                        std::string& err);
+
+  //----------------------------------------------------------------------------
+  //! Get the last applied raft index of QDB
+  //!
+  //! @param qcl QClient connection
+  //! @param raft false if QDB does not run in raft mode
+  //! @param index last applied index
+  //! @param err error message
+  //!
+  //! @return false on error
+  //----------------------------------------------------------------------------
+  static bool getLastApplied(qclient::QClient& qcl, bool& raft,
+                             uint64_t& index, std::string& err);
+
+private:
+  std::vector<qclient::QClient*> mQcls;
+  Options mOpts;
+
+  //----------------------------------------------------------------------------
+  //! Compress the given payload into a full frame, empty on failure
+  //----------------------------------------------------------------------------
+  static std::string buildFrame(FrameType type, const std::string& payload,
+                                int level);
+
+  //----------------------------------------------------------------------------
+  //! Write all the chunks of one table
+  //!
+  //! @return false on error, err is then set
+  //----------------------------------------------------------------------------
+  template<typename Proto>
+  bool exportTable(std::ostream& out, uint64_t& entries, uint64_t& chunks,
+                   std::string& err);
+};
+
+EOSNSNAMESPACE_END
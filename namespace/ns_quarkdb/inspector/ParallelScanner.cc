@@ -0,0 +1,370 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "namespace/ns_quarkdb/inspector/ParallelScanner.hh"
+#include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
+#include "namespace/ns_quarkdb/persistency/RequestBuilder.hh"
+#include "namespace/ns_quarkdb/persistency/Serialization.hh"
+#include "namespace/ns_quarkdb/Constants.hh"
+#include "common/ParseUtils.hh"
+#include <qclient/QClient.hh>
+#include <qclient/ResponseParsing.hh>
+#include <qclient/structures/QHash.hh>
+#include <algorithm>
+#include <future>
+
+EOSNSNAMESPACE_BEGIN
+
+namespace
+{
+//------------------------------------------------------------------------------
+// What differs between scanning files and containers
+//------------------------------------------------------------------------------
+template<typename Proto>
+struct ScanTraits;
+
+template<>
+struct ScanTraits<eos::ns::FileMdProto> {
+  static RedisRequest readRequest(uint64_t id)
+  {
+    return RequestBuilder::readFileProto(FileIdentifier(id));
+  }
+
+  static std::string lastUsedField(qclient::QHash& metaMap)
+  {
+    return constants::sLastUsedFid;
+  }
+
+  static ContainerIdentifier pathContainer(const eos::ns::FileMdProto& proto)
+  {
+    return ContainerIdentifier(proto.cont_id());
+  }
+
+  static constexpr bool kHasContents = false;
+};
+
+template<>
+struct ScanTraits<eos::ns::ContainerMdProto> {
+  static RedisRequest readRequest(uint64_t id)
+  {
+    return RequestBuilder::readContainerProto(ContainerIdentifier(id));
+  }
+
+  static std::string lastUsedField(qclient::QHash& metaMap)
+  {
+    if (metaMap.hget(constants::sUseSharedInodes) == "yes") {
+      return constants::sLastUsedFid;
+    }
+
+    return constants::sLastUsedCid;
+  }
+
+  static ContainerIdentifier pathContainer(const eos::ns::ContainerMdProto&
+      proto)
+  {
+    return ContainerIdentifier(proto.id());
+  }
+
+  static constexpr bool kHasContents = true;
+};
+
+//------------------------------------------------------------------------------
+// Get the value of a future, or the given default in case of exception
+//------------------------------------------------------------------------------
+template<typename T>
+T getOrDefault(folly::Future<T>& fut, T defaultValue)
+{
+  fut.wait();
+
+  if (fut.hasException()) {
+    return defaultValue;
+  }
+
+  return std::move(fut).get();
+}
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+template<typename Proto>
+ParallelScanner<Proto>::ParallelScanner(const std::vector<qclient::QClient*>&
+                                        qcls, const Options& opts)
+  : mQcls(qcls), mOpts(opts)
+{
+  mOpts.workers = std::max<size_t>(mOpts.workers, 1);
+  mOpts.rangeSize = std::max<uint64_t>(mOpts.rangeSize, 1);
+  mMaxAhead = 2 * mOpts.workers;
+
+  if (mQcls.empty()) {
+    mError = "no QClient connection given";
+    return;
+  }
+
+  std::string lastUsed;
+
+  try {
+    qclient::QHash metaMap(*mQcls[0], constants::sMapMetaInfoKey);
+    lastUsed = metaMap.hget(ScanTraits<Proto>::lastUsedField(metaMap));
+  } catch (const std::exception& exc) {
+    mError = SSTR("Error while fetching the last used id: " << exc.what());
+    return;
+  }
+
+  // An empty namespace has no last used id yet
+  if (!lastUsed.empty() && !common::ParseUInt64(lastUsed, mMaxId)) {
+    mError = SSTR("Could not parse the last used id: " << lastUsed);
+    return;
+  }
+
+  mNumRanges = (mMaxId + mOpts.rangeSize - 1) / mOpts.rangeSize;
+
+  for (size_t i = 0; i < mOpts.workers; ++i) {
+    qclient::QClient* qcl = mQcls[i % mQcls.size()];
+    mWorkers.emplace_back(&ParallelScanner::work, this, std::ref(*qcl));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+template<typename Proto>
+ParallelScanner<Proto>::~ParallelScanner()
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mSpaceCv.notify_all();
+
+  for (auto& worker : mWorkers) {
+    worker.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Fetch next item
+//------------------------------------------------------------------------------
+template<typename Proto>
+bool
+ParallelScanner<Proto>::fetch(Item& item)
+{
+  while (mCurrentPos >= mCurrent.size()) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReadyCv.wait(lock, [&] {
+      return !mError.empty() || (mConsumedRange >= mNumRanges) ||
+             (mReady.count(mConsumedRange) != 0);
+    });
+
+    if (!mError.empty() || (mConsumedRange >= mNumRanges)) {
+      return false;
+    }
+
+    auto it = mReady.find(mConsumedRange);
+    mCurrent = std::move(it->second);
+    mReady.erase(it);
+    mCurrentPos = 0;
+    ++mConsumedRange;
+    lock.unlock();
+    mSpaceCv.notify_all();
+  }
+
+  item = std::move(mCurrent[mCurrentPos++]);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Is there an error?
+//------------------------------------------------------------------------------
+template<typename Proto>
+bool
+ParallelScanner<Proto>::hasError(std::string& err) const
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  if (mError.empty()) {
+    return false;
+  }
+
+  err = mError;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get number of elements scanned so far
+//------------------------------------------------------------------------------
+template<typename Proto>
+uint64_t
+ParallelScanner<Proto>::getScannedSoFar() const
+{
+  return mScanned;
+}
+
+//------------------------------------------------------------------------------
+// Worker loop
+//------------------------------------------------------------------------------
+template<typename Proto>
+void
+ParallelScanner<Proto>::work(qclient::QClient& qcl)
+{
+  while (true) {
+    uint64_t range;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mSpaceCv.wait(lock, [&] {
+        return mStop || !mError.empty() || (mNextRange >= mNumRanges) ||
+               (mNextRange < mConsumedRange + mMaxAhead);
+      });
+
+      if (mStop || !mError.empty() || (mNextRange >= mNumRanges)) {
+        return;
+      }
+
+      range = mNextRange++;
+    }
+    std::vector<Item> items;
+    std::string err;
+
+    if (!scanRange(qcl, range, items, err)) {
+      setError(err);
+      return;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mReady[range] = std::move(items);
+    }
+    mReadyCv.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Read all the items in the given range
+//------------------------------------------------------------------------------
+template<typename Proto>
+bool
+ParallelScanner<Proto>::scanRange(qclient::QClient& qcl, uint64_t range,
+                                  std::vector<Item>& items, std::string& err)
+{
+  const uint64_t first = range * mOpts.rangeSize + 1;
+  const uint64_t last = std::min(first + mOpts.rangeSize - 1, mMaxId);
+  std::vector<std::future<qclient::redisReplyPtr>> replies;
+  replies.reserve(last - first + 1);
+
+  for (uint64_t id = first; id <= last; ++id) {
+    replies.push_back(qcl.execute(ScanTraits<Proto>::readRequest(id)));
+  }
+
+  for (uint64_t id = first; id <= last; ++id) {
+    qclient::redisReplyPtr reply = replies[id - first].get();
+
+    if (!reply) {
+      err = "QuarkDB backend not available!";
+      return false;
+    }
+
+    if ((reply->type == REDIS_REPLY_NIL) ||
+        (reply->type == REDIS_REPLY_STRING && reply->len == 0)) {
+      continue;
+    }
+
+    if (reply->type != REDIS_REPLY_STRING) {
+      err = SSTR("Received unexpected response for id " << id << ": " <<
+                 qclient::describeRedisReply(reply));
+      return false;
+    }
+
+    Item item;
+    MDStatus status = Serialization::deserialize(reply->str, reply->len,
+                      item.proto);
+
+    if (!status.ok()) {
+      err = SSTR("Error while deserializing id " << id << ": " <<
+                 status.getError());
+      return false;
+    }
+
+    ++mScanned;
+
+    if (mOpts.filter && !mOpts.filter(item.proto)) {
+      continue;
+    }
+
+    items.push_back(std::move(item));
+  }
+
+  // Resolve the paths and counts of the whole range at once, so that the
+  // requests of all the items are pipelined
+  const bool counts = ScanTraits<Proto>::kHasContents && mOpts.counts;
+
+  if (!mOpts.fullPaths && !counts) {
+    return true;
+  }
+
+  std::vector<folly::Future<std::string>> paths;
+  std::vector<std::pair<folly::Future<uint64_t>, folly::Future<uint64_t>>>
+      contents;
+
+  for (const auto& item : items) {
+    if (mOpts.fullPaths) {
+      paths.push_back(MetadataFetcher::resolveFullPath(qcl,
+                      ScanTraits<Proto>::pathContainer(item.proto)));
+    }
+
+    if (counts) {
+      contents.push_back(MetadataFetcher::countContents(qcl,
+                         ScanTraits<Proto>::pathContainer(item.proto)));
+    }
+  }
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    if (mOpts.fullPaths) {
+      items[i].fullPath = getOrDefault(paths[i], std::string());
+    }
+
+    if (counts) {
+      items[i].fileCount = getOrDefault(contents[i].first, uint64_t(0));
+      items[i].containerCount = getOrDefault(contents[i].second, uint64_t(0));
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Stop the workers because of the given error
+//------------------------------------------------------------------------------
+template<typename Proto>
+void
+ParallelScanner<Proto>::setError(const std::string& err)
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (mError.empty()) {
+      mError = err;
+    }
+  }
+  mReadyCv.notify_all();
+  mSpaceCv.notify_all();
+}
+
+template class ParallelScanner<eos::ns::FileMdProto>;
+template class ParallelScanner<eos::ns::ContainerMdProto>;
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,167 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Class for scanning all file or container metadata in parallel
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "proto/ContainerMd.pb.h"
+#include "proto/FileMd.pb.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace qclient
+{
+class QClient;
+}
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Scan all the file or container metadata stored in QDB, like the
+//! FileScanner and the ContainerScanner, but with a pool of workers.
+//!
+//! The id space, from 1 up to the last id handed out by the inode provider,
+//! is split into disjoint ranges. Each worker claims the next range, reads
+//! all its ids with pipelined requests on one of the given connections,
+//! applies the filter and optionally resolves the full paths. The ranges are
+//! then handed to the consumer in order, so the items come out sorted by id
+//! whatever the number of workers. Workers never run more than a bounded
+//! number of ranges ahead of the consumer.
+//!
+//! The locality hash can't be split between several cursors, which is why
+//! the ranges are read with point lookups. Ids which were never used or
+//! belong to deleted entries are simply skipped.
+//------------------------------------------------------------------------------
+template<typename Proto>
+class ParallelScanner
+{
+public:
+  //! Filter called concurrently from the workers, false drops the item
+  using Filter = std::function<bool(const Proto&)>;
+
+  struct Options {
+    size_t workers = 8; ///< Number of workers
+    uint64_t rangeSize = 10000; ///< Number of ids per range
+    bool fullPaths = false; ///< Resolve full paths
+    bool counts = false; ///< Count contents, containers only
+    Filter filter; ///< Optional filter
+  };
+
+  //----------------------------------------------------------------------------
+  //! Return type of fetch, same information as FileScanner::Item and
+  //! ContainerScanner::Item. For files the full path is the one of the parent
+  //! container, for containers it is their own path. Empty if not requested
+  //! or if it could not be resolved.
+  //----------------------------------------------------------------------------
+  struct Item {
+    Proto proto;
+    std::string fullPath;
+    uint64_t fileCount = 0;
+    uint64_t containerCount = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor, the workers start scanning right away
+  //!
+  //! @param qcls QClient connections used by the workers, no ownership
+  //! @param opts scanning options
+  //----------------------------------------------------------------------------
+  ParallelScanner(const std::vector<qclient::QClient*>& qcls,
+                  const Options& opts);
+
+  //----------------------------------------------------------------------------
+  //! Destructor, stops the workers even if the scan is not over
+  //----------------------------------------------------------------------------
+  ~ParallelScanner();
+
+  ParallelScanner(const ParallelScanner&) = delete;
+  ParallelScanner& operator=(const ParallelScanner&) = delete;
+
+  //----------------------------------------------------------------------------
+  //! Fetch next item, block if none is available yet
+  //!
+  //! @return false when the scan is over or on error
+  //----------------------------------------------------------------------------
+  bool fetch(Item& item);
+
+  //----------------------------------------------------------------------------
+  //! Is there an error?
+  //----------------------------------------------------------------------------
+  bool hasError(std::string& err) const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of elements scanned so far, including the filtered ones
+  //----------------------------------------------------------------------------
+  uint64_t getScannedSoFar() const;
+
+private:
+  std::vector<qclient::QClient*> mQcls;
+  Options mOpts;
+  uint64_t mMaxId {0}; ///< Last id that may be in use
+  uint64_t mNumRanges {0};
+  uint64_t mMaxAhead; ///< Max ranges claimed ahead of the consumer
+  mutable std::mutex mMutex; ///< Protects all the members below
+  std::condition_variable mReadyCv; ///< Signals a finished range or error
+  std::condition_variable mSpaceCv; ///< Signals a consumed range or stop
+  uint64_t mNextRange {0}; ///< Next range to be claimed by a worker
+  uint64_t mConsumedRange {0}; ///< Next range to hand to the consumer
+  std::map<uint64_t, std::vector<Item>> mReady; ///< Finished ranges
+  std::string mError;
+  bool mStop {false};
+  std::vector<Item> mCurrent; ///< Range being consumed
+  size_t mCurrentPos {0}; ///< Position in mCurrent
+  std::atomic<uint64_t> mScanned {0};
+  std::vector<std::thread> mWorkers;
+
+  //----------------------------------------------------------------------------
+  //! Worker loop
+  //!
+  //! @param qcl connection used by the worker
+  //----------------------------------------------------------------------------
+  void work(qclient::QClient& qcl);
+
+  //----------------------------------------------------------------------------
+  //! Read all the items in the given range
+  //!
+  //! @return false on error, err is then set
+  //----------------------------------------------------------------------------
+  bool scanRange(qclient::QClient& qcl, uint64_t range,
+                 std::vector<Item>& items, std::string& err);
+
+  //----------------------------------------------------------------------------
+  //! Stop the workers because of the given error
+  //----------------------------------------------------------------------------
+  void setError(const std::string& err);
+};
+
+using ParallelFileScanner = ParallelScanner<eos::ns::FileMdProto>;
+using ParallelContainerScanner = ParallelScanner<eos::ns::ContainerMdProto>;
+
+extern template class ParallelScanner<eos::ns::FileMdProto>;
+extern template class ParallelScanner<eos::ns::ContainerMdProto>;
+
+EOSNSNAMESPACE_END
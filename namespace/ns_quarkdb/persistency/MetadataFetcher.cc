@@ -151,11 +151,7 @@ public:
   //----------------------------------------------------------------------------
   //! Constructor
   //----------------------------------------------------------------------------
-  MapFetcher()
-  {
-    mContents.set_deleted_key("");
-    mContents.set_empty_key("##_EMPTY_##");
-  }
+  MapFetcher() = default;
 
   //----------------------------------------------------------------------------
   //! Initialize
@@ -449,17 +445,11 @@ std::vector<folly::Future<eos::ns::FileMdProto>>
     MetadataFetcher::getFilesFromFilemap(qclient::QClient& qcl,
         const IContainerMD::FileMap& fileMap)
 {
-  // FileMap is a hashmap, thus unsorted.. We want the results to be sorted
-  // based on filename, though.
-  std::map<std::string, IFileMD::id_t> sortedFileMap;
-
-  for (auto it = fileMap.begin(); it != fileMap.end(); ++it) {
-    sortedFileMap[it->first] = it->second;
-  }
-
+  // FileMap is already sorted by filename
   std::vector<folly::Future<eos::ns::FileMdProto>> retval;
+  retval.reserve(fileMap.size());
 
-  for (auto it = sortedFileMap.begin(); it != sortedFileMap.end(); it++) {
+  for (auto it = fileMap.begin(); it != fileMap.end(); ++it) {
     retval.emplace_back(getFileFromId(qcl, FileIdentifier(it->second)));
   }
 
@@ -484,18 +474,11 @@ std::vector<folly::Future<eos::ns::ContainerMdProto>>
     MetadataFetcher::getContainersFromContainerMap(qclient::QClient& qcl,
         const IContainerMD::ContainerMap& containerMap)
 {
-  // ContainerMap is a hashmap, thus unsorted.. We want the results to be
-  // sorted based on filename, though.
-  std::map<std::string , IContainerMD::id_t> sortedContainerMap;
-
-  for (auto it = containerMap.begin(); it != containerMap.end(); ++it) {
-    sortedContainerMap[it->first] = it->second;
-  }
-
+  // ContainerMap is already sorted by filename
   std::vector<folly::Future<eos::ns::ContainerMdProto>> retval;
+  retval.reserve(containerMap.size());
 
-  for (auto it = sortedContainerMap.cbegin(); it != sortedContainerMap.cend();
-       it++) {
+  for (auto it = containerMap.begin(); it != containerMap.end(); ++it) {
     retval.emplace_back(getContainerFromId(qcl, ContainerIdentifier(it->second)));
   }
 
@@ -21,8 +21,6 @@
 //! @brief Class to retrieve metadata from the backend - no caching!
 //------------------------------------------------------------------------------
 
-#include <google/protobuf/io/zero_copy_stream_impl.h>
-
 #include "namespace/ns_quarkdb/persistency/Serialization.hh"
 #include "namespace/utils/Buffer.hh"
 #include "namespace/utils/DataHelper.hh"
@@ -31,68 +29,95 @@
 
 EOSNSNAMESPACE_BEGIN
 
-MDStatus
-Serialization::deserializeNoThrow(const Buffer& buffer, eos::ns::FileMdProto &proto)
+//------------------------------------------------------------------------------
+// Locate the protobuf payload of a serialized object and verify its checksum.
+// The layout is: crc32c (4 bytes), payload size (4 bytes), payload padded to
+// a multiple of 4 bytes, with the checksum covering the padded payload.
+//------------------------------------------------------------------------------
+static MDStatus
+checkObject(const char* data, size_t len, const char* type,
+            const char*& payload, uint32_t& payload_size)
 {
   uint32_t cksum_expected = 0;
-  uint32_t obj_size = 0;
-  size_t sz = sizeof(cksum_expected);
-  const char* ptr = buffer.getDataPtr();
-  (void) memcpy(&cksum_expected, ptr, sz);
-  ptr += sz;
-  (void) memcpy(&obj_size, ptr, sz);
-  size_t msg_size = buffer.getSize();
-  uint32_t align_size = msg_size - 2 * sz;
-  ptr += sz; // now pointing to the serialized object
-  uint32_t cksum_computed = DataHelper::computeCRC32C((void*)ptr, align_size);
-  cksum_computed = DataHelper::finalizeCRC32C(cksum_computed);
+  const size_t sz = sizeof(cksum_expected);
 
-  if (cksum_expected != cksum_computed) {
-    return MDStatus(EIO, "FileMD object checksum mismatch");
+  if (len < 2 * sz) {
+    return MDStatus(EIO, SSTR(type << " object too short"));
   }
 
-  google::protobuf::io::ArrayInputStream ais(ptr, obj_size);
+  (void) memcpy(&cksum_expected, data, sz);
+  (void) memcpy(&payload_size, data + sz, sz);
+  payload = data + 2 * sz;
+  const uint32_t align_size = len - 2 * sz;
+
+  if (payload_size > align_size) {
+    return MDStatus(EIO, SSTR(type << " object size mismatch"));
+  }
+
+  uint32_t cksum_computed = DataHelper::computeCRC32C((void*)payload,
+                            align_size);
+  cksum_computed = DataHelper::finalizeCRC32C(cksum_computed);
 
-  if (!proto.ParseFromZeroCopyStream(&ais)) {
-    return MDStatus(EIO, "Failed while deserializing FileMD buffer");
+  if (cksum_expected != cksum_computed) {
+    return MDStatus(EIO, SSTR(type << " object checksum mismatch"));
   }
 
   return {};
 }
 
-MDStatus
-Serialization::deserializeNoThrow(const Buffer& buffer, eos::ns::ContainerMdProto &proto)
+//------------------------------------------------------------------------------
+// Parse a FileMD or ContainerMD protobuf in place
+//------------------------------------------------------------------------------
+template<typename T>
+static MDStatus
+parseObject(const char* data, size_t len, const char* type, T& proto)
 {
-  uint32_t cksum_expected = 0;
-  uint32_t obj_size = 0;
-  size_t sz = sizeof(cksum_expected);
-  const char* ptr = buffer.getDataPtr();
-  (void) memcpy(&cksum_expected, ptr, sz);
-  ptr += sz;
-  (void) memcpy(&obj_size, ptr, sz);
-  size_t msg_size = buffer.getSize();
-  uint32_t align_size = msg_size - 2 * sz;
-  ptr += sz; // now pointing to the serialized object
-  uint32_t cksum_computed = DataHelper::computeCRC32C((void*)ptr, align_size);
-  cksum_computed = DataHelper::finalizeCRC32C(cksum_computed);
+  const char* payload = nullptr;
+  uint32_t payload_size = 0;
+  MDStatus status = checkObject(data, len, type, payload, payload_size);
 
-  if (cksum_expected != cksum_computed) {
-    return MDStatus(EIO, "ContainerMD object checksum mismatch");
+  if (!status.ok()) {
+    return status;
   }
 
-  google::protobuf::io::ArrayInputStream ais(ptr, obj_size);
-
-  if (!proto.ParseFromZeroCopyStream(&ais)) {
-    return MDStatus(EIO, "Failed while deserializing ContainerMD buffer");
+  if (!proto.ParseFromArray(payload, payload_size)) {
+    return MDStatus(EIO, SSTR("Failed while deserializing " << type <<
+                              " buffer"));
   }
 
   return {};
 }
 
 MDStatus
-Serialization::deserializeNoThrow(const Buffer& buffer, int64_t &ret) {
+Serialization::deserializeNoThrow(const char* data, size_t len,
+                                  eos::ns::FileMdProto& proto)
+{
+  return parseObject(data, len, "FileMD", proto);
+}
+
+MDStatus
+Serialization::deserializeNoThrow(const char* data, size_t len,
+                                  eos::ns::ContainerMdProto& proto)
+{
+  return parseObject(data, len, "ContainerMD", proto);
+}
+
+MDStatus
+Serialization::deserializeNoThrow(const Buffer& buffer, eos::ns::FileMdProto &proto)
+{
+  return deserializeNoThrow(buffer.getDataPtr(), buffer.getSize(), proto);
+}
+
+MDStatus
+Serialization::deserializeNoThrow(const Buffer& buffer, eos::ns::ContainerMdProto &proto)
+{
+  return deserializeNoThrow(buffer.getDataPtr(), buffer.getSize(), proto);
+}
+
+MDStatus
+Serialization::deserializeNoThrow(const char* data, size_t len, int64_t &ret) {
   // Ensure there's a terminating null byte for strtoll.. :(
-  std::string str(buffer.getDataPtr(), buffer.getSize());
+  std::string str(data, len);
 
   char *endptr = NULL;
   ret = strtoll(str.c_str(), &endptr, 10);
@@ -102,7 +127,10 @@ Serialization::deserializeNoThrow(const Buffer& buffer, int64_t &ret) {
   return {};
 }
 
-
+MDStatus
+Serialization::deserializeNoThrow(const Buffer& buffer, int64_t &ret) {
+  return deserializeNoThrow(buffer.getDataPtr(), buffer.getSize(), ret);
+}
 
 void Serialization::deserializeFile(const Buffer& buffer, eos::ns::FileMdProto &proto) {
   MDStatus status = deserializeNoThrow(buffer, proto);
@@ -50,6 +50,14 @@ public:
   static MDStatus deserializeNoThrow(const Buffer& buffer,
                                      eos::ns::FileMdProto& proto);
 
+  //----------------------------------------------------------------------------
+  //! Deserialize a FileMD protobuf straight from the given memory, e.g. a
+  //! QClient reply, without any intermediate copy. The checksum is verified
+  //! on the same memory right before parsing.
+  //----------------------------------------------------------------------------
+  static MDStatus deserializeNoThrow(const char* data, size_t len,
+                                     eos::ns::FileMdProto& proto);
+
   //----------------------------------------------------------------------------
   //! Deserialize a ContainerMD protobuf
   //----------------------------------------------------------------------------
@@ -59,10 +67,18 @@ public:
   static MDStatus deserializeNoThrow(const Buffer& buffer,
                                      eos::ns::ContainerMdProto& proto);
 
+  //----------------------------------------------------------------------------
+  //! Deserialize a ContainerMD protobuf straight from the given memory
+  //----------------------------------------------------------------------------
+  static MDStatus deserializeNoThrow(const char* data, size_t len,
+                                     eos::ns::ContainerMdProto& proto);
+
   //----------------------------------------------------------------------------
   //! Deserialize an int64_t
   //----------------------------------------------------------------------------
   static MDStatus deserializeNoThrow(const Buffer& buffer, int64_t& val);
+  static MDStatus deserializeNoThrow(const char* data, size_t len,
+                                     int64_t& val);
 
   //----------------------------------------------------------------------------
   //! Deserialize any supported type.
@@ -70,10 +86,8 @@ public:
   template<typename T>
   static MDStatus deserialize(const char* str, size_t len, T& output)
   {
-    eos::Buffer ebuff;
-    ebuff.setDataPtr((char*)str, len);
     // Dispatch to appropriate overload
-    return Serialization::deserializeNoThrow(ebuff, output);
+    return Serialization::deserializeNoThrow(str, len, output);
   }
 };
 
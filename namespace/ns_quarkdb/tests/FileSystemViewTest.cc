@@ -578,8 +578,6 @@ TEST_F(FileSystemViewF, FileSystemHandlerCache)
 TEST(SetChangeList, BasicSanity)
 {
   eos::IFsView::FileList contents;
-  contents.set_deleted_key(0);
-  contents.set_empty_key(0xffffffffffffffffll);
   eos::SetChangeList<eos::IFileMD::id_t> changeList;
   contents.insert(5);
   contents.insert(9);
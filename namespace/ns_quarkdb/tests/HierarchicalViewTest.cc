@@ -743,6 +743,24 @@ TEST_F(HierarchicalViewF, QuotaRecomputation)
   ASSERT_EQ(qnc.getUsedSpaceByGroup(200), 0);
   ASSERT_EQ(qnc.getPhysicalSpaceByGroup(200), 0);
   ASSERT_EQ(qnc.getNumFilesByGroup(200), 0);
+  // same result when exploring in parallel
+  std::unique_ptr<qclient::QClient> qcl2 = createQClient();
+  eos::QuotaRecomputer parallelRecomputer({&(qcl()), qcl2.get()}, executor(),
+                                          4);
+  eos::QuotaNodeCore parallelQnc;
+  status = parallelRecomputer.recompute(view()->getUri(quota1.get()),
+                                        quota1->getId(), parallelQnc);
+  ASSERT_TRUE(status.ok());
+
+  for (size_t i = 0; i < 4; i++) {
+    ASSERT_EQ(parallelQnc.getUsedSpaceByUser(i), qnc.getUsedSpaceByUser(i));
+    ASSERT_EQ(parallelQnc.getPhysicalSpaceByUser(i),
+              qnc.getPhysicalSpaceByUser(i));
+    ASSERT_EQ(parallelQnc.getNumFilesByUser(i), qnc.getNumFilesByUser(i));
+  }
+
+  ASSERT_EQ(parallelQnc.getNumFilesByGroup(0), 5);
+  ASSERT_EQ(parallelQnc.getNumFilesByUser(100), 0);
 }
 
 TEST_F(HierarchicalViewF, CustomContainerId)
@@ -1558,3 +1576,30 @@ TEST_F(HierarchicalViewF, getMDMultiThreaded)
     worker.join();
   }
 }
+
+TEST_F(HierarchicalViewF, getItemColdDeepPath)
+{
+  const std::string dirPath = "/eos/a/b/c/d/e/f/g/";
+  const auto dirId = view()->createContainer(dirPath, true)->getId();
+  const auto fileId = view()->createFile(dirPath + "file.txt")->getId();
+  view()->createContainer("/eos/x/y/", true);
+  view()->createLink("/eos/x/y/link", "/eos/a/b/c/");
+  mdFlusher()->synchronize();
+  // Every lookup starts with a cold cache, the remaining path components are
+  // then fetched speculatively
+  shut_down_everything();
+  ASSERT_EQ(fileId, view()->getItem(dirPath + "file.txt").get().file->getId());
+  shut_down_everything();
+  ASSERT_EQ(dirId, view()->getContainer(dirPath)->getId());
+  shut_down_everything();
+  ASSERT_EQ(fileId, view()->getFile("/eos/x/y/link/d/e/f/g/file.txt")->getId());
+  shut_down_everything();
+  ASSERT_EQ(dirId, view()->getContainer("/eos/a/b/./c/../c/d/e/f/g")->getId());
+  shut_down_everything();
+  ASSERT_THROW(view()->getFile(dirPath + "missing"), eos::MDException);
+  shut_down_everything();
+  ASSERT_THROW(view()->getFile("/eos/a/b/missing/d/e/file.txt"),
+               eos::MDException);
+  shut_down_everything();
+  ASSERT_THROW(view()->getFile(dirPath + "file.txt/g"), eos::MDException);
+}
@@ -23,12 +23,22 @@
 
 #include "namespace/locking/BulkNsObjectLocker.hh"
 #include "namespace/ns_quarkdb/ConfigurationParser.hh"
+#include "namespace/ns_quarkdb/accounting/ContainerLevels.hh"
 #include "namespace/ns_quarkdb/LRU.hh"
 #include "namespace/ns_quarkdb/QdbContactDetails.hh"
+#include "namespace/ns_quarkdb/flusher/RequestCoalescer.hh"
+#include "namespace/ns_quarkdb/persistency/Serialization.hh"
 #include "namespace/ns_quarkdb/tests/MockContainerMD.hh"
+#include "namespace/utils/ChildMap.hh"
+#include "namespace/utils/DataHelper.hh"
+#include "namespace/utils/FidBitmap.hh"
 #include "namespace/utils/PathProcessor.hh"
 #include "namespace/MDLocking.hh"
+#include "proto/FileMd.pb.h"
 #include <gtest/gtest.h>
+#include <cstring>
+#include <map>
+#include <set>
 #include <sstream>
 #include <vector>
 
@@ -261,4 +271,441 @@ TEST(NSObjectLocker, testNoDeadlockNSObjectLocker) {
   ASSERT_EQ(2,eos::MockContainerMD::getReadUnlockedContainers().size());
   ASSERT_EQ(2,eos::MockContainerMD::getWriteUnlockedContainers().size());
   eos::MockContainerMD::clearVectors();
-}
\ No newline at end of file
+}
+
+TEST(RequestCoalescer, BasicSanity)
+{
+  using Request = eos::RequestCoalescer::Request;
+  eos::RequestCoalescer coalescer;
+  // Repeated writes of the same file metadata, only the last one is kept
+  coalescer.add({"LHSET", "eos-file-md", "1", "hint", "v1"});
+  coalescer.add({"LHSET", "eos-file-md", "2", "hint", "v1"});
+  coalescer.add({"LHSET", "eos-file-md", "1", "hint", "v2"});
+  coalescer.add({"LHSET", "eos-file-md", "1", "hint", "v3"});
+  // Set membership, the last operation wins
+  coalescer.add({"SADD", "orphans", "1"});
+  coalescer.add({"SREM", "orphans", "1"});
+  // Same field name in a different family is independent
+  coalescer.add({"HSET", "eos-file-md", "1", "v"});
+  // Increments pin the field
+  coalescer.add({"HSET", "quota", "space", "10"});
+  coalescer.add({"HINCRBY", "quota", "space", "5"});
+  coalescer.add({"HSET", "quota", "space", "20"});
+  ASSERT_EQ(10u, coalescer.size());
+  std::vector<Request> expected {
+    {"LHSET", "eos-file-md", "2", "hint", "v1"},
+    {"LHSET", "eos-file-md", "1", "hint", "v3"},
+    {"SREM", "orphans", "1"},
+    {"HSET", "eos-file-md", "1", "v"},
+    {"HSET", "quota", "space", "10"},
+    {"HINCRBY", "quota", "space", "5"},
+    {"HSET", "quota", "space", "20"}
+  };
+  ASSERT_EQ(expected, coalescer.extract());
+  ASSERT_EQ(0u, coalescer.size());
+  ASSERT_EQ(10u, coalescer.getStats().mRequestsIn);
+  ASSERT_EQ(7u, coalescer.getStats().mRequestsOut);
+  ASSERT_LT(coalescer.getStats().mBytesOut, coalescer.getStats().mBytesIn);
+  // Nothing is merged across an unknown command or an extraction
+  coalescer.add({"HSET", "k", "f", "1"});
+  ASSERT_EQ(1u, coalescer.extract().size());
+  coalescer.add({"HSET", "k", "f", "1"});
+  coalescer.add({"RENAME", "k", "k2"});
+  coalescer.add({"HSET", "k", "f", "2"});
+  ASSERT_EQ(3u, coalescer.extract().size());
+}
+
+TEST(FidBitmap, BasicSanity)
+{
+  eos::FidBitmap fids;
+  std::set<uint64_t> reference;
+  ASSERT_TRUE(fids.empty());
+  ASSERT_TRUE(fids.begin() == fids.end());
+
+  // Sparse ids spread over many chunks plus one dense chunk
+  for (uint64_t id = 1; id < 10000000; id += 7919) {
+    ASSERT_TRUE(fids.insert(id));
+    reference.insert(id);
+  }
+
+  for (uint64_t id = 1ull << 32; id < (1ull << 32) + 10000; ++id) {
+    ASSERT_TRUE(fids.insert(id));
+    reference.insert(id);
+  }
+
+  ASSERT_FALSE(fids.insert(1));
+  ASSERT_EQ(reference.size(), fids.size());
+  ASSERT_TRUE(std::equal(fids.begin(), fids.end(), reference.begin(),
+                         reference.end()));
+  ASSERT_EQ(1u, fids.count(7920));
+  ASSERT_EQ(0u, fids.count(7921));
+  ASSERT_EQ(*reference.begin(), fids.select(0));
+  ASSERT_EQ(*reference.rbegin(), fids.select(fids.size() - 1));
+  ASSERT_LT(fids.getMemoryUsage(), reference.size() * sizeof(uint64_t));
+  uint64_t seed = 0;
+
+  for (int i = 0; i < 1000; ++i) {
+    uint64_t id = fids.pickRandom([&seed](uint64_t max) {
+      seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+      return (seed >> 33) % max;
+    });
+    ASSERT_EQ(1u, reference.count(id));
+  }
+
+  // Erasing most of the dense chunk converts it back to an array
+  for (uint64_t id = 1ull << 32; id < (1ull << 32) + 9000; ++id) {
+    ASSERT_EQ(1u, fids.erase(id));
+    reference.erase(id);
+  }
+
+  ASSERT_EQ(0u, fids.erase(1ull << 32));
+  ASSERT_EQ(reference.size(), fids.size());
+  ASSERT_TRUE(std::equal(fids.begin(), fids.end(), reference.begin(),
+                         reference.end()));
+  // Chunks are released once empty
+  size_t num_chunks = fids.getNumChunks();
+  ASSERT_TRUE(fids.insert(1ull << 40));
+  ASSERT_EQ(num_chunks + 1, fids.getNumChunks());
+  ASSERT_EQ(1u, fids.erase(1ull << 40));
+  ASSERT_EQ(num_chunks, fids.getNumChunks());
+  fids.clear();
+  ASSERT_EQ(0u, fids.size());
+  ASSERT_TRUE(fids.begin() == fids.end());
+}
+
+TEST(FidBitmap, SelectAfterUpdates)
+{
+  eos::FidBitmap fids;
+  std::set<uint64_t> reference;
+  uint64_t seed = 0;
+  auto random = [&seed](uint64_t max) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return (seed >> 33) % max;
+  };
+
+  // Ids out of order create chunks in the middle of the set
+  for (int i = 0; i < 20000; ++i) {
+    uint64_t id = random(1ull << 24);
+    ASSERT_EQ(reference.insert(id).second, fids.insert(id));
+  }
+
+  // Drain the set, most chunks shrink and get released on the way
+  while (reference.size() > 100) {
+    uint64_t id = fids.pickRandom(random);
+    ASSERT_EQ(1u, reference.count(id));
+    ASSERT_EQ(1u, fids.erase(id));
+    reference.erase(id);
+  }
+
+  ASSERT_EQ(reference.size(), fids.size());
+  uint64_t rank = 0;
+
+  for (auto id : reference) {
+    ASSERT_EQ(id, fids.select(rank++));
+  }
+}
+
+TEST(FidBitmap, SetAlgebra)
+{
+  eos::FidBitmap evens, threes;
+
+  for (uint64_t id = 0; id < 200000; ++id) {
+    if (id % 2 == 0) {
+      evens.insert(id);
+    }
+
+    if (id % 3 == 0) {
+      threes.insert(id);
+    }
+  }
+
+  // Add a sparse chunk on one side only
+  threes.insert(1ull << 40);
+  eos::FidBitmap both = evens;
+  both &= threes;
+  ASSERT_EQ(33334u, both.size());
+
+  for (auto id : both) {
+    ASSERT_EQ(0u, id % 6);
+  }
+
+  eos::FidBitmap any = evens;
+  any |= threes;
+  ASSERT_EQ(100000u + 66667u - 33334u + 1u, any.size());
+  ASSERT_EQ(1u, any.count(1ull << 40));
+  eos::FidBitmap only_evens = evens;
+  only_evens -= threes;
+  ASSERT_EQ(100000u - 33334u, only_evens.size());
+  ASSERT_EQ(0u, only_evens.count(6));
+  ASSERT_EQ(1u, only_evens.count(4));
+  // (A - B) | (A & B) == A
+  only_evens |= both;
+  ASSERT_TRUE(only_evens == evens);
+  only_evens -= evens;
+  ASSERT_TRUE(only_evens.empty());
+  ASSERT_EQ(0u, only_evens.getNumChunks());
+}
+
+//------------------------------------------------------------------------------
+// Compare child map with the reference ordered map
+//------------------------------------------------------------------------------
+static bool SameEntries(const eos::ChildMap& children,
+                        const std::map<std::string, uint64_t>& reference)
+{
+  return std::equal(children.begin(), children.end(), reference.begin(),
+                    reference.end(), [](const eos::ChildMap::value_type & a,
+  const std::pair<const std::string, uint64_t>& b) {
+    return (a.first == b.first) && (a.second == b.second);
+  });
+}
+
+TEST(ChildMap, BasicSanity)
+{
+  eos::ChildMap children;
+  std::map<std::string, uint64_t> reference;
+  ASSERT_TRUE(children.empty());
+  ASSERT_TRUE(children.begin() == children.end());
+  ASSERT_TRUE(children.lower_bound("a") == children.end());
+
+  // Sorted names are appended, the rest goes through the generic path
+  for (uint64_t i = 0; i < 1000; ++i) {
+    std::string name = "run_" + std::to_string(100000 + i * 2) + ".root";
+    ASSERT_TRUE(children.insert(std::make_pair(name, i)).second);
+    reference[name] = i;
+  }
+
+  for (uint64_t i = 0; i < 1000; i += 3) {
+    std::string name = "run_" + std::to_string(100001 + i * 2) + ".root";
+    ASSERT_TRUE(children.insert(std::make_pair(name, i)).second);
+    reference[name] = i;
+  }
+
+  children["aaa"] = 7;
+  reference["aaa"] = 7;
+  ASSERT_FALSE(children.insert(std::make_pair("aaa", 8)).second);
+  ASSERT_EQ(7u, children.find("aaa")->second);
+  ASSERT_EQ(reference.size(), children.size());
+  ASSERT_TRUE(SameEntries(children, reference));
+  ASSERT_EQ(1u, children.count("run_100004.root"));
+  ASSERT_EQ(0u, children.count("run_100003.root"));
+  ASSERT_TRUE(children.find("run_100003.root") == children.end());
+  // Resume a listing from a name which is not present
+  auto it = children.lower_bound("run_100003.root");
+  ASSERT_EQ("run_100004.root", it->first);
+  ASSERT_EQ(reference.lower_bound("zzz") == reference.end(),
+            children.lower_bound("zzz") == children.end());
+  ASSERT_FALSE(children.hasHashIndex());
+
+  // Erase every other entry, chunks get merged and released
+  uint64_t generation = children.getGeneration();
+  size_t count = 0;
+
+  for (auto rit = reference.begin(); rit != reference.end();) {
+    if (count++ % 2) {
+      ASSERT_EQ(1u, children.erase(rit->first));
+      rit = reference.erase(rit);
+    } else {
+      ++rit;
+    }
+  }
+
+  ASSERT_NE(generation, children.getGeneration());
+  ASSERT_EQ(0u, children.erase("run_100003.root"));
+  ASSERT_EQ(reference.size(), children.size());
+  ASSERT_TRUE(SameEntries(children, reference));
+  // Erasing the largest name updates the append position
+  ASSERT_EQ(1u, children.erase(reference.rbegin()->first));
+  reference.erase(std::prev(reference.end()));
+  ASSERT_TRUE(children.insert(std::make_pair("zz", 1)).second);
+  reference["zz"] = 1;
+  ASSERT_TRUE(SameEntries(children, reference));
+  eos::ChildMap copy = children;
+  ASSERT_TRUE(copy == children);
+  copy.clear();
+  ASSERT_TRUE(copy.empty());
+  ASSERT_TRUE(copy.begin() == copy.end());
+}
+
+TEST(ChildMap, HashIndex)
+{
+  eos::ChildMap children;
+  std::map<std::string, uint64_t> reference;
+  uint64_t seed = 1;
+
+  // Random order forces chunk splits while the hash index is in use
+  for (uint64_t i = 0; i < 3 * eos::ChildMap::kHashIndexMinSize; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    std::string name = "file." + std::to_string(seed >> 40);
+
+    if (reference.emplace(name, i).second) {
+      ASSERT_TRUE(children.insert(std::make_pair(name, i)).second);
+    }
+  }
+
+  ASSERT_TRUE(children.hasHashIndex());
+  ASSERT_EQ(reference.size(), children.size());
+  ASSERT_TRUE(SameEntries(children, reference));
+
+  for (const auto& elem : reference) {
+    auto it = children.find(elem.first);
+    ASSERT_TRUE(it != children.end());
+    ASSERT_EQ(elem.second, it->second);
+  }
+
+  ASSERT_TRUE(children.find("file.x") == children.end());
+  // Even with half-full chunks and the index the map is smaller than the
+  // bucket array alone of a hash map holding the same entries
+  ASSERT_LT(children.getMemoryUsage(),
+            reference.size() * sizeof(eos::ChildMap::value_type));
+
+  // Shrinking drops the index, lookups keep working
+  while (reference.size() > 100) {
+    auto rit = reference.begin();
+    std::advance(rit, reference.size() / 2);
+    ASSERT_EQ(1u, children.erase(rit->first));
+    reference.erase(rit);
+  }
+
+  ASSERT_FALSE(children.hasHashIndex());
+  ASSERT_TRUE(SameEntries(children, reference));
+
+  for (const auto& elem : reference) {
+    ASSERT_EQ(1u, children.count(elem.first));
+  }
+}
+
+TEST(ChildMap, HashMode)
+{
+  eos::ChildMap children;
+  std::map<std::string, uint64_t> reference;
+  uint64_t seed = 7;
+
+  // Small maps stay in the hash map and still iterate in name order
+  while (reference.size() < eos::ChildMap::kOrderedMinSize - 1) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    std::string name = "f" + std::to_string(seed >> 40);
+
+    if (reference.emplace(name, seed).second) {
+      children[name] = seed;
+    }
+  }
+
+  ASSERT_FALSE(children.isOrdered());
+  ASSERT_EQ(reference.size(), children.size());
+  ASSERT_TRUE(SameEntries(children, reference));
+  auto it = children.lower_bound("f5");
+  ASSERT_EQ(reference.lower_bound("f5")->first, it->first);
+  // Iterators returned by a lookup continue in name order
+  auto rit = std::next(reference.begin(), 100);
+  it = children.find(rit->first);
+  ASSERT_EQ(rit->second, it->second);
+  ++it;
+  ASSERT_EQ(std::next(rit)->first, it->first);
+  ASSERT_TRUE(children.find(reference.rbegin()->first) != children.end());
+  ASSERT_TRUE(++children.find(reference.rbegin()->first) == children.end());
+
+  // Crossing the threshold moves the entries to the chunks
+  ASSERT_TRUE(children.insert(std::make_pair("a", 1)).second);
+  reference["a"] = 1;
+  ASSERT_TRUE(children.isOrdered());
+  ASSERT_EQ(reference.size(), children.size());
+  ASSERT_TRUE(SameEntries(children, reference));
+  eos::ChildMap copy = children;
+  ASSERT_TRUE(copy == children);
+
+  // Shrinking below half of the threshold moves them back
+  while (reference.size() >= eos::ChildMap::kOrderedMinSize / 2) {
+    ASSERT_EQ(1u, children.erase(reference.begin()->first));
+    reference.erase(reference.begin());
+  }
+
+  ASSERT_FALSE(children.isOrdered());
+  ASSERT_TRUE(SameEntries(children, reference));
+
+  for (const auto& elem : reference) {
+    ASSERT_EQ(elem.second, children.find(elem.first)->second);
+  }
+
+  ASSERT_FALSE(copy == children);
+  copy = children;
+  ASSERT_TRUE(copy == children);
+}
+
+TEST(ContainerLevels, BasicSanity)
+{
+  // 1 is the root: 1 <- 2 <- 3 <- 4 and 3 <- 5, 1 <- 6, plus a loop 7 <-> 8
+  std::map<eos::IContainerMD::id_t, eos::IContainerMD::id_t> parents {
+    {2, 1}, {3, 2}, {4, 3}, {5, 3}, {6, 1}, {7, 8}, {8, 7}
+  };
+  size_t lookups = 0;
+  eos::ContainerLevels levels([&](eos::IContainerMD::id_t id) {
+    ++lookups;
+    auto it = parents.find(id);
+    return (it == parents.end() ? 0 : it->second);
+  });
+  levels.add(4);
+  levels.add(5);
+  levels.add(3);
+  levels.add(6);
+  levels.add(1);
+  // Every parent is looked up once
+  ASSERT_EQ(5u, lookups);
+  ASSERT_EQ(5u, levels.size());
+  ASSERT_EQ(3u, levels.getNumLevels());
+  ASSERT_EQ(std::vector<eos::IContainerMD::id_t>({2, 6}), levels.getLevel(0));
+  ASSERT_EQ(std::vector<eos::IContainerMD::id_t>({3}), levels.getLevel(1));
+  ASSERT_EQ(std::vector<eos::IContainerMD::id_t>({4, 5}), levels.getLevel(2));
+  ASSERT_EQ(3u, levels.getParent(4));
+  ASSERT_EQ(2u, levels.getParent(3));
+  ASSERT_EQ(0u, levels.getParent(2));
+  ASSERT_EQ(0u, levels.getParent(1));
+  // A loop is cut where it closes
+  levels.add(7);
+  ASSERT_EQ(7u, levels.size());
+  ASSERT_EQ(0u, levels.getParent(8));
+  ASSERT_EQ(8u, levels.getParent(7));
+  // The walk up stops after the max depth
+  eos::ContainerLevels shallow([](eos::IContainerMD::id_t id) {
+    return id - 1;
+  }, 10);
+  shallow.add(100);
+  ASSERT_EQ(10u, shallow.size());
+  ASSERT_EQ(10u, shallow.getNumLevels());
+  ASSERT_EQ(0u, shallow.getParent(91));
+}
+
+TEST(Serialization, RawBuffer)
+{
+  eos::ns::FileMdProto proto;
+  proto.set_id(42);
+  proto.set_name("some-file");
+  (*proto.mutable_xattrs())["user.key"] = "value";
+  // Same layout as QuarkFileMD::serialize
+  uint32_t obj_size = proto.ByteSizeLong();
+  uint32_t align_size = (obj_size + 3) >> 2 << 2;
+  std::string data(2 * sizeof(uint32_t) + align_size, '\0');
+  ASSERT_TRUE(proto.SerializeToArray(&data[2 * sizeof(uint32_t)], obj_size));
+  uint32_t cksum = eos::DataHelper::computeCRC32C(&data[2 * sizeof(uint32_t)],
+                   align_size);
+  cksum = eos::DataHelper::finalizeCRC32C(cksum);
+  memcpy(&data[0], &cksum, sizeof(cksum));
+  memcpy(&data[sizeof(cksum)], &obj_size, sizeof(obj_size));
+  eos::ns::FileMdProto parsed;
+  ASSERT_TRUE(eos::Serialization::deserialize(data.data(), data.size(),
+              parsed).ok());
+  ASSERT_EQ(42u, parsed.id());
+  ASSERT_EQ("some-file", parsed.name());
+  ASSERT_EQ("value", parsed.xattrs().at("user.key"));
+  // Truncated objects, bad size and corruption are detected
+  ASSERT_EQ(EIO, eos::Serialization::deserialize(data.data(), 6,
+            parsed).getErrno());
+  std::string corrupted = data;
+  uint32_t bad_size = align_size + 1;
+  memcpy(&corrupted[sizeof(cksum)], &bad_size, sizeof(bad_size));
+  ASSERT_EQ(EIO, eos::Serialization::deserialize(corrupted.data(),
+            corrupted.size(), parsed).getErrno());
+  corrupted = data;
+  corrupted.back() ^= 0x1;
+  ASSERT_EQ(EIO, eos::Serialization::deserialize(corrupted.data(),
+            corrupted.size(), parsed).getErrno());
+}
@@ -24,9 +24,12 @@
 #include <memory>
 #include <gtest/gtest.h>
 #include <cstring>
+#include <set>
+#include <sstream>
 
 #include "namespace/interface/ContainerIterators.hh"
 #include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
 #include "namespace/ns_quarkdb/persistency/ContainerMDSvc.hh"
 #include "namespace/ns_quarkdb/persistency/FileMDSvc.hh"
 #include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
@@ -41,6 +44,10 @@
 #include "namespace/ns_quarkdb/persistency/FileSystemIterator.hh"
 #include "namespace/ns_quarkdb/inspector/AttributeExtraction.hh"
 #include "namespace/ns_quarkdb/inspector/FileMetadataFilter.hh"
+#include "namespace/ns_quarkdb/inspector/FileScanner.hh"
+#include "namespace/ns_quarkdb/inspector/ContainerScanner.hh"
+#include "namespace/ns_quarkdb/inspector/ParallelScanner.hh"
+#include "namespace/ns_quarkdb/inspector/NamespaceExporter.hh"
 #include "namespace/ns_quarkdb/accounting/QuotaNodeCore.hh"
 #include "namespace/utils/Checksum.hh"
 #include "namespace/utils/Etag.hh"
@@ -50,6 +57,7 @@
 #include "TestUtils.hh"
 #include <folly/futures/Future.h>
 #include "google/protobuf/util/message_differencer.h"
+#include "proto/NamespaceExport.pb.h"
 #include <folly/executors/IOThreadPoolExecutor.h>
 
 
@@ -1018,6 +1026,268 @@ TEST_F(NamespaceExplorerF, NoFiles)
   ASSERT_FALSE(explorer2.fetch(item));
 }
 
+TEST_F(NamespaceExplorerF, Parallel)
+{
+  populateDummyData1();
+  std::unique_ptr<qclient::QClient> qcl2 = createQClient();
+  std::vector<qclient::QClient*> qcls {&qcl(), qcl2.get()};
+
+  for (bool ignoreFiles : {
+         false, true
+       }) {
+    ExplorationOptions options;
+    options.depthLimit = 999;
+    options.ignoreFiles = ignoreFiles;
+    // Invalid path
+    ASSERT_THROW(eos::ParallelNamespaceExplorer("/eos/invalid/path", options,
+                 qcls, executor()), eos::MDException);
+    // Find on single file
+    ParallelNamespaceExplorer explorer("/eos/d2/d3-2/my-file", options, qcls,
+                                       executor());
+    NamespaceItem item;
+    ASSERT_TRUE(explorer.fetch(item));
+    ASSERT_EQ(item.fullPath, "/eos/d2/d3-2/my-file");
+    ASSERT_FALSE(explorer.fetch(item));
+    // Find on directory, same items as the sequential explorer in any order
+    std::multiset<std::string> expected;
+    std::multiset<std::string> found;
+    NamespaceExplorer explorer2("/eos/d2", options, qcl(), executor());
+
+    while (explorer2.fetch(item)) {
+      expected.insert(SSTR(item.fullPath << " " << item.numFiles << " " <<
+                           item.numContainers));
+    }
+
+    ParallelNamespaceExplorer explorer3("/eos/d2", options, qcls, executor(),
+                                        4, 2);
+
+    while (explorer3.fetch(item)) {
+      found.insert(SSTR(item.fullPath << " " << item.numFiles << " " <<
+                        item.numContainers));
+    }
+
+    ASSERT_EQ(expected.size(), ignoreFiles ? 11u : 23u);
+    ASSERT_EQ(expected, found);
+    ASSERT_FALSE(explorer3.fetch(item));
+  }
+}
+
+TEST_F(NamespaceExplorerF, ParallelScanner)
+{
+  populateDummyData1();
+  std::unique_ptr<qclient::QClient> qcl2 = createQClient();
+  std::vector<qclient::QClient*> qcls {&qcl(), qcl2.get()};
+  // Same files as the single cursor scanner, sorted by id
+  std::map<uint64_t, std::string> expected;
+  FileScanner fileScanner(qcl(), true);
+
+  while (fileScanner.valid()) {
+    eos::ns::FileMdProto proto;
+    FileScanner::Item item;
+    ASSERT_TRUE(fileScanner.getItem(proto, &item));
+    expected[proto.id()] = std::move(item.fullPath).get() + proto.name();
+    fileScanner.next();
+  }
+
+  ParallelFileScanner::Options opts;
+  opts.workers = 4;
+  opts.rangeSize = 3;
+  opts.fullPaths = true;
+  std::vector<std::pair<uint64_t, std::string>> found;
+  {
+    ParallelFileScanner scanner(qcls, opts);
+    ParallelFileScanner::Item item;
+
+    while (scanner.fetch(item)) {
+      found.emplace_back(item.proto.id(), item.fullPath + item.proto.name());
+    }
+
+    std::string err;
+    ASSERT_FALSE(scanner.hasError(err));
+    ASSERT_EQ(scanner.getScannedSoFar(), expected.size());
+  }
+  ASSERT_FALSE(expected.empty());
+  ASSERT_EQ(std::vector<std::pair<uint64_t, std::string>>(expected.begin(),
+            expected.end()), found);
+  // Filter evaluated by the workers
+  opts.fullPaths = false;
+  opts.filter = [](const eos::ns::FileMdProto& proto) {
+    return (proto.id() % 2) == 0;
+  };
+  {
+    ParallelFileScanner scanner(qcls, opts);
+    ParallelFileScanner::Item item;
+    size_t count = 0;
+
+    while (scanner.fetch(item)) {
+      ASSERT_EQ(item.proto.id() % 2, 0u);
+      ASSERT_TRUE(item.fullPath.empty());
+      ++count;
+    }
+
+    size_t expectedCount = 0;
+
+    for (const auto& entry : expected) {
+      expectedCount += ((entry.first % 2) == 0);
+    }
+
+    ASSERT_EQ(count, expectedCount);
+  }
+  // Containers with paths and counts
+  std::map<uint64_t, std::string> expectedConts;
+  ContainerScanner containerScanner(qcl(), true, true);
+
+  while (containerScanner.valid()) {
+    eos::ns::ContainerMdProto proto;
+    ContainerScanner::Item item;
+    ASSERT_TRUE(containerScanner.getItem(proto, &item));
+    expectedConts[proto.id()] = SSTR(std::move(item.fullPath).get() << " " <<
+                                     std::move(item.fileCount).get() << " " <<
+                                     std::move(item.containerCount).get());
+    containerScanner.next();
+  }
+
+  ParallelContainerScanner::Options contOpts;
+  contOpts.workers = 3;
+  contOpts.rangeSize = 2;
+  contOpts.fullPaths = true;
+  contOpts.counts = true;
+  ParallelContainerScanner scanner(qcls, contOpts);
+  ParallelContainerScanner::Item item;
+  std::map<uint64_t, std::string> foundConts;
+  uint64_t previous = 0;
+
+  while (scanner.fetch(item)) {
+    ASSERT_GT(item.proto.id(), previous);
+    previous = item.proto.id();
+    foundConts[item.proto.id()] = SSTR(item.fullPath << " " << item.fileCount <<
+                                       " " << item.containerCount);
+  }
+
+  ASSERT_EQ(expectedConts, foundConts);
+}
+
+TEST_F(NamespaceExplorerF, ColumnarExport)
+{
+  populateDummyData1();
+  std::unique_ptr<qclient::QClient> qcl2 = createQClient();
+  std::vector<qclient::QClient*> qcls {&qcl(), qcl2.get()};
+  std::map<uint64_t, eos::ns::FileMdProto> expected;
+  FileScanner fileScanner(qcl(), false);
+
+  while (fileScanner.valid()) {
+    eos::ns::FileMdProto proto;
+    ASSERT_TRUE(fileScanner.getItem(proto));
+    expected[proto.id()] = proto;
+    fileScanner.next();
+  }
+
+  size_t expectedContainers = 0;
+  ContainerScanner containerScanner(qcl());
+
+  while (containerScanner.valid()) {
+    ++expectedContainers;
+    containerScanner.next();
+  }
+
+  NamespaceExporter::Options opts;
+  opts.workers = 3;
+  opts.chunkSize = 4;
+  NamespaceExporter exporter(qcls, opts);
+  std::stringstream files, containers;
+  NamespaceExporter::Summary summary;
+  std::string err;
+  ASSERT_TRUE(exporter.run(files, containers, summary, err)) << err;
+  ASSERT_EQ(summary.files, expected.size());
+  ASSERT_EQ(summary.containers, expectedContainers);
+  // Nothing writes to QDB during the test, but the consistency can only be
+  // checked when running in raft mode
+  ASSERT_EQ(summary.consistent, summary.raft);
+  ASSERT_EQ(summary.startIndex, summary.endIndex);
+  // Read the file table back
+  NamespaceExporter::FrameType type;
+  std::string payload;
+  ASSERT_TRUE(NamespaceExporter::readFrame(files, type, payload, err));
+  ASSERT_EQ(type, NamespaceExporter::FrameType::kHeader);
+  eos::ns::ExportHeaderProto header;
+  ASSERT_TRUE(header.ParseFromString(payload));
+  ASSERT_EQ(header.kind(), "files");
+  ASSERT_EQ(header.version(), NamespaceExporter::kVersion);
+  ASSERT_EQ(header.raft_last_applied(), summary.startIndex);
+  std::vector<uint64_t> ids;
+  uint64_t chunks = 0;
+
+  while (NamespaceExporter::readFrame(files, type, payload, err) &&
+         type == NamespaceExporter::FrameType::kFileColumns) {
+    eos::ns::FileColumnsProto columns;
+    ASSERT_TRUE(columns.ParseFromString(payload));
+    ASSERT_LE(columns.id_size(), 4);
+    ASSERT_EQ(columns.name_size(), columns.id_size());
+    ASSERT_EQ(columns.num_locations_size(), columns.id_size());
+    int location = 0;
+
+    for (int i = 0; i < columns.id_size(); ++i) {
+      const eos::ns::FileMdProto& proto = expected[columns.id(i)];
+      ASSERT_EQ(columns.cont_id(i), proto.cont_id());
+      ASSERT_EQ(columns.name(i), proto.name());
+      ASSERT_EQ(columns.size(i), proto.size());
+      ASSERT_EQ(columns.num_locations(i), (uint32_t) proto.locations_size());
+
+      for (int j = 0; j < proto.locations_size(); ++j) {
+        ASSERT_EQ(columns.locations(location++), proto.locations(j));
+      }
+
+      ids.push_back(columns.id(i));
+    }
+
+    ASSERT_EQ(location, columns.locations_size());
+    ++chunks;
+  }
+
+  ASSERT_TRUE(err.empty()) << err;
+  ASSERT_EQ(type, NamespaceExporter::FrameType::kTrailer);
+  eos::ns::ExportTrailerProto trailer;
+  ASSERT_TRUE(trailer.ParseFromString(payload));
+  ASSERT_EQ(trailer.num_entries(), expected.size());
+  ASSERT_EQ(trailer.num_chunks(), chunks);
+  ASSERT_EQ(trailer.consistent(), summary.consistent);
+  ASSERT_FALSE(NamespaceExporter::readFrame(files, type, payload, err));
+  ASSERT_TRUE(err.empty());
+  std::vector<uint64_t> expectedIds;
+
+  for (const auto& entry : expected) {
+    expectedIds.push_back(entry.first);
+  }
+
+  ASSERT_EQ(ids, expectedIds);
+  // Container table
+  ASSERT_TRUE(NamespaceExporter::readFrame(containers, type, payload, err));
+  ASSERT_TRUE(header.ParseFromString(payload));
+  ASSERT_EQ(header.kind(), "containers");
+  size_t numContainers = 0;
+
+  while (NamespaceExporter::readFrame(containers, type, payload, err) &&
+         type == NamespaceExporter::FrameType::kContainerColumns) {
+    eos::ns::ContainerColumnsProto columns;
+    ASSERT_TRUE(columns.ParseFromString(payload));
+    ASSERT_EQ(columns.parent_id_size(), columns.id_size());
+    numContainers += columns.id_size();
+  }
+
+  ASSERT_EQ(type, NamespaceExporter::FrameType::kTrailer);
+  ASSERT_EQ(numContainers, expectedContainers);
+  // Any write moves the last applied index
+  ASSERT_TRUE(qcl().exec("SET", "export-test", "1").get());
+  bool raft = false;
+  uint64_t index = 0;
+  ASSERT_TRUE(NamespaceExporter::getLastApplied(qcl(), raft, index, err));
+  ASSERT_EQ(raft, summary.raft);
+
+  if (raft) {
+    ASSERT_GT(index, summary.endIndex);
+  }
+}
+
 TEST_F(NamespaceExplorerF, LinkedAttributes)
 {
   std::shared_ptr<eos::IContainerMD> root = view()->getContainer("/");
@@ -219,6 +219,7 @@ int main(int argc, char* argv[])
   bool onlyNoAttrs = false;
   bool countContents = false;
   size_t countThreshold = 0;
+  size_t scanWorkers = 0;
   scanDirsSubcommand->add_flag("--only-no-attrs", onlyNoAttrs,
                                "Only show directories which have no extended attributes whatsoever");
   scanDirsSubcommand->add_flag("--full-paths", fullPaths,
@@ -228,6 +229,8 @@ int main(int argc, char* argv[])
   scanDirsSubcommand->add_option("--count-threshold", countThreshold,
                                  "Only print containers which contain more than the specified number of items. Useful for detecting huge containers on which 'ls' might hang");
   scanDirsSubcommand->add_flag("--json", json, "Use json output");
+  scanDirsSubcommand->add_option("--workers", scanWorkers,
+                                 "Scan with the given number of parallel workers, each with its own connection. The output is then sorted by container id.");
   //----------------------------------------------------------------------------
   // Set-up scan-files subcommand..
   //----------------------------------------------------------------------------
@@ -244,9 +247,31 @@ int main(int argc, char* argv[])
   scanFilesSubcommand->add_flag("--find-unknown-fsids", findUnknownFsids,
                                 "Only print files for which there is one or more unrecognized fsids in location vector.");
   scanFilesSubcommand->add_flag("--json", json, "Use json output");
+  scanFilesSubcommand->add_option("--workers", scanWorkers,
+                                  "Scan with the given number of parallel workers, each with its own connection. The output is then sorted by file id.");
   scanFilesSubcommand->add_option("--where", filterExpression,
                                   "Filter results using the given expression.\nNOTE: Filtering is done client side! All results still have to be streamed -- performance is the same.");
   //----------------------------------------------------------------------------
+  // Set-up export subcommand..
+  //----------------------------------------------------------------------------
+  auto exportSubcommand = app.add_subcommand("export",
+                          "Export all file and container metadata as compressed columnar chunks, for offline analysis");
+  addClusterOptions(exportSubcommand, membersStr, memberValidator, password,
+                    passwordFile, connectionRetries);
+  std::string exportPrefix;
+  uint64_t chunkSize = 100000;
+  bool requireConsistent = false;
+  exportSubcommand->add_option("--output", exportPrefix,
+                               "Prefix of the output files, <prefix>.files.eosns and <prefix>.containers.eosns are created")
+  ->required();
+  exportSubcommand->add_option("--chunk-size", chunkSize,
+                               "Number of entries per chunk")
+  ->check(CLI::Range((uint64_t) 1, (uint64_t) UINT32_MAX));
+  exportSubcommand->add_option("--workers", scanWorkers,
+                               "Scan with the given number of parallel workers, each with its own connection");
+  exportSubcommand->add_flag("--require-consistent", requireConsistent,
+                             "Fail if QuarkDB applied any write during the export. For a point-in-time view of a live instance, run the export against a standalone QuarkDB started on a raft checkpoint.");
+  //----------------------------------------------------------------------------
   // Set-up scan-deathrow subcommand..
   //----------------------------------------------------------------------------
   auto scanDeathrowSubcommand = app.add_subcommand("scan-deathrow",
@@ -509,6 +534,25 @@ int main(int argc, char* argv[])
   }
 
   inspector.setMetadataFilter(std::move(metadataFilter));
+  //----------------------------------------------------------------------------
+  // Set-up one more connection per parallel scan worker
+  //----------------------------------------------------------------------------
+  std::vector<std::unique_ptr<qclient::QClient>> scanQclients;
+  std::vector<qclient::QClient*> scanQcls;
+
+  for (size_t i = 0; i < scanWorkers; ++i) {
+    qclient::Options scanOpts = contactDetails.constructOptions();
+
+    if (connectionRetries) {
+      scanOpts.retryStrategy = qclient::RetryStrategy::NRetries(connectionRetries);
+    }
+
+    scanQclients.emplace_back(new qclient::QClient(contactDetails.members,
+                              std::move(scanOpts)));
+    scanQcls.push_back(scanQclients.back().get());
+  }
+
+  inspector.setParallelScan(scanQcls, scanWorkers);
 
   //----------------------------------------------------------------------------
   // Dispatch subcommand
@@ -557,6 +601,11 @@ int main(int argc, char* argv[])
     return inspector.scanFileMetadata(onlySizes, fullPaths, findUnknownFsids);
   }
 
+  if (exportSubcommand->parsed()) {
+    return inspector.exportNamespace(exportPrefix, chunkSize, requireConsistent,
+                                     std::cout, std::cerr);
+  }
+
   if (scanDeathrowSubcommand->parsed()) {
     return inspector.scanDeathrow(std::cout, std::cerr);
   }
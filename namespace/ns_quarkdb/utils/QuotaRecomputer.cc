@@ -25,6 +25,7 @@
 #include "namespace/ns_quarkdb/views/HierarchicalView.hh"
 #include "namespace/Constants.hh"
 #include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
 #include "common/LayoutId.hh"
 
 EOSNSNAMESPACE_BEGIN
@@ -36,9 +37,18 @@ QuotaRecomputer::QuotaRecomputer(qclient::QClient* qcl,
                                  folly::Executor* exec)
   : mQcl(qcl), mExecutor(exec) {}
 
+//------------------------------------------------------------------------------
+// Constructor - parallel exploration
+//------------------------------------------------------------------------------
+QuotaRecomputer::QuotaRecomputer(const std::vector<qclient::QClient*>& qcls,
+                                 folly::Executor* exec, size_t num_workers)
+  : mQcl(qcls.empty() ? nullptr : qcls.front()), mExecutor(exec),
+    mQcls(qcls), mNumWorkers(qcls.empty() ? 0 : num_workers) {}
+
 //------------------------------------------------------------------------------
 // Filtering class for NamespaceExplorer to ignore sub-quotanodes when
-// recomputing a quotanode.
+// recomputing a quotanode. Stateless, so also usable by the parallel
+// explorer.
 //------------------------------------------------------------------------------
 class QuotaNodeFilter : public ExpansionDecider
 {
@@ -82,10 +92,7 @@ MDStatus QuotaRecomputer::recompute(const std::string& cont_uri,
   ExplorationOptions options;
   options.depthLimit = 2048;
   options.expansionDecider.reset(new QuotaNodeFilter(cont_id));
-  NamespaceExplorer explorer(cont_uri, options, *mQcl, mExecutor);
-  NamespaceItem item;
-
-  while (explorer.fetch(item)) {
+  auto accountFile = [&qnc](const NamespaceItem& item) {
     if (item.isFile) {
       // Calculate physical size
       uint64_t logicalSize = item.fileMd.size();
@@ -95,6 +102,27 @@ MDStatus QuotaRecomputer::recompute(const std::string& cont_uri,
       qnc.addFile(item.fileMd.uid(), item.fileMd.gid(), logicalSize,
                   physicalSize);
     }
+  };
+
+  if (mNumWorkers > 0) {
+    ParallelNamespaceExplorer explorer(cont_uri, options, mQcls, mExecutor,
+                                       mNumWorkers);
+    std::vector<NamespaceItem> batch;
+
+    while (explorer.fetchBatch(batch)) {
+      for (const auto& item : batch) {
+        accountFile(item);
+      }
+    }
+
+    return MDStatus(); // OK
+  }
+
+  NamespaceExplorer explorer(cont_uri, options, *mQcl, mExecutor);
+  NamespaceItem item;
+
+  while (explorer.fetch(item)) {
+    accountFile(item);
   }
 
   return MDStatus(); // OK
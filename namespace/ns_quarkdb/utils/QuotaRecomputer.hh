@@ -26,6 +26,7 @@
 #include "namespace/interface/IContainerMD.hh"
 #include "namespace/Namespace.hh"
 #include "namespace/MDException.hh"
+#include <vector>
 
 namespace qclient
 {
@@ -53,6 +54,16 @@ public:
   //----------------------------------------------------------------------------
   QuotaRecomputer(qclient::QClient* qcl, folly::Executor* exec);
 
+  //----------------------------------------------------------------------------
+  //! Constructor, the subtree of the quota node is explored in parallel
+  //!
+  //! @param qcls connections shared by the workers, no ownership
+  //! @param exec executor for the metadata futures
+  //! @param num_workers number of exploration workers
+  //----------------------------------------------------------------------------
+  QuotaRecomputer(const std::vector<qclient::QClient*>& qcls,
+                  folly::Executor* exec, size_t num_workers = 8);
+
   //----------------------------------------------------------------------------
   //! Given a quotanode, re-calculate the quota values,
   //! store into QuotaNodeCore.
@@ -69,6 +80,8 @@ public:
 private:
   qclient::QClient* mQcl;
   folly::Executor* mExecutor;
+  std::vector<qclient::QClient*> mQcls; ///< Only for parallel exploration
+  size_t mNumWorkers {0}; ///< Parallel exploration workers, 0 if sequential
 };
 
 EOSNSNAMESPACE_END
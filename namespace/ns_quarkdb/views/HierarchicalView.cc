@@ -23,6 +23,7 @@
 #include "namespace/interface/IContainerMDSvc.hh"
 #include "namespace/interface/IFileMDSvc.hh"
 #include "namespace/ns_quarkdb/persistency/ContainerMDSvc.hh"
+#include "namespace/ns_quarkdb/persistency/MetadataFetcher.hh"
 #include "namespace/utils/PathProcessor.hh"
 #include <cerrno>
 #include <ctime>
@@ -190,7 +191,7 @@ QuarkHierarchicalView::getItem(const std::string& uri, bool follow)
   // Initial state: We're at "/", and have to look up all chunks.
   //----------------------------------------------------------------------------
   FileOrContainerMD initialState {nullptr, pRoot};
-  return getPathInternal(initialState, pendingChunks, follow, 0);
+  return getPathInternal(initialState, pendingChunks, follow, 0, true);
 }
 
 //------------------------------------------------------------------------------
@@ -207,7 +208,8 @@ static FileOrContainerMD toFileOrContainerMD(IContainerMDPtr ptr)
 folly::Future<FileOrContainerMD>
 QuarkHierarchicalView::getPathDeferred(folly::Future<FileOrContainerMD> fut,
                                        std::deque<std::string> pendingChunks,
-                                       bool follow, size_t expendedEffort)
+                                       bool follow, size_t expendedEffort,
+                                       bool speculate)
 {
   //----------------------------------------------------------------------------
   // We're blocked on a network request. "Pause" execution of getPathInternal
@@ -219,7 +221,7 @@ QuarkHierarchicalView::getPathDeferred(folly::Future<FileOrContainerMD> fut,
   return fut.via(pExecutor.get())
          .thenValue(std::bind(&QuarkHierarchicalView::getPathInternal, this, _1,
                               pendingChunks,
-                              follow, expendedEffort));
+                              follow, expendedEffort, speculate));
 }
 
 //------------------------------------------------------------------------------
@@ -228,7 +230,8 @@ QuarkHierarchicalView::getPathDeferred(folly::Future<FileOrContainerMD> fut,
 folly::Future<FileOrContainerMD>
 QuarkHierarchicalView::getPathDeferred(folly::Future<IContainerMDPtr> fut,
                                        std::deque<std::string> pendingChunks,
-                                       bool follow, size_t expendedEffort)
+                                       bool follow, size_t expendedEffort,
+                                       bool speculate)
 {
   //----------------------------------------------------------------------------
   // Same as getPathDeferred taking FileOrContainerMD.
@@ -237,7 +240,7 @@ QuarkHierarchicalView::getPathDeferred(folly::Future<IContainerMDPtr> fut,
          .thenValue(toFileOrContainerMD)
          .thenValue(std::bind(&QuarkHierarchicalView::getPathInternal, this, _1,
                               pendingChunks,
-                              follow, expendedEffort));
+                              follow, expendedEffort, speculate));
 }
 
 //------------------------------------------------------------------------------
@@ -246,7 +249,8 @@ QuarkHierarchicalView::getPathDeferred(folly::Future<IContainerMDPtr> fut,
 folly::Future<FileOrContainerMD>
 QuarkHierarchicalView::getPathInternal(FileOrContainerMD state,
                                        std::deque<std::string> pendingChunks,
-                                       bool follow, size_t expendedEffort)
+                                       bool follow, size_t expendedEffort,
+                                       bool speculate)
 {
   //----------------------------------------------------------------------------
   // Our goal is to consume pendingChunks until it's empty.
@@ -307,7 +311,8 @@ QuarkHierarchicalView::getPathInternal(FileOrContainerMD state,
           //--------------------------------------------------------------------
           // We're blocked, "pause" execution, unblock caller.
           //--------------------------------------------------------------------
-          return getPathDeferred(std::move(fut), pendingChunks, follow, expendedEffort);
+          return getPathDeferred(std::move(fut), pendingChunks, follow,
+                                 expendedEffort, speculate);
         }
 
         state.container = std::move(fut).get();
@@ -318,8 +323,8 @@ QuarkHierarchicalView::getPathInternal(FileOrContainerMD state,
       // Normal case: Our current state contains a container, and we're simply
       // looking up the next chunk.
       //------------------------------------------------------------------------
-      folly::Future<FileOrContainerMD> next = state.container->findItem(
-          pendingChunks.front());
+      const std::string name = pendingChunks.front();
+      folly::Future<FileOrContainerMD> next = state.container->findItem(name);
       pendingChunks.pop_front();
 
       //------------------------------------------------------------------------
@@ -329,12 +334,34 @@ QuarkHierarchicalView::getPathInternal(FileOrContainerMD state,
       if (next.isReady() && !next.hasException()) {
         state = std::move(next).get();
         continue;
-      } else {
-        //----------------------------------------------------------------------
-        // We're blocked, "pause" execution, unblock caller.
-        //----------------------------------------------------------------------
-        return getPathDeferred(std::move(next), pendingChunks, follow, expendedEffort);
       }
+
+      //------------------------------------------------------------------------
+      // We're blocked, "pause" execution, unblock caller.
+      //------------------------------------------------------------------------
+      if (!speculate || pendingChunks.empty()) {
+        return getPathDeferred(std::move(next), pendingChunks, follow,
+                               expendedEffort, speculate);
+      }
+
+      //------------------------------------------------------------------------
+      // First cache miss of a cold path: the following levels are most
+      // likely cold as well. Start loading them right away instead of one
+      // after the other as the lookup progresses. The lookup completes only
+      // once the speculation is over, so that no callback outlives the
+      // lookup. The speculation mostly runs ahead of the lookup since it
+      // needs just one small request per level.
+      //------------------------------------------------------------------------
+      std::deque<std::string> speculativeChunks = pendingChunks;
+      speculativeChunks.push_front(name);
+      folly::Future<folly::Unit> speculation = prefetchRemainingPath(
+            state.container->getIdentifier(), std::move(speculativeChunks));
+      folly::Future<FileOrContainerMD> result = getPathDeferred(
+            std::move(next), pendingChunks, follow, expendedEffort, false);
+      return std::move(speculation).thenValue([result = std::move(result)]
+      (folly::Unit) mutable {
+        return std::move(result);
+      });
     }
 
     if (state.file) {
@@ -382,7 +409,8 @@ QuarkHierarchicalView::getPathInternal(FileOrContainerMD state,
           //--------------------------------------------------------------------
           // We're blocked, "pause" execution, unblock caller.
           //--------------------------------------------------------------------
-          return getPathDeferred(std::move(fut), pendingChunks, follow, expendedEffort);
+          return getPathDeferred(std::move(fut), pendingChunks, follow,
+                                 expendedEffort, speculate);
         }
 
         state.container = std::move(fut).get();
@@ -394,6 +422,57 @@ QuarkHierarchicalView::getPathInternal(FileOrContainerMD state,
   }
 }
 
+//------------------------------------------------------------------------------
+// Speculatively load the containers along the remaining path components
+//------------------------------------------------------------------------------
+folly::Future<folly::Unit>
+QuarkHierarchicalView::prefetchRemainingPath(ContainerIdentifier parent,
+    std::deque<std::string> chunks)
+{
+  if (chunks.empty() || chunks.front() == "." || chunks.front() == "..") {
+    return folly::makeFuture();
+  }
+
+  const std::string name = chunks.front();
+  chunks.pop_front();
+
+  if (chunks.empty()) {
+    //--------------------------------------------------------------------------
+    // Last component, could be either a container or a file.
+    //--------------------------------------------------------------------------
+    return MetadataFetcher::getContainerIDFromName(*pQcl, parent, name)
+           .via(pExecutor.get())
+    .thenValue([this](ContainerIdentifier id) {
+      // Loading happens in the background, the future can be dropped
+      (void) pContainerSvc->getContainerMDFut(id.getUnderlyingUInt64());
+    })
+    .thenError([this, parent, name](const folly::exception_wrapper & e) {
+      return MetadataFetcher::getFileIDFromName(*pQcl, parent, name)
+             .via(pExecutor.get())
+      .thenValue([this](FileIdentifier id) {
+        (void) pFileSvc->getFileMDFut(id.getUnderlyingUInt64());
+      });
+    })
+    .thenError([](const folly::exception_wrapper & e) {
+      return folly::Unit();
+    });
+  }
+
+  //----------------------------------------------------------------------------
+  // Intermediate component, must be a container unless it's a symlink. Start
+  // loading it, and carry on with the next component without waiting.
+  //----------------------------------------------------------------------------
+  return MetadataFetcher::getContainerIDFromName(*pQcl, parent, name)
+         .via(pExecutor.get())
+  .thenValue([this, chunks](ContainerIdentifier id) {
+    (void) pContainerSvc->getContainerMDFut(id.getUnderlyingUInt64());
+    return prefetchRemainingPath(id, chunks);
+  })
+  .thenError([](const folly::exception_wrapper & e) {
+    return folly::Unit();
+  });
+}
+
 //------------------------------------------------------------------------------
 // Retrieve a file for given uri, asynchronously
 //------------------------------------------------------------------------------
@@ -695,7 +774,8 @@ QuarkHierarchicalView::getPathExpectContainer(const std::deque<std::string>&
     return pRoot;
   }
 
-  return getPathInternal(FileOrContainerMD {nullptr, pRoot}, chunks, true, 0)
+  return getPathInternal(FileOrContainerMD {nullptr, pRoot}, chunks, true, 0,
+                         true)
          .thenValue(extractContainerMD);
 }
 
@@ -312,10 +312,13 @@ public:
 private:
   //----------------------------------------------------------------------------
   //! Lookup a given path - internal function.
+  //!
+  //! @param speculate if true, the first cache miss triggers a speculative
+  //!        fetch of the remaining path components, see prefetchRemainingPath
   //----------------------------------------------------------------------------
   folly::Future<FileOrContainerMD>
   getPathInternal(FileOrContainerMD state, std::deque<std::string> pendingChunks,
-                  bool follow, size_t expendedEffort);
+                  bool follow, size_t expendedEffort, bool speculate = false);
 
   //----------------------------------------------------------------------------
   //! Lookup a given path - deferred function.
@@ -323,7 +326,7 @@ private:
   folly::Future<FileOrContainerMD>
   getPathDeferred(folly::Future<FileOrContainerMD> fut,
                   std::deque<std::string> pendingChunks,
-                  bool follow, size_t expendedEffort);
+                  bool follow, size_t expendedEffort, bool speculate = false);
 
   //----------------------------------------------------------------------------
   //! Lookup a given path - deferred function.
@@ -331,7 +334,30 @@ private:
   folly::Future<FileOrContainerMD>
   getPathDeferred(folly::Future<IContainerMDPtr> fut,
                   std::deque<std::string> pendingChunks,
-                  bool follow, size_t expendedEffort);
+                  bool follow, size_t expendedEffort, bool speculate = false);
+
+  //----------------------------------------------------------------------------
+  //! Speculatively load the containers along the remaining path components
+  //! into the metadata cache, so that a cold lookup doesn't pay one full
+  //! container load per level in sequence.
+  //!
+  //! The id of every next component is read directly from the child maps
+  //! stored in QDB, and the load of each container is started as soon as its
+  //! id is known, concurrently with the lookup of the following component.
+  //! The last component is loaded as a container or as a file. The
+  //! speculation stops at "." or "..", at symlinks and at missing entries.
+  //! This is only a hint: the lookup itself still goes through the child maps
+  //! of the cached parents, a stale id only costs a useless fetch.
+  //!
+  //! @param parent container id under which the chunks are looked up
+  //! @param chunks remaining path components
+  //!
+  //! @return future completed once all the ids have been looked up, never
+  //!         holds an exception
+  //----------------------------------------------------------------------------
+  folly::Future<folly::Unit>
+  prefetchRemainingPath(ContainerIdentifier parent,
+                        std::deque<std::string> chunks);
 
   //----------------------------------------------------------------------------
   //! Lookup a given path, expect a container there.
@@ -0,0 +1,1089 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Sorted and prefix-compressed map of container children
+//------------------------------------------------------------------------------
+
+#include "namespace/utils/ChildMap.hh"
+#include "common/Murmur3.hh"
+#include <algorithm>
+
+EOSNSNAMESPACE_BEGIN
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Append variable length integer
+//------------------------------------------------------------------------------
+void
+PutVarint(std::string& out, size_t value)
+{
+  while (value >= 0x80) {
+    out.push_back((char)((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+
+  out.push_back((char) value);
+}
+
+//------------------------------------------------------------------------------
+// Read variable length integer and advance the offset
+//------------------------------------------------------------------------------
+inline size_t
+GetVarint(const std::string& data, size_t& offset)
+{
+  size_t value = 0;
+  uint32_t shift = 0;
+  uint8_t byte;
+
+  do {
+    byte = (uint8_t) data[offset++];
+    value |= (size_t)(byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+
+  return value;
+}
+
+//------------------------------------------------------------------------------
+// Get length of the common prefix of two strings
+//------------------------------------------------------------------------------
+inline size_t
+CommonPrefix(const std::string& a, const std::string& b)
+{
+  size_t max = std::min(a.size(), b.size());
+  size_t len = 0;
+
+  while ((len < max) && (a[len] == b[len])) {
+    ++len;
+  }
+
+  return len;
+}
+}
+
+//------------------------------------------------------------------------------
+//! Chunk of entries, names are stored as the length of the prefix shared with
+//! the previous name and the remaining suffix
+//------------------------------------------------------------------------------
+struct ChildMap::Chunk {
+  std::string mData; ///< Encoded names
+  std::vector<uint64_t> mIds; ///< Ids in the same order as the names
+  Chunk* mNext {nullptr}; ///< Next chunk in name order
+  uint32_t mId {0}; ///< Stable id used by the hash index
+
+  inline uint32_t size() const
+  {
+    return (uint32_t) mIds.size();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Decode entry at the given offset, name holds the previous name on input
+  //! and the current one on output. Return the offset of the next entry.
+  //----------------------------------------------------------------------------
+  inline size_t decode(size_t offset, std::string& name) const
+  {
+    size_t shared = GetVarint(mData, offset);
+    size_t len = GetVarint(mData, offset);
+    name.resize(shared);
+    name.append(mData, offset, len);
+    return offset + len;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Compare the first name of the chunk with the given name
+  //----------------------------------------------------------------------------
+  inline int compareFirst(const std::string& key) const
+  {
+    size_t offset = 0;
+    (void) GetVarint(mData, offset);
+    size_t len = GetVarint(mData, offset);
+    return mData.compare(offset, len, key);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get all names
+  //----------------------------------------------------------------------------
+  std::vector<std::string> names() const
+  {
+    std::vector<std::string> result(size());
+    std::string name;
+    size_t offset = 0;
+
+    for (uint32_t i = 0; i < size(); ++i) {
+      offset = decode(offset, name);
+      result[i] = name;
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get last name
+  //----------------------------------------------------------------------------
+  std::string last() const
+  {
+    std::string name;
+    size_t offset = 0;
+
+    for (uint32_t i = 0; i < size(); ++i) {
+      offset = decode(offset, name);
+    }
+
+    return name;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Append entry, prev must be the last name of the chunk
+  //----------------------------------------------------------------------------
+  void append(const std::string& prev, const std::string& name, uint64_t id)
+  {
+    size_t shared = (mIds.empty() ? 0 : CommonPrefix(prev, name));
+    PutVarint(mData, shared);
+    PutVarint(mData, name.size() - shared);
+    mData.append(name, shared, std::string::npos);
+    mIds.push_back(id);
+
+    if (mIds.size() == kMaxChunkEntries) {
+      mData.shrink_to_fit();
+      mIds.shrink_to_fit();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Re-encode the given sorted names, the ids must already match them
+  //----------------------------------------------------------------------------
+  void encode(const std::vector<std::string>& names)
+  {
+    std::string data;
+    data.reserve(mData.size() + 32);
+
+    for (size_t i = 0; i < names.size(); ++i) {
+      size_t shared = (i ? CommonPrefix(names[i - 1], names[i]) : 0);
+      PutVarint(data, shared);
+      PutVarint(data, names[i].size() - shared);
+      data.append(names[i], shared, std::string::npos);
+    }
+
+    data.shrink_to_fit();
+    mData.swap(data);
+
+    if (mIds.capacity() > mIds.size() + mIds.size() / 2) {
+      mIds.shrink_to_fit();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Find the first entry not less than the given name. The names are not
+  //! decoded, match is the length of the prefix shared by the key and the
+  //! previous name: an entry sharing a longer prefix with the previous name
+  //! is still smaller than the key while one sharing a shorter prefix is
+  //! larger, only the entries sharing exactly match bytes are compared.
+  //!
+  //! @param key name to look for
+  //! @param index entry index
+  //! @param name if not null, filled with the name of the entry
+  //! @param next if not null, filled with the offset of the next entry
+  //!
+  //! @return true if the entry matches the name
+  //----------------------------------------------------------------------------
+  bool scan(const std::string& key, uint32_t& index,
+            std::string* name = nullptr, size_t* next = nullptr) const
+  {
+    const unsigned char* data = (const unsigned char*) mData.data();
+    const unsigned char* ukey = (const unsigned char*) key.data();
+    size_t offset = 0;
+    size_t match = 0;
+
+    for (index = 0; index < size(); ++index) {
+      size_t shared = GetVarint(mData, offset);
+      size_t len = GetVarint(mData, offset);
+      size_t suffix = offset;
+      offset += len;
+      int cmp = 1;
+
+      if (shared > match) {
+        continue;
+      }
+
+      if (shared == match) {
+        size_t max = std::min(len, key.size() - match);
+        size_t pos = 0;
+
+        while ((pos < max) && (data[suffix + pos] == ukey[match + pos])) {
+          ++pos;
+        }
+
+        if (pos < max) {
+          cmp = ((data[suffix + pos] < ukey[match + pos]) ? -1 : 1);
+        } else {
+          cmp = ((len < key.size() - match) ? -1 :
+                 (len > key.size() - match ? 1 : 0));
+        }
+
+        match += pos;
+
+        if (cmp < 0) {
+          continue;
+        }
+      }
+
+      if (name) {
+        name->assign(key, 0, shared);
+        name->append(mData, suffix, len);
+      }
+
+      if (next) {
+        *next = offset;
+      }
+
+      return (cmp == 0);
+    }
+
+    return false;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Iterator constructor
+//------------------------------------------------------------------------------
+ChildMap::const_iterator::const_iterator(const Chunk* chunk, uint32_t index):
+  mChunk(chunk), mIndex(index)
+{
+  if (mChunk && (mIndex >= mChunk->size())) {
+    mChunk = mChunk->mNext;
+    mIndex = 0;
+  }
+
+  if (mChunk) {
+    for (uint32_t i = 0; i <= mIndex; ++i) {
+      mOffset = mChunk->decode(mOffset, mValue.first);
+    }
+
+    mValue.second = mChunk->mIds[mIndex];
+  }
+}
+
+//------------------------------------------------------------------------------
+// Iterator constructor for a map in hash mode
+//------------------------------------------------------------------------------
+ChildMap::const_iterator::const_iterator(const ChildMap* map,
+    std::shared_ptr<const SortedEntries> sorted, size_t pos, value_type&& value):
+  mOffset(pos), mMap(map), mSorted(std::move(sorted)), mValue(std::move(value))
+{}
+
+//------------------------------------------------------------------------------
+// Iterator increment
+//------------------------------------------------------------------------------
+ChildMap::const_iterator&
+ChildMap::const_iterator::operator++()
+{
+  if (mMap) {
+    // Iterator returned by a lookup, locate its entry in name order
+    if (!mSorted) {
+      mSorted = mMap->sortedEntries();
+      mOffset = std::lower_bound(mSorted->begin(), mSorted->end(), mValue.first,
+      [](const HashMap::value_type * entry, const std::string & key) {
+        return (entry->first < key);
+      }) - mSorted->begin();
+    }
+
+    if (++mOffset < mSorted->size()) {
+      mValue.first = (*mSorted)[mOffset]->first;
+      mValue.second = (*mSorted)[mOffset]->second;
+    } else {
+      *this = const_iterator();
+    }
+
+    return *this;
+  }
+
+  if (mIndex + 1 < mChunk->size()) {
+    mOffset = mChunk->decode(mOffset, mValue.first);
+    mValue.second = mChunk->mIds[++mIndex];
+    return *this;
+  }
+
+  mChunk = mChunk->mNext;
+  mIndex = 0;
+
+  if (mChunk) {
+    mOffset = mChunk->decode(0, mValue.first);
+    mValue.second = mChunk->mIds[0];
+  }
+
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ChildMap::ChildMap() = default;
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ChildMap::~ChildMap() = default;
+
+//------------------------------------------------------------------------------
+// Copy constructor
+//------------------------------------------------------------------------------
+ChildMap::ChildMap(const ChildMap& other):
+  mHash(other.mHash ? std::make_unique<HashMap>(*other.mHash) : nullptr),
+  mChunkById(other.mChunkById.size(), nullptr), mFreeIds(other.mFreeIds),
+  mTail(other.mTail), mSize(other.mSize), mGeneration(other.mGeneration)
+{
+  mChunks.reserve(other.mChunks.size());
+
+  for (const auto& chunk : other.mChunks) {
+    mChunks.push_back(std::make_unique<Chunk>(*chunk));
+  }
+
+  relinkChunks();
+
+  if (!other.mIndex.empty()) {
+    rebuildIndex();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Move constructor
+//------------------------------------------------------------------------------
+ChildMap::ChildMap(ChildMap&& other) noexcept
+{
+  swap(other);
+}
+
+//------------------------------------------------------------------------------
+// Copy assignment
+//------------------------------------------------------------------------------
+ChildMap&
+ChildMap::operator=(const ChildMap& other)
+{
+  if (this != &other) {
+    ChildMap tmp(other);
+    *this = std::move(tmp);
+  }
+
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// Move assignment - the generation moves forward so that iterators over the
+// previous contents detect the change
+//------------------------------------------------------------------------------
+ChildMap&
+ChildMap::operator=(ChildMap&& other) noexcept
+{
+  if (this != &other) {
+    uint64_t generation = std::max(mGeneration, other.mGeneration) + 1;
+    swap(other);
+    other.clear();
+    mGeneration = generation;
+  }
+
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// Swap contents
+//------------------------------------------------------------------------------
+void
+ChildMap::swap(ChildMap& other) noexcept
+{
+  mHash.swap(other.mHash);
+  mChunks.swap(other.mChunks);
+  mChunkById.swap(other.mChunkById);
+  mFreeIds.swap(other.mFreeIds);
+  mIndex.swap(other.mIndex);
+  mTail.swap(other.mTail);
+  std::swap(mSize, other.mSize);
+  std::swap(mGeneration, other.mGeneration);
+}
+
+//------------------------------------------------------------------------------
+// Remove all entries
+//------------------------------------------------------------------------------
+void
+ChildMap::clear()
+{
+  releaseChunks();
+  mHash.reset();
+  mSize = 0;
+  ++mGeneration;
+}
+
+//------------------------------------------------------------------------------
+// Release the chunks and the hash index
+//------------------------------------------------------------------------------
+void
+ChildMap::releaseChunks()
+{
+  std::vector<std::unique_ptr<Chunk>>().swap(mChunks);
+  std::vector<Chunk*>().swap(mChunkById);
+  std::vector<uint32_t>().swap(mFreeIds);
+  std::vector<IndexSlot>().swap(mIndex);
+  std::string().swap(mTail);
+}
+
+//------------------------------------------------------------------------------
+// Get the entries of the hash map sorted by name
+//------------------------------------------------------------------------------
+std::shared_ptr<const ChildMap::SortedEntries>
+ChildMap::sortedEntries() const
+{
+  auto sorted = std::make_shared<SortedEntries>();
+  sorted->reserve(mHash->size());
+
+  for (const auto& entry : *mHash) {
+    sorted->push_back(&entry);
+  }
+
+  std::sort(sorted->begin(), sorted->end(),
+  [](const HashMap::value_type * a, const HashMap::value_type * b) {
+    return (a->first < b->first);
+  });
+  return sorted;
+}
+
+//------------------------------------------------------------------------------
+// Move the entries from the hash map to the chunks
+//------------------------------------------------------------------------------
+void
+ChildMap::toOrdered()
+{
+  auto sorted = sortedEntries();
+  std::unique_ptr<HashMap> hash;
+  hash.swap(mHash);
+  mSize = 0;
+
+  for (const auto* entry : *sorted) {
+    (void) append(entry->first, entry->second);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Move the entries from the chunks to the hash map
+//------------------------------------------------------------------------------
+void
+ChildMap::toHash()
+{
+  auto hash = std::make_unique<HashMap>();
+  hash->set_deleted_key("");
+  hash->set_empty_key("##_EMPTY_##");
+  hash->resize(mSize);
+
+  for (auto it = begin(); it != end(); ++it) {
+    hash->insert(*it);
+  }
+
+  releaseChunks();
+  mHash = std::move(hash);
+}
+
+//------------------------------------------------------------------------------
+// Get position of the chunk that holds or should hold the given name
+//------------------------------------------------------------------------------
+size_t
+ChildMap::findChunk(const std::string& key) const
+{
+  // First chunk starting after the key, the previous one is the candidate
+  auto it = std::upper_bound(mChunks.begin(), mChunks.end(), key,
+  [](const std::string & key, const std::unique_ptr<Chunk>& chunk) {
+    return (chunk->compareFirst(key) > 0);
+  });
+
+  if (it == mChunks.begin()) {
+    return 0;
+  }
+
+  return (it - mChunks.begin()) - 1;
+}
+
+//------------------------------------------------------------------------------
+// Locate name
+//------------------------------------------------------------------------------
+bool
+ChildMap::locate(const std::string& key, Chunk*& chunk, uint32_t& index,
+                 bool exact_only, std::string* name, size_t* offset) const
+{
+  chunk = nullptr;
+  index = 0;
+
+  if (mChunks.empty()) {
+    return false;
+  }
+
+  if (!mIndex.empty()) {
+    uint32_t hash = hashKey(key);
+    size_t mask = mIndex.size() - 1;
+
+    for (size_t pos = hash & mask; mIndex[pos].mHash; pos = (pos + 1) & mask) {
+      if (mIndex[pos].mHash == hash) {
+        Chunk* candidate = mChunkById[mIndex[pos].mChunkId];
+
+        if (candidate->scan(key, index, name, offset)) {
+          chunk = candidate;
+          return true;
+        }
+      }
+    }
+
+    if (exact_only) {
+      return false;
+    }
+  }
+
+  chunk = mChunks[findChunk(key)].get();
+  return chunk->scan(key, index, name, offset);
+}
+
+//------------------------------------------------------------------------------
+// Insert chunk at the given position
+//------------------------------------------------------------------------------
+ChildMap::Chunk*
+ChildMap::addChunk(size_t pos, std::unique_ptr<Chunk>&& chunk)
+{
+  Chunk* ptr = chunk.get();
+
+  if (mFreeIds.empty()) {
+    ptr->mId = (uint32_t) mChunkById.size();
+    mChunkById.push_back(ptr);
+  } else {
+    ptr->mId = mFreeIds.back();
+    mFreeIds.pop_back();
+    mChunkById[ptr->mId] = ptr;
+  }
+
+  mChunks.insert(mChunks.begin() + pos, std::move(chunk));
+  ptr->mNext = ((pos + 1 < mChunks.size()) ? mChunks[pos + 1].get() : nullptr);
+
+  if (pos) {
+    mChunks[pos - 1]->mNext = ptr;
+  }
+
+  return ptr;
+}
+
+//------------------------------------------------------------------------------
+// Remove chunk at the given position
+//------------------------------------------------------------------------------
+void
+ChildMap::removeChunk(size_t pos)
+{
+  if (pos) {
+    mChunks[pos - 1]->mNext = mChunks[pos]->mNext;
+  }
+
+  mChunkById[mChunks[pos]->mId] = nullptr;
+  mFreeIds.push_back(mChunks[pos]->mId);
+  mChunks.erase(mChunks.begin() + pos);
+}
+
+//------------------------------------------------------------------------------
+// Relink all the chunks
+//------------------------------------------------------------------------------
+void
+ChildMap::relinkChunks()
+{
+  for (size_t i = 0; i < mChunks.size(); ++i) {
+    mChunks[i]->mNext = ((i + 1 < mChunks.size()) ? mChunks[i + 1].get() :
+                         nullptr);
+    mChunkById[mChunks[i]->mId] = mChunks[i].get();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Append entry larger than all the existing ones
+//------------------------------------------------------------------------------
+ChildMap::Chunk*
+ChildMap::append(const std::string& key, uint64_t id)
+{
+  Chunk* chunk = nullptr;
+
+  if (mChunks.empty() || (mChunks.back()->size() >= kMaxChunkEntries)) {
+    chunk = addChunk(mChunks.size(), std::make_unique<Chunk>());
+  } else {
+    chunk = mChunks.back().get();
+  }
+
+  chunk->append(mTail, key, id);
+  mTail = key;
+  ++mSize;
+
+  if (!mIndex.empty() || (mSize >= kHashIndexMinSize)) {
+    indexInsert(hashKey(key), chunk);
+  }
+
+  return chunk;
+}
+
+//------------------------------------------------------------------------------
+// Insert entry
+//------------------------------------------------------------------------------
+std::pair<ChildMap::const_iterator, bool>
+ChildMap::insert(const value_type& value)
+{
+  const std::string& key = value.first;
+  Chunk* chunk = nullptr;
+  uint32_t index = 0;
+
+  // Empty maps start in hash mode
+  if (!mHash && mChunks.empty()) {
+    toHash();
+  }
+
+  if (mHash) {
+    auto res = mHash->insert(value);
+
+    if (!res.second) {
+      return {const_iterator(this, nullptr, 0, value_type(key, res.first->second)),
+              false};
+    }
+
+    ++mSize;
+    ++mGeneration;
+
+    if (mSize < kOrderedMinSize) {
+      return {const_iterator(this, nullptr, 0, value_type(value)), true};
+    }
+
+    toOrdered();
+    return {find(key), true};
+  }
+
+  if (mSize && (key <= mTail)) {
+    size_t offset = 0;
+
+    if (locate(key, chunk, index, false, nullptr, &offset)) {
+      value_type entry(key, chunk->mIds[index]);
+      return {const_iterator(chunk, index, offset, std::move(entry)), false};
+    }
+
+    auto names = chunk->names();
+    names.insert(names.begin() + index, key);
+    chunk->mIds.insert(chunk->mIds.begin() + index, value.second);
+
+    if (chunk->size() <= kMaxChunkEntries) {
+      chunk->encode(names);
+    } else {
+      // Split the chunk in two halves
+      size_t half = names.size() / 2;
+      size_t pos = findChunk(key);
+      auto next = std::make_unique<Chunk>();
+      next->mIds.assign(chunk->mIds.begin() + half, chunk->mIds.end());
+      chunk->mIds.resize(half);
+      std::vector<std::string> upper(names.begin() + half, names.end());
+      names.resize(half);
+      next->encode(upper);
+      chunk->encode(names);
+      Chunk* ptr = addChunk(pos + 1, std::move(next));
+
+      if (!mIndex.empty()) {
+        for (const auto& name : upper) {
+          if (name != key) {
+            indexUpdate(hashKey(name), chunk, ptr);
+          }
+        }
+      }
+
+      if (index >= half) {
+        chunk = ptr;
+        index -= half;
+      }
+    }
+  } else {
+    // Names larger than all the existing ones are appended
+    chunk = append(key, value.second);
+    ++mGeneration;
+    value_type entry(value);
+    return {const_iterator(chunk, chunk->size() - 1, chunk->mData.size(),
+                           std::move(entry)), true};
+  }
+
+  ++mSize;
+  ++mGeneration;
+
+  if (!mIndex.empty() || (mSize >= kHashIndexMinSize)) {
+    indexInsert(hashKey(key), chunk);
+  }
+
+  return {const_iterator(chunk, index), true};
+}
+
+//------------------------------------------------------------------------------
+// Get reference to the id of the given name
+//------------------------------------------------------------------------------
+uint64_t&
+ChildMap::operator[](const std::string& key)
+{
+  if (mHash && (mSize + 1 < kOrderedMinSize)) {
+    size_t size = mHash->size();
+    uint64_t& id = (*mHash)[key];
+
+    if (mHash->size() != size) {
+      ++mSize;
+      ++mGeneration;
+    }
+
+    return id;
+  }
+
+  auto it = insert(std::make_pair(key, 0ull)).first;
+
+  if (mHash) {
+    return mHash->find(key)->second;
+  }
+
+  // Chunks are owned by the map, the iterator only has a const view
+  return const_cast<Chunk*>(it.mChunk)->mIds[it.mIndex];
+}
+
+//------------------------------------------------------------------------------
+// Erase entry
+//------------------------------------------------------------------------------
+size_t
+ChildMap::erase(const std::string& key)
+{
+  Chunk* chunk = nullptr;
+  uint32_t index = 0;
+
+  if (mHash) {
+    if (mHash->erase(key) == 0) {
+      return 0;
+    }
+
+    --mSize;
+    ++mGeneration;
+    return 1;
+  }
+
+  if (!locate(key, chunk, index, true)) {
+    return 0;
+  }
+
+  // Get the position before touching the first name of the chunk
+  size_t pos = findChunk(key);
+
+  if (!mIndex.empty()) {
+    indexErase(hashKey(key), chunk);
+  }
+
+  if (chunk->size() == 1) {
+    removeChunk(pos);
+  } else {
+    auto names = chunk->names();
+    names.erase(names.begin() + index);
+    chunk->mIds.erase(chunk->mIds.begin() + index);
+
+    // Merge small chunks with the next one
+    Chunk* next = chunk->mNext;
+
+    if (next && (chunk->size() < kMaxChunkEntries / 4) &&
+        (chunk->size() + next->size() <= kMaxChunkEntries / 2)) {
+      auto next_names = next->names();
+
+      if (!mIndex.empty()) {
+        for (const auto& name : next_names) {
+          indexUpdate(hashKey(name), next, chunk);
+        }
+      }
+
+      names.insert(names.end(), next_names.begin(), next_names.end());
+      chunk->mIds.insert(chunk->mIds.end(), next->mIds.begin(),
+                         next->mIds.end());
+      removeChunk(pos + 1);
+    }
+
+    chunk->encode(names);
+  }
+
+  if (key == mTail) {
+    mTail = (mChunks.empty() ? std::string() : mChunks.back()->last());
+  }
+
+  --mSize;
+  ++mGeneration;
+
+  if (!mIndex.empty() && (mSize < kHashIndexMinSize / 2)) {
+    std::vector<IndexSlot>().swap(mIndex);
+  }
+
+  if (mSize < kOrderedMinSize / 2) {
+    toHash();
+  }
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+// Find entry
+//------------------------------------------------------------------------------
+ChildMap::const_iterator
+ChildMap::find(const std::string& key) const
+{
+  Chunk* chunk = nullptr;
+  uint32_t index = 0;
+  size_t offset = 0;
+
+  if (mHash) {
+    auto it = mHash->find(key);
+
+    if (it == mHash->end()) {
+      return end();
+    }
+
+    return const_iterator(this, nullptr, 0, value_type(key, it->second));
+  }
+
+  if (!locate(key, chunk, index, true, nullptr, &offset)) {
+    return end();
+  }
+
+  return const_iterator(chunk, index, offset, value_type(key,
+                        chunk->mIds[index]));
+}
+
+//------------------------------------------------------------------------------
+// Get iterator to the first entry not less than the given name
+//------------------------------------------------------------------------------
+ChildMap::const_iterator
+ChildMap::lower_bound(const std::string& key) const
+{
+  Chunk* chunk = nullptr;
+  uint32_t index = 0;
+
+  if (mHash) {
+    auto sorted = sortedEntries();
+    size_t pos = std::lower_bound(sorted->begin(), sorted->end(), key,
+    [](const HashMap::value_type * entry, const std::string & key) {
+      return (entry->first < key);
+    }) - sorted->begin();
+
+    if (pos == sorted->size()) {
+      return end();
+    }
+
+    value_type value(*(*sorted)[pos]);
+    return const_iterator(this, std::move(sorted), pos, std::move(value));
+  }
+
+  if (mChunks.empty() || (key > mTail)) {
+    return end();
+  }
+
+  std::string name;
+  size_t offset = 0;
+  (void) locate(key, chunk, index, false, &name, &offset);
+
+  // Past the last entry of the chunk, the entry is the first of the next one
+  if (index >= chunk->size()) {
+    return const_iterator(chunk, index);
+  }
+
+  return const_iterator(chunk, index, offset, value_type(std::move(name),
+                        chunk->mIds[index]));
+}
+
+//------------------------------------------------------------------------------
+// Get iterator to the first entry
+//------------------------------------------------------------------------------
+ChildMap::const_iterator
+ChildMap::begin() const
+{
+  if (mHash) {
+    if (mHash->empty()) {
+      return end();
+    }
+
+    auto sorted = sortedEntries();
+    value_type value(*(*sorted)[0]);
+    return const_iterator(this, std::move(sorted), 0, std::move(value));
+  }
+
+  return const_iterator(mChunks.empty() ? nullptr : mChunks[0].get(), 0);
+}
+
+//------------------------------------------------------------------------------
+// Get approximate number of bytes used by the map
+//------------------------------------------------------------------------------
+size_t
+ChildMap::getMemoryUsage() const
+{
+  size_t total = sizeof(*this) + mTail.capacity() +
+                 mChunks.capacity() * sizeof(std::unique_ptr<Chunk>) +
+                 mChunkById.capacity() * sizeof(Chunk*) +
+                 mFreeIds.capacity() * sizeof(uint32_t) +
+                 mIndex.capacity() * sizeof(IndexSlot);
+
+  for (const auto& chunk : mChunks) {
+    total += sizeof(Chunk) + chunk->mData.capacity() +
+             chunk->mIds.capacity() * sizeof(uint64_t);
+  }
+
+  if (mHash) {
+    total += sizeof(HashMap) + mHash->bucket_count() *
+             sizeof(HashMap::value_type);
+
+    // Names which do not fit in the small string buffer are on the heap
+    for (const auto& entry : *mHash) {
+      if (entry.first.capacity() > 15) {
+        total += entry.first.capacity() + 1;
+      }
+    }
+  }
+
+  return total;
+}
+
+//------------------------------------------------------------------------------
+// Equality
+//------------------------------------------------------------------------------
+bool
+ChildMap::operator==(const ChildMap& other) const
+{
+  return (mSize == other.mSize) && std::equal(begin(), end(), other.begin());
+}
+
+//------------------------------------------------------------------------------
+// Hash used by the side index, 0 marks the empty slots
+//------------------------------------------------------------------------------
+uint32_t
+ChildMap::hashKey(const std::string& key)
+{
+  uint32_t hash = (uint32_t)(Murmur3::MurmurHasher<std::string>()(key) >> 32);
+  return (hash ? hash : 1);
+}
+
+//------------------------------------------------------------------------------
+// Add entry to the hash index, growing it if needed
+//------------------------------------------------------------------------------
+void
+ChildMap::indexInsert(uint32_t hash, const Chunk* chunk)
+{
+  // Keep the load factor below 3/4, the rebuild picks up the new entry
+  if (mSize * 4 > mIndex.size() * 3) {
+    rebuildIndex();
+    return;
+  }
+
+  size_t mask = mIndex.size() - 1;
+  size_t pos = hash & mask;
+
+  while (mIndex[pos].mHash) {
+    pos = (pos + 1) & mask;
+  }
+
+  mIndex[pos] = {hash, chunk->mId};
+}
+
+//------------------------------------------------------------------------------
+// Update chunk of an entry in the hash index
+//------------------------------------------------------------------------------
+void
+ChildMap::indexUpdate(uint32_t hash, const Chunk* old_chunk,
+                      const Chunk* new_chunk)
+{
+  size_t mask = mIndex.size() - 1;
+
+  for (size_t pos = hash & mask; mIndex[pos].mHash; pos = (pos + 1) & mask) {
+    if ((mIndex[pos].mHash == hash) &&
+        (mIndex[pos].mChunkId == old_chunk->mId)) {
+      mIndex[pos].mChunkId = new_chunk->mId;
+      return;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Remove entry from the hash index using backward shift deletion
+//------------------------------------------------------------------------------
+void
+ChildMap::indexErase(uint32_t hash, const Chunk* chunk)
+{
+  size_t mask = mIndex.size() - 1;
+  size_t pos = hash & mask;
+
+  while (mIndex[pos].mHash && ((mIndex[pos].mHash != hash) ||
+                               (mIndex[pos].mChunkId != chunk->mId))) {
+    pos = (pos + 1) & mask;
+  }
+
+  if (mIndex[pos].mHash == 0) {
+    return;
+  }
+
+  size_t next = pos;
+
+  while (true) {
+    next = (next + 1) & mask;
+
+    if (mIndex[next].mHash == 0) {
+      break;
+    }
+
+    size_t home = mIndex[next].mHash & mask;
+
+    // Move the entry if its home slot is not between the hole and itself
+    if (((next > pos) && ((home <= pos) || (home > next))) ||
+        ((next < pos) && ((home <= pos) && (home > next)))) {
+      mIndex[pos] = mIndex[next];
+      pos = next;
+    }
+  }
+
+  mIndex[pos] = {0, 0};
+}
+
+//------------------------------------------------------------------------------
+// Rebuild the hash index from the chunks
+//------------------------------------------------------------------------------
+void
+ChildMap::rebuildIndex()
+{
+  size_t capacity = 16;
+
+  while (capacity < mSize * 2) {
+    capacity <<= 1;
+  }
+
+  std::vector<IndexSlot> index(capacity, IndexSlot{0, 0});
+  size_t mask = capacity - 1;
+
+  for (const auto& chunk : mChunks) {
+    std::string name;
+    size_t offset = 0;
+
+    for (uint32_t i = 0; i < chunk->size(); ++i) {
+      offset = chunk->decode(offset, name);
+      uint32_t hash = hashKey(name);
+      size_t pos = hash & mask;
+
+      while (index[pos].mHash) {
+        pos = (pos + 1) & mask;
+      }
+
+      index[pos] = {hash, chunk->mId};
+    }
+  }
+
+  mIndex.swap(index);
+}
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,370 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Sorted and prefix-compressed map of container children
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include "common/Murmur3.hh"
+#include <google/dense_hash_map>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Map from child name to id kept sorted by name. The entries are stored in
+//! chunks of at most kMaxChunkEntries. Inside a chunk every name is encoded
+//! as the length of the prefix shared with the previous name followed by the
+//! remaining suffix, while the ids are kept in a plain array. Directory
+//! entries tend to share long prefixes (run numbers, dates) so a chunk takes
+//! a fraction of the memory of a hash map bucket array plus one heap string
+//! per name.
+//!
+//! Lookups binary search the first name of each chunk and then scan the
+//! chunk comparing only the suffixes that matter. Maps holding at least
+//! kHashIndexMinSize entries also keep a side index from the name hash to the
+//! chunk holding it, so lookups in very large directories do not pay for the
+//! binary search. The index takes 8 bytes per slot as it refers to the
+//! chunks through a stable chunk id.
+//!
+//! Ordinary directories do not need any of this, maps with less than
+//! kOrderedMinSize entries are kept in a plain hash map so that their
+//! lookups are not slowed down. They switch to the chunks once they reach
+//! kOrderedMinSize entries and back once they shrink below half of it.
+//! Iterating over a hash map sorts pointers to its entries first.
+//!
+//! Iteration is in name order. Any modification invalidates the existing
+//! iterators, getGeneration() changes with every modification and can be
+//! used to detect it. The object is not thread-safe.
+//------------------------------------------------------------------------------
+class ChildMap
+{
+  struct Chunk;
+public:
+  using key_type = std::string;
+  using mapped_type = uint64_t;
+  using value_type = std::pair<std::string, uint64_t>;
+  static constexpr uint32_t kMaxChunkEntries = 64;
+  static constexpr uint64_t kHashIndexMinSize = 4096;
+  static constexpr uint64_t kOrderedMinSize = 4096;
+
+private:
+  using HashMap = google::dense_hash_map<std::string, uint64_t,
+        Murmur3::MurmurHasher<std::string>>;
+  using SortedEntries = std::vector<const HashMap::value_type*>;
+
+public:
+
+  //----------------------------------------------------------------------------
+  //! Forward iterator over the entries in name order. The entry is decoded
+  //! in the iterator, the returned reference is valid until the iterator is
+  //! incremented.
+  //----------------------------------------------------------------------------
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ChildMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const_iterator() = default;
+
+    inline const value_type& operator*() const
+    {
+      return mValue;
+    }
+
+    inline const value_type* operator->() const
+    {
+      return &mValue;
+    }
+
+    const_iterator& operator++();
+
+    inline const_iterator operator++(int)
+    {
+      const_iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    inline bool operator==(const const_iterator& other) const
+    {
+      if (mMap || other.mMap) {
+        return (mMap == other.mMap) && (mValue.first == other.mValue.first);
+      }
+
+      return (mChunk == other.mChunk) && (mIndex == other.mIndex);
+    }
+
+    inline bool operator!=(const const_iterator& other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    friend class ChildMap;
+
+    //--------------------------------------------------------------------------
+    //! Constructor positioning the iterator on the given entry, an index past
+    //! the last entry of the chunk moves to the next chunk
+    //--------------------------------------------------------------------------
+    const_iterator(const Chunk* chunk, uint32_t index);
+
+    //--------------------------------------------------------------------------
+    //! Constructor for an already decoded entry
+    //--------------------------------------------------------------------------
+    const_iterator(const Chunk* chunk, uint32_t index, size_t offset,
+                   value_type&& value):
+      mChunk(chunk), mIndex(index), mOffset(offset), mValue(std::move(value))
+    {}
+
+    //--------------------------------------------------------------------------
+    //! Constructor for an entry of a map in hash mode. The sorted entries are
+    //! only computed once the iterator moves, a null sorted list means that
+    //! the iterator was returned by a lookup.
+    //--------------------------------------------------------------------------
+    const_iterator(const ChildMap* map,
+                   std::shared_ptr<const SortedEntries> sorted, size_t pos,
+                   value_type&& value);
+
+    const Chunk* mChunk {nullptr}; ///< Current chunk, nullptr at the end
+    uint32_t mIndex {0}; ///< Entry index in the chunk
+    //! Offset of the next entry in the chunk data or, in hash mode, position
+    //! in the sorted entries
+    size_t mOffset {0};
+    const ChildMap* mMap {nullptr}; ///< Map in hash mode, nullptr otherwise
+    std::shared_ptr<const SortedEntries> mSorted; ///< Entries in name order
+    value_type mValue; ///< Current entry
+  };
+
+  using iterator = const_iterator;
+
+  //----------------------------------------------------------------------------
+  //! Constructors and assignment
+  //----------------------------------------------------------------------------
+  ChildMap();
+  ~ChildMap();
+  ChildMap(const ChildMap& other);
+  ChildMap(ChildMap&& other) noexcept;
+  ChildMap& operator=(const ChildMap& other);
+  ChildMap& operator=(ChildMap&& other) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Insert entry if the name is not present
+  //!
+  //! @return iterator to the entry with the given name and true if the
+  //!         insertion took place
+  //----------------------------------------------------------------------------
+  std::pair<const_iterator, bool> insert(const value_type& value);
+
+  //----------------------------------------------------------------------------
+  //! Get reference to the id of the given name, inserting it with id 0 if
+  //! not present. The reference is valid until the next modification.
+  //----------------------------------------------------------------------------
+  uint64_t& operator[](const std::string& key);
+
+  //----------------------------------------------------------------------------
+  //! Erase entry, return number of erased entries i.e. 0 or 1
+  //----------------------------------------------------------------------------
+  size_t erase(const std::string& key);
+
+  inline void erase(const const_iterator& it)
+  {
+    (void) erase(std::string(it->first));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Find entry with the given name or end()
+  //----------------------------------------------------------------------------
+  const_iterator find(const std::string& key) const;
+
+  inline size_t count(const std::string& key) const
+  {
+    return (find(key) == end() ? 0 : 1);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get iterator to the first entry not less than the given name, allows
+  //! resuming a listing from a given name
+  //----------------------------------------------------------------------------
+  const_iterator lower_bound(const std::string& key) const;
+
+  const_iterator begin() const;
+
+  inline const_iterator end() const
+  {
+    return const_iterator();
+  }
+
+  inline const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  inline const_iterator cend() const
+  {
+    return end();
+  }
+
+  inline size_t size() const
+  {
+    return mSize;
+  }
+
+  inline bool empty() const
+  {
+    return (mSize == 0);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Remove all entries and release the memory
+  //----------------------------------------------------------------------------
+  void clear();
+
+  void swap(ChildMap& other) noexcept;
+
+  //----------------------------------------------------------------------------
+  //! Get value changing with every modification of the map
+  //----------------------------------------------------------------------------
+  inline uint64_t getGeneration() const
+  {
+    return mGeneration;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get approximate number of bytes used by the map
+  //----------------------------------------------------------------------------
+  size_t getMemoryUsage() const;
+
+  //----------------------------------------------------------------------------
+  //! Check if the hash side index is in use
+  //----------------------------------------------------------------------------
+  inline bool hasHashIndex() const
+  {
+    return !mIndex.empty();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if the entries are kept in the sorted chunks rather than in the
+  //! hash map used for small maps
+  //----------------------------------------------------------------------------
+  inline bool isOrdered() const
+  {
+    return !mHash;
+  }
+
+  bool operator==(const ChildMap& other) const;
+
+private:
+  //! Slot of the open addressing hash index, hash 0 marks an empty slot
+  struct IndexSlot {
+    uint32_t mHash;
+    uint32_t mChunkId;
+  };
+
+  std::unique_ptr<HashMap> mHash; ///< Entries of small maps, else nullptr
+  std::vector<std::unique_ptr<Chunk>> mChunks; ///< Chunks sorted by name
+  std::vector<Chunk*> mChunkById; ///< Chunks by id, nullptr for free ids
+  std::vector<uint32_t> mFreeIds; ///< Free chunk ids
+  std::vector<IndexSlot> mIndex; ///< Optional hash index to chunk ids
+  std::string mTail; ///< Largest name in the map
+  size_t mSize {0}; ///< Number of entries
+  uint64_t mGeneration {0}; ///< Modification counter
+
+  //----------------------------------------------------------------------------
+  //! Get position of the chunk that holds or should hold the given name
+  //----------------------------------------------------------------------------
+  size_t findChunk(const std::string& key) const;
+
+  //----------------------------------------------------------------------------
+  //! Locate name, return the chunk and entry index of the first entry not
+  //! less than the given name and whether it is an exact match. The chunk is
+  //! nullptr if there is no such entry.
+  //!
+  //! @param key name to locate
+  //! @param chunk chunk holding the entry
+  //! @param index entry index in the chunk
+  //! @param exact_only if true and the name is not found then the returned
+  //!        position is not computed, only possible with the hash index
+  //! @param name if not null, filled with the name of the entry
+  //! @param offset if not null, filled with the offset of the next entry
+  //----------------------------------------------------------------------------
+  bool locate(const std::string& key, Chunk*& chunk, uint32_t& index,
+              bool exact_only, std::string* name = nullptr,
+              size_t* offset = nullptr) const;
+
+  //----------------------------------------------------------------------------
+  //! Append entry larger than all the existing ones to the chunks
+  //!
+  //! @return chunk holding the new entry as its last one
+  //----------------------------------------------------------------------------
+  Chunk* append(const std::string& key, uint64_t id);
+
+  //----------------------------------------------------------------------------
+  //! Get the entries of the hash map sorted by name
+  //----------------------------------------------------------------------------
+  std::shared_ptr<const SortedEntries> sortedEntries() const;
+
+  //----------------------------------------------------------------------------
+  //! Move the entries from the hash map to the chunks and vice versa
+  //----------------------------------------------------------------------------
+  void toOrdered();
+  void toHash();
+
+  //----------------------------------------------------------------------------
+  //! Release the chunks and the hash index
+  //----------------------------------------------------------------------------
+  void releaseChunks();
+
+  //----------------------------------------------------------------------------
+  //! Insert chunk at the given position and link it with its neighbours
+  //----------------------------------------------------------------------------
+  Chunk* addChunk(size_t pos, std::unique_ptr<Chunk>&& chunk);
+
+  //----------------------------------------------------------------------------
+  //! Remove chunk at the given position and link its neighbours
+  //----------------------------------------------------------------------------
+  void removeChunk(size_t pos);
+
+  //----------------------------------------------------------------------------
+  //! Relink all the chunks, used after copying
+  //----------------------------------------------------------------------------
+  void relinkChunks();
+
+  //----------------------------------------------------------------------------
+  //! Hash index helpers
+  //----------------------------------------------------------------------------
+  static uint32_t hashKey(const std::string& key);
+  void indexInsert(uint32_t hash, const Chunk* chunk);
+  void indexUpdate(uint32_t hash, const Chunk* old_chunk,
+                   const Chunk* new_chunk);
+  void indexErase(uint32_t hash, const Chunk* chunk);
+  void rebuildIndex();
+};
+
+EOSNSNAMESPACE_END
@@ -0,0 +1,659 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Compressed set of file ids partitioned by id range
+//------------------------------------------------------------------------------
+
+#include "namespace/utils/FidBitmap.hh"
+#include <algorithm>
+#include <iterator>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Insert offset
+//------------------------------------------------------------------------------
+bool
+FidBitmap::Chunk::insert(uint16_t low)
+{
+  if (isBitmap()) {
+    uint64_t& word = mBitmap[low >> 6];
+    uint64_t mask = 1ull << (low & 63);
+
+    if (word & mask) {
+      return false;
+    }
+
+    word |= mask;
+    ++mSize;
+    return true;
+  }
+
+  auto it = std::lower_bound(mArray.begin(), mArray.end(), low);
+
+  if ((it != mArray.end()) && (*it == low)) {
+    return false;
+  }
+
+  mArray.insert(it, low);
+  ++mSize;
+
+  if (mSize > kMaxArraySize) {
+    toBitmap();
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Erase offset
+//------------------------------------------------------------------------------
+bool
+FidBitmap::Chunk::erase(uint16_t low)
+{
+  if (isBitmap()) {
+    uint64_t& word = mBitmap[low >> 6];
+    uint64_t mask = 1ull << (low & 63);
+
+    if ((word & mask) == 0) {
+      return false;
+    }
+
+    word &= ~mask;
+    --mSize;
+
+    if (mSize < kMinBitmapSize) {
+      toArray();
+    }
+
+    return true;
+  }
+
+  auto it = std::lower_bound(mArray.begin(), mArray.end(), low);
+
+  if ((it == mArray.end()) || (*it != low)) {
+    return false;
+  }
+
+  mArray.erase(it);
+  --mSize;
+
+  // Give back memory once the array is mostly empty
+  if (mArray.capacity() > 2 * mArray.size() + 16) {
+    mArray.shrink_to_fit();
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Check if offset is present
+//------------------------------------------------------------------------------
+bool
+FidBitmap::Chunk::contains(uint16_t low) const
+{
+  if (isBitmap()) {
+    return (mBitmap[low >> 6] >> (low & 63)) & 1ull;
+  }
+
+  return std::binary_search(mArray.begin(), mArray.end(), low);
+}
+
+//------------------------------------------------------------------------------
+// Get first set bit starting from the given position
+//------------------------------------------------------------------------------
+uint32_t
+FidBitmap::Chunk::nextBit(uint32_t pos) const
+{
+  if (pos >= kChunkSize) {
+    return kEndPos;
+  }
+
+  uint32_t index = pos >> 6;
+  uint64_t word = mBitmap[index] & (~0ull << (pos & 63));
+
+  while (word == 0) {
+    if (++index == kBitmapWords) {
+      return kEndPos;
+    }
+
+    word = mBitmap[index];
+  }
+
+  return (index << 6) + __builtin_ctzll(word);
+}
+
+//------------------------------------------------------------------------------
+// Get offset of the entry with the given rank
+//------------------------------------------------------------------------------
+uint16_t
+FidBitmap::Chunk::select(uint32_t rank) const
+{
+  if (!isBitmap()) {
+    return mArray[rank];
+  }
+
+  for (uint32_t index = 0; index < kBitmapWords; ++index) {
+    uint64_t word = mBitmap[index];
+    uint32_t count = __builtin_popcountll(word);
+
+    if (rank < count) {
+      while (rank--) {
+        word &= word - 1;
+      }
+
+      return (uint16_t)((index << 6) + __builtin_ctzll(word));
+    }
+
+    rank -= count;
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Convert array chunk to bitmap
+//------------------------------------------------------------------------------
+void
+FidBitmap::Chunk::toBitmap()
+{
+  std::vector<uint64_t> bitmap(kBitmapWords, 0ull);
+
+  for (uint16_t low : mArray) {
+    bitmap[low >> 6] |= 1ull << (low & 63);
+  }
+
+  mBitmap.swap(bitmap);
+  std::vector<uint16_t>().swap(mArray);
+}
+
+//------------------------------------------------------------------------------
+// Convert bitmap chunk to array
+//------------------------------------------------------------------------------
+void
+FidBitmap::Chunk::toArray()
+{
+  std::vector<uint16_t> array;
+  array.reserve(mSize);
+
+  for (uint32_t pos = nextBit(0); pos != kEndPos; pos = nextBit(pos + 1)) {
+    array.push_back((uint16_t)pos);
+  }
+
+  mArray.swap(array);
+  std::vector<uint64_t>().swap(mBitmap);
+}
+
+//------------------------------------------------------------------------------
+// Recompute size of bitmap chunk and pick the matching representation
+//------------------------------------------------------------------------------
+void
+FidBitmap::Chunk::normalize()
+{
+  if (isBitmap()) {
+    mSize = 0;
+
+    for (uint64_t word : mBitmap) {
+      mSize += __builtin_popcountll(word);
+    }
+
+    if (mSize <= kMaxArraySize) {
+      toArray();
+    }
+  } else {
+    mSize = mArray.size();
+
+    if (mSize > kMaxArraySize) {
+      toBitmap();
+    } else {
+      mArray.shrink_to_fit();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Union with other chunk
+//------------------------------------------------------------------------------
+void
+FidBitmap::Chunk::unite(const Chunk& other)
+{
+  if (!isBitmap() && !other.isBitmap()) {
+    std::vector<uint16_t> result;
+    result.reserve(mArray.size() + other.mArray.size());
+    std::set_union(mArray.begin(), mArray.end(), other.mArray.begin(),
+                   other.mArray.end(), std::back_inserter(result));
+    mArray.swap(result);
+  } else {
+    if (!isBitmap()) {
+      toBitmap();
+    }
+
+    if (other.isBitmap()) {
+      for (uint32_t i = 0; i < kBitmapWords; ++i) {
+        mBitmap[i] |= other.mBitmap[i];
+      }
+    } else {
+      for (uint16_t low : other.mArray) {
+        mBitmap[low >> 6] |= 1ull << (low & 63);
+      }
+    }
+  }
+
+  normalize();
+}
+
+//------------------------------------------------------------------------------
+// Intersection with other chunk
+//------------------------------------------------------------------------------
+void
+FidBitmap::Chunk::intersect(const Chunk& other)
+{
+  if (isBitmap() && other.isBitmap()) {
+    for (uint32_t i = 0; i < kBitmapWords; ++i) {
+      mBitmap[i] &= other.mBitmap[i];
+    }
+  } else if (isBitmap()) {
+    // Result is at most as large as the other array
+    std::vector<uint16_t> result;
+    result.reserve(other.mArray.size());
+
+    for (uint16_t low : other.mArray) {
+      if (contains(low)) {
+        result.push_back(low);
+      }
+    }
+
+    mArray.swap(result);
+    std::vector<uint64_t>().swap(mBitmap);
+  } else if (other.isBitmap()) {
+    auto last = std::remove_if(mArray.begin(), mArray.end(),
+    [&other](uint16_t low) {
+      return !other.contains(low);
+    });
+    mArray.erase(last, mArray.end());
+  } else {
+    std::vector<uint16_t> result;
+    std::set_intersection(mArray.begin(), mArray.end(), other.mArray.begin(),
+                          other.mArray.end(), std::back_inserter(result));
+    mArray.swap(result);
+  }
+
+  normalize();
+}
+
+//------------------------------------------------------------------------------
+// Difference with other chunk
+//------------------------------------------------------------------------------
+void
+FidBitmap::Chunk::subtract(const Chunk& other)
+{
+  if (isBitmap() && other.isBitmap()) {
+    for (uint32_t i = 0; i < kBitmapWords; ++i) {
+      mBitmap[i] &= ~other.mBitmap[i];
+    }
+  } else if (isBitmap()) {
+    for (uint16_t low : other.mArray) {
+      mBitmap[low >> 6] &= ~(1ull << (low & 63));
+    }
+  } else if (other.isBitmap()) {
+    auto last = std::remove_if(mArray.begin(), mArray.end(),
+    [&other](uint16_t low) {
+      return other.contains(low);
+    });
+    mArray.erase(last, mArray.end());
+  } else {
+    std::vector<uint16_t> result;
+    std::set_difference(mArray.begin(), mArray.end(), other.mArray.begin(),
+                        other.mArray.end(), std::back_inserter(result));
+    mArray.swap(result);
+  }
+
+  normalize();
+}
+
+//------------------------------------------------------------------------------
+// Chunk equality
+//------------------------------------------------------------------------------
+bool
+FidBitmap::Chunk::operator==(const Chunk& other) const
+{
+  if (mSize != other.mSize) {
+    return false;
+  }
+
+  if (isBitmap() == other.isBitmap()) {
+    return (mArray == other.mArray) && (mBitmap == other.mBitmap);
+  }
+
+  const Chunk& array = (isBitmap() ? other : *this);
+  const Chunk& bitmap = (isBitmap() ? *this : other);
+
+  for (uint16_t low : array.mArray) {
+    if (!bitmap.contains(low)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Find chunk with the given key or the position where it should be added
+//------------------------------------------------------------------------------
+FidBitmap::ChunkVector::iterator
+FidBitmap::lowerBound(uint64_t key)
+{
+  return std::lower_bound(mChunks.begin(), mChunks.end(), key,
+  [](const ChunkVector::value_type & elem, uint64_t key) {
+    return elem.first < key;
+  });
+}
+
+FidBitmap::ChunkVector::const_iterator
+FidBitmap::lowerBound(uint64_t key) const
+{
+  return std::lower_bound(mChunks.begin(), mChunks.end(), key,
+  [](const ChunkVector::value_type & elem, uint64_t key) {
+    return elem.first < key;
+  });
+}
+
+//------------------------------------------------------------------------------
+// Insert id
+//------------------------------------------------------------------------------
+bool
+FidBitmap::insert(uint64_t id)
+{
+  uint64_t key = id >> kChunkBits;
+  ChunkVector::iterator it;
+
+  // Fast path for ids arriving in increasing order
+  if (!mChunks.empty() && (mChunks.back().first <= key)) {
+    if (mChunks.back().first == key) {
+      it = std::prev(mChunks.end());
+    } else {
+      mChunks.emplace_back(key, Chunk());
+      rankTreeAppend();
+      it = std::prev(mChunks.end());
+    }
+  } else {
+    it = lowerBound(key);
+
+    if ((it == mChunks.end()) || (it->first != key)) {
+      it = mChunks.emplace(it, key, Chunk());
+      rankTreeRebuild();
+    }
+  }
+
+  if (!it->second.insert((uint16_t)id)) {
+    return false;
+  }
+
+  ++mSize;
+  rankTreeAdd(it - mChunks.begin(), 1);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Erase id
+//------------------------------------------------------------------------------
+size_t
+FidBitmap::erase(uint64_t id)
+{
+  auto it = lowerBound(id >> kChunkBits);
+
+  if ((it == mChunks.end()) || (it->first != (id >> kChunkBits)) ||
+      !it->second.erase((uint16_t)id)) {
+    return 0;
+  }
+
+  --mSize;
+
+  if (it->second.size() == 0) {
+    mChunks.erase(it);
+    rankTreeRebuild();
+  } else {
+    rankTreeAdd(it - mChunks.begin(), -1);
+  }
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+// Get number of occurrences of id
+//------------------------------------------------------------------------------
+size_t
+FidBitmap::count(uint64_t id) const
+{
+  auto it = lowerBound(id >> kChunkBits);
+
+  if ((it == mChunks.end()) || (it->first != (id >> kChunkBits))) {
+    return 0;
+  }
+
+  return (it->second.contains((uint16_t)id) ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------
+// Get id with the given rank
+//------------------------------------------------------------------------------
+uint64_t
+FidBitmap::select(uint64_t rank) const
+{
+  if (rank >= mSize) {
+    return 0;
+  }
+
+  // Descend the rank tree looking for the last chunk position whose prefix
+  // sum is not above the rank
+  size_t pos = 0;
+  size_t step = 1;
+
+  while ((step << 1) <= mRankTree.size()) {
+    step <<= 1;
+  }
+
+  for (; step; step >>= 1) {
+    if ((pos + step <= mRankTree.size()) &&
+        (mRankTree[pos + step - 1] <= rank)) {
+      pos += step;
+      rank -= mRankTree[pos - 1];
+    }
+  }
+
+  const auto& elem = mChunks[pos];
+  return (elem.first << kChunkBits) | elem.second.select((uint32_t)rank);
+}
+
+//------------------------------------------------------------------------------
+// Drop empty chunks and recompute the size counters
+//------------------------------------------------------------------------------
+void
+FidBitmap::compact()
+{
+  mChunks.erase(std::remove_if(mChunks.begin(), mChunks.end(),
+  [](const ChunkVector::value_type & elem) {
+    return (elem.second.size() == 0);
+  }), mChunks.end());
+  mSize = 0;
+
+  for (const auto& elem : mChunks) {
+    mSize += elem.second.size();
+  }
+
+  rankTreeRebuild();
+}
+
+//------------------------------------------------------------------------------
+// Add delta to the size of the chunk at the given position in the rank tree
+//------------------------------------------------------------------------------
+void
+FidBitmap::rankTreeAdd(size_t pos, int64_t delta)
+{
+  for (size_t i = pos + 1; i <= mRankTree.size(); i += (i & (~i + 1))) {
+    mRankTree[i - 1] += delta;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get total size of the first count chunks from the rank tree
+//------------------------------------------------------------------------------
+uint64_t
+FidBitmap::rankTreePrefix(size_t count) const
+{
+  uint64_t sum = 0;
+
+  for (size_t i = count; i > 0; i -= (i & (~i + 1))) {
+    sum += mRankTree[i - 1];
+  }
+
+  return sum;
+}
+
+//------------------------------------------------------------------------------
+// Add an empty chunk appended at the end to the rank tree
+//------------------------------------------------------------------------------
+void
+FidBitmap::rankTreeAppend()
+{
+  // The new node covers the chunks (i - lowbit(i), i] and the last one is
+  // still empty
+  const size_t i = mRankTree.size() + 1;
+  mRankTree.push_back(rankTreePrefix(i - 1) - rankTreePrefix(i - (i & (~i + 1))));
+}
+
+//------------------------------------------------------------------------------
+// Rebuild the rank tree
+//------------------------------------------------------------------------------
+void
+FidBitmap::rankTreeRebuild()
+{
+  mRankTree.resize(mChunks.size());
+
+  for (size_t i = 0; i < mChunks.size(); ++i) {
+    mRankTree[i] = mChunks[i].second.size();
+  }
+
+  for (size_t i = 1; i <= mRankTree.size(); ++i) {
+    const size_t parent = i + (i & (~i + 1));
+
+    if (parent <= mRankTree.size()) {
+      mRankTree[parent - 1] += mRankTree[i - 1];
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Union
+//------------------------------------------------------------------------------
+FidBitmap&
+FidBitmap::operator|=(const FidBitmap& other)
+{
+  if (this == &other) {
+    return *this;
+  }
+
+  ChunkVector result;
+  result.reserve(mChunks.size() + other.mChunks.size());
+  auto it = mChunks.begin();
+  auto it_other = other.mChunks.begin();
+
+  while ((it != mChunks.end()) || (it_other != other.mChunks.end())) {
+    if ((it_other == other.mChunks.end()) ||
+        ((it != mChunks.end()) && (it->first < it_other->first))) {
+      result.push_back(std::move(*it++));
+    } else if ((it == mChunks.end()) || (it_other->first < it->first)) {
+      result.push_back(*it_other++);
+    } else {
+      it->second.unite(it_other->second);
+      result.push_back(std::move(*it++));
+      ++it_other;
+    }
+  }
+
+  mChunks.swap(result);
+  compact();
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// Intersection
+//------------------------------------------------------------------------------
+FidBitmap&
+FidBitmap::operator&=(const FidBitmap& other)
+{
+  if (this == &other) {
+    return *this;
+  }
+
+  for (auto& elem : mChunks) {
+    auto it_other = other.lowerBound(elem.first);
+
+    if ((it_other == other.mChunks.end()) || (it_other->first != elem.first)) {
+      elem.second = Chunk();
+    } else {
+      elem.second.intersect(it_other->second);
+    }
+  }
+
+  compact();
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// Difference
+//------------------------------------------------------------------------------
+FidBitmap&
+FidBitmap::operator-=(const FidBitmap& other)
+{
+  if (this == &other) {
+    clear();
+    return *this;
+  }
+
+  for (auto& elem : mChunks) {
+    auto it_other = other.lowerBound(elem.first);
+
+    if ((it_other != other.mChunks.end()) && (it_other->first == elem.first)) {
+      elem.second.subtract(it_other->second);
+    }
+  }
+
+  compact();
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// Get approximate number of bytes used by the set
+//------------------------------------------------------------------------------
+size_t
+FidBitmap::getMemoryUsage() const
+{
+  size_t total = sizeof(*this) +
+                 mChunks.capacity() * sizeof(ChunkVector::value_type) +
+                 mRankTree.capacity() * sizeof(uint64_t);
+
+  for (const auto& elem : mChunks) {
+    total += elem.second.getMemoryUsage();
+  }
+
+  return total;
+}
+
+EOSNSNAMESPACE_END
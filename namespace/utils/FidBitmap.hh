@@ -0,0 +1,376 @@
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+//! @brief Compressed set of file ids partitioned by id range
+//------------------------------------------------------------------------------
+
+#pragma once
+#include "namespace/Namespace.hh"
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+EOSNSNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Roaring-style compressed set of 64-bit file ids. The id space is split in
+//! chunks of 2^16 consecutive ids keyed by the high bits of the id. A chunk
+//! holding few ids stores them as a sorted array of 16-bit offsets, while a
+//! dense chunk switches to a fixed 8KB bitmap. File ids on a file system are
+//! allocated from a monotonic counter so they cluster in a limited number of
+//! chunks and the memory footprint is typically 1-4 bytes per id compared to
+//! more than 16 bytes per id for a hash set.
+//!
+//! The chunks are kept in a sorted vector. New ids are mostly larger than
+//! all the existing ones and the backend returns the ids of a set in order,
+//! so new chunks are usually appended at the end.
+//!
+//! Iteration is in increasing id order. Any modification of the set
+//! invalidates the existing iterators. The object is not thread-safe.
+//------------------------------------------------------------------------------
+class FidBitmap
+{
+public:
+  using value_type = uint64_t;
+  static constexpr uint32_t kChunkBits = 16;
+  static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+  //! Max number of entries held in array form, above it a chunk becomes a
+  //! bitmap which has the same size as an array of 4096 entries
+  static constexpr uint32_t kMaxArraySize = 4096;
+  //! Bitmap chunks shrinking below this size are converted back to arrays,
+  //! the gap avoids flipping representation on alternating insert/erase
+  static constexpr uint32_t kMinBitmapSize = kMaxArraySize / 2;
+  static constexpr uint32_t kBitmapWords = kChunkSize / 64;
+
+  //----------------------------------------------------------------------------
+  //! Set of ids sharing the same high bits
+  //----------------------------------------------------------------------------
+  class Chunk
+  {
+  public:
+    //! Position returned when there are no more entries in the chunk
+    static constexpr uint32_t kEndPos = UINT32_MAX;
+
+    //--------------------------------------------------------------------------
+    //! Insert offset, return true if it was not already present
+    //--------------------------------------------------------------------------
+    bool insert(uint16_t low);
+
+    //--------------------------------------------------------------------------
+    //! Erase offset, return true if it was present
+    //--------------------------------------------------------------------------
+    bool erase(uint16_t low);
+
+    //--------------------------------------------------------------------------
+    //! Check if offset is present
+    //--------------------------------------------------------------------------
+    bool contains(uint16_t low) const;
+
+    //--------------------------------------------------------------------------
+    //! Get number of entries
+    //--------------------------------------------------------------------------
+    inline uint32_t size() const
+    {
+      return mSize;
+    }
+
+    //--------------------------------------------------------------------------
+    //! Check if chunk uses the bitmap representation
+    //--------------------------------------------------------------------------
+    inline bool isBitmap() const
+    {
+      return !mBitmap.empty();
+    }
+
+    //--------------------------------------------------------------------------
+    //! Iteration helpers - positions are array indices for array chunks and
+    //! bit numbers for bitmap chunks
+    //--------------------------------------------------------------------------
+    inline uint32_t first() const
+    {
+      return isBitmap() ? nextBit(0) : (mArray.empty() ? kEndPos : 0);
+    }
+
+    inline uint32_t next(uint32_t pos) const
+    {
+      if (isBitmap()) {
+        return nextBit(pos + 1);
+      }
+
+      return (pos + 1 < mArray.size()) ? pos + 1 : kEndPos;
+    }
+
+    inline uint16_t value(uint32_t pos) const
+    {
+      return isBitmap() ? (uint16_t)pos : mArray[pos];
+    }
+
+    //--------------------------------------------------------------------------
+    //! Get offset of the entry with the given rank, rank must be < size()
+    //--------------------------------------------------------------------------
+    uint16_t select(uint32_t rank) const;
+
+    //--------------------------------------------------------------------------
+    //! Set algebra - the current chunk is replaced by the result
+    //--------------------------------------------------------------------------
+    void unite(const Chunk& other);
+    void intersect(const Chunk& other);
+    void subtract(const Chunk& other);
+
+    //--------------------------------------------------------------------------
+    //! Get number of bytes used by the chunk payload
+    //--------------------------------------------------------------------------
+    inline size_t getMemoryUsage() const
+    {
+      return mArray.capacity() * sizeof(uint16_t) +
+             mBitmap.capacity() * sizeof(uint64_t);
+    }
+
+    bool operator==(const Chunk& other) const;
+
+  private:
+    std::vector<uint16_t> mArray; ///< Sorted offsets for sparse chunks
+    std::vector<uint64_t> mBitmap; ///< Bitmap for dense chunks
+    uint32_t mSize {0}; ///< Number of entries
+
+    //--------------------------------------------------------------------------
+    //! Get first set bit starting from the given position or kEndPos
+    //--------------------------------------------------------------------------
+    uint32_t nextBit(uint32_t pos) const;
+
+    //--------------------------------------------------------------------------
+    //! Pick the representation matching the current number of entries
+    //--------------------------------------------------------------------------
+    void toBitmap();
+    void toArray();
+    void normalize();
+  };
+
+  using ChunkVector = std::vector<std::pair<uint64_t, Chunk>>;
+
+  //----------------------------------------------------------------------------
+  //! Forward iterator over the ids in increasing order
+  //----------------------------------------------------------------------------
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const uint64_t*;
+    using reference = uint64_t;
+
+    const_iterator() = default;
+
+    const_iterator(ChunkVector::const_iterator it, ChunkVector::const_iterator end):
+      mIt(it), mEnd(end)
+    {
+      if (mIt != mEnd) {
+        mPos = mIt->second.first();
+      }
+    }
+
+    inline uint64_t operator*() const
+    {
+      return (mIt->first << kChunkBits) | mIt->second.value(mPos);
+    }
+
+    inline const_iterator& operator++()
+    {
+      mPos = mIt->second.next(mPos);
+
+      if (mPos == Chunk::kEndPos) {
+        ++mIt;
+        mPos = ((mIt != mEnd) ? mIt->second.first() : 0);
+      }
+
+      return *this;
+    }
+
+    inline const_iterator operator++(int)
+    {
+      const_iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    inline bool operator==(const const_iterator& other) const
+    {
+      return (mIt == other.mIt) && (mPos == other.mPos);
+    }
+
+    inline bool operator!=(const const_iterator& other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    ChunkVector::const_iterator mIt;
+    ChunkVector::const_iterator mEnd;
+    uint32_t mPos {0};
+  };
+
+  using iterator = const_iterator;
+
+  //----------------------------------------------------------------------------
+  //! Insert id, return true if it was not already present
+  //----------------------------------------------------------------------------
+  bool insert(uint64_t id);
+
+  //----------------------------------------------------------------------------
+  //! Erase id, return number of erased entries i.e. 0 or 1
+  //----------------------------------------------------------------------------
+  size_t erase(uint64_t id);
+
+  //----------------------------------------------------------------------------
+  //! Get number of occurrences of id i.e. 0 or 1
+  //----------------------------------------------------------------------------
+  size_t count(uint64_t id) const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of ids in the set
+  //----------------------------------------------------------------------------
+  inline uint64_t size() const
+  {
+    return mSize;
+  }
+
+  inline bool empty() const
+  {
+    return (mSize == 0);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Remove all ids and release the memory
+  //----------------------------------------------------------------------------
+  inline void clear()
+  {
+    ChunkVector().swap(mChunks);
+    std::vector<uint64_t>().swap(mRankTree);
+    mSize = 0;
+  }
+
+  inline void swap(FidBitmap& other)
+  {
+    mChunks.swap(other.mChunks);
+    std::swap(mSize, other.mSize);
+    mRankTree.swap(other.mRankTree);
+  }
+
+  inline const_iterator begin() const
+  {
+    return const_iterator(mChunks.cbegin(), mChunks.cend());
+  }
+
+  inline const_iterator end() const
+  {
+    return const_iterator(mChunks.cend(), mChunks.cend());
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get id with the given rank in increasing order, rank must be < size().
+  //! The chunk is found in logarithmic time using the prefix sums of the
+  //! chunk sizes.
+  //----------------------------------------------------------------------------
+  uint64_t select(uint64_t rank) const;
+
+  //----------------------------------------------------------------------------
+  //! Get a uniformly distributed random id, the set must not be empty
+  //!
+  //! @param random function returning a random number in the range [0, max)
+  //!        for the given max value
+  //----------------------------------------------------------------------------
+  template <typename RandomFunc>
+  uint64_t pickRandom(RandomFunc&& random) const
+  {
+    return select(random(mSize));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Set algebra, used for example to compare the file lists of different
+  //! file systems or the namespace view against the disk contents
+  //----------------------------------------------------------------------------
+  FidBitmap& operator|=(const FidBitmap& other);
+  FidBitmap& operator&=(const FidBitmap& other);
+  FidBitmap& operator-=(const FidBitmap& other);
+
+  bool operator==(const FidBitmap& other) const
+  {
+    return (mSize == other.mSize) && (mChunks == other.mChunks);
+  }
+
+  bool operator!=(const FidBitmap& other) const
+  {
+    return !(*this == other);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get approximate number of bytes used by the set
+  //----------------------------------------------------------------------------
+  size_t getMemoryUsage() const;
+
+  //----------------------------------------------------------------------------
+  //! Get number of chunks
+  //----------------------------------------------------------------------------
+  inline size_t getNumChunks() const
+  {
+    return mChunks.size();
+  }
+
+private:
+  ChunkVector mChunks; ///< Chunks sorted by the high bits of the id
+  uint64_t mSize {0}; ///< Total number of ids
+  //! Fenwick tree over the chunk sizes giving the number of ids before each
+  //! chunk in logarithmic time, kept up to date by all the modifications
+  std::vector<uint64_t> mRankTree;
+
+  //----------------------------------------------------------------------------
+  //! Find chunk with the given key or the position where it should be added
+  //----------------------------------------------------------------------------
+  ChunkVector::iterator lowerBound(uint64_t key);
+  ChunkVector::const_iterator lowerBound(uint64_t key) const;
+
+  //----------------------------------------------------------------------------
+  //! Drop empty chunks and recompute the size counters
+  //----------------------------------------------------------------------------
+  void compact();
+
+  //----------------------------------------------------------------------------
+  //! Add delta to the size of the chunk at the given position in the rank tree
+  //----------------------------------------------------------------------------
+  void rankTreeAdd(size_t pos, int64_t delta);
+
+  //----------------------------------------------------------------------------
+  //! Get total size of the first count chunks from the rank tree
+  //----------------------------------------------------------------------------
+  uint64_t rankTreePrefix(size_t count) const;
+
+  //----------------------------------------------------------------------------
+  //! Add an empty chunk appended at the end to the rank tree
+  //----------------------------------------------------------------------------
+  void rankTreeAppend();
+
+  //----------------------------------------------------------------------------
+  //! Rebuild the rank tree after chunks were added or removed in the middle
+  //----------------------------------------------------------------------------
+  void rankTreeRebuild();
+};
+
+EOSNSNAMESPACE_END
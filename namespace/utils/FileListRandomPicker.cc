@@ -33,17 +33,10 @@ bool pickRandomFile(const IFsView::FileList &filelist, eos::IFileMD::id_t &retva
     return false;
   }
 
-
-  while(true) {
-    eos::IFileMD::id_t randomPosition = eos::common::getRandom<uint64_t>(0, filelist.bucket_count() - 1);
-
-    // Is there an element at that location on the table?
-    auto it = filelist.begin(randomPosition);
-    if(it != filelist.end(randomPosition)) {
-      retval = *it;
-      return true;
-    }
-  }
+  retval = filelist.pickRandom([](uint64_t max) {
+    return eos::common::getRandom<uint64_t>(0, max - 1);
+  });
+  return true;
 }
 
 EOSNSNAMESPACE_END
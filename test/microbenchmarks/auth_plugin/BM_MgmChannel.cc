@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+// File: BM_MgmChannel.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "auth_plugin/MgmChannel.hh"
+#include "common/ConcurrentQueue.hh"
+#include "benchmark/benchmark.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// MGM stand-in with the same layout as XrdMgmOfs::AuthMasterThread: a ROUTER
+// facing the auth plugins proxied to REP workers which echo the requests
+// after some processing time
+//------------------------------------------------------------------------------
+class MgmStandIn
+{
+public:
+  MgmStandIn(int num_workers, std::chrono::microseconds service_time):
+    mCtx(1), mFrontend(mCtx, ZMQ_ROUTER), mBackend(mCtx, ZMQ_DEALER)
+  {
+    mFrontend.bind("tcp://127.0.0.1:*");
+    mEndpoint = mFrontend.get(zmq::sockopt::last_endpoint);
+    mBackend.bind("inproc://authbackend");
+    mProxy = std::thread([this] {
+      try {
+        zmq::proxy(mFrontend, mBackend);
+      } catch (const zmq::error_t& e) {}
+    });
+
+    for (int i = 0; i < num_workers; ++i) {
+      mWorkers.emplace_back([this, service_time] {
+        try {
+          zmq::socket_t responder(mCtx, ZMQ_REP);
+          responder.connect("inproc://authbackend");
+
+          while (true) {
+            zmq::message_t request;
+            (void) responder.recv(request, zmq::recv_flags::none);
+
+            if (service_time.count()) {
+              std::this_thread::sleep_for(service_time);
+            }
+
+            responder.send(request, zmq::send_flags::none);
+          }
+        } catch (const zmq::error_t& e) {}
+      });
+    }
+  }
+
+  ~MgmStandIn()
+  {
+    mFrontend.close();
+    mBackend.close();
+    mCtx.shutdown();
+
+    for (auto& worker : mWorkers) {
+      worker.join();
+    }
+
+    mProxy.join();
+  }
+
+  const std::string& GetEndpoint() const
+  {
+    return mEndpoint;
+  }
+
+private:
+  zmq::context_t mCtx;
+  zmq::socket_t mFrontend;
+  zmq::socket_t mBackend;
+  std::string mEndpoint;
+  std::thread mProxy;
+  std::vector<std::thread> mWorkers;
+};
+
+static std::unique_ptr<MgmStandIn> sMgm;
+static std::unique_ptr<zmq::context_t> sCtx;
+static std::unique_ptr<eos::auth::MgmChannel> sChannel;
+static eos::common::ConcurrentQueue<zmq::socket_t*> sPoolSocket;
+static const std::string sRequest(256, 'r');
+
+//------------------------------------------------------------------------------
+// Previous model: a pool of REQ sockets, each blocked for a full round trip.
+// Arg 0 is the service time of the MGM in microseconds, 5 sockets as the
+// default eosauth.numsockets.
+//------------------------------------------------------------------------------
+static void BM_ReqSocketPool(benchmark::State& state)
+{
+  const int pool_size = 5;
+
+  if (state.thread_index() == 0) {
+    sMgm.reset(new MgmStandIn(64, std::chrono::microseconds(state.range(0))));
+    sCtx.reset(new zmq::context_t(1));
+
+    for (int i = 0; i < pool_size; ++i) {
+      zmq::socket_t* socket = new zmq::socket_t(*sCtx, ZMQ_REQ);
+      socket->connect(sMgm->GetEndpoint());
+      sPoolSocket.push(socket);
+    }
+  }
+
+  for (auto _ : state) {
+    zmq::socket_t* socket;
+    sPoolSocket.wait_pop(socket);
+    zmq::message_t request(sRequest.data(), sRequest.size());
+    zmq::message_t reply;
+    socket->send(request, zmq::send_flags::none);
+    (void) socket->recv(reply, zmq::recv_flags::none);
+    sPoolSocket.push(socket);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    zmq::socket_t* socket;
+
+    while (sPoolSocket.try_pop(socket)) {
+      delete socket;
+    }
+
+    sCtx.reset();
+    sMgm.reset();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Requests multiplexed over the MgmChannel used by EosAuthOfs
+//------------------------------------------------------------------------------
+static void BM_MgmChannel(benchmark::State& state)
+{
+  if (state.thread_index() == 0) {
+    sMgm.reset(new MgmStandIn(64, std::chrono::microseconds(state.range(0))));
+    sCtx.reset(new zmq::context_t(1));
+    sChannel.reset(new eos::auth::MgmChannel(*sCtx, sMgm->GetEndpoint()));
+    sChannel->Start();
+  }
+
+  for (auto _ : state) {
+    uint64_t id;
+    std::string response;
+
+    if (!sChannel->Send(sRequest, id) ||
+        !sChannel->GetResponse(id, response, std::chrono::seconds(60))) {
+      state.SkipWithError("request failed");
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    sChannel.reset();
+    sCtx.reset();
+    sMgm.reset();
+  }
+}
+
+BENCHMARK(BM_ReqSocketPool)->Arg(0)->Arg(100)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_MgmChannel)->Arg(0)->Arg(100)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -22,6 +22,7 @@
  ************************************************************************/
 
 #include "common/Mapping.hh"
+#include "common/token/EosTok.hh"
 #include <XrdSec/XrdSecEntity.hh>
 #include "benchmark/benchmark.h"
 #include <sstream>
@@ -81,6 +82,102 @@ static void BM_IdMap(benchmark::State& state)
   }
 }
 
+//------------------------------------------------------------------------------
+// Mapping of requests carrying the same EOS token, as sent by batch clients.
+// With argument 0 the token cache is emptied before every request, which
+// gives the cost of decoding and verifying the token each time.
+//------------------------------------------------------------------------------
+static void BM_IdMapToken(benchmark::State& state)
+{
+  using namespace eos::common;
+  const bool use_cache = state.range(0);
+
+  if (state.thread_index() == 0) {
+    eos::common::Mapping::Reset();
+    eos::common::Mapping::Init();
+    eos::common::Mapping::gVirtualUidMap["sss:\"<pwd>\":uid"] = 0;
+    eos::common::Mapping::gVirtualGidMap["sss:\"<pwd>\":gid"] = 0;
+  }
+
+  // Default key used by IdMap when no sss key is loaded
+  EosTok token;
+  token.SetPath("/eos/test/", true);
+  token.SetPermission("rwx");
+  token.SetOwner("nobody");
+  token.SetExpires(time(NULL) + 3600);
+  token.SetGeneration(EosTok::sTokenGeneration);
+  const std::string env = "authz=" + token.Write("0123457890defaultkey");
+  XrdSecEntity client("sss");
+  std::string client_name = "client";
+  client.name = client_name.data();
+  client.tident = "batch.1:1@host";
+
+  for (auto _ : state) {
+    if (!use_cache) {
+      state.PauseTiming();
+      eos::common::Mapping::gShardedTokenCache.clear();
+      state.ResumeTiming();
+    }
+
+    eos::common::VirtualIdentity vid;
+    eos::common::Mapping::IdMap(&client, env.c_str(), client.tident, vid,
+                                nullptr, AOP_Stat, "", false);
+    benchmark::DoNotOptimize(vid);
+  }
+
+  state.counters["frequency"] = Counter(state.iterations(),
+                                        benchmark::Counter::kIsRate);
+
+  if (state.thread_index() == 0) {
+    eos::common::Mapping::Reset();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Mapping of the requests of a few long lived connections, as seen from FUSE
+// mounts or batch nodes. With argument 0 the identity cache is disabled and
+// every request goes through the mapping rules.
+//------------------------------------------------------------------------------
+static void BM_IdMapCached(benchmark::State& state)
+{
+  using namespace eos::common;
+  const bool use_cache = state.range(0);
+
+  if (state.thread_index() == 0) {
+    eos::common::Mapping::Reset();
+    eos::common::Mapping::Init();
+    eos::common::Mapping::gIdentityCache = use_cache;
+    eos::common::Mapping::gVirtualUidMap["sss:\"<pwd>\":uid"] = 0;
+    eos::common::Mapping::gVirtualGidMap["sss:\"<pwd>\":gid"] = 0;
+    ++eos::common::Mapping::gMapGeneration;
+  }
+
+  std::stringstream tident_ss;
+  tident_ss << "fuse.1:" << state.thread_index() << "@host";
+  std::string tident = tident_ss.str();
+  XrdSecEntity client("sss");
+  std::string client_name = "client";
+  client.name = client_name.data();
+  client.tident = tident.c_str();
+
+  for (auto _ : state) {
+    eos::common::VirtualIdentity vid;
+    eos::common::Mapping::IdMap(&client, nullptr, client.tident, vid,
+                                nullptr, AOP_Stat, "", false);
+    benchmark::DoNotOptimize(vid);
+  }
+
+  client.name = nullptr;
+  client.tident = nullptr;
+  state.counters["frequency"] = Counter(state.iterations(),
+                                        benchmark::Counter::kIsRate);
+
+  if (state.thread_index() == 0) {
+    eos::common::Mapping::gIdentityCache = true;
+    eos::common::Mapping::Reset();
+  }
+}
+
 static void BM_ReduceTident(benchmark::State& state)
 {
   for (auto _ : state) {
@@ -118,6 +215,10 @@ BENCHMARK(BM_IdMap)
 ->Range(1 << 10, 1 << 20)->ThreadRange(1, 128)->UseRealTime()
 ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK(BM_IdMapToken)->Arg(0)->Arg(1)->ThreadRange(1, 16)->UseRealTime()
+->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IdMapCached)->Arg(0)->Arg(1)->ThreadRange(1, 16)->UseRealTime()
+->Unit(benchmark::kMicrosecond);
 BENCHMARK(BM_ReduceTident)->Range(1, 1 << 20);
 BENCHMARK(BM_ReduceTidentXrd)->Range(1, 1 << 20);
 BENCHMARK_MAIN();
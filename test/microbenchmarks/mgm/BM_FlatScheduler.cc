@@ -25,6 +25,8 @@
 #include "mgm/placement/PlacementStrategy.hh"
 #include "mgm/placement/ClusterMap.hh"
 #include "mgm/placement/FlatScheduler.hh"
+#include <algorithm>
+#include <cmath>
 
 
 static void BM_Scheduler(benchmark::State& state) {
@@ -239,6 +241,205 @@ static void BM_WeightedRRScheduler(benchmark::State& state) {
 }
 
 
+// Place a batch of files one schedule() call at a time, baseline for
+// BM_ScheduleBatch
+static void BM_ScheduleLoop(benchmark::State& state) {
+  using namespace eos::mgm::placement;
+  auto n_groups = state.range(0);
+  auto batch_size = state.range(1);
+  auto n_elements = 1024;
+  const int n_disks_per_group = 16;
+  ClusterMgr mgr;
+  {
+
+    auto sh = mgr.getStorageHandler(n_elements);
+    sh.addBucket(get_bucket_type(StdBucketType::ROOT), 0);
+
+    for (int i=0; i< n_groups; ++i) {
+      sh.addBucket(get_bucket_type(StdBucketType::GROUP), -100-i, 0);
+    }
+
+    for (int i=0; i < n_groups*n_disks_per_group; i++) {
+      sh.addDisk(Disk(i+1, ConfigStatus::kRW, ActiveStatus::kOnline, 1),
+                 -100 - i/n_disks_per_group);
+    }
+
+  }
+  FlatScheduler flat_scheduler(PlacementStrategyT::kRoundRobin, n_elements);
+
+  for (auto _: state) {
+    auto cluster_data_ptr = mgr.getClusterData();
+    for (int i=0; i < batch_size; ++i) {
+      benchmark::DoNotOptimize(flat_scheduler.schedule(cluster_data_ptr(), 2));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+static void BM_ScheduleBatch(benchmark::State& state) {
+  using namespace eos::mgm::placement;
+  auto n_groups = state.range(0);
+  auto batch_size = state.range(1);
+  auto n_elements = 1024;
+  const int n_disks_per_group = 16;
+  ClusterMgr mgr;
+  {
+
+    auto sh = mgr.getStorageHandler(n_elements);
+    sh.addBucket(get_bucket_type(StdBucketType::ROOT), 0);
+
+    for (int i=0; i< n_groups; ++i) {
+      sh.addBucket(get_bucket_type(StdBucketType::GROUP), -100-i, 0);
+    }
+
+    for (int i=0; i < n_groups*n_disks_per_group; i++) {
+      sh.addDisk(Disk(i+1, ConfigStatus::kRW, ActiveStatus::kOnline, 1),
+                 -100 - i/n_disks_per_group);
+    }
+
+  }
+  FlatScheduler flat_scheduler(PlacementStrategyT::kRoundRobin, n_elements);
+
+  for (auto _: state) {
+    auto cluster_data_ptr = mgr.getClusterData();
+    benchmark::DoNotOptimize(flat_scheduler.scheduleBatch(cluster_data_ptr(),
+                                                          2, batch_size));
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+static void BM_LoadAwareScheduler(benchmark::State& state) {
+  using namespace eos::mgm::placement;
+  auto n_groups = state.range(0);
+  auto n_elements = 1024;
+  const int n_disks_per_group = 16;
+  ClusterMgr mgr;
+  {
+
+    auto sh = mgr.getStorageHandler(n_elements);
+    sh.addBucket(get_bucket_type(StdBucketType::ROOT), 0);
+
+    for (int i=0; i< n_groups; ++i) {
+      sh.addBucket(get_bucket_type(StdBucketType::GROUP), -100-i, 0);
+    }
+
+    for (int i=0; i < n_groups*n_disks_per_group; i++) {
+      sh.addDisk(Disk(i+1, ConfigStatus::kRW, ActiveStatus::kOnline, 1),
+                 -100 - i/n_disks_per_group);
+    }
+
+  }
+
+  for (int i=0; i < n_groups*n_disks_per_group; i++) {
+    mgr.setDiskLoad(i+1, (i % 10) / 10.0, 0.0, i % 100);
+  }
+
+  FlatScheduler flat_scheduler(PlacementStrategyT::kLoadAware, n_elements);
+  PlacementArguments args(state.range(1));
+  for (auto _: state) {
+    auto cluster_data_ptr = mgr.getClusterData();
+    benchmark::DoNotOptimize(flat_scheduler.schedule(cluster_data_ptr(), args));
+  }
+  state.counters["frequency"] = benchmark::Counter(state.iterations(),
+                                                   benchmark::Counter::kIsRate);
+}
+
+// Simulate a cluster where a quarter of the disks are 4 times slower than the
+// rest. Every iteration is one time unit in which files with 2 replicas are
+// placed at 80% of the cluster throughput and every disk serves its queue at
+// its own rate. The disk load is published every 10 time units as the FSTs do
+// with their heartbeats. The reported counters are the quantiles of the file
+// write latency in time units, a file being done when both replicas are.
+static void BM_PlacementSimulation(benchmark::State& state) {
+  using namespace eos::mgm::placement;
+  auto strategy = static_cast<PlacementStrategyT>(state.range(0));
+  const int n_groups = 8;
+  const int n_disks_per_group = 16;
+  const int n_disks = n_groups * n_disks_per_group;
+  const int publish_interval = 10;
+  const double utilisation = 0.8;
+  ClusterMgr mgr;
+  {
+    auto sh = mgr.getStorageHandler(1024);
+    sh.addBucket(get_bucket_type(StdBucketType::ROOT), 0);
+
+    for (int i=0; i< n_groups; ++i) {
+      sh.addBucket(get_bucket_type(StdBucketType::GROUP), -100-i, 0);
+    }
+
+    for (int i=0; i < n_disks; i++) {
+      sh.addDisk(Disk(i+1, ConfigStatus::kRW, ActiveStatus::kOnline, 1),
+                 -100 - i/n_disks_per_group);
+    }
+  }
+
+  std::vector<double> rate(n_disks);
+  std::vector<double> backlog(n_disks, 0);
+  std::vector<double> busy(n_disks, 0);
+  double total_rate = 0;
+
+  for (int i=0; i < n_disks; i++) {
+    rate[i] = (i % 4 == 3) ? 0.25 : 1.0;
+    total_rate += rate[i];
+  }
+
+  const double files_per_tick = utilisation * total_rate / 2;
+  FlatScheduler flat_scheduler(strategy, 1024);
+  PlacementArguments args(2, ConfigStatus::kRW, strategy);
+  std::vector<double> latencies;
+  double pending_files = 0;
+  int64_t tick = 0;
+
+  for (auto _: state) {
+    auto cluster_data_ptr = mgr.getClusterData();
+
+    for (pending_files += files_per_tick; pending_files >= 1; --pending_files) {
+      auto result = flat_scheduler.schedule(cluster_data_ptr(), args);
+
+      if (!result) {
+        state.SkipWithError(result.error_string().c_str());
+        return;
+      }
+
+      double latency = 0;
+
+      for (int i=0; i < 2; ++i) {
+        auto index = result.ids[i] - 1;
+        backlog[index] += 1;
+        latency = std::max(latency, backlog[index] / rate[index]);
+      }
+
+      latencies.push_back(latency);
+    }
+
+    for (int i=0; i < n_disks; i++) {
+      busy[i] += std::min(backlog[i] / rate[i], 1.0);
+      backlog[i] = std::max(backlog[i] - rate[i], 0.0);
+    }
+
+    if (++tick % publish_interval == 0) {
+      for (int i=0; i < n_disks; i++) {
+        mgr.setDiskLoad(i+1, busy[i] / publish_interval, 0.0,
+                        std::ceil(backlog[i]));
+        busy[i] = 0;
+      }
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto quantile = [&latencies](double q) {
+    return latencies.empty() ? 0 :
+           latencies[std::min(latencies.size() - 1,
+                              (size_t)(q * latencies.size()))];
+  };
+  state.SetLabel(strategy_to_str(strategy));
+  state.counters["p50"] = quantile(0.5);
+  state.counters["p99"] = quantile(0.99);
+  state.counters["p999"] = quantile(0.999);
+  state.SetItemsProcessed(latencies.size());
+}
+
+
 
 
 BENCHMARK(BM_Scheduler)->Threads(1)->Threads(8)->Threads(64)->Threads(128)->Threads(256)
@@ -265,5 +466,22 @@ BENCHMARK(BM_WeightedRRScheduler)->Threads(1)->Threads(8)->Threads(64)->Threads(
 ->ArgsProduct({{32, 64, 128, 256, 512},
                {2,3,6}})->UseRealTime();
 
+BENCHMARK(BM_ScheduleLoop)->Threads(1)->Threads(8)
+->ArgsProduct({{32, 512},
+               {1, 10, 100, 1000, 10000}})->UseRealTime();
+
+BENCHMARK(BM_ScheduleBatch)->Threads(1)->Threads(8)
+->ArgsProduct({{32, 512},
+               {1, 10, 100, 1000, 10000}})->UseRealTime();
+
+BENCHMARK(BM_LoadAwareScheduler)->Threads(1)->Threads(8)->Threads(64)
+->ArgsProduct({{32, 64, 128, 256, 512},
+               {2,3,6}})->UseRealTime();
+
+BENCHMARK(BM_PlacementSimulation)->Iterations(20000)
+->Arg(static_cast<int>(eos::mgm::placement::PlacementStrategyT::kRandom))
+->Arg(static_cast<int>(eos::mgm::placement::PlacementStrategyT::kRoundRobin))
+->Arg(static_cast<int>(eos::mgm::placement::PlacementStrategyT::kWeightedRandom))
+->Arg(static_cast<int>(eos::mgm::placement::PlacementStrategyT::kLoadAware));
 
 BENCHMARK_MAIN();
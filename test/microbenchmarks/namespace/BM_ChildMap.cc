@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+// File: BM_ChildMap.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// Compare the container children map representations: memory footprint and
+// load time, lookup and a sorted listing as done for a directory listing.
+// The argument is the number of entries in the directory.
+//------------------------------------------------------------------------------
+
+#include "namespace/utils/ChildMap.hh"
+#include "common/Murmur3.hh"
+#include "benchmark/benchmark.h"
+#include <google/dense_hash_map>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using benchmark::Counter;
+using HashChildMap = google::dense_hash_map<std::string, uint64_t,
+      Murmur3::MurmurHasher<std::string>>;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Generate num sorted names looking like the output of a data taking job,
+// QuarkDB returns the hash fields in lexicographic order
+//------------------------------------------------------------------------------
+std::vector<std::string>
+GenerateNames(uint64_t num)
+{
+  std::vector<std::string> names;
+  names.reserve(num);
+
+  for (uint64_t i = 0; i < num; ++i) {
+    names.push_back("data_run" + std::to_string(300000 + i / 1000) +
+                    "_lumi" + std::to_string(1000000 + i) + ".root");
+  }
+
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+//------------------------------------------------------------------------------
+// Container helpers
+//------------------------------------------------------------------------------
+void Init(HashChildMap& map)
+{
+  map.set_deleted_key("");
+  map.set_empty_key("##_EMPTY_##");
+}
+
+void Init(eos::ChildMap& map) {}
+
+size_t MemoryUsage(const HashChildMap& map)
+{
+  size_t total = sizeof(map) +
+                 map.bucket_count() * sizeof(HashChildMap::value_type);
+
+  // Names which do not fit in the small string buffer are on the heap
+  for (const auto& elem : map) {
+    if (elem.first.capacity() > 15) {
+      total += elem.first.capacity() + 1;
+    }
+  }
+
+  return total;
+}
+
+size_t MemoryUsage(const eos::ChildMap& map)
+{
+  return map.getMemoryUsage();
+}
+
+template <typename ChildMap>
+void Load(ChildMap& map, const std::vector<std::string>& names)
+{
+  Init(map);
+
+  for (size_t i = 0; i < names.size(); ++i) {
+    map.insert(std::make_pair(names[i], (uint64_t) i));
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+// Load the map and report the memory per entry
+//------------------------------------------------------------------------------
+template <typename ChildMap>
+static void BM_ChildMapLoad(benchmark::State& state)
+{
+  auto names = GenerateNames(state.range(0));
+  size_t memory = 0;
+
+  for (auto _ : state) {
+    ChildMap map;
+    Load(map, names);
+    memory = MemoryUsage(map);
+    benchmark::DoNotOptimize(map);
+  }
+
+  state.counters["bytes_per_entry"] = (double)memory / names.size();
+  state.counters["entries_rate"] = Counter(names.size() * state.iterations(),
+                                           Counter::kIsRate);
+}
+
+//------------------------------------------------------------------------------
+// Look up random existing names
+//------------------------------------------------------------------------------
+template <typename ChildMap>
+static void BM_ChildMapFind(benchmark::State& state)
+{
+  auto names = GenerateNames(state.range(0));
+  ChildMap map;
+  Load(map, names);
+  std::mt19937_64 gen(7);
+  std::uniform_int_distribution<size_t> dist(0, names.size() - 1);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(names[dist(gen)]));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Produce the sorted listing of the directory
+//------------------------------------------------------------------------------
+static void BM_HashChildMapListing(benchmark::State& state)
+{
+  auto names = GenerateNames(state.range(0));
+  HashChildMap map;
+  Load(map, names);
+
+  for (auto _ : state) {
+    std::vector<std::string> listing;
+    listing.reserve(map.size());
+
+    for (const auto& elem : map) {
+      listing.push_back(elem.first);
+    }
+
+    std::sort(listing.begin(), listing.end());
+    benchmark::DoNotOptimize(listing);
+  }
+
+  state.counters["entries_rate"] = Counter(map.size() * state.iterations(),
+                                           Counter::kIsRate);
+}
+
+static void BM_ChildMapListing(benchmark::State& state)
+{
+  auto names = GenerateNames(state.range(0));
+  eos::ChildMap map;
+  Load(map, names);
+
+  for (auto _ : state) {
+    std::vector<std::string> listing;
+    listing.reserve(map.size());
+
+    for (const auto& elem : map) {
+      listing.push_back(elem.first);
+    }
+
+    benchmark::DoNotOptimize(listing);
+  }
+
+  state.counters["entries_rate"] = Counter(map.size() * state.iterations(),
+                                           Counter::kIsRate);
+}
+
+//------------------------------------------------------------------------------
+// Fetch one page of 1000 entries from the middle of the listing
+//------------------------------------------------------------------------------
+static void BM_ChildMapPage(benchmark::State& state)
+{
+  auto names = GenerateNames(state.range(0));
+  eos::ChildMap map;
+  Load(map, names);
+  const std::string& start = names[names.size() / 2];
+
+  for (auto _ : state) {
+    std::vector<std::string> page;
+    page.reserve(1000);
+
+    for (auto it = map.lower_bound(start); (it != map.end()) &&
+         (page.size() < 1000); ++it) {
+      page.push_back(it->first);
+    }
+
+    benchmark::DoNotOptimize(page);
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_ChildMapLoad, HashChildMap)
+->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ChildMapLoad, eos::ChildMap)
+->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ChildMapFind, HashChildMap)
+->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK_TEMPLATE(BM_ChildMapFind, eos::ChildMap)
+->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK(BM_HashChildMapListing)
+->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ChildMapListing)
+->RangeMultiplier(100)->Range(100, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ChildMapPage)
+->RangeMultiplier(100)->Range(10000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+// File: BM_FidBitmap.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// Compare the file system file list representations: memory footprint and
+// load time normalised to 100M file ids, iteration and random pick. The
+// first argument is the number of ids, the second one the percentage of the
+// id space held by the file system e.g. with 1000 disks and two replicas per
+// file a disk holds about 0.2% of the ids. The optional third argument
+// shuffles the ids before loading them.
+//------------------------------------------------------------------------------
+
+#include "namespace/utils/FidBitmap.hh"
+#include "common/Murmur3.hh"
+#include "benchmark/benchmark.h"
+#include <google/dense_hash_set>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using benchmark::Counter;
+using HashFileList = google::dense_hash_set<uint64_t,
+      Murmur3::MurmurHasher<uint64_t>>;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Generate num ids with the given density in percent. QuarkDB returns the set
+// members in lexicographic order which is the numeric order for ids with the
+// same number of digits, this is the case for the generated ids unless they
+// are shuffled.
+//------------------------------------------------------------------------------
+std::vector<uint64_t>
+GenerateIds(uint64_t num, uint64_t density, bool shuffle = false)
+{
+  std::mt19937_64 gen(42);
+  std::geometric_distribution<uint64_t> gap(density / 100.0);
+  std::vector<uint64_t> ids;
+  ids.reserve(num);
+  uint64_t id = 10000000000ull;
+
+  for (uint64_t i = 0; i < num; ++i) {
+    id += 1 + gap(gen);
+    ids.push_back(id);
+  }
+
+  if (shuffle) {
+    std::shuffle(ids.begin(), ids.end(), gen);
+  }
+
+  return ids;
+}
+
+//------------------------------------------------------------------------------
+// Container helpers
+//------------------------------------------------------------------------------
+void Init(HashFileList& list)
+{
+  list.set_deleted_key(0);
+  list.set_empty_key(0xffffffffffffffffll);
+}
+
+void Init(eos::FidBitmap& list) {}
+
+size_t MemoryUsage(const HashFileList& list)
+{
+  return sizeof(list) + list.bucket_count() * sizeof(uint64_t);
+}
+
+size_t MemoryUsage(const eos::FidBitmap& list)
+{
+  return list.getMemoryUsage();
+}
+
+uint64_t PickRandom(const HashFileList& list, std::mt19937_64& gen)
+{
+  // Same approach used for the hash set in the FileListRandomPicker
+  std::uniform_int_distribution<uint64_t> dist(0, list.bucket_count() - 1);
+
+  while (true) {
+    uint64_t pos = dist(gen);
+    auto it = list.begin(pos);
+
+    if (it != list.end(pos)) {
+      return *it;
+    }
+  }
+}
+
+uint64_t PickRandom(const eos::FidBitmap& list, std::mt19937_64& gen)
+{
+  return list.pickRandom([&gen](uint64_t max) {
+    return std::uniform_int_distribution<uint64_t>(0, max - 1)(gen);
+  });
+}
+}
+
+//------------------------------------------------------------------------------
+// Load the file list and report memory and time per 100M ids
+//------------------------------------------------------------------------------
+template <typename FileList>
+static void BM_FileListLoad(benchmark::State& state)
+{
+  auto ids = GenerateIds(state.range(0), state.range(1), state.range(2));
+  double load_sec = 0;
+  size_t memory = 0;
+
+  for (auto _ : state) {
+    FileList list;
+    Init(list);
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto id : ids) {
+      list.insert(id);
+    }
+
+    load_sec += std::chrono::duration<double>
+                (std::chrono::steady_clock::now() - start).count();
+    memory = MemoryUsage(list);
+    benchmark::DoNotOptimize(list);
+  }
+
+  double scale = 1e8 / ids.size();
+  state.counters["bytes_per_fid"] = (double)memory / ids.size();
+  state.counters["MB_per_100M"] = memory * scale / (1 << 20);
+  state.counters["load_s_per_100M"] = load_sec / state.iterations() * scale;
+  state.counters["fids_rate"] = Counter(ids.size() * state.iterations(),
+                                        Counter::kIsRate);
+}
+
+//------------------------------------------------------------------------------
+// Iterate over the full file list
+//------------------------------------------------------------------------------
+template <typename FileList>
+static void BM_FileListIterate(benchmark::State& state)
+{
+  FileList list;
+  Init(list);
+
+  for (auto id : GenerateIds(state.range(0), state.range(1))) {
+    list.insert(id);
+  }
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+
+    for (auto it = list.begin(); it != list.end(); ++it) {
+      sum += *it;
+    }
+
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.counters["fids_rate"] = Counter(list.size() * state.iterations(),
+                                        Counter::kIsRate);
+}
+
+//------------------------------------------------------------------------------
+// Pick random files from the file list
+//------------------------------------------------------------------------------
+template <typename FileList>
+static void BM_FileListRandomPick(benchmark::State& state)
+{
+  FileList list;
+  Init(list);
+
+  for (auto id : GenerateIds(state.range(0), state.range(1))) {
+    list.insert(id);
+  }
+
+  std::mt19937_64 gen(7);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PickRandom(list, gen));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Set difference, as used when comparing two file lists
+//------------------------------------------------------------------------------
+static void BM_FidBitmapDifference(benchmark::State& state)
+{
+  auto ids = GenerateIds(state.range(0), state.range(1));
+  eos::FidBitmap lhs, rhs;
+
+  for (size_t i = 0; i < ids.size(); ++i) {
+    lhs.insert(ids[i]);
+
+    if (i % 100) {
+      rhs.insert(ids[i]);
+    }
+  }
+
+  for (auto _ : state) {
+    eos::FidBitmap diff = lhs;
+    diff -= rhs;
+    benchmark::DoNotOptimize(diff);
+  }
+
+  state.counters["fids_rate"] = Counter(lhs.size() * state.iterations(),
+                                        Counter::kIsRate);
+}
+
+BENCHMARK_TEMPLATE(BM_FileListLoad, HashFileList)
+->ArgsProduct({{10 << 20, 100000000}, {1, 10, 100}, {0, 1}})
+->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK_TEMPLATE(BM_FileListLoad, eos::FidBitmap)
+->ArgsProduct({{10 << 20, 100000000}, {1, 10, 100}, {0, 1}})
+->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK_TEMPLATE(BM_FileListIterate, HashFileList)
+->ArgsProduct({{10 << 20}, {1, 100}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_FileListIterate, eos::FidBitmap)
+->ArgsProduct({{10 << 20}, {1, 100}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_FileListRandomPick, HashFileList)
+->ArgsProduct({{10 << 20}, {1, 100}});
+BENCHMARK_TEMPLATE(BM_FileListRandomPick, eos::FidBitmap)
+->ArgsProduct({{10 << 20}, {1, 100}});
+BENCHMARK(BM_FidBitmapDifference)
+->ArgsProduct({{10 << 20}, {1, 100}})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// File: BM_Serialization.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// Deserialisation rate of FileMD protos as stored in QDB: parsing from a copy
+// of the reply through a zero copy stream as done previously and parsing
+// straight from the reply. The argument is the number of extended attributes
+// of the file.
+//------------------------------------------------------------------------------
+
+#include "namespace/ns_quarkdb/persistency/Serialization.hh"
+#include "namespace/utils/DataHelper.hh"
+#include "proto/FileMd.pb.h"
+#include "benchmark/benchmark.h"
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <cstring>
+#include <string>
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Serialize a typical file entry the same way as QuarkFileMD::serialize
+//------------------------------------------------------------------------------
+std::string
+SerializedFile(int num_xattrs)
+{
+  eos::ns::FileMdProto proto;
+  proto.set_id(123456789);
+  proto.set_cont_id(4567);
+  proto.set_uid(1000);
+  proto.set_gid(1000);
+  proto.set_size(1234567);
+  proto.set_layout_id(0x00100112);
+  proto.set_name("run_000123_lumi_0042.root");
+  proto.set_ctime(std::string(16, 'c'));
+  proto.set_mtime(std::string(16, 'm'));
+  proto.set_checksum(std::string(4, 'k'));
+
+  for (uint32_t i = 0; i < 2; ++i) {
+    proto.add_locations(100 + i);
+  }
+
+  for (int i = 0; i < num_xattrs; ++i) {
+    (*proto.mutable_xattrs())["user.attr." + std::to_string(i)] =
+      std::string(32, 'v');
+  }
+
+  uint32_t obj_size = proto.ByteSizeLong();
+  uint32_t align_size = (obj_size + 3) >> 2 << 2;
+  std::string out(2 * sizeof(uint32_t) + align_size, '\0');
+  char* payload = &out[2 * sizeof(uint32_t)];
+  proto.SerializeToArray(payload, obj_size);
+  uint32_t cksum = eos::DataHelper::computeCRC32C(payload, align_size);
+  cksum = eos::DataHelper::finalizeCRC32C(cksum);
+  memcpy(&out[0], &cksum, sizeof(cksum));
+  memcpy(&out[sizeof(cksum)], &obj_size, sizeof(obj_size));
+  return out;
+}
+
+//------------------------------------------------------------------------------
+// Previous implementation: copy of the reply, checksum and parsing through a
+// zero copy stream
+//------------------------------------------------------------------------------
+bool
+LegacyDeserialize(const std::string& reply, eos::ns::FileMdProto& proto)
+{
+  std::string copy(reply);
+  uint32_t cksum_expected = 0;
+  uint32_t obj_size = 0;
+  memcpy(&cksum_expected, copy.data(), sizeof(cksum_expected));
+  memcpy(&obj_size, copy.data() + sizeof(cksum_expected), sizeof(obj_size));
+  const char* ptr = copy.data() + 2 * sizeof(uint32_t);
+  uint32_t cksum = eos::DataHelper::computeCRC32C((void*)ptr,
+                   copy.size() - 2 * sizeof(uint32_t));
+
+  if (eos::DataHelper::finalizeCRC32C(cksum) != cksum_expected) {
+    return false;
+  }
+
+  google::protobuf::io::ArrayInputStream ais(ptr, obj_size);
+  return proto.ParseFromZeroCopyStream(&ais);
+}
+}
+
+//------------------------------------------------------------------------------
+// Previous implementation
+//------------------------------------------------------------------------------
+static void BM_DeserializeLegacy(benchmark::State& state)
+{
+  const std::string reply = SerializedFile(state.range(0));
+
+  for (auto _ : state) {
+    eos::ns::FileMdProto proto;
+
+    if (!LegacyDeserialize(reply, proto)) {
+      state.SkipWithError("deserialization failed");
+      break;
+    }
+
+    benchmark::DoNotOptimize(proto);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+//------------------------------------------------------------------------------
+// Parsing straight from the reply, heap allocated fields
+//------------------------------------------------------------------------------
+static void BM_Deserialize(benchmark::State& state)
+{
+  const std::string reply = SerializedFile(state.range(0));
+
+  for (auto _ : state) {
+    eos::ns::FileMdProto proto;
+
+    if (!eos::Serialization::deserialize(reply.data(), reply.size(),
+                                         proto).ok()) {
+      state.SkipWithError("deserialization failed");
+      break;
+    }
+
+    benchmark::DoNotOptimize(proto);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_DeserializeLegacy)->Arg(0)->Arg(8);
+BENCHMARK(BM_Deserialize)->Arg(0)->Arg(8);
+
+BENCHMARK_MAIN();
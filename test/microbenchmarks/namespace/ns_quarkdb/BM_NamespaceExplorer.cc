@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+// File: BM_NamespaceExplorer.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// Compare the sequential NamespaceExplorer with the ParallelNamespaceExplorer
+// on a tree stored in the unit tests QuarkDB instance, see README.md. The
+// argument is the number of workers, 0 stands for the sequential explorer.
+//------------------------------------------------------------------------------
+
+#include "benchmark/benchmark.h"
+#include "namespace/ns_quarkdb/explorer/NamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/explorer/ParallelNamespaceExplorer.hh"
+#include "namespace/ns_quarkdb/flusher/MetadataFlusher.hh"
+#include "namespace/ns_quarkdb/tests/NsTests.hh"
+#include "namespace/interface/IView.hh"
+#include <qclient/QClient.hh>
+
+using benchmark::Counter;
+
+namespace
+{
+//! Tree layout: kFanout^2 directories with kFilesPerDir files each
+constexpr int kFanout = 30;
+constexpr int kFilesPerDir = 50;
+constexpr size_t kQdbConnections = 4;
+
+std::unique_ptr<eos::ns::testing::NsTests> nsTests;
+std::vector<std::unique_ptr<qclient::QClient>> qclients;
+std::vector<qclient::QClient*> qcls;
+
+//------------------------------------------------------------------------------
+// Populate the namespace once for all the benchmarks
+//------------------------------------------------------------------------------
+void Populate()
+{
+  if (nsTests) {
+    return;
+  }
+
+  nsTests = std::make_unique<eos::ns::testing::NsTests>();
+
+  for (int i = 0; i < kFanout; ++i) {
+    for (int j = 0; j < kFanout; ++j) {
+      std::string dir = "/bm/d" + std::to_string(i) + "/e" + std::to_string(j);
+      nsTests->view()->createContainer(dir, true);
+
+      for (int k = 0; k < kFilesPerDir; ++k) {
+        nsTests->view()->createFile(dir + "/f" + std::to_string(k));
+      }
+    }
+  }
+
+  nsTests->mdFlusher()->synchronize();
+
+  for (size_t i = 0; i < kQdbConnections; ++i) {
+    qclients.push_back(nsTests->createQClient());
+    qcls.push_back(qclients.back().get());
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+// Explore the whole tree
+//------------------------------------------------------------------------------
+static void BM_NamespaceExplorer(benchmark::State& state)
+{
+  Populate();
+  eos::ExplorationOptions options;
+  options.depthLimit = 999;
+  const size_t num_workers = state.range(0);
+  uint64_t items = 0;
+
+  for (auto _ : state) {
+    eos::NamespaceItem item;
+
+    if (num_workers == 0) {
+      eos::NamespaceExplorer explorer("/bm", options, nsTests->qcl(),
+                                      nsTests->executor());
+
+      while (explorer.fetch(item)) {
+        ++items;
+      }
+    } else {
+      eos::ParallelNamespaceExplorer explorer("/bm", options, qcls,
+                                              nsTests->executor(),
+                                              num_workers);
+      std::vector<eos::NamespaceItem> batch;
+
+      while (explorer.fetchBatch(batch)) {
+        items += batch.size();
+      }
+    }
+  }
+
+  state.counters["items_rate"] = Counter(items, Counter::kIsRate);
+}
+
+BENCHMARK(BM_NamespaceExplorer)->Arg(0)->Arg(1)->Arg(4)->Arg(8)->Arg(16)
+->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -79,12 +79,16 @@ int main(int argc, char* argv[])
   XrdMqMessage message("");
   message.Configure(0); // Creates a logger object for the message
   uint64_t dumped = 0ull;
+  std::chrono::time_point<std::chrono::steady_clock> start;
 
   while (true) {
     std::unique_ptr<XrdMqMessage> new_msg {mqc.RecvMessage()};
 
     if (new_msg) {
-      ++dumped;
+      // Measure the rate from the first received message
+      if (dumped++ == 0) {
+        start = std::chrono::steady_clock::now();
+      }
 
       if (!debug) {
         std::cout << "info: msg #" << dumped << " contents: "
@@ -99,6 +103,11 @@ int main(int argc, char* argv[])
 
     // Exit after max_dumps messages
     if (max_dumps && (dumped >= max_dumps)) {
+      auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                        (std::chrono::steady_clock::now() - start).count();
+      std::cout << "info: received " << dumped << " msgs in " << elapsed_ms
+                << " ms, rate: " << (elapsed_ms ? (1000 * dumped / elapsed_ms) :
+                                     dumped) << " msg/s" << std::endl;
       exit(0);
     }
 
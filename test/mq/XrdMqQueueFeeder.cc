@@ -94,6 +94,8 @@ int main(int argc, char* argv[])
     body += "a";
   }
 
+  auto start = std::chrono::steady_clock::now();
+
   while (true) {
     message.NewId();
     message.kMessageHeader.kDescription = "Hello Dumper ";
@@ -110,8 +112,12 @@ int main(int argc, char* argv[])
 
     // Exit after max_feeds messages
     if (max_feeds && (num_feeds >= max_feeds)) {
+      auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>
+                        (std::chrono::steady_clock::now() - start).count();
       std::cout << "info: successfully sent " << successful_feeds
-                << "/" << num_feeds << " feeds" << std::endl;
+                << "/" << num_feeds << " feeds in " << elapsed_ms << " ms, "
+                << "rate: " << (elapsed_ms ? (1000 * successful_feeds / elapsed_ms) :
+                                successful_feeds) << " msg/s" << std::endl;
       exit(0);
     }
 
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//! @file FsckDeltaTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "common/Fmd.hh"
+
+using eos::common::FsckDelta;
+using eos::common::FsckErrsPerFsMap;
+
+//------------------------------------------------------------------------------
+// Test serialization of fsck deltas
+//------------------------------------------------------------------------------
+TEST(FsckDelta, Serialization)
+{
+  FsckDelta delta;
+  delta.mSeq = 1234;
+  delta.mAppeared = false;
+  delta.mErrType = eos::common::FSCK_D_CX_DIFF;
+  delta.mFid = 0x1234abcd;
+  delta.mFsid = 42;
+  const std::string data = delta.Serialize();
+  ASSERT_EQ("1234:-:d_cx_diff:305441741:42", data);
+  FsckDelta other;
+  ASSERT_TRUE(other.Deserialize(data));
+  ASSERT_EQ(delta.mSeq, other.mSeq);
+  ASSERT_EQ(delta.mAppeared, other.mAppeared);
+  ASSERT_EQ(delta.mErrType, other.mErrType);
+  ASSERT_EQ(delta.mFid, other.mFid);
+  ASSERT_EQ(delta.mFsid, other.mFsid);
+  ASSERT_FALSE(other.Deserialize(""));
+  ASSERT_FALSE(other.Deserialize("1:*:d_cx_diff:1:1"));
+  ASSERT_FALSE(other.Deserialize("1:+::1:1"));
+  ASSERT_FALSE(other.Deserialize("1:+:d_cx_diff:abc:1"));
+  ASSERT_FALSE(other.Deserialize("1:+:d_cx_diff:1"));
+}
+
+//------------------------------------------------------------------------------
+// Test computation of deltas between two fsck error maps
+//------------------------------------------------------------------------------
+TEST(FsckDelta, ComputeDeltas)
+{
+  FsckErrsPerFsMap old_map, new_map, appeared, resolved;
+  old_map["d_cx_diff"][1] = {10, 11, 12};
+  old_map["rep_missing_n"][2] = {20};
+  new_map["d_cx_diff"][1] = {11, 12, 13};
+  new_map["blockxs_err"][3] = {30};
+  eos::common::ComputeFsckDeltas(old_map, new_map, appeared, resolved);
+  ASSERT_EQ(2u, appeared.size());
+  ASSERT_EQ(std::set<eos::common::FileId::fileid_t>({13}),
+            appeared["d_cx_diff"][1]);
+  ASSERT_EQ(std::set<eos::common::FileId::fileid_t>({30}),
+            appeared["blockxs_err"][3]);
+  ASSERT_EQ(2u, resolved.size());
+  ASSERT_EQ(std::set<eos::common::FileId::fileid_t>({10}),
+            resolved["d_cx_diff"][1]);
+  ASSERT_EQ(std::set<eos::common::FileId::fileid_t>({20}),
+            resolved["rep_missing_n"][2]);
+  appeared.clear();
+  resolved.clear();
+  eos::common::ComputeFsckDeltas(new_map, new_map, appeared, resolved);
+  ASSERT_TRUE(appeared.empty());
+  ASSERT_TRUE(resolved.empty());
+}
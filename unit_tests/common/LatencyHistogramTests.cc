@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//! @file LatencyHistogramTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "common/LatencyHistogram.hh"
+#include <thread>
+#include <vector>
+
+using eos::common::LatencyHistogram;
+using eos::common::WindowedLatencyHistogram;
+
+//------------------------------------------------------------------------------
+// Test bucket boundaries are contiguous and the relative error is bounded
+//------------------------------------------------------------------------------
+TEST(LatencyHistogram, BucketBoundaries)
+{
+  for (uint64_t val = 0; val < 32; ++val) {
+    ASSERT_EQ(val, LatencyHistogram::BucketIndex(val));
+    ASSERT_EQ(val, LatencyHistogram::BucketLowerBound(val));
+  }
+
+  for (uint32_t i = 1; i < LatencyHistogram::kNumBuckets; ++i) {
+    ASSERT_EQ(LatencyHistogram::BucketUpperBound(i - 1) + 1,
+              LatencyHistogram::BucketLowerBound(i));
+    ASSERT_EQ(i, LatencyHistogram::BucketIndex(
+                LatencyHistogram::BucketLowerBound(i)));
+    ASSERT_EQ(i, LatencyHistogram::BucketIndex(
+                LatencyHistogram::BucketUpperBound(i)));
+  }
+
+  for (uint64_t val = 1; val < (1ull << 30); val = val * 3 + 7) {
+    uint32_t index = LatencyHistogram::BucketIndex(val);
+    uint64_t upper = LatencyHistogram::BucketUpperBound(index);
+    ASSERT_LE(val, upper);
+    ASSERT_LE((double)(upper - val) / val, 1.0 / LatencyHistogram::kSubBuckets);
+  }
+
+  ASSERT_EQ(LatencyHistogram::kNumBuckets - 1,
+            LatencyHistogram::BucketIndex(UINT64_MAX));
+}
+
+//------------------------------------------------------------------------------
+// Test quantiles computed from multiple threads
+//------------------------------------------------------------------------------
+TEST(LatencyHistogram, Quantiles)
+{
+  LatencyHistogram histo;
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&histo]() {
+      for (uint64_t val = 1; val <= 10000; ++val) {
+        histo.Record(val);
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  auto snap = histo.GetSnapshot();
+  ASSERT_EQ(40000ull, snap.mCount);
+  ASSERT_EQ(10000ull, snap.mMaxUs);
+  ASSERT_NEAR(5000.5, snap.Mean(), 0.001);
+  ASSERT_NEAR(5000, snap.Quantile(0.5), 5000 / 16);
+  ASSERT_NEAR(9900, snap.Quantile(0.99), 9900 / 16);
+  ASSERT_EQ(10000ull, snap.Quantile(1.0));
+  histo.Reset();
+  ASSERT_EQ(0ull, histo.GetSnapshot().mCount);
+  ASSERT_EQ(0ull, histo.GetSnapshot().Quantile(0.99));
+}
+
+//------------------------------------------------------------------------------
+// Test windowed snapshots
+//------------------------------------------------------------------------------
+TEST(WindowedLatencyHistogram, Windows)
+{
+  WindowedLatencyHistogram histo(5);
+  ASSERT_EQ(0ull, histo.GetWindow(1).mCount);
+
+  for (uint64_t interval = 1; interval <= 10; ++interval) {
+    for (int i = 0; i < 100; ++i) {
+      histo.Record(interval * 1000);
+    }
+
+    histo.Rotate();
+  }
+
+  ASSERT_EQ(1000ull, histo.GetCumulative().mCount);
+  auto last = histo.GetWindow(1);
+  ASSERT_EQ(100ull, last.mCount);
+  ASSERT_EQ(10000ull * 100, last.mSumUs);
+  ASSERT_NEAR(10000, last.Quantile(0.5), 10000 / 16);
+  // Only the last 5 intervals are kept
+  auto all = histo.GetWindow(60);
+  ASSERT_EQ(500ull, all.mCount);
+  ASSERT_NEAR(6000, all.Quantile(0.01), 6000 / 16);
+  // Samples recorded after the last rotation are not part of any window
+  histo.Record(1);
+  ASSERT_EQ(100ull, histo.GetWindow(1).mCount);
+  histo.Rotate();
+  ASSERT_EQ(1ull, histo.GetWindow(1).mCount);
+  histo.Reset();
+  ASSERT_EQ(0ull, histo.GetWindow(5).mCount);
+  ASSERT_EQ(0ull, histo.GetCumulative().mCount);
+}
@@ -32,6 +32,7 @@
 #include <XrdSec/XrdSecEntity.hh>
 #include <memory>
 #include "common/UnixGroupsFetcher.hh"
+#include "common/token/EosTok.hh"
 
 
 EOSCOMMONTESTING_BEGIN
@@ -201,6 +202,101 @@ protected:
   }
 };
 
+TEST(Mapping, TokenCache)
+{
+  const uint64_t generation = EosTok::sTokenGeneration;
+  EosTok token;
+  token.SetPath("/eos/token/test/", true);
+  token.SetPermission("rx");
+  token.SetOwner("myuser");
+  token.SetExpires(time(NULL) + 300);
+  token.SetGeneration(generation);
+  const std::string key = "1234567890";
+  const std::string authz = token.Write(key);
+  int rc = -1;
+  std::shared_ptr<Token> first = Mapping::ReadEosToken(authz, key, rc);
+  ASSERT_EQ(0, rc);
+  ASSERT_TRUE(first->Valid());
+  ASSERT_EQ("myuser", first->Owner());
+  // Served from the cache
+  std::shared_ptr<Token> second = Mapping::ReadEosToken(authz, key, rc);
+  ASSERT_EQ(0, rc);
+  ASSERT_EQ(first.get(), second.get());
+  // The cached token is only valid for the key it was verified with
+  std::shared_ptr<Token> other = Mapping::ReadEosToken(authz, "0987654321", rc);
+  ASSERT_EQ(-EPERM, rc);
+  ASSERT_FALSE(other->Valid());
+  // A new generation revokes the cached token
+  EosTok::sTokenGeneration = generation + 1;
+  std::shared_ptr<Token> revoked = Mapping::ReadEosToken(authz, key, rc);
+  ASSERT_EQ(-EACCES, rc);
+  ASSERT_FALSE(revoked->Valid());
+  EosTok::sTokenGeneration = generation;
+  // Expired tokens are never served
+  EosTok expired;
+  expired.SetPath("/eos/token/test/", true);
+  expired.SetExpires(time(NULL) - 1);
+  expired.SetGeneration(generation);
+  const std::string expired_authz = expired.Write(key);
+  ASSERT_FALSE(Mapping::ReadEosToken(expired_authz, key, rc)->Valid());
+  ASSERT_EQ(-EKEYEXPIRED, rc);
+  ASSERT_FALSE(Mapping::ReadEosToken(expired_authz, key, rc)->Valid());
+  Mapping::Reset();
+  ASSERT_EQ(0u, Mapping::gShardedTokenCache.num_entries());
+}
+
+TEST(Mapping, IdentityCache)
+{
+  Mapping::Reset();
+  const std::string uid_key = "sss:\"cacheduser\":uid";
+  const std::string gid_key = "sss:\"cacheduser\":gid";
+  Mapping::gVirtualUidMap[uid_key] = 1234;
+  Mapping::gVirtualGidMap[gid_key] = 1234;
+  ++Mapping::gMapGeneration;
+  XrdSecEntity client("sss");
+  std::string name = "cacheduser";
+  std::string host = "client.cern.ch";
+  client.name = name.data();
+  client.host = host.data();
+  client.tident = "cacheduser.1:2@client";
+  VirtualIdentity vid;
+  Mapping::IdMap(&client, nullptr, client.tident, vid, nullptr, AOP_Stat, "",
+                 false);
+  ASSERT_EQ(1234, vid.uid);
+  ASSERT_EQ(1234, vid.gid);
+  ASSERT_EQ(1u, Mapping::gShardedIdentityCache.num_entries());
+  // Changing the maps without a new generation keeps serving the cache
+  Mapping::gVirtualUidMap[uid_key] = 4321;
+  VirtualIdentity cached;
+  Mapping::IdMap(&client, nullptr, client.tident, cached, nullptr, AOP_Stat,
+                 "", false);
+  ASSERT_EQ(1234, cached.uid);
+  ASSERT_EQ(vid.allowed_uids, cached.allowed_uids);
+  // A new generation invalidates the cached identities
+  ++Mapping::gMapGeneration;
+  Mapping::IdMap(&client, nullptr, client.tident, vid, nullptr, AOP_Stat, "",
+                 false);
+  ASSERT_EQ(4321, vid.uid);
+  ASSERT_EQ(1u, Mapping::gShardedIdentityCache.num_entries());
+  // The selected role is part of the key
+  Mapping::IdMap(&client, "eos.ruid=0", client.tident, vid, nullptr, AOP_Stat,
+                 "", false);
+  ASSERT_EQ(VirtualIdentity::kNobodyUid, vid.uid);
+  ASSERT_EQ(2u, Mapping::gShardedIdentityCache.num_entries());
+  // Requests with a token are never cached
+  Mapping::IdMap(&client, "authz=zteos64:invalid", client.tident, vid, nullptr,
+                 AOP_Stat, "", false);
+  ASSERT_EQ(2u, Mapping::gShardedIdentityCache.num_entries());
+  client.name = nullptr;
+  client.host = nullptr;
+  client.tident = nullptr;
+  Mapping::gVirtualUidMap.erase(uid_key);
+  Mapping::gVirtualGidMap.erase(gid_key);
+  ++Mapping::gMapGeneration;
+  Mapping::Reset();
+  ASSERT_EQ(0u, Mapping::gShardedIdentityCache.num_entries());
+}
+
 void printvid(const VirtualIdentity& vid) {
   std::cerr << vid.getTrace() << "\nallowed gids: ";
   for (const auto& gid: vid.allowed_gids) {
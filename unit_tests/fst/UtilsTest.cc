@@ -23,6 +23,7 @@
 
 #include "TestEnv.hh"
 #include "fst/utils/OpenFileTracker.hh"
+#include "fst/utils/PublishFilter.hh"
 #include "gtest/gtest.h"
 
 TEST(OpenFileTracker, BasicSanity)
@@ -179,3 +180,65 @@ TEST(OpenFileTracker, SortedByUseCount)
   auto hotFiles3 = oft.getHotFiles(3, 0);
   ASSERT_TRUE(hotFiles3.empty());
 }
+
+TEST(PublishFilter, OnlyChangedKeys)
+{
+  eos::fst::PublishFilter filter(3);
+  std::map<std::string, std::string> values {{"a", "1"}, {"b", "x"}};
+  // First cycle publishes everything
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 2);
+  values = {{"a", "1"}, {"b", "y"}, {"c", "z"}};
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 2);
+  ASSERT_EQ(values["b"], "y");
+  ASSERT_EQ(values["c"], "z");
+  // Other hashes are tracked separately
+  values = {{"a", "1"}};
+  filter.Filter("fs2", values);
+  ASSERT_EQ(values.size(), 1);
+  values = {{"a", "1"}, {"b", "y"}, {"c", "z"}};
+  filter.Filter("fs1", values);
+  ASSERT_TRUE(values.empty());
+  // Refresh cycle publishes everything again
+  values = {{"a", "1"}, {"b", "y"}, {"c", "z"}};
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 3);
+  values = {{"a", "1"}};
+  filter.Filter("fs1", values);
+  ASSERT_TRUE(values.empty());
+  filter.Reset();
+  values = {{"a", "1"}};
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 1);
+}
+
+TEST(PublishFilter, Thresholds)
+{
+  eos::fst::PublishFilter filter(100);
+  filter.SetThreshold("rate", 1.0, 0.1);
+  std::map<std::string, std::string> values {{"rate", "100.0"}};
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 1);
+  // Both thresholds have to be exceeded
+  values = {{"rate", "105.0"}};
+  filter.Filter("fs1", values);
+  ASSERT_TRUE(values.empty());
+  // Drift is compared to the last published value
+  values = {{"rate", "109.0"}};
+  filter.Filter("fs1", values);
+  ASSERT_TRUE(values.empty());
+  values = {{"rate", "111.0"}};
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 1);
+  values = {{"rate", "0.5"}};
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 1);
+  values = {{"rate", "1.2"}};
+  filter.Filter("fs1", values);
+  ASSERT_TRUE(values.empty());
+  // Non numeric values always count as changed
+  values = {{"rate", "N/A"}};
+  filter.Filter("fs1", values);
+  ASSERT_EQ(values.size(), 1);
+}
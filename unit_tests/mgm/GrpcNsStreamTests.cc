@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//! @file GrpcNsStreamTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifdef EOS_GRPC
+#include "gtest/gtest.h"
+#include "mgm/grpc/GrpcNsStream.hh"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using eos::mgm::GrpcNsStreamService;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Service listening on a local port chosen by the system
+//------------------------------------------------------------------------------
+struct LocalServer {
+  LocalServer(size_t max_inflight): mService(max_inflight)
+  {
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(),
+                             &mPort);
+    mService.Register(builder);
+    mServer = builder.BuildAndStart();
+
+    if (mServer) {
+      mService.Start();
+    }
+  }
+
+  std::unique_ptr<eos::rpc::EosStream::Stub> NewStub()
+  {
+    return eos::rpc::EosStream::NewStub(grpc::CreateChannel(
+                                          "127.0.0.1:" + std::to_string(mPort),
+                                          grpc::InsecureChannelCredentials()));
+  }
+
+  void Shutdown()
+  {
+    mServer->Shutdown(std::chrono::system_clock::now() +
+                      std::chrono::milliseconds(200));
+    mService.Stop();
+  }
+
+  GrpcNsStreamService mService;
+  std::unique_ptr<grpc::Server> mServer;
+  int mPort {0};
+};
+
+//------------------------------------------------------------------------------
+// Open a stream, send the given batch if not empty and return the status
+//------------------------------------------------------------------------------
+grpc::Status
+RunStream(eos::rpc::EosStream::Stub& stub,
+          const eos::rpc::NSBatchRequest& batch)
+{
+  grpc::ClientContext ctx;
+  ctx.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+  auto stream = stub.Exec(&ctx);
+
+  if (batch.ops_size()) {
+    (void) stream->Write(batch);
+  }
+
+  (void) stream->WritesDone();
+  eos::rpc::NSBatchResponse response;
+
+  while (stream->Read(&response)) {}
+
+  return stream->Finish();
+}
+}
+
+//------------------------------------------------------------------------------
+// Streams closed by the client are finished with an OK status, batches larger
+// than the in-flight limit are refused
+//------------------------------------------------------------------------------
+TEST(GrpcNsStream, FinishAndRefuse)
+{
+  LocalServer server(4);
+  ASSERT_TRUE(server.mServer != nullptr);
+  auto stub = server.NewStub();
+  eos::rpc::NSBatchRequest batch;
+  ASSERT_TRUE(RunStream(*stub, batch).ok());
+
+  for (uint64_t id = 0; id < 5; ++id) {
+    batch.add_ops()->set_id(id);
+  }
+
+  ASSERT_EQ(grpc::StatusCode::RESOURCE_EXHAUSTED,
+            RunStream(*stub, batch).error_code());
+  // Every accepted stream was replaced, the service keeps serving
+  batch.Clear();
+  ASSERT_TRUE(RunStream(*stub, batch).ok());
+  server.Shutdown();
+}
+
+//------------------------------------------------------------------------------
+// Streams accepted while the server shuts down are all released before the
+// completion queue goes away
+//------------------------------------------------------------------------------
+TEST(GrpcNsStream, AcceptDuringShutdown)
+{
+  LocalServer server(4);
+  ASSERT_TRUE(server.mServer != nullptr);
+  auto stub = server.NewStub();
+  std::atomic<bool> stop {false};
+  std::atomic<uint64_t> streams {0};
+  std::vector<std::thread> clients;
+
+  for (int i = 0; i < 4; ++i) {
+    clients.emplace_back([&]() {
+      eos::rpc::NSBatchRequest batch;
+
+      while (!stop) {
+        (void) RunStream(*stub, batch);
+        ++streams;
+      }
+    });
+  }
+
+  while (streams < 20) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  server.Shutdown();
+  stop = true;
+
+  for (auto& client : clients) {
+    client.join();
+  }
+}
+#endif
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+//! @file NegativeLookupCacheTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "mgm/NegativeLookupCache.hh"
+#include <thread>
+#include <vector>
+
+using eos::mgm::NegativeLookupCache;
+
+//------------------------------------------------------------------------------
+// Test entries are only valid for the version of the parent they were
+// recorded with
+//------------------------------------------------------------------------------
+TEST(NegativeLookupCache, Versioning)
+{
+  NegativeLookupCache cache(100);
+  NegativeLookupCache::Version version;
+  version.mtime_sec = 1000;
+  version.num_files = 3;
+  ASSERT_FALSE(cache.IsMissing(5, version, "foo.py"));
+  cache.AddMissing(5, version, "foo.py");
+  ASSERT_TRUE(cache.IsMissing(5, version, "foo.py"));
+  ASSERT_FALSE(cache.IsMissing(5, version, "bar.py"));
+  ASSERT_FALSE(cache.IsMissing(6, version, "foo.py"));
+  // A new file without mtime update
+  NegativeLookupCache::Version added = version;
+  ++added.num_files;
+  ASSERT_FALSE(cache.IsMissing(5, added, "foo.py"));
+  // Stale entries are dropped
+  ASSERT_FALSE(cache.IsMissing(5, version, "foo.py"));
+  cache.AddMissing(5, version, "foo.py");
+  NegativeLookupCache::Version touched = version;
+  ++touched.mtime_nsec;
+  ASSERT_FALSE(cache.IsMissing(5, touched, "foo.py"));
+  NegativeLookupCache::Stats stats = cache.GetStats();
+  ASSERT_EQ(100u, stats.max_size);
+  ASSERT_EQ(0u, stats.occupancy);
+  ASSERT_EQ(7u, stats.requests);
+  ASSERT_EQ(1u, stats.hits);
+}
+
+//------------------------------------------------------------------------------
+// Test the cache is bounded and can be disabled
+//------------------------------------------------------------------------------
+TEST(NegativeLookupCache, Bounded)
+{
+  NegativeLookupCache cache(100);
+  NegativeLookupCache::Version version;
+
+  for (uint64_t i = 0; i < 1000; ++i) {
+    cache.AddMissing(1, version, std::to_string(i));
+  }
+
+  ASSERT_LE(cache.GetStats().occupancy, 110u);
+  ASSERT_TRUE(cache.IsMissing(1, version, "999"));
+  ASSERT_FALSE(cache.IsMissing(1, version, "0"));
+  cache.SetMaxSize(0);
+  ASSERT_FALSE(cache.IsEnabled());
+  ASSERT_EQ(0u, cache.GetStats().occupancy);
+  cache.AddMissing(1, version, "foo");
+  ASSERT_FALSE(cache.IsMissing(1, version, "foo"));
+  cache.SetMaxSize(10);
+  cache.AddMissing(1, version, "foo");
+  ASSERT_TRUE(cache.IsMissing(1, version, "foo"));
+  cache.Clear();
+  ASSERT_FALSE(cache.IsMissing(1, version, "foo"));
+}
+
+//------------------------------------------------------------------------------
+// Test concurrent lookups and insertions spread over the shards
+//------------------------------------------------------------------------------
+TEST(NegativeLookupCache, Concurrent)
+{
+  NegativeLookupCache cache(10000);
+  NegativeLookupCache::Version version;
+  std::vector<std::thread> threads;
+
+  for (uint64_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &version, t]() {
+      for (uint64_t i = 0; i < 1000; ++i) {
+        cache.AddMissing(t, version, std::to_string(i));
+        ASSERT_TRUE(cache.IsMissing(t, version, std::to_string(i)));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  NegativeLookupCache::Stats stats = cache.GetStats();
+  ASSERT_EQ(4000u, stats.requests);
+  ASSERT_EQ(4000u, stats.hits);
+  ASSERT_LE(stats.occupancy, 4000u);
+  ASSERT_GE(stats.occupancy, 3000u);
+}
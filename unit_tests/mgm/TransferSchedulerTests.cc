@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------
+//! @file TransferSchedulerTests.cc
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2025 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "gtest/gtest.h"
+#include "mgm/TransferScheduler.hh"
+#include <atomic>
+#include <future>
+#include <thread>
+
+using eos::mgm::TransferScheduler;
+using Priority = TransferScheduler::Priority;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Build file system info map with the given number of file systems spread
+// over the given number of nodes
+//------------------------------------------------------------------------------
+std::map<TransferScheduler::fsid_t, TransferScheduler::FsInfo>
+MakeFsInfo(uint32_t num_fs, uint32_t num_nodes, uint32_t max_tx,
+           const std::string& space = "default")
+{
+  std::map<TransferScheduler::fsid_t, TransferScheduler::FsInfo> fs_info;
+
+  for (uint32_t fsid = 1; fsid <= num_fs; ++fsid) {
+    TransferScheduler::FsInfo info;
+    info.mNode = "node" + std::to_string(fsid % num_nodes);
+    info.mSpace = space;
+    info.mMaxTx = max_tx;
+    fs_info[fsid] = info;
+  }
+
+  return fs_info;
+}
+
+//------------------------------------------------------------------------------
+// Wait until the number of queued requests reaches the given value
+//------------------------------------------------------------------------------
+void
+WaitQueued(const TransferScheduler& sched, Priority prio, uint64_t num)
+{
+  for (int i = 0; (i < 500) && (sched.GetNumQueued(prio) != num); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  ASSERT_EQ(num, sched.GetNumQueued(prio));
+}
+}
+
+//------------------------------------------------------------------------------
+// Test mapping of application tags to priorities
+//------------------------------------------------------------------------------
+TEST(TransferScheduler, GetPriority)
+{
+  ASSERT_EQ(Priority::Fsck, TransferScheduler::GetPriority("eos/fsck"));
+  ASSERT_EQ(Priority::Drain, TransferScheduler::GetPriority("eos/draining"));
+  ASSERT_EQ(Priority::Drain, TransferScheduler::GetPriority("GroupDrainer"));
+  ASSERT_EQ(Priority::Balance, TransferScheduler::GetPriority("eos/balancing"));
+  ASSERT_EQ(Priority::Balance, TransferScheduler::GetPriority("GroupBalancer"));
+  ASSERT_EQ(Priority::Conversion, TransferScheduler::GetPriority("eos/converter"));
+  ASSERT_EQ("fsck", TransferScheduler::PriorityToString(Priority::Fsck));
+}
+
+//------------------------------------------------------------------------------
+// Test per file system and per node concurrency limits
+//------------------------------------------------------------------------------
+TEST(TransferScheduler, ConcurrencyLimits)
+{
+  TransferScheduler sched;
+  auto fs_info = MakeFsInfo(4, 2, 2);
+
+  for (auto& elem : fs_info) {
+    elem.second.mNodeMaxTx = 3;
+  }
+
+  sched.UpdateFsInfo(std::move(fs_info));
+  TransferScheduler::Request req;
+  req.mPriority = Priority::Drain;
+  req.mFsids = {1, 2};
+  std::vector<std::unique_ptr<TransferScheduler::Slot>> slots;
+  slots.push_back(sched.Acquire(req));
+  slots.push_back(sched.Acquire(req));
+  ASSERT_EQ(2u, sched.GetNumRunningOnFs(1));
+  ASSERT_EQ(2u, sched.GetNumRunningOnFs(2));
+  // File system 1 is at its limit
+  std::atomic<bool> cancel {false};
+  auto fut = std::async(std::launch::async, [&]() {
+    return sched.Acquire(req, [&]() {
+      return cancel.load();
+    });
+  });
+  WaitQueued(sched, Priority::Drain, 1);
+  // Node of file system 3 (node1) already runs two transfers out of three
+  req.mFsids = {3};
+  slots.push_back(sched.Acquire(req));
+  ASSERT_EQ(1u, sched.GetNumRunningOnFs(3));
+  cancel = true;
+  ASSERT_EQ(nullptr, fut.get());
+  ASSERT_EQ(0u, sched.GetNumQueued(Priority::Drain));
+  // Releasing a slot lets the next request run
+  slots.clear();
+  ASSERT_EQ(0u, sched.GetNumRunningOnFs(1));
+  ASSERT_EQ(0u, sched.GetNumRunning(Priority::Drain));
+}
+
+//------------------------------------------------------------------------------
+// Test higher priority requests are served first
+//------------------------------------------------------------------------------
+TEST(TransferScheduler, PriorityOrdering)
+{
+  TransferScheduler sched;
+  sched.UpdateFsInfo(MakeFsInfo(2, 1, 1));
+  TransferScheduler::Request req;
+  req.mFsids = {1};
+  req.mPriority = Priority::Drain;
+  auto slot = sched.Acquire(req);
+  ASSERT_NE(nullptr, slot);
+  std::mutex mutex;
+  std::vector<Priority> order;
+  std::vector<std::thread> workers;
+
+  for (auto prio : {
+         Priority::Balance, Priority::Conversion, Priority::Fsck
+       }) {
+    workers.emplace_back([&, prio]() {
+      TransferScheduler::Request lreq = req;
+      lreq.mPriority = prio;
+      auto lslot = sched.Acquire(lreq);
+      std::unique_lock<std::mutex> lock(mutex);
+      order.push_back(prio);
+    });
+    WaitQueued(sched, prio, 1);
+  }
+
+  // Work conserving - request on a free file system is granted even if higher
+  // priority ones are waiting
+  req.mFsids = {2};
+  req.mPriority = Priority::Balance;
+  ASSERT_NE(nullptr, sched.Acquire(req));
+  slot.reset();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  ASSERT_EQ((std::vector<Priority> {Priority::Fsck, Priority::Conversion,
+                                    Priority::Balance
+                                   }), order);
+}
+
+//------------------------------------------------------------------------------
+// Test requests from different spaces are served round-robin
+//------------------------------------------------------------------------------
+TEST(TransferScheduler, SpaceRoundRobin)
+{
+  TransferScheduler sched;
+  sched.UpdateFsInfo(MakeFsInfo(1, 1, 1));
+  TransferScheduler::Request req;
+  req.mFsids = {1};
+  req.mPriority = Priority::Balance;
+  auto slot = sched.Acquire(req);
+  std::mutex mutex;
+  std::vector<std::string> order;
+  std::vector<std::thread> workers;
+
+  for (const auto& space : {
+         "a", "a", "a", "b", "b", "b"
+       }) {
+    workers.emplace_back([&, space]() {
+      TransferScheduler::Request lreq = req;
+      lreq.mSpace = space;
+      auto lslot = sched.Acquire(lreq);
+      std::unique_lock<std::mutex> lock(mutex);
+      order.push_back(space);
+    });
+    WaitQueued(sched, Priority::Balance, workers.size());
+  }
+
+  slot.reset();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  ASSERT_EQ((std::vector<std::string> {"a", "b", "a", "b", "a", "b"}), order);
+}
+
+//------------------------------------------------------------------------------
+// Test concurrency is reduced as the disk utilisation grows
+//------------------------------------------------------------------------------
+TEST(TransferScheduler, LoadScaling)
+{
+  TransferScheduler sched;
+  auto fs_info = MakeFsInfo(1, 1, 8);
+  fs_info[1].mLoad = 0.45;
+  fs_info[1].mMaxLoad = 0.9;
+  sched.UpdateFsInfo(std::move(fs_info));
+  TransferScheduler::Request req;
+  req.mFsids = {1};
+  std::vector<std::unique_ptr<TransferScheduler::Slot>> slots;
+
+  for (int i = 0; i < 4; ++i) {
+    slots.push_back(sched.Acquire(req));
+  }
+
+  auto fut = std::async(std::launch::async, [&]() {
+    return sched.Acquire(req);
+  });
+  WaitQueued(sched, Priority::Balance, 1);
+  // Utilisation drops, more transfers are allowed
+  fs_info = MakeFsInfo(1, 1, 8);
+  sched.UpdateFsInfo(std::move(fs_info));
+  slots.push_back(fut.get());
+  ASSERT_EQ(5u, sched.GetNumRunningOnFs(1));
+  // Overloaded disk still allows one transfer
+  slots.clear();
+  fs_info = MakeFsInfo(1, 1, 8);
+  fs_info[1].mLoad = 0.95;
+  sched.UpdateFsInfo(std::move(fs_info));
+  slots.push_back(sched.Acquire(req));
+  ASSERT_EQ(1u, sched.GetNumRunningOnFs(1));
+  sched.Stop();
+  ASSERT_EQ(nullptr, sched.Acquire(req));
+}
+
+//------------------------------------------------------------------------------
+// Test requests blocked on bandwidth are granted once the tokens are refilled
+// and that there is no concurrency limit by default
+//------------------------------------------------------------------------------
+TEST(TransferScheduler, BandwidthRefill)
+{
+  TransferScheduler sched;
+  std::map<TransferScheduler::fsid_t, TransferScheduler::FsInfo> fs_info;
+  fs_info[1].mRate = 10000;
+  sched.UpdateFsInfo(std::move(fs_info));
+  TransferScheduler::Request req;
+  req.mFsids = {1};
+  req.mSize = 20000;
+  // Budget is one second in debt after the first transfer
+  auto slot = sched.Acquire(req);
+  ASSERT_NE(nullptr, slot);
+  const auto start = std::chrono::steady_clock::now();
+  auto fut = std::async(std::launch::async, [&]() {
+    return sched.Acquire(req);
+  });
+  auto slot2 = fut.get();
+  ASSERT_NE(nullptr, slot2);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_GE(elapsed, std::chrono::milliseconds(900));
+  ASSERT_LT(elapsed, std::chrono::milliseconds(3000));
+  // Only the bandwidth is limited
+  ASSERT_EQ(2u, sched.GetNumRunningOnFs(1));
+}
@@ -900,6 +900,211 @@ TEST(FlatScheduler, TLNoSiteWeightedRR)
   ASSERT_TRUE(flat_scheduler.schedule(cluster_data(), {2}));
 }
 
+TEST_F(SimpleClusterF, FlatSchedulerBatch)
+{
+  using namespace eos::mgm::placement;
+  FlatScheduler flat_scheduler(2048);
+  auto cluster_data_ptr = mgr.getClusterData();
+
+  for (auto strategy : {PlacementStrategyT::kRoundRobin,
+                        PlacementStrategyT::kWeightedRoundRobin}) {
+    auto results = flat_scheduler.scheduleBatch(cluster_data_ptr(),
+                                                {2, ConfigStatus::kRW, strategy},
+                                                300);
+    ASSERT_EQ(results.size(), 300);
+    std::map<item_id_t, int> disk_ctr;
+
+    for (const auto& result: results) {
+      ASSERT_TRUE(result);
+      ASSERT_TRUE(result.is_valid_placement(2));
+      ASSERT_NE(result.ids[0], result.ids[1]);
+      // both replicas are in the same group
+      ASSERT_EQ((result.ids[0] - 1) / 10, (result.ids[1] - 1) / 10);
+      disk_ctr[result.ids[0]]++;
+      disk_ctr[result.ids[1]]++;
+    }
+
+    ASSERT_EQ(disk_ctr.size(), 30);
+
+    for (const auto& kv: disk_ctr) {
+      if (strategy == PlacementStrategyT::kRoundRobin) {
+        // Every site gets half of the files, site2 has a single group
+        ASSERT_EQ(kv.second, kv.first > 20 ? 30 : 15);
+      } else {
+        // Sites are weighted by the number of disks
+        ASSERT_EQ(kv.second, 20);
+      }
+    }
+  }
+}
+
+TEST_F(SimpleClusterF, FlatSchedulerBatchMaxPerDisk)
+{
+  using namespace eos::mgm::placement;
+  FlatScheduler flat_scheduler(2048);
+  auto cluster_data_ptr = mgr.getClusterData();
+  cluster_data_ptr().disks[0].active_status.store(ActiveStatus::kOffline);
+  PlacementArguments args {2, ConfigStatus::kRW,
+                           PlacementStrategyT::kWeightedRoundRobin};
+  args.excludefs = {2};
+  auto results = flat_scheduler.scheduleBatch(cluster_data_ptr(), args, 40, 2);
+  ASSERT_EQ(results.size(), 40);
+  std::map<item_id_t, int> disk_ctr;
+  int n_placed = 0;
+
+  for (const auto& result: results) {
+    if (!result) {
+      ASSERT_EQ(result.ret_code, ENOSPC);
+      continue;
+    }
+
+    ++n_placed;
+    ASSERT_TRUE(result.is_valid_placement(2));
+    ASSERT_NE(result.ids[0], result.ids[1]);
+    disk_ctr[result.ids[0]]++;
+    disk_ctr[result.ids[1]]++;
+  }
+
+  // Group 1 has 8 usable disks so it can take 8 files, 10 for the others
+  ASSERT_EQ(n_placed, 28);
+  ASSERT_EQ(disk_ctr.count(1), 0);
+  ASSERT_EQ(disk_ctr.count(2), 0);
+
+  for (const auto& kv: disk_ctr) {
+    ASSERT_EQ(kv.second, 2);
+  }
+
+  args.forced_group_index = 4000;
+  results = flat_scheduler.scheduleBatch(cluster_data_ptr(), args, 3);
+  ASSERT_EQ(results.size(), 3);
+  ASSERT_FALSE(results[0]);
+  ASSERT_EQ(results[0].error_string(), "Invalid forced group index");
+}
+
+TEST(FlatScheduler, BatchWeighted)
+{
+  using namespace eos::mgm::placement;
+  ClusterMgr mgr;
+  FlatScheduler flat_scheduler(PlacementStrategyT::kWeightedRandom, 2048);
+  std::vector<uint8_t> weights {1, 1, 2, 4};
+
+  {
+    auto sh = mgr.getStorageHandler(1024);
+    ASSERT_TRUE(sh.addBucket(get_bucket_type(StdBucketType::ROOT), 0));
+    ASSERT_TRUE(sh.addBucket(get_bucket_type(StdBucketType::GROUP),
+                             kBaseGroupOffset, 0));
+    ASSERT_TRUE(sh.addBucket(get_bucket_type(StdBucketType::GROUP),
+                             kBaseGroupOffset - 1, 0));
+
+    for (int i = 0; i < 8; i++) {
+      ASSERT_TRUE(sh.addDisk(Disk(i + 1, ConfigStatus::kRW, ActiveStatus::kOnline,
+                                  weights[i % 4]), kBaseGroupOffset - i / 4));
+    }
+  }
+
+  auto cluster_data = mgr.getClusterData();
+
+  for (size_t n_files : {1, 7, 160}) {
+    auto results = flat_scheduler.scheduleBatch(cluster_data(), {1}, n_files);
+    ASSERT_EQ(results.size(), n_files);
+    std::map<item_id_t, int> disk_ctr;
+
+    for (const auto& result: results) {
+      ASSERT_TRUE(result.is_valid_placement(1));
+      disk_ctr[result.ids[0]]++;
+    }
+
+    if (n_files == 160) {
+      for (int i = 0; i < 8; i++) {
+        ASSERT_EQ(disk_ctr[i + 1], 10 * weights[i % 4]);
+      }
+    }
+  }
+
+  // Forcing a group places all the files in that group
+  PlacementArguments args {2};
+  args.forced_group_index = 1;
+  auto results = flat_scheduler.scheduleBatch(cluster_data(), args, 100);
+
+  for (const auto& result: results) {
+    ASSERT_TRUE(result.is_valid_placement(2));
+    ASSERT_GT(result.ids[0], 4);
+    ASSERT_GT(result.ids[1], 4);
+  }
+}
+
+TEST(FlatScheduler, LoadAware)
+{
+  using namespace eos::mgm::placement;
+  ClusterMgr mgr;
+  FlatScheduler flat_scheduler(PlacementStrategyT::kLoadAware, 2048);
+  ASSERT_EQ(strategy_from_str("p2c"), PlacementStrategyT::kLoadAware);
+  ASSERT_EQ(strategy_to_str(PlacementStrategyT::kLoadAware), "loadaware");
+
+  {
+    auto sh = mgr.getStorageHandler(1024);
+    ASSERT_TRUE(sh.addBucket(get_bucket_type(StdBucketType::ROOT), 0));
+    ASSERT_TRUE(sh.addBucket(get_bucket_type(StdBucketType::GROUP),
+                             kBaseGroupOffset, 0));
+    ASSERT_TRUE(sh.addBucket(get_bucket_type(StdBucketType::GROUP),
+                             kBaseGroupOffset - 1, 0));
+
+    for (int i = 0; i < 32; i++) {
+      ASSERT_TRUE(sh.addDisk(Disk(i + 1, ConfigStatus::kRW, ActiveStatus::kOnline,
+                                  1), kBaseGroupOffset - i / 16));
+    }
+  }
+
+  // Disk utilisation is smoothed, the open files are taken as is
+  ASSERT_TRUE(mgr.setDiskLoad(1, 0.8, 0.0, 10));
+  ASSERT_TRUE(mgr.setDiskLoad(1, 0.8, 2.0, 20));
+  ASSERT_FALSE(mgr.setDiskLoad(33, 0.8, 0.0, 10));
+
+  {
+    auto cluster_data = mgr.getClusterData();
+    auto load = cluster_data().getDiskLoad(1);
+    ASSERT_NE(load, nullptr);
+    ASSERT_EQ(load->disk_util, 600);
+    ASSERT_EQ(load->net_util, kMaxDiskUtil);
+    ASSERT_EQ(load->open_files, 20);
+  }
+
+  // Odd disks are busy, even ones are idle
+  for (int i = 1; i <= 32; i++) {
+    if (i % 2) {
+      ASSERT_TRUE(mgr.setDiskLoad(i, 0.9, 0.0, 50));
+      ASSERT_TRUE(mgr.setDiskLoad(i, 0.9, 0.0, 50));
+    } else {
+      ASSERT_TRUE(mgr.setDiskLoad(i, 0.0, 0.0, 0));
+    }
+  }
+
+  auto cluster_data = mgr.getClusterData();
+  int busy_ctr = 0;
+  int idle_ctr = 0;
+
+  for (int i = 0; i < 1000; i++) {
+    auto result = flat_scheduler.schedule(cluster_data(), {2});
+    ASSERT_TRUE(result);
+    ASSERT_TRUE(result.is_valid_placement(2));
+
+    for (int j = 0; j < 2; j++) {
+      (result.ids[j] % 2) ? ++busy_ctr : ++idle_ctr;
+    }
+  }
+
+  // A busy disk is only used when both candidates are busy
+  ASSERT_LT(busy_ctr * 2, idle_ctr);
+  // Every placement is accounted in the open files of the disk
+  uint64_t open_files = 0;
+
+  for (const auto& load : cluster_data().disk_loads) {
+    open_files += load.open_files;
+  }
+
+  ASSERT_EQ(open_files, 16 * 50 + 2000);
+}
+
 void printProcessMemoryUsage() {
   std::ifstream status_file("/proc/self/status");
   std::string line;